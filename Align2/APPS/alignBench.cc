@@ -0,0 +1,204 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Benchmark of pairwise alignment with full matrices, in
+//                  linear-space mode and in a band, on two random related
+//                  sequences. Local alignments are also scored with the
+//                  striped engine.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <ScoringS2S.h>
+#include <NWAlign.h>
+#include <SWAlign.h>
+#include <FSAlign.h>
+#include <StripedSW.h>
+#include <SubMatrix.h>
+#include <AGPFunction.h>
+#include <SequenceData.h>
+#include <GetArg.h>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+using namespace Victor::Align2;
+using namespace Victor;
+
+void sShowHelp() {
+    cout << "Align Bench\n"
+            << "Times an alignment of two random related sequences, with the full\n"
+            << "matrices and in linear-space mode, and compares the results.\n"
+            << " Options: \n"
+            << "\t[-n <number>] \t\t Length of the sequences (def = 5000)\n"
+            << "\t[-a <type>] \t\t Alignment type: NW, SW or FS (def = NW)\n"
+            << "\t[-m <name>] \t\t Substitution matrix file (def = blosum62.dat)\n"
+            << "\t[-o <double>] \t\t Open gap penalty (def = 12.0)\n"
+            << "\t[-e <double>] \t\t Extension gap penalty (def = 3.0)\n"
+            << "\t[--seed <number>] \t Seed of the random sequences (def = 1)\n"
+            << "\t[-b <number>] \t\t Also align in a band of this width (def = 0, no)\n"
+            << "\t[--linearOnly] \t\t Skip the alignment with full matrices\n"
+            << "\n";
+}
+
+double sNow() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/**
+ *  Peak resident memory of the process so far, in MB.
+ */
+double sPeakMemory() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+/**
+ *  Random sequence and a copy with about 30% substitutions and 5% indels.
+ */
+void sMakeSequences(unsigned int length, string& seq1, string& seq2) {
+    static const string residues = "ACDEFGHIKLMNPQRSTVWY";
+    seq1 = "";
+    seq2 = "";
+    for (unsigned int i = 0; i < length; i++)
+        seq1 += residues[rand() % residues.size()];
+    for (unsigned int i = 0; (i < length) && (seq2.size() < length); i++) {
+        int r = rand() % 100;
+        if (r < 3)
+            continue; // deletion
+        if (r < 5)
+            seq2 += residues[rand() % residues.size()]; // insertion
+        if (r < 35)
+            seq2 += residues[rand() % residues.size()];
+        else
+            seq2 += seq1[i];
+    }
+}
+
+Align* sNewAlign(const string& type, AlignmentData* ad, GapFunction* gf,
+        ScoringScheme* ss, bool linearSpace, unsigned int band) {
+    if (type == "SW")
+        return new SWAlign(ad, gf, ss, linearSpace, band);
+    if (type == "FS")
+        return new FSAlign(ad, gf, ss, linearSpace, band);
+    return new NWAlign(ad, gf, ss, linearSpace, band);
+}
+
+/**
+ *  Aligns the sequences, prints time and peak memory and returns the match.
+ */
+vector<string> sTimeAlign(const string& type, AlignmentData* ad,
+        GapFunction* gf, ScoringScheme* ss, bool linearSpace, unsigned int band,
+        double& score) {
+    double start = sNow();
+    Align* a = sNewAlign(type, ad, gf, ss, linearSpace, band);
+    vector<string> match = a->getMatch();
+    double elapsed = sNow() - start;
+    score = a->getScore();
+
+    cout << setw(8) << ((band > 0) ? "band" : (linearSpace ? "linear" : "full"))
+            << "\t s= " << setprecision(4) << elapsed
+            << "\t peak MB= " << setprecision(6) << sPeakMemory()
+            << "\t score= " << score
+            << "\t length= " << match[0].size();
+    if (band > 0)
+        cout << "\t width= " << a->getBandWidth();
+    cout << "\n";
+    delete a;
+    return match;
+}
+
+int main(int argc, char* argv[]) {
+    if (getArg("h", argc, argv)) {
+        sShowHelp();
+        return 1;
+    };
+
+    unsigned int length, seed;
+    string type, matrixFileName;
+    double openGapPenalty, extensionGapPenalty;
+    getArg("n", length, argc, argv, 5000);
+    getArg("a", type, argc, argv, "NW");
+    getArg("m", matrixFileName, argc, argv, "blosum62.dat");
+    getArg("o", openGapPenalty, argc, argv, 12.00);
+    getArg("e", extensionGapPenalty, argc, argv, 3.00);
+    getArg("-seed", seed, argc, argv, 1);
+    unsigned int band;
+    getArg("b", band, argc, argv, 0);
+    bool linearOnly = getArg("-linearOnly", argc, argv);
+
+    char* victor = getenv("VICTOR_ROOT");
+    if (victor == NULL)
+        ERROR("Environment variable VICTOR_ROOT was not found.", exception);
+    matrixFileName = string(victor) + "data/" + matrixFileName;
+    ifstream matrixFile(matrixFileName.c_str());
+    if (!matrixFile)
+        ERROR("Error opening substitution matrix file.", exception);
+    SubMatrix sub(matrixFile);
+
+    srand(seed);
+    string seq1, seq2;
+    sMakeSequences(length, seq1, seq2);
+
+    AlignmentData* ad = new SequenceData(2, seq1, seq2, "target", "template");
+    ScoringScheme* ss = new ScoringS2S(&sub, ad, NULL, 1.00);
+    AGPFunction* gf = new AGPFunction(openGapPenalty, extensionGapPenalty);
+
+    cout << type << " alignment of " << seq1.size() << " x " << seq2.size()
+            << " residues\n";
+
+    // linear-space and band first, so that their peak memory is not hidden
+    // by the full matrices
+    double linearScore, bandScore, fullScore;
+    vector<string> linearMatch = sTimeAlign(type, ad, gf, ss, true, 0,
+            linearScore);
+    vector<string> bandMatch;
+    if (band > 0)
+        bandMatch = sTimeAlign(type, ad, gf, ss, false, band, bandScore);
+    if (!linearOnly) {
+        vector<string> fullMatch = sTimeAlign(type, ad, gf, ss, false, 0,
+                fullScore);
+        bool same = (linearMatch == fullMatch) && (linearScore == fullScore);
+        cout << "alignments " << (same ? "identical" : "DIFFERENT") << "\n";
+        if (band > 0) {
+            same = (bandMatch == fullMatch) && (bandScore == fullScore);
+            cout << "band alignment " << (same ? "identical" : "DIFFERENT")
+                    << "\n";
+        }
+    }
+
+    if (type == "SW") {
+        double start = sNow();
+        StripedSW striped(&sub, gf, seq1);
+        double stripedScore = striped.getScore(seq2);
+        cout << setw(8) << "striped" << "\t s= " << setprecision(4)
+                << sNow() - start << "\t score= " << setprecision(6)
+                << stripedScore << " ("
+                << StripedSW::getEngineName(striped.getLastEngine())
+                << ", score only)\n";
+    }
+
+    delete gf;
+    delete ss;
+    delete ad;
+    return 0;
+}
@@ -99,6 +99,7 @@ sShowHelp() {
             << "\n                     \t --sf=6: JensenShannon."
             << "\n                     \t --sf=7: AtchleyDistance."
             << "\n                     \t --sf=8: AtchleyCorrelation."
+            << "\n   [--precompute]    \t Precompute the profile-to-profile scores with SIMD kernels"
             << "\n"
             << "\n   [--global]        \t Needleman-Wunsch global alignment (default)"
             << "\n   [--local]         \t Smith-Waterman local alignment"
@@ -156,7 +157,7 @@ main(int argc, char **argv) {
     double weightHelix, weightStrand, weightBuried, weightStraight, weightSpace;
     double cSeq, cStr;
     unsigned int weightingScheme, scoringFunction, suboptNum, gapFunction, extensionType, structure;
-    bool fasta, global, local, freeshift, verbose;
+    bool fasta, global, local, freeshift, precompute, verbose;
     struct tm* newtime;
     time_t t;
 
@@ -180,6 +181,7 @@ main(int argc, char **argv) {
     getArg("U", upa, argc, argv, 999.9);
     getArg("-ws", weightingScheme, argc, argv, 0);
     getArg("-sf", scoringFunction, argc, argv, 1);
+    precompute = getArg("-precompute", argc, argv);
 
     global = getArg("-global", argc, argv);
     local = getArg("-local", argc, argv);
@@ -507,7 +509,10 @@ main(int argc, char **argv) {
                     cout << "switch scoring function: CrossProduct\n";
                     break;
             }
-            ss = new ScoringP2P(&sub, ad, str, pro1, pro2, sf, cSeq);
+            ScoringP2P *p2p = new ScoringP2P(&sub, ad, str, pro1, pro2, sf, cSeq);
+            if (precompute)
+                p2p->setPrecomputed();
+            ss = p2p;
         } else
             ss = new ScoringP2S(&sub, ad, str, pro1, cSeq);
     } else
@@ -0,0 +1,309 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Library search mode of subali: aligns one query against a
+//                  database of templates (FASTA file or directory of
+//                  profiles) on a pool of threads and ranks the hits.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <TemplateSearch.h>
+#include <HenikoffProfile.h>
+#include <PSICProfile.h>
+#include <SeqDivergenceProfile.h>
+#include <AGPFunction.h>
+#include <Alignment.h>
+#include <GetArg.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <dirent.h>
+
+using namespace Victor::Align2;
+using namespace Victor;
+
+
+/// Show command line options and help text.
+
+void
+sShowHelp() {
+    cout << "\nSUBALI LIBRARY SEARCH"
+            << "\nThis program aligns one query against a database of templates, a FASTA file of"
+            << "\nsequences or a directory of profiles, and ranks the templates by ReverseScore"
+            << "\nz-score. The query and the matrices are loaded once and the templates are read"
+            << "\nand aligned in batches on a pool of threads.\n"
+            << "\nOptions:"
+            << "\n"
+            << "\n * [--in <name>]     \t Name of query FASTA file (first sequence)"
+            << "\n * [--db <name>]     \t Name of template FASTA file"
+            << "\n   [--proDir <name>] \t Directory of template profiles (instead of --db)"
+            << "\n   [--pro1 <name>]   \t Name of query profile (psiBLAST M4 format) file"
+            << "\n   [--fasta]         \t Profiles are in FASTA format"
+            << "\n   [--ws <0|1|2|3>]  \t Weighting scheme of the profiles (default = 0)"
+            << "\n   [--sf <0-8>]      \t Profile-to-profile scoring function, as subali (default = 1)"
+            << "\n   [--precompute]    \t Precompute the profile-to-profile scores with SIMD kernels"
+            << "\n"
+            << "\n   [--sec <name>]    \t Query secondary structure FASTA file"
+            << "\n   [--secdb <name>]  \t Template secondary structure FASTA file, in --db order"
+            << "\n   [--cSeq <double>] \t Coefficient for sequence alignment (default = 0.80)"
+            << "\n   [--cStr <double>] \t Coefficient for structural alignment (default = 0.20)"
+            << "\n"
+            << "\n   [--global]        \t Needleman-Wunsch global alignment (default)"
+            << "\n   [--local]         \t Smith-Waterman local alignment"
+            << "\n   [--freeshift]     \t Free-shift alignment"
+            << "\n   [-m <name>]       \t Name of substitution matrix file (default = blosum62.dat)"
+            << "\n   [-M <name>]       \t Name of structural substitution matrix file (default = secid.dat)"
+            << "\n   [-o <double>]     \t Open gap penalty (default = 12.00)"
+            << "\n   [-e <double>]     \t Extension gap penalty (default = 3.00)"
+            << "\n"
+            << "\n   [--threads <n>]   \t Number of threads (default = 1)"
+            << "\n   [-z <n>]          \t Reversed alignments of the z-scores, 0 ranks by score (default = 50)"
+            << "\n   [--shuffle]       \t Z-scores of shuffled reversals, score only, with EVD p-values"
+            << "\n   [--hits <n>]      \t Number of hits to output, 0 for all (default = 20)"
+            << "\n   [--out <name>]    \t Save the alignments of the hits to FASTA file"
+            << "\n" << endl;
+}
+
+/**
+ *  Read the next sequence of a FASTA stream.
+ */
+bool
+sReadFasta(istream &is, string &name, string &seq) {
+    string line;
+    name = "";
+    seq = "";
+    while (is.peek() != EOF) {
+        if ((is.peek() == '>') && (name != ""))
+            break;
+        getline(is, line);
+        if (line.size() && (line[line.size() - 1] == '\r'))
+            line.erase(line.size() - 1);
+        if (line.size() && (line[0] == '>')) {
+            name = line.substr(1, line.find_first_of(" \t") - 1);
+            if (name == "")
+                name = "unnamed";
+        } else
+            seq += Alignment::getPureSequence(line);
+    }
+    return name != "";
+}
+
+/**
+ *  Load a profile of the weighting scheme from an alignment file.
+ */
+Profile*
+sLoadProfile(const string &fileName, bool fasta, unsigned int weightingScheme) {
+    ifstream file(fileName.c_str());
+    if (!file)
+        ERROR("Error opening profile file " + fileName, exception);
+    Alignment ali;
+    if (fasta)
+        ali.loadFasta(file);
+    else
+        ali.loadPsiBlastMode4(file);
+
+    Profile *pro;
+    switch (weightingScheme) {
+        case 1:
+            pro = new HenikoffProfile();
+            break;
+        case 2:
+            pro = new PSICProfile();
+            break;
+        case 3:
+            pro = new SeqDivergenceProfile();
+            break;
+        default:
+            pro = new Profile();
+            break;
+    }
+    pro->setProfile(ali);
+    return pro;
+}
+
+int
+main(int argc, char **argv) {
+    string inputFileName, dbFileName, proDirName, pro1FileName, secFileName, secDbFileName;
+    string matrixFileName, matrixStrFileName, outputFileName;
+    double openGapPenalty, extensionGapPenalty, cSeq, cStr;
+    unsigned int weightingScheme, scoringFunction, threads, samples, maxHits;
+
+    if (getArg("h", argc, argv)) {
+        sShowHelp();
+        return 1;
+    }
+
+    getArg("-in", inputFileName, argc, argv, "!");
+    getArg("-db", dbFileName, argc, argv, "!");
+    getArg("-proDir", proDirName, argc, argv, "!");
+    getArg("-pro1", pro1FileName, argc, argv, "!");
+    bool fasta = getArg("-fasta", argc, argv);
+    getArg("-ws", weightingScheme, argc, argv, 0);
+    getArg("-sf", scoringFunction, argc, argv, 1);
+    bool precompute = getArg("-precompute", argc, argv);
+    getArg("-sec", secFileName, argc, argv, "!");
+    getArg("-secdb", secDbFileName, argc, argv, "!");
+    getArg("-cSeq", cSeq, argc, argv, 0.80);
+    getArg("-cStr", cStr, argc, argv, 0.20);
+    bool local = getArg("-local", argc, argv);
+    bool freeshift = getArg("-freeshift", argc, argv);
+    getArg("m", matrixFileName, argc, argv, "blosum62.dat");
+    getArg("M", matrixStrFileName, argc, argv, "secid.dat");
+    getArg("o", openGapPenalty, argc, argv, 12.00);
+    getArg("e", extensionGapPenalty, argc, argv, 3.00);
+    getArg("-threads", threads, argc, argv, 1);
+    getArg("z", samples, argc, argv, 50);
+    bool shuffle = getArg("-shuffle", argc, argv);
+    getArg("-hits", maxHits, argc, argv, 20);
+    getArg("-out", outputFileName, argc, argv, "!");
+
+    if ((inputFileName == "!") || ((dbFileName == "!") && (proDirName == "!"))) {
+        sShowHelp();
+        ERROR("subaliSearch needs a query FASTA file and a template database.", exception);
+    }
+
+
+    // --------------------------------------------------
+    // 1. Load query and matrices, once
+    // --------------------------------------------------
+
+    string path = getenv("VICTOR_ROOT");
+    if (path.length() < 3)
+        cout << "Warning: environment variable VICTOR_ROOT is not set." << endl;
+    string dataPath = path + "data/";
+
+    ifstream inputFile(inputFileName.c_str());
+    if (!inputFile)
+        ERROR("Error opening query FASTA file.", exception);
+    string queryName, query;
+    if (!sReadFasta(inputFile, queryName, query))
+        ERROR("Query FASTA file contains no sequence.", exception);
+
+    matrixFileName = dataPath + matrixFileName;
+    ifstream matrixFile(matrixFileName.c_str());
+    if (!matrixFile)
+        ERROR("Error opening substitution matrix file.", exception);
+    SubMatrix sub(matrixFile);
+
+    matrixStrFileName = dataPath + matrixStrFileName;
+    ifstream matrixStrFile(matrixStrFileName.c_str());
+    if (!matrixStrFile)
+        ERROR("Error opening structural substitution matrix file.", exception);
+    SubMatrix subStr(matrixStrFile);
+
+    AGPFunction gf(openGapPenalty, extensionGapPenalty);
+    TemplateSearch search(&sub, &gf, queryName, query);
+    search.setThreads(threads);
+    search.setZScore(samples, shuffle);
+    if (local)
+        search.setMode(TemplateSearch::LOCAL_MODE);
+    else
+        if (freeshift)
+        search.setMode(TemplateSearch::FREESHIFT_MODE);
+
+    Profile *queryProfile = NULL;
+    if (pro1FileName != "!") {
+        queryProfile = sLoadProfile(pro1FileName, fasta, weightingScheme);
+        search.setQueryProfile(queryProfile, scoringFunction, precompute);
+    }
+
+    ifstream secDbFile;
+    if (secFileName != "!") {
+        ifstream secFile(secFileName.c_str());
+        string secName, sec;
+        if (!secFile || !sReadFasta(secFile, secName, sec))
+            ERROR("Error reading query secondary structure FASTA file.", exception);
+        search.setQuerySecondary(sec, &subStr, cSeq, cStr);
+
+        secDbFile.open(secDbFileName.c_str());
+        if ((dbFileName == "!") || !secDbFile)
+            ERROR("--sec needs --db and its --secdb file.", exception);
+    }
+
+
+    // --------------------------------------------------
+    // 2. Stream the templates
+    // --------------------------------------------------
+
+    if (dbFileName != "!") {
+        ifstream dbFile(dbFileName.c_str());
+        if (!dbFile)
+            ERROR("Error opening template FASTA file.", exception);
+        string name, seq, secName, sec;
+        while (sReadFasta(dbFile, name, seq)) {
+            if (secDbFile.is_open() && !sReadFasta(secDbFile, secName, sec))
+                ERROR("Template secondary structure missing for " + name, exception);
+            search.addTemplate(name, seq, NULL, sec);
+        }
+    } else {
+        DIR *dir = opendir(proDirName.c_str());
+        if (dir == NULL)
+            ERROR("Error opening template profile directory.", exception);
+        vector<string> fileNames;
+        for (struct dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir))
+            if (entry->d_name[0] != '.')
+                fileNames.push_back(entry->d_name);
+        closedir(dir);
+        sort(fileNames.begin(), fileNames.end());
+
+        for (unsigned int i = 0; i < fileNames.size(); i++) {
+            Profile *pro = sLoadProfile(proDirName + "/" + fileNames[i], fasta,
+                    weightingScheme);
+            search.addTemplate(fileNames[i], pro->getSeq(), pro);
+        }
+    }
+    search.alignQueued();
+
+
+    // --------------------------------------------------
+    // 3. Output ranked hits
+    // --------------------------------------------------
+
+    vector<TemplateSearch::Hit> hits = search.getHits(maxHits);
+    cout << "\nQuery " << queryName << " (" << query.size() << " residues), "
+            << search.size() << " templates\n\n"
+            << setw(6) << "rank" << "  " << setw(20) << left << "template" << right
+            << setw(8) << "length" << setw(12) << "score" << setw(10) << "z-score";
+    if (shuffle)
+        cout << setw(12) << "p-value";
+    cout << "\n";
+    for (unsigned int i = 0; i < hits.size(); i++) {
+        cout << setw(6) << i + 1 << "  " << setw(20) << left << hits[i].name << right
+            << setw(8) << hits[i].length << setw(12) << fixed << setprecision(2)
+            << hits[i].score << setw(10) << hits[i].zScore;
+        if (shuffle)
+            cout << setw(12) << scientific << setprecision(2) << hits[i].pValue;
+        cout << "\n";
+    }
+    cout << endl;
+
+    if (outputFileName != "!") {
+        ofstream outputFile(outputFileName.c_str());
+        if (!outputFile)
+            ERROR("Error opening output FASTA file.", exception);
+        for (unsigned int i = 0; i < hits.size(); i++)
+            outputFile << ">" << queryName << "\n" << hits[i].match[0] << "\n"
+                << ">" << hits[i].name << " rank=" << i + 1 << " score="
+                << hits[i].score << " z=" << hits[i].zScore << "\n"
+                << hits[i].match[1] << "\n";
+        cout << "Alignments saved to FASTA file: " << outputFileName << endl;
+    }
+
+    delete queryProfile;
+    return 0;
+}
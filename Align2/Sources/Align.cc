@@ -23,23 +23,21 @@
 // -----------------x-----------------------------------------------------------
 
 #include <Align.h>
+#include <Profiler.h>
+#include <limits.h>
 
 namespace Victor { namespace Align2{
 
     // CONSTRUCTORS:
 
-    Align::Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss) : ad(ad),
-    gf(gf), ss(ss), F((ad->getSequence(1)).size() + 1),
-    B((ad->getSequence(1)).size() + 1), n((ad->getSequence(1)).size()),
-    m((ad->getSequence(2)).size()), res1Pos(), res2Pos() {
+    Align::Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+            bool linearSpace, unsigned int bandWidth) : ad(ad), gf(gf), ss(ss),
+    F(), B(), n((ad->getSequence(1)).size()), m((ad->getSequence(2)).size()),
+    res1Pos(), res2Pos(), linearSpace(linearSpace), path(), pathScore(0.0),
+    weight1(), weight2(), bandWidth(bandWidth), bandAnchor() {
         //cout<<"building align objA\n";
-        vector<double> frow(m + 1, 0);
-        vector<Traceback> brow(m + 1);
-        //cout<<"building align objB\n";
-        for (unsigned int i = 0; i < F.size(); ++i) {
-            F[i] = frow;
-            B[i] = brow;
-        }
+        if (!linearSpace && (bandWidth == 0))
+            pAllocateMatrix();
         //cout<<"building align objC\n";
         setPenalties(0.98, 0.00);
         //cout<<"building align objD\n";
@@ -204,6 +202,76 @@ namespace Victor { namespace Align2{
         return score;
     }
 
+    /**
+     * Score of the optimal path, calculated row by row with the recurrence
+     * of pCalculateRow() but without checkpoints and traceback: memory is
+     * O(m) and F, B and the stored path are not changed, so it may be
+     * called by several threads at once. The gap penalties of the columns
+     * are read once instead of at every cell. With columns, column j of the
+     * matrix scores template position columns[j - 1] (e.g. a shuffled
+     * template).
+     * @param columns permutation of 1..m (NULL for the template order)
+     * @return score
+     */
+    double
+    Align::getScoreOnly(const vector<unsigned int> *columns) const {
+        if ((columns != NULL) && (columns->size() != m))
+            ERROR("Error in Align: permutation of wrong length", exception);
+
+        bool local = pIsLocal();
+        vector<double> prevF(m + 1), curF(m + 1), s(m + 1);
+        vector<double> open(m + 1), ext(m + 1);
+        vector<unsigned char> prevUp(m + 1), curUp(m + 1); // UP_STEP moves
+        vector<int> col(m + 1);
+        for (int j = 0; j <= static_cast<int> (m); j++) {
+            prevF[j] = pGetBorderScore(0, j);
+            prevUp[j] = (pGetBorderStep(0, j) == UP_STEP);
+            open[j] = gf->getOpenPenalty(j);
+            ext[j] = gf->getExtensionPenalty(j);
+            col[j] = ((columns != NULL) && (j > 0)) ? (*columns)[j - 1] : j;
+        }
+
+        vector<double> lastColumn(n + 1);
+        lastColumn[0] = prevF[m];
+        double maxval = local ? 0.00 : INT_MIN;
+
+        for (int i = 1; i <= static_cast<int> (n); i++) {
+            for (int j = 1; j <= static_cast<int> (m); j++)
+                s[j] = ss->scoring(i, col[j]);
+
+            curF[0] = pGetBorderScore(i, 0);
+            curUp[0] = (pGetBorderStep(i, 0) == UP_STEP);
+            bool left = false;
+
+            for (int j = 1; j <= static_cast<int> (m); j++) {
+                bool inside = (i != 1) && (j != 1);
+                double extI = prevF[j] - ((inside && prevUp[j]) ? ext[j] : open[j]);
+                double extJ = curF[j - 1] - ((inside && left) ? ext[j] : open[j]);
+                double z = prevF[j - 1] + s[j];
+                double val = max(max(z, extI), extJ);
+                if (local) {
+                    val = max(val, 0.00);
+                    maxval = max(maxval, val);
+                }
+                curF[j] = val;
+
+                // same order of the moves as pCalculateRow()
+                bool diagonal = (local && EQUALS(val, 0)) || EQUALS(val, z);
+                left = !diagonal && EQUALS(val, extJ);
+                curUp[j] = !diagonal && !left;
+            }
+
+            lastColumn[i] = curF[m];
+            prevF.swap(curF);
+            prevUp.swap(curUp);
+        }
+
+        if (local)
+            return maxval;
+        Traceback end = pGetEndPoint(prevF, lastColumn);
+        return (end.i == static_cast<int> (n)) ? prevF[end.j] : lastColumn[end.i];
+    }
+
     void
     Align::doMatch(ostream &os) const {
         vector<string> match = getMatch();
@@ -237,21 +305,8 @@ namespace Victor { namespace Align2{
         gf = orig.gf->newCopy();
         ss = orig.ss->newCopy();
 
-        F.clear();
-        for (unsigned int i = 0; i < orig.F.size(); i++) {
-            vector<double> *tmp = new vector<double>;
-            for (unsigned int j = 0; j < orig.F[i].size(); j++)
-                tmp->push_back(orig.F[i][j]);
-            F.push_back(*tmp);
-        }
-
-        B.clear();
-        for (unsigned int i = 0; i < orig.B.size(); i++) {
-            vector<Traceback> *tmp = new vector<Traceback>;
-            for (unsigned int j = 0; j < orig.B[i].size(); j++)
-                tmp->push_back(orig.B[i][j]);
-            B.push_back(*tmp);
-        }
+        F = orig.F;
+        B = orig.B;
 
         B0 = orig.B0;
         n = orig.n;
@@ -267,21 +322,24 @@ namespace Victor { namespace Align2{
 
         penaltyMul = orig.penaltyMul;
         penaltyAdd = orig.penaltyAdd;
+
+        linearSpace = orig.linearSpace;
+        path = orig.path;
+        pathScore = orig.pathScore;
+        weight1 = orig.weight1;
+        weight2 = orig.weight2;
+        bandWidth = orig.bandWidth;
+        bandAnchor = orig.bandAnchor;
     }
 /**
  * 
  */
      void
     Align::recalculateMatrix() {
-        for (unsigned int i = 0; i < F.size(); i++)
-            for (unsigned int j = 0; j < F[i].size(); j++)
-                F[i][j] = -999;
-
-        for (unsigned int i = 0; i < B.size(); i++)
-            for (unsigned int j = 0; j < B[i].size(); j++) {
-                B[i][j].i = -999;
-                B[i][j].j = -999;
-            }
+        if (F.size() > 0) {
+            F.assign(n + 1, m + 1, -999);
+            B.assign(n + 1, m + 1);
+        }
 
         B0.i = -999;
         B0.j = -999;
@@ -292,4 +350,532 @@ namespace Victor { namespace Align2{
         pCalculateMatrix(true);
     }
 
+    /**
+     * The matrices are freed and the path calculated again in the band.
+     * Weights of a linear-space or banded alignment are kept, those of an
+     * alignment with full matrices are not stored and are lost. Width 0
+     * returns to the full matrices (or to linear-space mode).
+     * @param width columns of the band on each side of the guide path
+     * @param anchor positions aligned by a previous alignment, as returned
+     * by getMatchSubset() (empty: the line from (0, 0) to (n, m))
+     */
+    void
+    Align::setBand(unsigned int width, const vector< vector<int> > &anchor) {
+        if ((anchor.size() != 0) && ((anchor.size() != 2)
+                || (anchor[0].size() != anchor[1].size())))
+            ERROR("Error in Align: band anchor is not a pair of positions",
+                exception);
+
+        bandWidth = width;
+        bandAnchor = anchor;
+        path.clear();
+        res1Pos.clear();
+        res2Pos.clear();
+        if (!linearSpace && (bandWidth == 0))
+            pAllocateMatrix();
+        else {
+            F.clear();
+            B.clear();
+        }
+
+        if (weight1.empty())
+            pCalculateMatrix(true);
+        else {
+            vector<unsigned int> v1 = weight1, v2 = weight2;
+            pCalculateMatrix(v1, v2, true);
+        }
+    }
+
+
+    // HELPERS:
+
+    /**
+     * Calculate the optimal path without storing F and B. The forward pass
+     * keeps every k-th row of scores and moves as checkpoints; the traceback
+     * recalculates the rows following a checkpoint whenever it enters them.
+     * The rows are calculated as in pCalculateMatrix(), so path and score are
+     * the same as with the full matrices.
+     * @param v1 weights of the target positions (NULL if not weighted)
+     * @param v2 weights of the template positions (NULL if not weighted)
+     */
+    void
+    Align::pCalculateLinear(const vector<unsigned int> *v1,
+            const vector<unsigned int> *v2) {
+        if (v1 != NULL) {
+            weight1 = *v1;
+            weight2 = *v2;
+        } else {
+            weight1.clear();
+            weight2.clear();
+        }
+
+        bool local = pIsLocal();
+        int k = static_cast<int> (sqrt(static_cast<double> (n + 1)));
+        if (k < 1)
+            k = 1;
+
+        vector<double> prevF(m + 1), curF(m + 1);
+        vector<unsigned char> prevStep(m + 1), curStep(m + 1);
+        for (int j = 0; j <= static_cast<int> (m); j++) {
+            prevF[j] = pGetBorderScore(0, j);
+            prevStep[j] = pGetBorderStep(0, j);
+        }
+
+        vector< vector<double> > checkF(1, prevF);
+        vector< vector<unsigned char> > checkStep(1, prevStep);
+        vector<double> lastColumn(n + 1);
+        lastColumn[0] = prevF[m];
+        double maxval = INT_MIN;
+        B0 = Traceback(n, m);
+
+        for (int i = 1; i <= static_cast<int> (n); i++) {
+            pCalculateRow(i, prevF, prevStep, curF, curStep, v1, v2);
+            lastColumn[i] = curF[m];
+
+            if (local)
+                for (int j = 1; j <= static_cast<int> (m); j++)
+                    if (curF[j] > maxval) {
+                        maxval = curF[j];
+                        B0 = Traceback(i, j);
+                    }
+
+            if (i % k == 0) {
+                checkF.push_back(curF);
+                checkStep.push_back(curStep);
+            }
+            prevF.swap(curF);
+            prevStep.swap(curStep);
+        }
+
+        if (!local)
+            B0 = pGetEndPoint(prevF, lastColumn);
+
+        path.clear();
+        vector< vector<unsigned char> > block; // moves of rows first...
+        int first = -1;
+        Traceback tb = B0;
+
+        while (!Traceback::isInvalidTraceback(tb)) {
+            if ((first < 0) || (tb.i < first)) {
+                first = (tb.i / k) * k;
+                prevF = checkF[first / k];
+                block.assign(1, checkStep[first / k]);
+                for (int i = first + 1; i <= tb.i; i++) {
+                    pCalculateRow(i, prevF, block.back(), curF, curStep, v1, v2);
+                    block.push_back(curStep);
+                    prevF.swap(curF);
+                }
+                if (path.empty())
+                    pathScore = prevF[tb.j];
+            }
+
+            path.push_back(tb);
+            switch (block[tb.i - first][tb.j]) {
+                case DIAGONAL_STEP:
+                    tb = Traceback(tb.i - 1, tb.j - 1);
+                    break;
+                case LEFT_STEP:
+                    tb = Traceback(tb.i, tb.j - 1);
+                    break;
+                case UP_STEP:
+                    tb = Traceback(tb.i - 1, tb.j);
+                    break;
+                default:
+                    tb = Traceback::getInvalidTraceback();
+            }
+        }
+    }
+
+    /**
+     * Calculate the optimal path in the band of pSetBandLimits(), with
+     * the recurrence of pCalculateRow() restricted to the cells of the band
+     * (cells outside it cannot be reached). Two rows of scores and the
+     * moves of the band are stored. If the traceback touches an edge of the
+     * band that is not a border of the matrix, or a cell whose upper
+     * neighbour is outside the band, the band is doubled and the path
+     * calculated again.
+     * @param v1 weights of the target positions (NULL if not weighted)
+     * @param v2 weights of the template positions (NULL if not weighted)
+     */
+    void
+    Align::pCalculateBanded(const vector<unsigned int> *v1,
+            const vector<unsigned int> *v2) {
+        if (v1 != NULL) {
+            weight1 = *v1;
+            weight2 = *v2;
+        } else {
+            weight1.clear();
+            weight2.clear();
+        }
+
+        const double outside = -1E30; // score of the cells outside the band
+        bool local = pIsLocal();
+
+        while (true) {
+            vector<int> low, high;
+            pSetBandLimits(low, high);
+
+            vector< vector<unsigned char> > step(n + 1);
+            vector<double> prevF(m + 1, outside), curF(m + 1, outside);
+            vector<double> lastColumn(n + 1, outside);
+            step[0].resize(high[0] + 1);
+            for (int j = 0; j <= high[0]; j++) {
+                prevF[j] = pGetBorderScore(0, j);
+                step[0][j] = pGetBorderStep(0, j);
+            }
+            if (high[0] == static_cast<int> (m))
+                lastColumn[0] = prevF[m];
+            double maxval = INT_MIN;
+            B0 = Traceback(n, m);
+
+            for (int i = 1; i <= static_cast<int> (n); i++) {
+                int lo = low[i], hi = high[i];
+                int prevLo = low[i - 1], prevHi = high[i - 1];
+                vector<unsigned char> &prevStep = step[i - 1];
+                vector<unsigned char> &curStep = step[i];
+                curStep.resize(hi - lo + 1);
+                PROFILE_COUNT("cells", hi - lo + 1);
+
+                if (lo == 0) {
+                    curF[0] = pGetBorderScore(i, 0);
+                    curStep[0] = pGetBorderStep(i, 0);
+                }
+
+                for (int j = max(lo, 1); j <= hi; j++) {
+                    double s;
+                    if (v1 != NULL) {
+                        unsigned int minL = ((*v1)[i - 1] < (*v2)[j - 1]) ?
+                                (*v1)[i - 1] : (*v2)[j - 1];
+                        s = ss->scoring(i, j) * minL;
+                    } else
+                        s = ss->scoring(i, j);
+
+                    double extI = outside, extJ = outside, z = outside;
+                    if (j <= prevHi) {
+                        if ((i != 1) && (j != 1) && (prevStep[j - prevLo] == UP_STEP))
+                            extI = prevF[j] - gf->getExtensionPenalty(j);
+                        else
+                            extI = prevF[j] - gf->getOpenPenalty(j);
+                    }
+                    if (j > lo) {
+                        if ((i != 1) && (j != 1) && (curStep[j - 1 - lo] == LEFT_STEP))
+                            extJ = curF[j - 1] - gf->getExtensionPenalty(j);
+                        else
+                            extJ = curF[j - 1] - gf->getOpenPenalty(j);
+                    }
+                    if ((j - 1 >= prevLo) && (j - 1 <= prevHi))
+                        z = prevF[j - 1] + s;
+
+                    double val = max(max(z, extI), extJ);
+                    if (local)
+                        val = max(val, 0.00);
+                    curF[j] = val;
+
+                    if (local && EQUALS(val, 0))
+                        curStep[j - lo] = NO_STEP;
+                    else
+                        if (EQUALS(val, z))
+                        curStep[j - lo] = DIAGONAL_STEP;
+                    else
+                        if (EQUALS(val, extJ))
+                        curStep[j - lo] = LEFT_STEP;
+                    else
+                        curStep[j - lo] = UP_STEP;
+
+                    if (local && (val > maxval)) {
+                        maxval = val;
+                        B0 = Traceback(i, j);
+                    }
+                }
+
+                if (hi == static_cast<int> (m))
+                    lastColumn[i] = curF[m];
+                for (int j = prevLo; j <= prevHi; j++)
+                    prevF[j] = outside;
+                prevF.swap(curF);
+            }
+
+            if (!local)
+                B0 = pGetEndPoint(prevF, lastColumn);
+            if (local)
+                pathScore = maxval;
+            else
+                if (B0.i == static_cast<int> (n))
+                pathScore = prevF[B0.j];
+            else
+                if (B0.j == static_cast<int> (m))
+                pathScore = lastColumn[B0.i];
+            else
+                pathScore = pGetBorderScore(B0.i, B0.j);
+
+            path.clear();
+            bool edge = false;
+            Traceback tb = B0;
+            while (!Traceback::isInvalidTraceback(tb)) {
+                path.push_back(tb);
+                if (((tb.j == low[tb.i]) && (tb.j > 0))
+                        || ((tb.j == high[tb.i]) && (tb.j < static_cast<int> (m)))
+                        || ((tb.i > 0) && (tb.j > high[tb.i - 1])))
+                    edge = true;
+
+                switch (step[tb.i][tb.j - low[tb.i]]) {
+                    case DIAGONAL_STEP:
+                        tb = Traceback(tb.i - 1, tb.j - 1);
+                        break;
+                    case LEFT_STEP:
+                        tb = Traceback(tb.i, tb.j - 1);
+                        break;
+                    case UP_STEP:
+                        tb = Traceback(tb.i - 1, tb.j);
+                        break;
+                    default:
+                        tb = Traceback::getInvalidTraceback();
+                }
+            }
+
+            if (!edge || (bandWidth >= max(n, m)))
+                break;
+            bandWidth = min(2 * bandWidth, static_cast<unsigned int> (max(n, m)));
+        }
+    }
+
+    /**
+     * The band follows the guide path: the line from (0, 0) to (n, m), or
+     * the cells of the bandAnchor path, extended diagonally before its
+     * first and after its last row. The limits are then adjusted so that
+     * every cell of the band can be reached: the first column never
+     * decreases, each row overlaps the previous one, and the band includes
+     * (0, 0) and (n, m).
+     * @param low first column of the band, for rows 0 to n
+     * @param high last column of the band, for rows 0 to n
+     */
+    void
+    Align::pSetBandLimits(vector<int> &low, vector<int> &high) const {
+        vector<int> first(n + 1, -1), last(n + 1, -1); // guide columns by row
+        int firstRow = n + 1, lastRow = -1;
+
+        if (!bandAnchor.empty()) {
+            int i = -1, j = -1;
+            for (unsigned int k = 0; k < bandAnchor[0].size(); k++) {
+                if ((i < 0) && (bandAnchor[0][k] != INVALID_POS))
+                    i = bandAnchor[0][k];
+                if ((j < 0) && (bandAnchor[1][k] != INVALID_POS))
+                    j = bandAnchor[1][k];
+            }
+
+            for (int k = -1; (i >= 0) && (j >= 0)
+                    && (k < static_cast<int> (bandAnchor[0].size())); k++) {
+                if ((k >= 0) && (bandAnchor[0][k] != INVALID_POS))
+                    i = bandAnchor[0][k] + 1;
+                if ((k >= 0) && (bandAnchor[1][k] != INVALID_POS))
+                    j = bandAnchor[1][k] + 1;
+                if ((i > static_cast<int> (n)) || (j > static_cast<int> (m)))
+                    ERROR("Error in Align: band anchor outside the matrix",
+                        exception);
+                first[i] = (first[i] < 0) ? j : min(first[i], j);
+                last[i] = max(last[i], j);
+                firstRow = min(firstRow, i);
+                lastRow = max(lastRow, i);
+            }
+        }
+
+        for (int i = 0; i <= static_cast<int> (n); i++)
+            if (lastRow < 0)
+                first[i] = last[i] = static_cast<int> (floor((n > 0) ?
+                    static_cast<double> (i) * m / n + 0.5 : 0));
+            else
+                if (i < firstRow)
+                first[i] = last[i] = first[firstRow] - (firstRow - i);
+            else
+                if (i > lastRow)
+                first[i] = last[i] = last[lastRow] + (i - lastRow);
+
+        low.resize(n + 1);
+        high.resize(n + 1);
+        for (unsigned int i = 0; i <= n; i++) {
+            low[i] = max(0, min(first[i], static_cast<int> (m))
+                    - static_cast<int> (bandWidth));
+            high[i] = min(static_cast<int> (m), max(last[i], 0)
+                    + static_cast<int> (bandWidth));
+        }
+
+        low[0] = 0;
+        high[n] = m;
+        for (unsigned int i = 1; i <= n; i++) {
+            low[i] = max(low[i], low[i - 1]);
+            if (low[i] > high[i - 1] + 1)
+                high[i - 1] = low[i] - 1;
+            high[i] = max(high[i], low[i]);
+        }
+    }
+
+    /**
+     * Allocate F and B, calculate them and forget the linear-space or
+     * banded path.
+     * Needed before modifying the matrix for suboptimal alignments.
+     */
+    void
+    Align::pUseFullMatrix() {
+        if (!linearSpace && (bandWidth == 0))
+            return;
+
+        linearSpace = false;
+        bandWidth = 0;
+        path.clear();
+        pAllocateMatrix();
+        if (weight1.empty())
+            pCalculateMatrix(true);
+        else
+            pCalculateMatrix(weight1, weight2, true);
+        weight1.clear();
+        weight2.clear();
+    }
+
+    /**
+     * Default scores of row and column 0: gap penalties of a global
+     * alignment.
+     * @param i row
+     * @param j column
+     * @return F[i][j]
+     */
+    double
+    Align::pGetBorderScore(int i, int j) const {
+        if (j == 0) {
+            if (i == 0)
+                return 0.0;
+            return -gf->getOpenPenalty(0) - gf->getExtensionPenalty(0) * (i - 1);
+        }
+        return -gf->getOpenPenalty(j) - gf->getExtensionPenalty(j) * (j - 1);
+    }
+
+    /**
+     * 
+     * @return false, alignments are global by default
+     */
+    bool
+    Align::pIsLocal() const {
+        return false;
+    }
+
+    /**
+     * Default end of the optimal path: the last cell of the matrix.
+     * @param lastRow F[n]
+     * @param lastColumn F[i][m] for all i
+     * @return end of the optimal path
+     */
+    Traceback
+    Align::pGetEndPoint(const vector<double> &lastRow,
+            const vector<double> &lastColumn) const {
+        return Traceback(n, m);
+    }
+
+    void
+    Align::pAllocateMatrix() {
+        F.assign(n + 1, m + 1);
+        B.assign(n + 1, m + 1);
+    }
+
+    /**
+     * Calculate scores and moves of row i with the recurrence of
+     * pCalculateMatrix(): opening a gap after a gap in the same direction
+     * costs the extension penalty.
+     * @param i row
+     * @param prevF scores of row i - 1
+     * @param prevStep moves of row i - 1
+     * @param curF scores of row i
+     * @param curStep moves of row i
+     * @param v1 weights of the target positions (NULL if not weighted)
+     * @param v2 weights of the template positions (NULL if not weighted)
+     */
+    void
+    Align::pCalculateRow(int i, const vector<double> &prevF,
+            const vector<unsigned char> &prevStep, vector<double> &curF,
+            vector<unsigned char> &curStep, const vector<unsigned int> *v1,
+            const vector<unsigned int> *v2) const {
+        bool local = pIsLocal();
+        curF[0] = pGetBorderScore(i, 0);
+        curStep[0] = pGetBorderStep(i, 0);
+        PROFILE_COUNT("cells", m);
+
+        for (int j = 1; j <= static_cast<int> (m); j++) {
+            double s;
+            if (v1 != NULL) {
+                unsigned int minL = ((*v1)[i - 1] < (*v2)[j - 1]) ?
+                        (*v1)[i - 1] : (*v2)[j - 1];
+                s = ss->scoring(i, j) * minL;
+            } else
+                s = ss->scoring(i, j);
+
+            double extI, extJ;
+
+            if ((i != 1) && (j != 1) && (prevStep[j] == UP_STEP))
+                extI = prevF[j] - gf->getExtensionPenalty(j);
+            else
+                extI = prevF[j] - gf->getOpenPenalty(j);
+
+            if ((i != 1) && (j != 1) && (curStep[j - 1] == LEFT_STEP))
+                extJ = curF[j - 1] - gf->getExtensionPenalty(j);
+            else
+                extJ = curF[j - 1] - gf->getOpenPenalty(j);
+
+            double z = prevF[j - 1] + s;
+            double val = max(max(z, extI), extJ);
+            if (local)
+                val = max(val, 0.00);
+
+            curF[j] = val;
+
+            if (local && EQUALS(val, 0))
+                curStep[j] = NO_STEP;
+            else
+                if (EQUALS(val, z))
+                curStep[j] = DIAGONAL_STEP;
+            else
+                if (EQUALS(val, extJ))
+                curStep[j] = LEFT_STEP;
+            else
+                if (EQUALS(val, extI))
+                curStep[j] = UP_STEP;
+            else
+                ERROR("Error in Align: linear-space row", exception);
+        }
+    }
+
+    /**
+     * 
+     * @param i row
+     * @param j column, i or j is 0
+     * @return move leading to cell (i, j)
+     */
+    Align::Step
+    Align::pGetBorderStep(int i, int j) const {
+        if (pIsLocal() || ((i == 0) && (j == 0)))
+            return NO_STEP;
+        return (i == 0) ? LEFT_STEP : UP_STEP;
+    }
+
+    /**
+     * Look up tb on the stored path, where i + j decreases at each step.
+     * @param tb cell on the path
+     * @return following cell, invalid for the last one or cells off the path
+     */
+    Traceback
+    Align::pNextOnPath(const Traceback &tb) const {
+        int key = tb.i + tb.j;
+        unsigned int lo = 0;
+        unsigned int hi = path.size();
+        while (lo < hi) {
+            unsigned int mid = (lo + hi) / 2;
+            if (path[mid].i + path[mid].j > key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if ((lo + 1 < path.size()) && (path[lo] == tb))
+            return path[lo + 1];
+        return Traceback::getInvalidTraceback();
+    }
+
 }} // namespace
+
@@ -22,8 +22,10 @@
 #include <AlignmentData.h>
 #include <GapFunction.h>
 #include <IoTools.h>
+#include <ScoreMatrix.h>
 #include <ScoringScheme.h>
 #include <Traceback.h>
+#include <TracebackMatrix.h>
 #include <algorithm>
 #include <iostream>
 #include <limits>
@@ -44,6 +46,28 @@ namespace Victor { namespace Align2{
      *    originally based
      *                  on the Java implementation from Peter Sestoft.
      *                  http://www.dina.dk/~sestoft
+     *
+     *    In linear-space mode the score and traceback matrices F and B are
+     *    not stored. Only every k-th row of the matrix is kept (k close to
+     *    sqrt(n)) and the rows between two checkpoints are recalculated
+     *    when the traceback passes through them, so memory grows as
+     *    O(m * sqrt(n)) and the optimal path is the same as with the full
+     *    matrices. Suboptimal alignments need F and B: getMultiMatch()
+     *    switches to the full matrices the first time it is called.
+     *
+     *    The full matrices are stored compactly: B keeps a two bit move per
+     *    cell (see TracebackMatrix) and F keeps floats while the scores are
+     *    exact in single precision (see ScoreMatrix), in one allocation
+     *    each.
+     *
+     *    In banded mode only the cells within bandWidth columns of a guide
+     *    path are calculated: the line from (0, 0) to (n, m), or a previous
+     *    alignment given to setBand(). The moves of the band are stored,
+     *    so memory grows as O(n * bandWidth). When the optimal path touches
+     *    the edge of the band, the band is doubled and the path calculated
+     *    again, until it stays inside the band or the band covers the
+     *    matrix. Like linear-space mode, getMultiMatch() switches to the
+     *    full matrices.
      **/
     class Align {
     public:
@@ -58,7 +82,8 @@ namespace Victor { namespace Align2{
         // CONSTRUCTORS:
 
         /// Default constructor.
-        Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+                bool linearSpace = false, unsigned int bandWidth = 0);
 
         /// Copy constructor.
         Align(const Align &orig);
@@ -84,12 +109,21 @@ namespace Victor { namespace Align2{
         /// Return ScoringScheme pointer.
         ScoringScheme* getScoringScheme();
 
+        /// Return true if F and B are not stored (linear-space mode).
+        bool isLinearSpace() const;
+
+        /// Return band width, after widening (0 if not banded).
+        unsigned int getBandWidth() const;
+
         /// Return next Traceback element.
         virtual Traceback next(const Traceback &tb) const;
 
         /// Return alignment score.
         virtual double getScore() const;
 
+        /// Return optimal score without traceback, with permuted template columns.
+        double getScoreOnly(const vector<unsigned int> *columns = NULL) const;
+
         /// Return alignment scores of an ensemble of suboptimal alignments.
         virtual vector<double> getMultiMatchScore(unsigned int num = 10);
 
@@ -141,6 +175,10 @@ namespace Victor { namespace Align2{
         /// Recalculate the alignment matrix.
         virtual void recalculateMatrix();
 
+        /// Align again in a band around anchor (getMatchSubset() of an alignment).
+        void setBand(unsigned int width,
+                const vector< vector<int> > &anchor = vector< vector<int> >());
+
 
         // HELPERS:
 
@@ -151,14 +189,35 @@ namespace Victor { namespace Align2{
         virtual void pCalculateMatrix(const vector<unsigned int> &v1,
                 const vector<unsigned int> &v2, bool update = true) = 0;
 
+        /// Calculate the optimal path in linear space.
+        void pCalculateLinear(const vector<unsigned int> *v1 = NULL,
+                const vector<unsigned int> *v2 = NULL);
+
+        /// Calculate the optimal path in a band of the matrix.
+        void pCalculateBanded(const vector<unsigned int> *v1 = NULL,
+                const vector<unsigned int> *v2 = NULL);
+
+        /// Leave linear-space or banded mode and calculate the full matrices.
+        void pUseFullMatrix();
+
+        /// Return score of cell (i, j) in row or column 0.
+        virtual double pGetBorderScore(int i, int j) const;
+
+        /// Return true if the alignment is local (scores bounded by zero).
+        virtual bool pIsLocal() const;
+
+        /// Return end of the optimal path from last row and column of F.
+        virtual Traceback pGetEndPoint(const vector<double> &lastRow,
+                const vector<double> &lastColumn) const;
+
 
         // ATTRIBUTES:
 
         AlignmentData *ad; ///< Pointer to AlignmentData.
         GapFunction *gf; ///< Pointer to GapFunction.
         ScoringScheme *ss; ///< Pointer to ScoringScheme.
-        vector< vector<double> > F; ///< Score matrix.
-        vector< vector<Traceback> > B; ///< Traceback matrix.
+        ScoreMatrix F; ///< Score matrix.
+        TracebackMatrix B; ///< Traceback matrix.
         Traceback B0; ///< Starting point of the traceback.
         unsigned int n; ///< Length of target sequence.
         unsigned int m; ///< Length of template sequence.
@@ -166,6 +225,13 @@ namespace Victor { namespace Align2{
         mutable vector<int> res2Pos; ///< Aligned positions for template sequence.
         double penaltyMul; ///< Multiplicative penalty for suboptimal alignment.
         double penaltyAdd; ///< Additive penalty for suboptimal alignment.
+        bool linearSpace; ///< F and B are not stored.
+        vector<Traceback> path; ///< Optimal path from B0 (linear-space mode).
+        double pathScore; ///< Score of the optimal path (linear-space mode).
+        vector<unsigned int> weight1; ///< Target weights (linear-space mode).
+        vector<unsigned int> weight2; ///< Template weights (linear-space mode).
+        unsigned int bandWidth; ///< Columns of the band on each side (0 = none).
+        vector< vector<int> > bandAnchor; ///< Alignment guiding the band.
 
 
     protected:
@@ -173,6 +239,35 @@ namespace Victor { namespace Align2{
 
     private:
 
+        /// Moves stored for each cell in linear-space mode.
+
+        enum Step {
+            DIAGONAL_STEP, ///< From (i - 1, j - 1).
+            LEFT_STEP, ///< From (i, j - 1).
+            UP_STEP, ///< From (i - 1, j).
+            NO_STEP ///< Start of the path.
+        };
+
+        // HELPERS:
+
+        /// Allocate F and B.
+        void pAllocateMatrix();
+
+        /// Set first and last column of the band in each row.
+        void pSetBandLimits(vector<int> &low, vector<int> &high) const;
+
+        /// Calculate row i of F from row i - 1.
+        void pCalculateRow(int i, const vector<double> &prevF,
+                const vector<unsigned char> &prevStep, vector<double> &curF,
+                vector<unsigned char> &curStep, const vector<unsigned int> *v1,
+                const vector<unsigned int> *v2) const;
+
+        /// Return move leading to border cell (i, j).
+        Step pGetBorderStep(int i, int j) const;
+
+        /// Return next Traceback element on the stored optimal path.
+        Traceback pNextOnPath(const Traceback &tb) const;
+
     };
 
     // -----------------------------------------------------------------------------
@@ -196,18 +291,31 @@ namespace Victor { namespace Align2{
         return ss;
     }
 
+    inline bool
+    Align::isLinearSpace() const {
+        return linearSpace;
+    }
+
+    inline unsigned int
+    Align::getBandWidth() const {
+        return bandWidth;
+    }
+
     inline Traceback
     Align::next(const Traceback& tb) const {
+        if (linearSpace || (bandWidth > 0))
+            return pNextOnPath(tb);
         if ((B.size() > 0) && (tb.i >= 0) && (tb.j >= 0) &&
-                (tb.i < static_cast<int> (B.size())) &&
-                (tb.j < static_cast<int> (B[tb.i].size())))
-            return B[tb.i][tb.j];
+                (tb.i <= static_cast<int> (n)) && (tb.j <= static_cast<int> (m)))
+            return B.getTraceback(tb.i, tb.j);
         return Traceback::getInvalidTraceback();
     }
 
     inline double
     Align::getScore() const {
-        return F[B0.i][B0.j];
+        if (linearSpace || (bandWidth > 0))
+            return pathScore;
+        return F.get(B0.i, B0.j);
     }
 
 
@@ -230,7 +338,7 @@ namespace Victor { namespace Align2{
      */
     inline void
     Align::pModifyMatrix(int i, int j) {
-        F[i][j] = penaltyMul * F[i][j] - penaltyAdd;
+        F.set(i, j, penaltyMul * F.get(i, j) - penaltyAdd);
     }
 
 }} // namespace
@@ -136,6 +136,28 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * Correlations of the Atchley factor vectors: two dot products per pair,
+     * of the centred vectors and of their squares.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    AtchleyCorrelation::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        ProfileFeatures f1(n, 5), f2(m, 5), square1(n, 5), square2(m, 5);
+        pCalculateFactors(pro1, f1, square1);
+        pCalculateFactors(pro2, f2, square2);
+
+        vector<float> den;
+        ProfileFeatures::dotProduct(f1, f2, matrix);
+        ProfileFeatures::dotProduct(square1, square2, den);
+        for (unsigned int c = 0; c < matrix.size(); c++)
+            matrix[c] = offset * ((matrix[c] / 5) / sqrt(den[c] / 5));
+    }
+
+
     // MODIFIERS:
     /**
      *  
@@ -190,4 +212,33 @@ namespace Victor { namespace Align2{
             }
     }
 
+    /**
+     * 
+     * @param pro profile
+     * @param f factor vectors minus their mean, one per position of pro
+     * @param square squares of f
+     */
+    void
+    AtchleyCorrelation::pCalculateFactors(Profile *pro, ProfileFeatures &f,
+            ProfileFeatures &square) {
+        const string residue_indices = "ARNDCQEGHILKMFPSTWYV";
+
+        for (unsigned int p = 0; p < f.size(); p++) {
+            double s[5];
+            double mean = 0.00;
+            for (unsigned int z = 0; z < 5; z++) {
+                s[z] = 0.00;
+                for (unsigned int k = 0; k < 20; k++)
+                    s[z] += (pro->getAminoFrequency(residue_indices[k], p) * factor[k][z]);
+                mean += s[z];
+            }
+            mean /= 5;
+
+            for (unsigned int z = 0; z < 5; z++) {
+                f.set(z, p, s[z] - mean);
+                square.set(z, p, (s[z] - mean) * (s[z] - mean));
+            }
+        }
+    }
+
 }} // namespace
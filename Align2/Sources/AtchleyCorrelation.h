@@ -19,6 +19,7 @@
 #define __AtchleyCorrelation_H__
 
 #include <Profile.h>
+#include <ProfileFeatures.h>
 #include <ScoringFunction.h>
 #include <iostream>
 
@@ -64,6 +65,10 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoringSeq(int i, int j);
 
+        /// Calculate scores of all target and template positions at once.
+        virtual void scoringSeqMatrix(unsigned int n, unsigned int m,
+                vector<float> &matrix);
+
         /// Return offset.
         virtual double getOffset();
 
@@ -85,6 +90,10 @@ namespace Victor { namespace Align2{
         /// Helper function used to load Atchley metric factor.
         virtual void pLoadFactor();
 
+        /// Calculate the centred Atchley factor vectors of all positions of pro.
+        void pCalculateFactors(Profile *pro, ProfileFeatures &f,
+                ProfileFeatures &square);
+
 
     protected:
 
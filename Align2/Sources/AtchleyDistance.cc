@@ -124,6 +124,24 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * Euclidean distances of the Atchley factor vectors.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    AtchleyDistance::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        ProfileFeatures f1(n, 5), f2(m, 5);
+        pCalculateFactors(pro1, f1);
+        pCalculateFactors(pro2, f2);
+        ProfileFeatures::squaredDistance(f1, f2, matrix);
+        for (unsigned int c = 0; c < matrix.size(); c++)
+            matrix[c] = offset - sqrt(matrix[c]);
+    }
+
+
     // MODIFIERS:
     /**
      *  
@@ -178,4 +196,22 @@ namespace Victor { namespace Align2{
             }
     }
 
+    /**
+     * 
+     * @param pro profile
+     * @param f factor vectors, one per position of pro
+     */
+    void
+    AtchleyDistance::pCalculateFactors(Profile *pro, ProfileFeatures &f) {
+        const string residue_indices = "ARNDCQEGHILKMFPSTWYV";
+
+        for (unsigned int p = 0; p < f.size(); p++)
+            for (unsigned int z = 0; z < 5; z++) {
+                double s = 0.00;
+                for (unsigned int k = 0; k < 20; k++)
+                    s += (pro->getAminoFrequency(residue_indices[k], p) * factor[k][z]);
+                f.set(z, p, s);
+            }
+    }
+
 }} // namespace
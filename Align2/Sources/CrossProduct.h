@@ -23,6 +23,7 @@
 #define __CrossProduct_H__
 
 #include <Profile.h>
+#include <ProfileFeatures.h>
 #include <ScoringFunction.h>
 #include <SubMatrix.h>
 
@@ -64,6 +65,10 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoringSeq(int i, int j);
 
+        /// Calculate scores of all target and template positions at once.
+        virtual void scoringSeqMatrix(unsigned int n, unsigned int m,
+                vector<float> &matrix);
+
 
         // MODIFIERS:
 
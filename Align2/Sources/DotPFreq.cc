@@ -104,6 +104,20 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * Dot products of the frequency vectors.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    DotPFreq::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        ProfileFeatures::dotProduct(ProfileFeatures(pro1, n),
+                ProfileFeatures(pro2, m), matrix);
+    }
+
+
     // MODIFIERS:
 
     /**
@@ -118,6 +118,26 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * Dot products of the log-odds vectors.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    DotPOdds::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        ProfileFeatures odds1(pro1, n), odds2(pro2, m);
+        for (unsigned int k = 0; k < 20; k++) {
+            for (unsigned int i = 0; i < n; i++)
+                odds1.set(k, i, log((odds1.get(k, i) + 0.00001) / p1[k]));
+            for (unsigned int j = 0; j < m; j++)
+                odds2.set(k, j, log((odds2.get(k, j) + 0.00001) / p2[k]));
+        }
+        ProfileFeatures::dotProduct(odds1, odds2, matrix);
+    }
+
+
     // MODIFIERS:
     /**
      *  
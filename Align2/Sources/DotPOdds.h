@@ -19,6 +19,7 @@
 #define __DotPOdds_H__
 
 #include <Profile.h>
+#include <ProfileFeatures.h>
 #include <ScoringFunction.h>
 
 namespace Victor { namespace Align2{
@@ -66,6 +67,10 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoringSeq(int i, int j);
 
+        /// Calculate scores of all target and template positions at once.
+        virtual void scoringSeqMatrix(unsigned int n, unsigned int m,
+                vector<float> &matrix);
+
 
         // MODIFIERS:
 
@@ -96,6 +96,22 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * Euclidean distances of the frequency vectors.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    EDistance::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        ProfileFeatures::squaredDistance(ProfileFeatures(pro1, n),
+                ProfileFeatures(pro2, m), matrix);
+        for (unsigned int c = 0; c < matrix.size(); c++)
+            matrix[c] = offset - sqrt(matrix[c]);
+    }
+
+
     // MODIFIERS:
     /**
      *  
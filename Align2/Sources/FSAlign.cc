@@ -20,6 +20,7 @@
 // -----------------x-----------------------------------------------------------
 
 #include <FSAlign.h>
+#include <Profiler.h>
 
 namespace Victor { namespace Align2{
 
@@ -30,11 +31,10 @@ namespace Victor { namespace Align2{
      * @param gf
      * @param ss
      */
-    FSAlign::FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
-    : Align(ad, gf, ss) {
-        cout << "inizio creazione FSAlign\n";
+    FSAlign::FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+            bool linearSpace, unsigned int bandWidth)
+    : Align(ad, gf, ss, linearSpace, bandWidth) {
         pCalculateMatrix(true);
-        cout << "fine creazione FSAlign\n";
     }
     /**
      *  
@@ -45,8 +45,9 @@ namespace Victor { namespace Align2{
      * @param v2
      */
     FSAlign::FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
-            const vector<unsigned int> &v1, const vector<unsigned int> &v2)
-    : Align(ad, gf, ss) {
+            const vector<unsigned int> &v1, const vector<unsigned int> &v2,
+            bool linearSpace, unsigned int bandWidth)
+    : Align(ad, gf, ss, linearSpace, bandWidth) {
         pCalculateMatrix(v1, v2, true);
     }
     /**
@@ -81,6 +82,7 @@ namespace Victor { namespace Align2{
      */
     void
     FSAlign::getMultiMatch() {
+        pUseFullMatrix();
         Traceback tb = B0;
         int i = tb.i;
         int j = tb.j;
@@ -124,19 +126,30 @@ namespace Victor { namespace Align2{
      */
     void
     FSAlign::pCalculateMatrix(bool update) {
+        PROFILE_REGION("FSAlign::pCalculateMatrix");
+        if (bandWidth > 0) {
+            pCalculateBanded();
+            return;
+        }
+        if (linearSpace) {
+            pCalculateLinear();
+            return;
+        }
+        PROFILE_COUNT("cells", n * m);
+
         if (update)
-            F[0][0] = 0;
+            F.set(0, 0, 0);
 
         for (int i = 1; i <= static_cast<int> (n); i++) {
             if (update)
-                F[i][0] = 0;
-            B[i][0] = Traceback(i - 1, 0);
+                F.set(i, 0, 0);
+            B.setMove(i, 0, TracebackMatrix::UP_MOVE);
         }
 
         for (int j = 1; j <= static_cast<int> (m); j++) {
             if (update)
-                F[0][j] = 0;
-            B[0][j] = Traceback(0, j - 1);
+                F.set(0, j, 0);
+            B.setMove(0, j, TracebackMatrix::LEFT_MOVE);
         }
         //cout<<"pCalculateMatrixA\n";
         for (int i = 1; i <= static_cast<int> (n); i++)
@@ -146,37 +159,35 @@ namespace Victor { namespace Align2{
                 double extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i - 1, j) == TracebackMatrix::UP_MOVE)
+                        extI = F.get(i - 1, j) - gf->getExtensionPenalty(j);
                     else
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
                 } else
-                    if (B[i - 1][j].j == (j - 1))
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i, j - 1) == TracebackMatrix::LEFT_MOVE)
+                        extJ = F.get(i, j - 1) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
+                double z = F.get(i - 1, j - 1) + s;
                 double val = max(max(z, extI), extJ);
 
                 if (update)
-                    F[i][j] = val;
+                    F.set(i, j, val);
 
                 if (EQUALS(val, z))
-                    B[i][j] = Traceback(i - 1, j - 1);
+                    B.setMove(i, j, TracebackMatrix::DIAGONAL_MOVE);
                 else
                     if (EQUALS(val, extJ))
-                    B[i][j] = Traceback(i, j - 1);
+                    B.setMove(i, j, TracebackMatrix::LEFT_MOVE);
                 else
                     if (EQUALS(val, extI))
-                    B[i][j] = Traceback(i - 1, j);
+                    B.setMove(i, j, TracebackMatrix::UP_MOVE);
                 else
                     ERROR("Error in FSAlign: FS 1", exception);
             }
@@ -186,15 +197,15 @@ namespace Victor { namespace Align2{
         int maxJ = 0;
 
         for (int j = 0; j <= static_cast<int> (m); j++)
-            if (F[static_cast<int> (n)][j] > maxi) {
-                maxi = F[static_cast<int> (n)][j];
+            if (F.get(static_cast<int> (n), j) > maxi) {
+                maxi = F.get(static_cast<int> (n), j);
                 maxI = static_cast<int> (n);
                 maxJ = j;
             }
         //cout<<"pCalculateMatrixC\n";
         for (int i = 0; i < static_cast<int> (n); i++)
-            if (F[i][static_cast<int> (m)] > maxi) {
-                maxi = F[i][static_cast<int> (m)];
+            if (F.get(i, static_cast<int> (m)) > maxi) {
+                maxi = F.get(i, static_cast<int> (m));
                 maxI = i;
                 maxJ = static_cast<int> (m);
             }
@@ -213,24 +224,35 @@ namespace Victor { namespace Align2{
     void
     FSAlign::pCalculateMatrix(const vector<unsigned int> &v1,
             const vector<unsigned int> &v2, bool update) {
+        PROFILE_REGION("FSAlign::pCalculateMatrix");
+        if (bandWidth > 0) {
+            pCalculateBanded(&v1, &v2);
+            return;
+        }
+        if (linearSpace) {
+            pCalculateLinear(&v1, &v2);
+            return;
+        }
+        PROFILE_COUNT("cells", n * m);
+
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
         unsigned int minL = 0;
         // end SSEA variant code
 
         if (update)
-            F[0][0] = 0;
+            F.set(0, 0, 0);
 
         for (int i = 1; i <= static_cast<int> (n); i++) {
             if (update)
-                F[i][0] = 0;
-            B[i][0] = Traceback(i - 1, 0);
+                F.set(i, 0, 0);
+            B.setMove(i, 0, TracebackMatrix::UP_MOVE);
         }
 
         for (int j = 1; j <= static_cast<int> (m); j++) {
             if (update)
-                F[0][j] = 0;
-            B[0][j] = Traceback(0, j - 1);
+                F.set(0, j, 0);
+            B.setMove(0, j, TracebackMatrix::LEFT_MOVE);
         }
 
         for (int i = 1; i <= static_cast<int> (n); i++)
@@ -247,37 +269,35 @@ namespace Victor { namespace Align2{
                 double extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i - 1, j) == TracebackMatrix::UP_MOVE)
+                        extI = F.get(i - 1, j) - gf->getExtensionPenalty(j);
                     else
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
                 } else
-                    if (B[i - 1][j].j == (j - 1))
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i, j - 1) == TracebackMatrix::LEFT_MOVE)
+                        extJ = F.get(i, j - 1) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
+                double z = F.get(i - 1, j - 1) + s;
                 double val = max(max(z, extI), extJ);
 
                 if (update)
-                    F[i][j] = val;
+                    F.set(i, j, val);
 
                 if (EQUALS(val, z))
-                    B[i][j] = Traceback(i - 1, j - 1);
+                    B.setMove(i, j, TracebackMatrix::DIAGONAL_MOVE);
                 else
                     if (EQUALS(val, extJ))
-                    B[i][j] = Traceback(i, j - 1);
+                    B.setMove(i, j, TracebackMatrix::LEFT_MOVE);
                 else
                     if (EQUALS(val, extI))
-                    B[i][j] = Traceback(i - 1, j);
+                    B.setMove(i, j, TracebackMatrix::UP_MOVE);
                 else
                     ERROR("Error in FSAlign: FS 1", exception);
             }
@@ -287,15 +307,15 @@ namespace Victor { namespace Align2{
         int maxJ = 0;
 
         for (int j = 0; j <= static_cast<int> (m); j++)
-            if (F[static_cast<int> (n)][j] > maxi) {
-                maxi = F[static_cast<int> (n)][j];
+            if (F.get(static_cast<int> (n), j) > maxi) {
+                maxi = F.get(static_cast<int> (n), j);
                 maxI = static_cast<int> (n);
                 maxJ = j;
             }
 
         for (int i = 0; i < static_cast<int> (n); i++)
-            if (F[i][static_cast<int> (m)] > maxi) {
-                maxi = F[i][static_cast<int> (m)];
+            if (F.get(i, static_cast<int> (m)) > maxi) {
+                maxi = F.get(i, static_cast<int> (m));
                 maxI = i;
                 maxJ = static_cast<int> (m);
             }
@@ -303,4 +323,45 @@ namespace Victor { namespace Align2{
         B0 = Traceback(maxI, maxJ);
     }
 
+    /**
+     * 
+     * @param i
+     * @param j
+     * @return 0, terminal gaps are free
+     */
+    double
+    FSAlign::pGetBorderScore(int i, int j) const {
+        return 0.0;
+    }
+
+    /**
+     * Best cell of the last row or column, as in pCalculateMatrix().
+     * @param lastRow F[n]
+     * @param lastColumn F.get(i, m) for all i
+     * @return end of the optimal path
+     */
+    Traceback
+    FSAlign::pGetEndPoint(const vector<double> &lastRow,
+            const vector<double> &lastColumn) const {
+        double maxi = 0.00;
+        int maxI = 0;
+        int maxJ = 0;
+
+        for (int j = 0; j <= static_cast<int> (m); j++)
+            if (lastRow[j] > maxi) {
+                maxi = lastRow[j];
+                maxI = static_cast<int> (n);
+                maxJ = j;
+            }
+
+        for (int i = 0; i < static_cast<int> (n); i++)
+            if (lastColumn[i] > maxi) {
+                maxi = lastColumn[i];
+                maxI = i;
+                maxJ = static_cast<int> (m);
+            }
+
+        return Traceback(maxI, maxJ);
+    }
+
 }} // namespace
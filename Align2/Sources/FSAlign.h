@@ -33,11 +33,13 @@ namespace Victor { namespace Align2{
         // CONSTRUCTORS:
 
         /// Default constructor.
-        FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+                bool linearSpace = false, unsigned int bandWidth = 0);
 
         /// Constructor with weighted alignment positions.
         FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
-                const vector<unsigned int> &v1, const vector<unsigned int> &v2);
+                const vector<unsigned int> &v1, const vector<unsigned int> &v2,
+                bool linearSpace = false, unsigned int bandWidth = 0);
 
         /// Copy constructor.
         FSAlign(const FSAlign &orig);
@@ -76,6 +78,13 @@ namespace Victor { namespace Align2{
         virtual void pCalculateMatrix(const vector<unsigned int> &v1,
                 const vector<unsigned int> &v2, bool update = true);
 
+        /// Return score of cell (i, j) in row or column 0.
+        virtual double pGetBorderScore(int i, int j) const;
+
+        /// Return end of the optimal path from last row and column of F.
+        virtual Traceback pGetEndPoint(const vector<double> &lastRow,
+                const vector<double> &lastColumn) const;
+
 
     protected:
 
@@ -116,6 +116,53 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * No SIMD kernel (the logarithms depend on both positions): the
+     * frequencies are read once and the scores calculated as in scoringSeq().
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    JensenShannon::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        const string residue_indices = "ARNDCQEGHILKMFPSTWYV";
+
+        vector<double> freq1(20), freq2(20 * m);
+        for (unsigned int j = 0; j < m; j++)
+            for (unsigned int k = 0; k < 20; k++)
+                freq2[j * 20 + k] =
+                    pro2->getAminoFrequency(residue_indices[k], j) + 0.00001;
+
+        matrix.resize(n * m);
+        for (unsigned int i = 0; i < n; i++) {
+            for (unsigned int k = 0; k < 20; k++)
+                freq1[k] = pro1->getAminoFrequency(residue_indices[k], i) + 0.00001;
+
+            for (unsigned int j = 0; j < m; j++) {
+                double s1 = 0.00;
+                double s2 = 0.00;
+                double s3 = 0.00;
+                double s4 = 0.00;
+
+                for (unsigned int k = 0; k < 20; k++) {
+                    double tmp1 = (freq1[k] + freq2[j * 20 + k]) / 2;
+                    double tmp2 = (tmp1 + ((p1[k] + p2[k]) / 2)) / 2;
+
+                    s1 += (freq1[k] * log2(freq1[k] / tmp1));
+                    s2 += (freq2[j * 20 + k] * log2(freq2[j * 20 + k] / tmp1));
+                    s3 += (tmp1 * log2(tmp1 / tmp2));
+                    s4 += (((p1[k] + p2[k]) / 2) * log2(((p1[k] + p2[k]) / 2) / tmp2));
+                }
+
+                double D = (s1 + s2) / 2;
+                double S = (s3 + s4) / 2;
+                matrix[i * m + j] = ((1 - D) * (1 + S)) / 2;
+            }
+        }
+    }
+
+
     // MODIFIERS:
     /**
      * 
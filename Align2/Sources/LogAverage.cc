@@ -97,6 +97,36 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * Logarithms of the dot products of the target frequencies with the
+     * template frequencies multiplied by the exponential substitution matrix.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    LogAverage::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        ProfileFeatures f1(n, 20), f2(m, 20);
+        for (AminoAcidCode amino1 = ALA; amino1 <= TYR; amino1++) {
+            for (unsigned int i = 0; i < n; i++)
+                f1.set(amino1, i, pro1->getAminoFrequencyFromCode(amino1, i));
+
+            for (unsigned int j = 0; j < m; j++) {
+                double tmp = 0.00;
+                for (AminoAcidCode amino2 = ALA; amino2 <= TYR; amino2++)
+                    tmp += exp(sub->score[aminoAcidOneLetterTranslator(amino1)]
+                        [aminoAcidOneLetterTranslator(amino2)]) *
+                    pro2->getAminoFrequencyFromCode(amino2, j);
+                f2.set(amino1, j, tmp);
+            }
+        }
+        ProfileFeatures::dotProduct(f1, f2, matrix);
+        for (unsigned int c = 0; c < matrix.size(); c++)
+            matrix[c] = log(matrix[c]);
+    }
+
+
     // MODIFIERS:
     /**
      * 
@@ -21,6 +21,7 @@
 // -----------------x-----------------------------------------------------------
 
 #include <NWAlign.h>
+#include <Profiler.h>
 
 namespace Victor { namespace Align2{
 
@@ -31,8 +32,9 @@ namespace Victor { namespace Align2{
      * @param gf
      * @param ss
      */
-    NWAlign::NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
-    : Align(ad, gf, ss) {
+    NWAlign::NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+            bool linearSpace, unsigned int bandWidth)
+    : Align(ad, gf, ss, linearSpace, bandWidth) {
         pCalculateMatrix(true);
     }
     /**
@@ -44,8 +46,9 @@ namespace Victor { namespace Align2{
      * @param v2
      */
     NWAlign::NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
-            const vector<unsigned int> &v1, const vector<unsigned int> &v2)
-    : Align(ad, gf, ss) {
+            const vector<unsigned int> &v1, const vector<unsigned int> &v2,
+            bool linearSpace, unsigned int bandWidth)
+    : Align(ad, gf, ss, linearSpace, bandWidth) {
         pCalculateMatrix(v1, v2, true);
     }
 
@@ -77,6 +80,7 @@ namespace Victor { namespace Align2{
      */
     void
     NWAlign::getMultiMatch() {
+        pUseFullMatrix();
         Traceback tb = B0;
         int i = tb.i;
         int j = tb.j;
@@ -120,21 +124,32 @@ namespace Victor { namespace Align2{
      */
     void
     NWAlign::pCalculateMatrix(bool update) {
+        PROFILE_REGION("NWAlign::pCalculateMatrix");
+        if (bandWidth > 0) {
+            pCalculateBanded();
+            return;
+        }
+        if (linearSpace) {
+            pCalculateLinear();
+            return;
+        }
+        PROFILE_COUNT("cells", n * m);
+
         if (update)
-            F[0][0] = 0;
+            F.set(0, 0, 0);
 
         for (int i = 1; i <= static_cast<int> (n); i++) {
             if (update)
-                F[i][0] = -gf->getOpenPenalty(0) -
-                gf->getExtensionPenalty(0) * (i - 1);
-            B[i][0] = Traceback(i - 1, 0);
+                F.set(i, 0, -gf->getOpenPenalty(0) -
+                gf->getExtensionPenalty(0) * (i - 1));
+            B.setMove(i, 0, TracebackMatrix::UP_MOVE);
         }
 
         for (int j = 1; j <= static_cast<int> (m); j++) {
             if (update)
-                F[0][j] = -gf->getOpenPenalty(j) -
-                gf->getExtensionPenalty(j) * (j - 1);
-            B[0][j] = Traceback(0, j - 1);
+                F.set(0, j, -gf->getOpenPenalty(j) -
+                gf->getExtensionPenalty(j) * (j - 1));
+            B.setMove(0, j, TracebackMatrix::LEFT_MOVE);
         }
 
         for (int i = 1; i <= static_cast<int> (n); i++)
@@ -143,37 +158,35 @@ namespace Victor { namespace Align2{
                 double extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i - 1, j) == TracebackMatrix::UP_MOVE)
+                        extI = F.get(i - 1, j) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i, j - 1) == TracebackMatrix::LEFT_MOVE)
+                        extJ = F.get(i, j - 1) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
+                double z = F.get(i - 1, j - 1) + s;
                 double val = max(max(z, extI), extJ);
 
                 if (update)
-                    F[i][j] = val;
+                    F.set(i, j, val);
 
                 if (EQUALS(val, z))
-                    B[i][j] = Traceback(i - 1, j - 1);
+                    B.setMove(i, j, TracebackMatrix::DIAGONAL_MOVE);
                 else
                     if (EQUALS(val, extJ))
-                    B[i][j] = Traceback(i, j - 1);
+                    B.setMove(i, j, TracebackMatrix::LEFT_MOVE);
                 else
                     if (EQUALS(val, extI))
-                    B[i][j] = Traceback(i - 1, j);
+                    B.setMove(i, j, TracebackMatrix::UP_MOVE);
                 else
                     ERROR("Error in NWAlign: NW 1", exception);
             }
@@ -192,26 +205,37 @@ namespace Victor { namespace Align2{
     void
     NWAlign::pCalculateMatrix(const vector<unsigned int> &v1,
             const vector<unsigned int> &v2, bool update) {
+        PROFILE_REGION("NWAlign::pCalculateMatrix");
+        if (bandWidth > 0) {
+            pCalculateBanded(&v1, &v2);
+            return;
+        }
+        if (linearSpace) {
+            pCalculateLinear(&v1, &v2);
+            return;
+        }
+        PROFILE_COUNT("cells", n * m);
+
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
         unsigned int minL = 0;
         // end SSEA variant code
 
         if (update)
-            F[0][0] = 0;
+            F.set(0, 0, 0);
 
         for (int i = 1; i <= static_cast<int> (n); i++) {
             if (update)
-                F[i][0] = -gf->getOpenPenalty(0) -
-                gf->getExtensionPenalty(0) * (i - 1);
-            B[i][0] = Traceback(i - 1, 0);
+                F.set(i, 0, -gf->getOpenPenalty(0) -
+                gf->getExtensionPenalty(0) * (i - 1));
+            B.setMove(i, 0, TracebackMatrix::UP_MOVE);
         }
 
         for (int j = 1; j <= static_cast<int> (m); j++) {
             if (update)
-                F[0][j] = -gf->getOpenPenalty(j) -
-                gf->getExtensionPenalty(j) * (j - 1);
-            B[0][j] = Traceback(0, j - 1);
+                F.set(0, j, -gf->getOpenPenalty(j) -
+                gf->getExtensionPenalty(j) * (j - 1));
+            B.setMove(0, j, TracebackMatrix::LEFT_MOVE);
         }
 
         for (int i = 1; i <= static_cast<int> (n); i++)
@@ -228,37 +252,35 @@ namespace Victor { namespace Align2{
                 double extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i - 1, j) == TracebackMatrix::UP_MOVE)
+                        extI = F.get(i - 1, j) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i, j - 1) == TracebackMatrix::LEFT_MOVE)
+                        extJ = F.get(i, j - 1) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
+                double z = F.get(i - 1, j - 1) + s;
                 double val = max(max(z, extI), extJ);
 
                 if (update)
-                    F[i][j] = val;
+                    F.set(i, j, val);
 
                 if (EQUALS(val, z))
-                    B[i][j] = Traceback(i - 1, j - 1);
+                    B.setMove(i, j, TracebackMatrix::DIAGONAL_MOVE);
                 else
                     if (EQUALS(val, extJ))
-                    B[i][j] = Traceback(i, j - 1);
+                    B.setMove(i, j, TracebackMatrix::LEFT_MOVE);
                 else
                     if (EQUALS(val, extI))
-                    B[i][j] = Traceback(i - 1, j);
+                    B.setMove(i, j, TracebackMatrix::UP_MOVE);
                 else
                     ERROR("Error in NWAlign: NW 1", exception);
             }
@@ -32,11 +32,13 @@ namespace Victor { namespace Align2{
         // CONSTRUCTORS:
 
         /// Default constructor.
-        NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+                bool linearSpace = false, unsigned int bandWidth = 0);
 
         /// Constructor with weighted alignment positions.
         NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
-                const vector<unsigned int> &v1, const vector<unsigned int> &v2);
+                const vector<unsigned int> &v1, const vector<unsigned int> &v2,
+                bool linearSpace = false, unsigned int bandWidth = 0);
 
         /// Copy constructor.
         NWAlign(const NWAlign &orig);
@@ -113,6 +113,39 @@ namespace Victor { namespace Align2{
     }
 
 
+    /**
+     * Correlations of the log-odds vectors: two dot products per pair, of
+     * the centred log-odds and of their squares.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row
+     */
+    void
+    Pearson::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        ProfileFeatures odds1(pro1, n), odds2(pro2, m);
+        ProfileFeatures square1(n, 20), square2(m, 20);
+        for (unsigned int k = 0; k < 20; k++) {
+            for (unsigned int i = 0; i < n; i++) {
+                double d = log((odds1.get(k, i) + 0.00001) / p1[k]) - p1[k];
+                odds1.set(k, i, d);
+                square1.set(k, i, d * d);
+            }
+            for (unsigned int j = 0; j < m; j++) {
+                double d = log((odds2.get(k, j) + 0.00001) / p2[k]) - p2[k];
+                odds2.set(k, j, d);
+                square2.set(k, j, d * d);
+            }
+        }
+
+        vector<float> s2;
+        ProfileFeatures::dotProduct(odds1, odds2, matrix);
+        ProfileFeatures::dotProduct(square1, square2, s2);
+        for (unsigned int c = 0; c < matrix.size(); c++)
+            matrix[c] = matrix[c] / sqrt(s2[c]);
+    }
+
+
     // MODIFIERS:
     /**
      * 
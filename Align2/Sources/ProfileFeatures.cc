@@ -0,0 +1,385 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// --*- C++ -*------x-----------------------------------------------------------
+//
+// Description:     Per-position feature vectors of a profile, packed for SIMD
+//                  calculation of profile-to-profile score matrices.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <ProfileFeatures.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PROFILE_FEATURES_X86
+#include <immintrin.h>
+#endif
+
+namespace Victor { namespace Align2{
+
+    ProfileFeatures::Kernel ProfileFeatures::kernel =
+            ProfileFeatures::pGetBestKernel();
+
+#ifdef PROFILE_FEATURES_X86
+
+    /**
+     * Store the 8 results of template positions j...j + 7, without writing
+     * past position m - 1.
+     */
+    __attribute__((target("avx2"))) static inline void
+    sStoreAvx2(float *out, unsigned int j, unsigned int m, __m256 acc) {
+        if (j + 8 <= m)
+            _mm256_storeu_ps(out + j, acc);
+        else
+            if (j < m) {
+            float tail[8];
+            _mm256_storeu_ps(tail, acc);
+            memcpy(out + j, tail, (m - j) * sizeof (float));
+        }
+    }
+
+    /**
+     * One row of the matrix, 8 template positions at a time. Four blocks of
+     * positions are calculated together to hide the latency of the sums.
+     * @param a features of the target position
+     * @param width number of features
+     * @param b feature rows of the template
+     * @param stride length of a template feature row
+     * @param m number of template positions
+     * @param distance squared distance instead of dot product
+     * @param out matrix row
+     */
+    __attribute__((target("avx2"))) static void
+    sRowAvx2(const float *a, unsigned int width, const float *b,
+            unsigned int stride, unsigned int m, bool distance, float *out) {
+        unsigned int j = 0;
+        for (; j + 32 <= stride; j += 32) {
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m256 acc2 = _mm256_setzero_ps();
+            __m256 acc3 = _mm256_setzero_ps();
+            for (unsigned int k = 0; k < width; k++) {
+                const float *row = b + k * stride + j;
+                __m256 x = _mm256_set1_ps(a[k]);
+                __m256 y0 = _mm256_load_ps(row);
+                __m256 y1 = _mm256_load_ps(row + 8);
+                __m256 y2 = _mm256_load_ps(row + 16);
+                __m256 y3 = _mm256_load_ps(row + 24);
+                if (distance) {
+                    y0 = _mm256_sub_ps(x, y0);
+                    y1 = _mm256_sub_ps(x, y1);
+                    y2 = _mm256_sub_ps(x, y2);
+                    y3 = _mm256_sub_ps(x, y3);
+                    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(y0, y0));
+                    acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(y1, y1));
+                    acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(y2, y2));
+                    acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(y3, y3));
+                } else {
+                    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(x, y0));
+                    acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(x, y1));
+                    acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(x, y2));
+                    acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(x, y3));
+                }
+            }
+            sStoreAvx2(out, j, m, acc0);
+            sStoreAvx2(out, j + 8, m, acc1);
+            sStoreAvx2(out, j + 16, m, acc2);
+            sStoreAvx2(out, j + 24, m, acc3);
+        }
+
+        for (; j < stride; j += 8) {
+            __m256 acc = _mm256_setzero_ps();
+            for (unsigned int k = 0; k < width; k++) {
+                __m256 x = _mm256_set1_ps(a[k]);
+                __m256 y = _mm256_load_ps(b + k * stride + j);
+                if (distance) {
+                    y = _mm256_sub_ps(x, y);
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(y, y));
+                } else
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(x, y));
+            }
+            sStoreAvx2(out, j, m, acc);
+        }
+    }
+
+    /**
+     * Store the 4 results of template positions j...j + 3, without writing
+     * past position m - 1.
+     */
+    __attribute__((target("sse2"))) static inline void
+    sStoreSse(float *out, unsigned int j, unsigned int m, __m128 acc) {
+        if (j + 4 <= m)
+            _mm_storeu_ps(out + j, acc);
+        else
+            if (j < m) {
+            float tail[4];
+            _mm_storeu_ps(tail, acc);
+            memcpy(out + j, tail, (m - j) * sizeof (float));
+        }
+    }
+
+    /**
+     * One row of the matrix, 4 template positions at a time. Two blocks of
+     * positions are calculated together to hide the latency of the sums.
+     * @param a features of the target position
+     * @param width number of features
+     * @param b feature rows of the template
+     * @param stride length of a template feature row
+     * @param m number of template positions
+     * @param distance squared distance instead of dot product
+     * @param out matrix row
+     */
+    __attribute__((target("sse2"))) static void
+    sRowSse(const float *a, unsigned int width, const float *b,
+            unsigned int stride, unsigned int m, bool distance, float *out) {
+        for (unsigned int j = 0; j < stride; j += 8) {
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            for (unsigned int k = 0; k < width; k++) {
+                const float *row = b + k * stride + j;
+                __m128 x = _mm_set1_ps(a[k]);
+                __m128 y0 = _mm_load_ps(row);
+                __m128 y1 = _mm_load_ps(row + 4);
+                if (distance) {
+                    y0 = _mm_sub_ps(x, y0);
+                    y1 = _mm_sub_ps(x, y1);
+                    acc0 = _mm_add_ps(acc0, _mm_mul_ps(y0, y0));
+                    acc1 = _mm_add_ps(acc1, _mm_mul_ps(y1, y1));
+                } else {
+                    acc0 = _mm_add_ps(acc0, _mm_mul_ps(x, y0));
+                    acc1 = _mm_add_ps(acc1, _mm_mul_ps(x, y1));
+                }
+            }
+            sStoreSse(out, j, m, acc0);
+            sStoreSse(out, j + 4, m, acc1);
+        }
+    }
+
+#endif
+
+    /**
+     * One row of the matrix, plain loops.
+     * @param a features of the target position
+     * @param width number of features
+     * @param b feature rows of the template
+     * @param stride length of a template feature row
+     * @param m number of template positions
+     * @param distance squared distance instead of dot product
+     * @param out matrix row
+     */
+    static void
+    sRowScalar(const float *a, unsigned int width, const float *b,
+            unsigned int stride, unsigned int m, bool distance, float *out) {
+        for (unsigned int j = 0; j < m; j++)
+            out[j] = 0.0f;
+        for (unsigned int k = 0; k < width; k++) {
+            const float *row = b + k * stride;
+            if (distance)
+                for (unsigned int j = 0; j < m; j++) {
+                    float d = a[k] - row[j];
+                    out[j] += d * d;
+                }
+            else
+                for (unsigned int j = 0; j < m; j++)
+                    out[j] += a[k] * row[j];
+        }
+    }
+
+
+    // CONSTRUCTORS:
+
+    /**
+     *
+     * @param size number of positions
+     * @param width number of features per position
+     */
+    ProfileFeatures::ProfileFeatures(unsigned int size, unsigned int width)
+    : positions(0), width(0), stride(0), data(NULL) {
+        pAllocate(size, width);
+    }
+
+    /**
+     *
+     * @param pro profile
+     * @param size number of positions
+     * @param order one letter codes of the features
+     */
+    ProfileFeatures::ProfileFeatures(Profile *pro, unsigned int size,
+            const string &order) : positions(0), width(0), stride(0),
+    data(NULL) {
+        pAllocate(size, order.size());
+        for (unsigned int k = 0; k < width; k++)
+            for (unsigned int p = 0; p < positions; p++)
+                set(k, p, pro->getAminoFrequency(order[k], p));
+    }
+
+    ProfileFeatures::ProfileFeatures(const ProfileFeatures &orig)
+    : positions(0), width(0), stride(0), data(NULL) {
+        copy(orig);
+    }
+
+    ProfileFeatures::~ProfileFeatures() {
+        free(data);
+    }
+
+
+    // OPERATORS:
+
+    ProfileFeatures&
+            ProfileFeatures::operator =(const ProfileFeatures &orig) {
+        if (&orig != this)
+            copy(orig);
+        return *this;
+    }
+
+
+    // PREDICATES:
+
+    string
+    ProfileFeatures::getKernelName(Kernel kernel) {
+        switch (kernel) {
+            case AVX2_KERNEL:
+                return "AVX2";
+            case SSE_KERNEL:
+                return "SSE";
+            default:
+                return "scalar";
+        }
+    }
+
+    /**
+     *
+     * @param target features of the target positions (rows)
+     * @param templ features of the template positions (columns)
+     * @param matrix scores, row by row
+     */
+    void
+    ProfileFeatures::dotProduct(const ProfileFeatures &target,
+            const ProfileFeatures &templ, vector<float> &matrix) {
+        pCalculate(target, templ, false, matrix);
+    }
+
+    /**
+     *
+     * @param target features of the target positions (rows)
+     * @param templ features of the template positions (columns)
+     * @param matrix squared distances, row by row
+     */
+    void
+    ProfileFeatures::squaredDistance(const ProfileFeatures &target,
+            const ProfileFeatures &templ, vector<float> &matrix) {
+        pCalculate(target, templ, true, matrix);
+    }
+
+
+    // MODIFIERS:
+
+    void
+    ProfileFeatures::copy(const ProfileFeatures &orig) {
+        pAllocate(orig.positions, orig.width);
+        if (data != NULL)
+            memcpy(data, orig.data, width * stride * sizeof (float));
+    }
+
+    /**
+     * Kernels not supported by the CPU fall back to the best one that is.
+     * @param kernel
+     */
+    void
+    ProfileFeatures::setKernel(Kernel kernel) {
+        Kernel best = pGetBestKernel();
+        ProfileFeatures::kernel = (kernel < best) ? kernel : best;
+    }
+
+
+    // HELPERS:
+
+    void
+    ProfileFeatures::pAllocate(unsigned int size, unsigned int width) {
+        free(data);
+        data = NULL;
+        positions = size;
+        this->width = width;
+        stride = ((size + 7) / 8) * 8;
+        if (width * stride == 0)
+            return;
+
+        void *p;
+        if (posix_memalign(&p, 32, width * stride * sizeof (float)) != 0)
+            ERROR("Could not allocate profile features.", exception);
+        data = static_cast<float *> (p);
+        memset(data, 0, width * stride * sizeof (float));
+    }
+
+    ProfileFeatures::Kernel
+    ProfileFeatures::pGetBestKernel() {
+#ifdef PROFILE_FEATURES_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return AVX2_KERNEL;
+        if (__builtin_cpu_supports("sse2"))
+            return SSE_KERNEL;
+#endif
+        return SCALAR_KERNEL;
+    }
+
+    /**
+     *
+     * @param target features of the target positions (rows)
+     * @param templ features of the template positions (columns)
+     * @param distance squared distance instead of dot product
+     * @param matrix result, row by row
+     */
+    void
+    ProfileFeatures::pCalculate(const ProfileFeatures &target,
+            const ProfileFeatures &templ, bool distance,
+            vector<float> &matrix) {
+        if (target.width != templ.width)
+            ERROR("Profile features of different width.", exception);
+
+        unsigned int n = target.positions;
+        unsigned int m = templ.positions;
+        matrix.resize(n * m);
+        if ((n == 0) || (m == 0))
+            return;
+
+        vector<float> a(target.width);
+        for (unsigned int i = 0; i < n; i++) {
+            for (unsigned int k = 0; k < target.width; k++)
+                a[k] = target.get(k, i);
+            const float *pa = (target.width > 0) ? &a[0] : NULL;
+            float *out = &matrix[i * m];
+
+            switch (kernel) {
+#ifdef PROFILE_FEATURES_X86
+                case AVX2_KERNEL:
+                    sRowAvx2(pa, templ.width, templ.data, templ.stride, m,
+                            distance, out);
+                    break;
+                case SSE_KERNEL:
+                    sRowSse(pa, templ.width, templ.data, templ.stride, m,
+                            distance, out);
+                    break;
+#endif
+                default:
+                    sRowScalar(pa, templ.width, templ.data, templ.stride, m,
+                            distance, out);
+            }
+        }
+    }
+
+}} // namespace
@@ -0,0 +1,174 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ProfileFeatures_H__
+#define __ProfileFeatures_H__
+
+#include <Profile.h>
+#include <string>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Per-position feature vectors of a profile, packed for SIMD.
+     *
+     *   Features are stored feature by feature: the values of feature k for
+     *   all positions form one float row, 32-byte aligned and padded with
+     *   zeros to a multiple of 8 positions. dotProduct() and
+     *   squaredDistance() calculate the full matrix of target x template
+     *   positions with AVX2 or SSE kernels, or plain loops when the CPU
+     *   (or the platform) does not support them. The kernel is selected at
+     *   run time.
+     **/
+    class ProfileFeatures {
+    public:
+
+        /// Kernels used for the matrix calculations.
+
+        enum Kernel {
+            SCALAR_KERNEL, ///< Plain loops.
+            SSE_KERNEL, ///< 4 positions at a time.
+            AVX2_KERNEL ///< 8 positions at a time.
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Default constructor, all features 0.
+        ProfileFeatures(unsigned int size = 0, unsigned int width = 0);
+
+        /// Constructor with the 20 aminoacid frequencies of a profile.
+        ProfileFeatures(Profile *pro, unsigned int size,
+                const string &order = "ARNDCQEGHILKMFPSTWYV");
+
+        /// Copy constructor.
+        ProfileFeatures(const ProfileFeatures &orig);
+
+        /// Destructor.
+        virtual ~ProfileFeatures();
+
+
+        // OPERATORS:
+
+        /// Assignment operator.
+        ProfileFeatures& operator =(const ProfileFeatures &orig);
+
+
+        // PREDICATES:
+
+        /// Return number of positions.
+        unsigned int size() const;
+
+        /// Return number of features per position.
+        unsigned int getWidth() const;
+
+        /// Return feature k of position p.
+        float get(unsigned int k, unsigned int p) const;
+
+        /// Return kernel used by dotProduct() and squaredDistance().
+        static Kernel getKernel();
+
+        /// Return name of a kernel.
+        static string getKernelName(Kernel kernel);
+
+        /// Calculate the dot products of all target and template positions.
+        static void dotProduct(const ProfileFeatures &target,
+                const ProfileFeatures &templ, vector<float> &matrix);
+
+        /// Calculate the squared distances of all target and template positions.
+        static void squaredDistance(const ProfileFeatures &target,
+                const ProfileFeatures &templ, vector<float> &matrix);
+
+
+        // MODIFIERS:
+
+        /// Set feature k of position p.
+        void set(unsigned int k, unsigned int p, float value);
+
+        /// Copy orig object to this object ("deep copy").
+        void copy(const ProfileFeatures &orig);
+
+        /// Select the kernel, if supported by the CPU.
+        static void setKernel(Kernel kernel);
+
+
+    protected:
+
+
+    private:
+
+        // HELPERS:
+
+        /// Allocate the aligned feature rows.
+        void pAllocate(unsigned int size, unsigned int width);
+
+        /// Return best kernel supported by the CPU.
+        static Kernel pGetBestKernel();
+
+        /// Calculate the matrix of dot products or squared distances.
+        static void pCalculate(const ProfileFeatures &target,
+                const ProfileFeatures &templ, bool distance,
+                vector<float> &matrix);
+
+
+        // ATTRIBUTES:
+
+        unsigned int positions; ///< Number of positions.
+        unsigned int width; ///< Number of features per position.
+        unsigned int stride; ///< Length of a feature row (multiple of 8).
+        float *data; ///< Feature rows.
+
+        static Kernel kernel; ///< Selected kernel.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                               ProfileFeatures
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    ProfileFeatures::size() const {
+        return positions;
+    }
+
+    inline unsigned int
+    ProfileFeatures::getWidth() const {
+        return width;
+    }
+
+    inline float
+    ProfileFeatures::get(unsigned int k, unsigned int p) const {
+        return data[k * stride + p];
+    }
+
+    inline ProfileFeatures::Kernel
+    ProfileFeatures::getKernel() {
+        return kernel;
+    }
+
+
+    // MODIFIERS:
+
+    inline void
+    ProfileFeatures::set(unsigned int k, unsigned int p, float value) {
+        data[k * stride + p] = value;
+    }
+
+}} // namespace
+
+#endif
@@ -16,25 +16,53 @@
 
 
 #include <ReverseScore.h>
+#include <math.h>
 
 namespace Victor { namespace Align2{
 
+    /**
+     * Minimal standard generator (Park and Miller), with its state in the
+     * caller: rand() would make the shuffles depend on the threads.
+     */
+    static unsigned long
+    sRandom(unsigned long &state) {
+        state = (state * 48271UL) % 2147483647UL;
+        return state;
+    }
+
     // CONSTRUCTORS:
     /**
      * 
      * @param a
      */
-    ReverseScore::ReverseScore(Align *a) {
+    ReverseScore::ReverseScore(Align *a) : owner(true), threads(1),
+    background() {
         ali = a->newCopy();
         inv = a->newCopy();
         inv->getScoringScheme()->reverse();
     }
 
-    ReverseScore::ReverseScore(const ReverseScore &orig) {
+    /**
+     * Avoids the copies of the default constructor, e.g. when many
+     * templates are scored: reversed must align the same data as a, with
+     * a scoring scheme of its own on which reverse() was called.
+     * @param a
+     * @param reversed
+     */
+    ReverseScore::ReverseScore(Align *a, Align *reversed) : ali(a),
+    inv(reversed), owner(false), threads(1), background() {
+    }
+
+    ReverseScore::ReverseScore(const ReverseScore &orig) : ali(NULL),
+    inv(NULL), owner(false), threads(1), background() {
         copy(orig);
     }
 
     ReverseScore::~ReverseScore() {
+        if (owner) {
+            delete ali;
+            delete inv;
+        }
     }
 
 
@@ -53,6 +81,69 @@ namespace Victor { namespace Align2{
     }
 
 
+    // PREDICATES:
+    /**
+     * Probability of reaching score by chance, from the extreme value
+     * distribution fitted to the scores of the last getShuffledZScore().
+     * @param score
+     * @return p-value
+     */
+    double
+    ReverseScore::getPValue(double score) const {
+        if (background.empty())
+            ERROR("ReverseScore::getPValue() needs getShuffledZScore().",
+                exception);
+        double lambda, mu;
+        fitEvd(background, lambda, mu);
+        if (lambda <= 0)
+            return (score > mu) ? 0.00 : 1.00;
+        return 1.00 - exp(-exp(-lambda * (score - mu)));
+    }
+
+    /**
+     * Gumbel distribution with mean mu + 0.5772 / lambda and variance
+     * pi^2 / (6 lambda^2). Optimal alignment scores of unrelated sequences
+     * follow it more closely than a normal distribution, so tail
+     * probabilities need fewer samples than with z-scores.
+     * @param scores
+     * @param lambda scale (0 if all scores are equal)
+     * @param mu location
+     */
+    void
+    ReverseScore::fitEvd(const vector<double> &scores, double &lambda,
+            double &mu) {
+        double sd = standardDeviation(scores);
+        if (sd <= 0) {
+            lambda = 0.00;
+            mu = average(scores);
+            return;
+        }
+        lambda = M_PI / (sd * sqrt(6.00));
+        mu = average(scores) - 0.5772156649 / lambda;
+    }
+
+    /**
+     * Fisher-Yates shuffle of 1..m.
+     * @param m number of positions
+     * @param k seed
+     * @return shuffled positions
+     */
+    vector<unsigned int>
+    ReverseScore::getShuffle(unsigned int m, unsigned int k) {
+        vector<unsigned int> columns(m);
+        for (unsigned int j = 0; j < m; j++)
+            columns[j] = j + 1;
+
+        unsigned long state = 1 + k;
+        for (unsigned int i = 0; i < 4; i++)
+            sRandom(state);
+        if (k > 0)
+            for (unsigned int j = m; j > 1; j--)
+                swap(columns[j - 1], columns[sRandom(state) % j]);
+        return columns;
+    }
+
+
     // MODIFIERS:
     /**
      * 
@@ -60,8 +151,15 @@ namespace Victor { namespace Align2{
      */
     void
     ReverseScore::copy(const ReverseScore &orig) {
-        ali = orig.ali;
-        inv = orig.inv;
+        if (owner) {
+            delete ali;
+            delete inv;
+        }
+        owner = orig.owner;
+        ali = owner ? orig.ali->newCopy() : orig.ali;
+        inv = owner ? orig.inv->newCopy() : orig.inv;
+        threads = orig.threads;
+        background = orig.background;
     }
     /**
      * 
@@ -86,4 +184,63 @@ namespace Victor { namespace Align2{
         return ((forward - reverse) / (standardDeviation(score) != 0 ? standardDeviation(score) : 1));
     }
 
+    /**
+     * The reversed alignment is scored n times without traceback, the k-th
+     * time with template columns shuffled by getShuffle(m, k). Neither
+     * alignment is recalculated: the forward score is that of ali.
+     * @param forward score of ali
+     * @param reverse average score of the shuffled reversals
+     * @param n number of shuffles
+     * @return z-score
+     */
+    double
+    ReverseScore::getShuffledZScore(double &forward, double &reverse,
+            unsigned int n) {
+        background.assign(n, 0.00);
+
+        Background b;
+        b.inv = inv;
+        b.next = 0;
+        b.scores = &background;
+
+        pthread_mutex_init(&b.lock, NULL);
+        unsigned int nThreads = min(threads, n);
+        if (nThreads <= 1)
+            pWorker(&b);
+        else {
+            vector<pthread_t> pool(nThreads);
+            for (unsigned int t = 0; t < nThreads; t++)
+                if (pthread_create(&pool[t], NULL, pWorker, &b) != 0)
+                    ERROR("Could not start ReverseScore thread.", exception);
+            for (unsigned int t = 0; t < nThreads; t++)
+                pthread_join(pool[t], NULL);
+        }
+        pthread_mutex_destroy(&b.lock);
+
+        forward = ali->getScore();
+        reverse = average(background);
+        double sd = standardDeviation(background);
+        return (forward - reverse) / ((sd != 0) ? sd : 1);
+    }
+
+
+    // HELPERS:
+
+    void*
+    ReverseScore::pWorker(void *background) {
+        Background &b = *static_cast<Background *> (background);
+        vector<double> &scores = *b.scores;
+
+        while (true) {
+            pthread_mutex_lock(&b.lock);
+            unsigned int k = b.next++;
+            pthread_mutex_unlock(&b.lock);
+            if (k >= scores.size())
+                break;
+            vector<unsigned int> columns = getShuffle(b.inv->m, k);
+            scores[k] = b.inv->getScoreOnly(&columns);
+        }
+        return NULL;
+    }
+
 }} // namespace
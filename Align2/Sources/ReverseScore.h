@@ -21,6 +21,7 @@
 #include <Align.h>
 #include <Alignment.h>
 #include <StatTools.h>
+#include <pthread.h>
 #include <algorithm>
 #include <iostream>
 #include <string>
@@ -28,10 +29,19 @@
 
 namespace Victor { namespace Align2{
 
-    /** @brief  
+    /** @brief  Z-score of an alignment against its reversal.
      * 
-     *   
-
+     *   getZScore() compares the score of the alignment with the scores of
+     *   suboptimal alignments of the reversed alignment, which are
+     *   calculated one after the other on the full matrices.
+     *
+     *   getShuffledZScore() compares it with the scores of n reversed
+     *   alignments whose template columns are shuffled. Each of them is
+     *   calculated by Align::getScoreOnly() without traceback, in O(m)
+     *   memory, and they are independent, so they are shared by a pool of
+     *   threads. The shuffles are seeded by their number: the scores do not
+     *   depend on the number of threads. getPValue() fits an extreme value
+     *   distribution to the same scores.
      **/
     class ReverseScore {
     public:
@@ -41,6 +51,9 @@ namespace Victor { namespace Align2{
         /// Default constructor.
         ReverseScore(Align *a);
 
+        /// Constructor with an alignment and its reversal, not copied.
+        ReverseScore(Align *a, Align *reversed);
+
         /// Copy constructor.
         ReverseScore(const ReverseScore &orig);
 
@@ -54,6 +67,22 @@ namespace Victor { namespace Align2{
         ReverseScore& operator =(const ReverseScore &orig);
 
 
+        // PREDICATES:
+
+        /// Return scores of the last shuffled alignments.
+        vector<double> getBackgroundScores() const;
+
+        /// Return probability of a score of at least score, from the EVD fit.
+        double getPValue(double score) const;
+
+        /// Fit an extreme value distribution to scores (method of moments).
+        static void fitEvd(const vector<double> &scores, double &lambda,
+                double &mu);
+
+        /// Return positions 1..m shuffled with seed k (k = 0: not shuffled).
+        static vector<unsigned int> getShuffle(unsigned int m, unsigned int k);
+
+
         // MODIFIERS:
 
         /// Copy orig object to this object ("deep copy").
@@ -62,6 +91,13 @@ namespace Victor { namespace Align2{
         /// Calculate Z-score between ali and its reversal.
         double getZScore(double &forward, double &reverse, unsigned int n = 50);
 
+        /// Calculate Z-score between ali and shuffled reversals, score only.
+        double getShuffledZScore(double &forward, double &reverse,
+                unsigned int n = 50);
+
+        /// Set number of threads of getShuffledZScore().
+        void setThreads(unsigned int threads);
+
 
     protected:
 
@@ -69,12 +105,49 @@ namespace Victor { namespace Align2{
 
         Align *ali; ///< Pointer to initial Align.
         Align *inv; ///< Pointer to inverted Align.
+        bool owner; ///< ali and inv are copies owned by this object.
+        unsigned int threads; ///< Threads of getShuffledZScore().
+        vector<double> background; ///< Scores of the shuffled alignments.
 
 
     private:
 
+        /// Shuffled alignments shared by the threads.
+
+        struct Background {
+            const Align *inv; ///< Reversed alignment.
+            unsigned int next; ///< Next shuffle to score.
+            pthread_mutex_t lock; ///< Lock of next.
+            vector<double> *scores; ///< One score per shuffle.
+        };
+
+
+        // HELPERS:
+
+        /// Thread of the pool: score shuffles until all are done.
+        static void* pWorker(void *background);
+
     };
 
+    // -----------------------------------------------------------------------------
+    //                                ReverseScore
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline vector<double>
+    ReverseScore::getBackgroundScores() const {
+        return background;
+    }
+
+
+    // MODIFIERS:
+
+    inline void
+    ReverseScore::setThreads(unsigned int threads) {
+        this->threads = (threads > 0) ? threads : 1;
+    }
+
 }} // namespace
 
 #endif
@@ -21,6 +21,7 @@
 // -----------------x-----------------------------------------------------------
 
 #include <SWAlign.h>
+#include <Profiler.h>
 #include <limits.h>
 
 namespace Victor { namespace Align2{
@@ -32,14 +33,16 @@ namespace Victor { namespace Align2{
      * @param gf
      * @param ss
      */
-    SWAlign::SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
-    : Align(ad, gf, ss) {
+    SWAlign::SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+            bool linearSpace, unsigned int bandWidth)
+    : Align(ad, gf, ss, linearSpace, bandWidth) {
         pCalculateMatrix(true);
     }
 
     SWAlign::SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
-            const vector<unsigned int> &v1, const vector<unsigned int> &v2)
-    : Align(ad, gf, ss) {
+            const vector<unsigned int> &v1, const vector<unsigned int> &v2,
+            bool linearSpace, unsigned int bandWidth)
+    : Align(ad, gf, ss, linearSpace, bandWidth) {
         pCalculateMatrix(v1, v2, true);
     }
 
@@ -67,6 +70,7 @@ namespace Victor { namespace Align2{
      */
     void
     SWAlign::getMultiMatch() {
+        pUseFullMatrix();
         Traceback tb = B0;
         int i = tb.i;
         int j = tb.j;
@@ -110,6 +114,17 @@ namespace Victor { namespace Align2{
      */
     void
     SWAlign::pCalculateMatrix(bool update) {
+        PROFILE_REGION("SWAlign::pCalculateMatrix");
+        if (bandWidth > 0) {
+            pCalculateBanded();
+            return;
+        }
+        if (linearSpace) {
+            pCalculateLinear();
+            return;
+        }
+        PROFILE_COUNT("cells", n * m);
+
         int maxi = n;
         int maxj = m;
         double maxval = INT_MIN;
@@ -120,41 +135,39 @@ namespace Victor { namespace Align2{
                 double extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i - 1, j) == TracebackMatrix::UP_MOVE)
+                        extI = F.get(i - 1, j) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i, j - 1) == TracebackMatrix::LEFT_MOVE)
+                        extJ = F.get(i, j - 1) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
+                double z = F.get(i - 1, j - 1) + s;
                 double val = max(max(max(z, extI), extJ), 0.00);
 
                 if (update)
-                    F[i][j] = val;
+                    F.set(i, j, val);
 
                 if (EQUALS(val, 0))
-                    B[i][j] = Traceback::getInvalidTraceback();
+                    B.setMove(i, j, TracebackMatrix::NO_MOVE);
                 else
                     if (val > 0) {
                     if (EQUALS(val, z))
-                        B[i][j] = Traceback(i - 1, j - 1);
+                        B.setMove(i, j, TracebackMatrix::DIAGONAL_MOVE);
                     else
                         if (EQUALS(val, extJ))
-                        B[i][j] = Traceback(i, j - 1);
+                        B.setMove(i, j, TracebackMatrix::LEFT_MOVE);
                     else
                         if (EQUALS(val, extI))
-                        B[i][j] = Traceback(i - 1, j);
+                        B.setMove(i, j, TracebackMatrix::UP_MOVE);
                     else
                         ERROR("Error in SWAlign: SW 1", exception);
                 } else
@@ -181,6 +194,17 @@ namespace Victor { namespace Align2{
     void
     SWAlign::pCalculateMatrix(const vector<unsigned int> &v1,
             const vector<unsigned int> &v2, bool update) {
+        PROFILE_REGION("SWAlign::pCalculateMatrix");
+        if (bandWidth > 0) {
+            pCalculateBanded(&v1, &v2);
+            return;
+        }
+        if (linearSpace) {
+            pCalculateLinear(&v1, &v2);
+            return;
+        }
+        PROFILE_COUNT("cells", n * m);
+
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
         unsigned int minL = 0;
@@ -204,41 +228,39 @@ namespace Victor { namespace Align2{
                 double extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i - 1, j) == TracebackMatrix::UP_MOVE)
+                        extI = F.get(i - 1, j) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F.get(i - 1, j) - gf->getOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                    if (B.getMove(i, j - 1) == TracebackMatrix::LEFT_MOVE)
+                        extJ = F.get(i, j - 1) - gf->getExtensionPenalty(j);
                     else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F.get(i, j - 1) - gf->getOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
+                double z = F.get(i - 1, j - 1) + s;
                 double val = max(max(max(z, extI), extJ), 0.00);
 
                 if (update)
-                    F[i][j] = val;
+                    F.set(i, j, val);
 
                 if (EQUALS(val, 0))
-                    B[i][j] = Traceback::getInvalidTraceback();
+                    B.setMove(i, j, TracebackMatrix::NO_MOVE);
                 else
                     if (val > 0) {
                     if (EQUALS(val, z))
-                        B[i][j] = Traceback(i - 1, j - 1);
+                        B.setMove(i, j, TracebackMatrix::DIAGONAL_MOVE);
                     else
                         if (EQUALS(val, extJ))
-                        B[i][j] = Traceback(i, j - 1);
+                        B.setMove(i, j, TracebackMatrix::LEFT_MOVE);
                     else
                         if (EQUALS(val, extI))
-                        B[i][j] = Traceback(i - 1, j);
+                        B.setMove(i, j, TracebackMatrix::UP_MOVE);
                     else
                         ERROR("Error in SWAlign: SW 1", exception);
                 } else
@@ -254,4 +276,20 @@ namespace Victor { namespace Align2{
             }
     }
 
+    /**
+     * 
+     * @param i
+     * @param j
+     * @return 0, local alignments start anywhere
+     */
+    double
+    SWAlign::pGetBorderScore(int i, int j) const {
+        return 0.0;
+    }
+
+    bool
+    SWAlign::pIsLocal() const {
+        return true;
+    }
+
 }} // namespace
@@ -33,11 +33,13 @@ namespace Victor { namespace Align2{
         // CONSTRUCTORS:
 
         /// Default constructor.
-        SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+                bool linearSpace = false, unsigned int bandWidth = 0);
 
         /// Constructor with weighted alignment positions.
         SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
-                const vector<unsigned int> &v1, const vector<unsigned int> &v2);
+                const vector<unsigned int> &v1, const vector<unsigned int> &v2,
+                bool linearSpace = false, unsigned int bandWidth = 0);
 
         /// Copy constructor.
         SWAlign(const SWAlign &orig);
@@ -76,6 +78,12 @@ namespace Victor { namespace Align2{
         virtual void pCalculateMatrix(const vector<unsigned int> &v1,
                 const vector<unsigned int> &v2, bool update = true);
 
+        /// Return score of cell (i, j) in row or column 0.
+        virtual double pGetBorderScore(int i, int j) const;
+
+        /// Return true, scores are bounded by zero.
+        virtual bool pIsLocal() const;
+
 
     protected:
 
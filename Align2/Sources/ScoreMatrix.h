@@ -0,0 +1,175 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ScoreMatrix_H__
+#define __ScoreMatrix_H__
+
+#include <Debug.h>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief    Score matrix F of an alignment, in one allocation.
+     * 
+     *   Scores are stored in single precision as long as every score
+     *   written is exactly representable as a float, which is the case for
+     *   integer substitution matrices and gap penalties. The first score
+     *   that is not (e.g. profile scores, or suboptimal alignment
+     *   penalties) converts the matrix to double precision, so reading a
+     *   score always returns the value written.
+     **/
+    class ScoreMatrix {
+    public:
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        ScoreMatrix();
+
+
+        // PREDICATES:
+
+        /// Return number of rows.
+        unsigned int size() const;
+
+        /// Return number of columns.
+        unsigned int getColumns() const;
+
+        /// Return true if scores are stored as float.
+        bool isSinglePrecision() const;
+
+        /// Return score of cell (i, j).
+        double get(int i, int j) const;
+
+
+        // MODIFIERS:
+
+        /// Resize to rows x columns, single precision, all cells set to value.
+        void assign(unsigned int rows, unsigned int columns, double value = 0.0);
+
+        /// Free the matrix.
+        void clear();
+
+        /// Set score of cell (i, j).
+        void set(int i, int j, double value);
+
+
+    protected:
+
+
+    private:
+
+        // HELPERS:
+
+        /// Move the scores to double precision.
+        void pUseDoublePrecision();
+
+
+        // ATTRIBUTES:
+
+        unsigned int rows; ///< Number of rows.
+        unsigned int columns; ///< Number of columns.
+        bool single; ///< Scores are stored in singleScore.
+        std::vector<float> singleScore; ///< Scores in single precision.
+        std::vector<double> doubleScore; ///< Scores in double precision.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                                 ScoreMatrix
+    // -----------------------------------------------------------------------------
+
+    // CONSTRUCTORS:
+
+    inline
+    ScoreMatrix::ScoreMatrix() : rows(0), columns(0), single(true),
+    singleScore(), doubleScore() {
+    }
+
+
+    // PREDICATES:
+
+    inline unsigned int
+    ScoreMatrix::size() const {
+        return rows;
+    }
+
+    inline unsigned int
+    ScoreMatrix::getColumns() const {
+        return columns;
+    }
+
+    inline bool
+    ScoreMatrix::isSinglePrecision() const {
+        return single;
+    }
+
+    inline double
+    ScoreMatrix::get(int i, int j) const {
+        unsigned int k = i * columns + j;
+        return single ? singleScore[k] : doubleScore[k];
+    }
+
+
+    // MODIFIERS:
+
+    inline void
+    ScoreMatrix::assign(unsigned int rows, unsigned int columns, double value) {
+        this->rows = rows;
+        this->columns = columns;
+        single = true;
+        std::vector<double>().swap(doubleScore);
+        singleScore.assign(rows * columns, static_cast<float> (value));
+        if (static_cast<float> (value) != value)
+            pUseDoublePrecision();
+    }
+
+    inline void
+    ScoreMatrix::clear() {
+        rows = 0;
+        columns = 0;
+        single = true;
+        std::vector<float>().swap(singleScore);
+        std::vector<double>().swap(doubleScore);
+    }
+
+    inline void
+    ScoreMatrix::set(int i, int j, double value) {
+        unsigned int k = i * columns + j;
+        if (single) {
+            float f = static_cast<float> (value);
+            if (f == value) {
+                singleScore[k] = f;
+                return;
+            }
+            pUseDoublePrecision();
+        }
+        doubleScore[k] = value;
+    }
+
+
+    // HELPERS:
+
+    inline void
+    ScoreMatrix::pUseDoublePrecision() {
+        doubleScore.assign(singleScore.begin(), singleScore.end());
+        std::vector<float>().swap(singleScore);
+        single = false;
+    }
+
+}} // namespace
+
+#endif
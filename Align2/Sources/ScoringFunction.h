@@ -20,6 +20,7 @@
 
 #include <math.h>
 #include <string>
+#include <vector>
 
 namespace Victor { namespace Align2{
 
@@ -61,6 +62,10 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoringSeq(int i, int j) = 0;
 
+        /// Calculate scores of all target and template positions at once.
+        virtual void scoringSeqMatrix(unsigned int n, unsigned int m,
+                vector<float> &matrix);
+
 
         // MODIFIERS:
 
@@ -93,6 +98,25 @@ namespace Victor { namespace Align2{
     }
 
 
+    // PREDICATES:
+
+    /**
+     * Default bulk calculation, one scoringSeq() call per pair. Subclasses
+     * override it with the SIMD kernels of ProfileFeatures.
+     * @param n number of target positions
+     * @param m number of template positions
+     * @param matrix scores, row by row: score of (i, j) at (i - 1) * m + j - 1
+     */
+    inline void
+    ScoringFunction::scoringSeqMatrix(unsigned int n, unsigned int m,
+            vector<float> &matrix) {
+        matrix.resize(n * m);
+        for (unsigned int i = 0; i < n; i++)
+            for (unsigned int j = 0; j < m; j++)
+                matrix[i * m + j] = scoringSeq(i + 1, j + 1);
+    }
+
+
     // MODIFIERS:
 
     inline void
@@ -38,7 +38,7 @@ namespace Victor { namespace Align2{
             Profile *pro1, Profile *pro2, ScoringFunction *fun, double cSeq)
     : ScoringScheme(sub, ad, str), seq1(ad->getSequence(1)),
     seq2(ad->getSequence(2)), pro1(pro1), pro2(pro2), fun(fun),
-    cSeq(cSeq) {
+    cSeq(cSeq), precomputed(false), seqScore() {
     }
 
     ScoringP2P::ScoringP2P(const ScoringP2P &orig) : ScoringScheme(orig) {
@@ -73,7 +73,11 @@ namespace Victor { namespace Align2{
      */
     double
     ScoringP2P::scoring(int i, int j) {
-        double s = cSeq * fun->scoringSeq(i, j);
+        double s;
+        if (precomputed)
+            s = cSeq * seqScore[(i - 1) * seq2.size() + (j - 1)];
+        else
+            s = cSeq * fun->scoringSeq(i, j);
         if (str != 0)
             s += str->scoringStr(i, j);
         return s;
@@ -94,6 +98,8 @@ namespace Victor { namespace Align2{
         pro2 = orig.pro2->newCopy();
         fun = orig.fun->newCopy();
         cSeq = orig.cSeq;
+        precomputed = orig.precomputed;
+        seqScore = orig.seqScore;
     }
     /**
      * 
@@ -115,6 +121,23 @@ namespace Victor { namespace Align2{
         seq2 = tmp;
 
         pro2->reverse();
+        if (precomputed)
+            fun->scoringSeqMatrix(seq1.size(), seq2.size(), seqScore);
+    }
+
+    /**
+     * The scores of all pairs of positions are calculated at once with
+     * ScoringFunction::scoringSeqMatrix() and stored as floats, instead of
+     * calling scoringSeq() for every cell of the alignment matrix.
+     * @param precomputed
+     */
+    void
+    ScoringP2P::setPrecomputed(bool precomputed) {
+        this->precomputed = precomputed;
+        if (precomputed)
+            fun->scoringSeqMatrix(seq1.size(), seq2.size(), seqScore);
+        else
+            seqScore.clear();
     }
 
 }} // namespace
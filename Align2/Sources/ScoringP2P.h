@@ -56,6 +56,9 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoring(int i, int j);
 
+        /// Return true if the sequence scores are calculated in bulk.
+        bool isPrecomputed() const;
+
 
         // MODIFIERS:
 
@@ -68,6 +71,9 @@ namespace Victor { namespace Align2{
         /// Reverse template sequence and profile.
         virtual void reverse();
 
+        /// Calculate all sequence scores in bulk before the alignment.
+        void setPrecomputed(bool precomputed = true);
+
 
     protected:
 
@@ -82,9 +88,22 @@ namespace Victor { namespace Align2{
         Profile *pro2; ///< Template profile.
         ScoringFunction *fun; ///< Scoring function.
         double cSeq; ///< Coefficient for sequence alignment.
+        bool precomputed; ///< Sequence scores are calculated in bulk.
+        vector<float> seqScore; ///< Sequence scores, row by row.
 
     };
 
+    // -----------------------------------------------------------------------------
+    //                                 ScoringP2P
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline bool
+    ScoringP2P::isPrecomputed() const {
+        return precomputed;
+    }
+
 }} // namespace
 
 #endif
@@ -105,7 +105,7 @@ namespace Victor { namespace Align2{
     ScoringScheme::copy(const ScoringScheme &orig) {
         sub = orig.sub->newCopy();
         ad = orig.ad->newCopy();
-        str = orig.str->newCopy();
+        str = (orig.str != 0) ? orig.str->newCopy() : 0;
     }
 
     void
@@ -0,0 +1,451 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// --*- C++ -*------x-----------------------------------------------------------
+//
+// Description:     Score-only striped Smith-Waterman, with 8 and 16 bit
+//                  saturated SIMD engines and a plain fallback.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <StripedSW.h>
+#include <SequenceData.h>
+#include <ScoringS2S.h>
+#include <SWAlign.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STRIPED_SW_X86
+#include <emmintrin.h>
+#endif
+
+namespace Victor { namespace Align2{
+
+    /// Number of residue codes with a profile row.
+    static const unsigned int sCodes = 128;
+
+    /**
+     * Profile row of a target residue.
+     */
+    static inline unsigned int
+    sCode(char c) {
+        unsigned int code = static_cast<unsigned char> (c);
+        return (code < sCodes) ? code : 0;
+    }
+
+#ifdef STRIPED_SW_X86
+
+    /**
+     * Score of a target with 16 cells of 8 bits at a time. Scores are
+     * unsigned, with the substitution scores shifted by bias.
+     * @param profile striped query profile, one row per residue code
+     * @param segments vectors per column
+     * @param target target sequence
+     * @param bias shift of the substitution scores
+     * @param open penalty of the first residue of a gap
+     * @param extension penalty of the other residues of a gap
+     * @param buffer H and E columns, 3 * segments vectors
+     * @return best score, 255 - bias or more if it saturated
+     */
+    __attribute__((target("sse2"))) static int
+    sScore8(const unsigned char *profile, unsigned int segments,
+            const string &target, int bias, int open, int extension,
+            __m128i *buffer) {
+        const __m128i vZero = _mm_setzero_si128();
+        const __m128i vBias = _mm_set1_epi8(static_cast<char> (bias));
+        const __m128i vOpen = _mm_set1_epi8(static_cast<char> (open));
+        const __m128i vExtension = _mm_set1_epi8(static_cast<char> (extension));
+        __m128i vMax = vZero;
+
+        __m128i *hLoad = buffer;
+        __m128i *hStore = buffer + segments;
+        __m128i *e = buffer + 2 * segments;
+        for (unsigned int s = 0; s < 3 * segments; s++)
+            buffer[s] = vZero;
+
+        for (unsigned int j = 0; j < target.size(); j++) {
+            const __m128i *p = reinterpret_cast<const __m128i *> (profile
+                    + sCode(target[j]) * segments * 16);
+
+            // H of the previous column, shifted to the next query position
+            __m128i vF = vZero;
+            __m128i vH = _mm_slli_si128(hStore[segments - 1], 1);
+            __m128i *swap = hLoad;
+            hLoad = hStore;
+            hStore = swap;
+
+            for (unsigned int s = 0; s < segments; s++) {
+                vH = _mm_adds_epu8(vH, p[s]);
+                vH = _mm_subs_epu8(vH, vBias);
+                __m128i vE = e[s];
+                vH = _mm_max_epu8(vH, vE);
+                vH = _mm_max_epu8(vH, vF);
+                vMax = _mm_max_epu8(vMax, vH);
+                hStore[s] = vH;
+
+                vH = _mm_subs_epu8(vH, vOpen);
+                vE = _mm_subs_epu8(vE, vExtension);
+                e[s] = _mm_max_epu8(vE, vH);
+                vF = _mm_subs_epu8(vF, vExtension);
+                vF = _mm_max_epu8(vF, vH);
+                vH = hLoad[s];
+            }
+
+            // gaps along the query crossing the segments (lazy F loop)
+            vF = _mm_slli_si128(vF, 1);
+            unsigned int s = 0;
+            vH = hStore[0];
+            while (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(vF,
+                    _mm_subs_epu8(vH, vOpen)), vZero)) != 0xffff) {
+                vH = _mm_max_epu8(vH, vF);
+                hStore[s] = vH;
+                e[s] = _mm_max_epu8(e[s], _mm_subs_epu8(vH, vOpen));
+                vF = _mm_subs_epu8(vF, vExtension);
+                if (++s >= segments) {
+                    s = 0;
+                    vF = _mm_slli_si128(vF, 1);
+                }
+                vH = hStore[s];
+            }
+        }
+
+        unsigned char lanes[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i *> (lanes), vMax);
+        int best = 0;
+        for (unsigned int l = 0; l < 16; l++)
+            if (lanes[l] > best)
+                best = lanes[l];
+        return best;
+    }
+
+    /**
+     * Score of a target with 8 cells of 16 bits at a time.
+     * @param profile striped query profile, one row per residue code
+     * @param segments vectors per column
+     * @param target target sequence
+     * @param open penalty of the first residue of a gap
+     * @param extension penalty of the other residues of a gap
+     * @param buffer H and E columns, 3 * segments vectors
+     * @return best score, 32767 if it saturated
+     */
+    __attribute__((target("sse2"))) static int
+    sScore16(const short int *profile, unsigned int segments,
+            const string &target, int open, int extension, __m128i *buffer) {
+        const __m128i vZero = _mm_setzero_si128();
+        const __m128i vOpen = _mm_set1_epi16(static_cast<short int> (open));
+        const __m128i vExtension =
+                _mm_set1_epi16(static_cast<short int> (extension));
+        __m128i vMax = vZero;
+
+        __m128i *hLoad = buffer;
+        __m128i *hStore = buffer + segments;
+        __m128i *e = buffer + 2 * segments;
+        for (unsigned int s = 0; s < 3 * segments; s++)
+            buffer[s] = vZero;
+
+        for (unsigned int j = 0; j < target.size(); j++) {
+            const __m128i *p = reinterpret_cast<const __m128i *> (profile
+                    + sCode(target[j]) * segments * 8);
+
+            __m128i vF = vZero;
+            __m128i vH = _mm_slli_si128(hStore[segments - 1], 2);
+            __m128i *swap = hLoad;
+            hLoad = hStore;
+            hStore = swap;
+
+            for (unsigned int s = 0; s < segments; s++) {
+                vH = _mm_adds_epi16(vH, p[s]);
+                __m128i vE = e[s];
+                vH = _mm_max_epi16(vH, vE);
+                vH = _mm_max_epi16(vH, vF);
+                vH = _mm_max_epi16(vH, vZero);
+                vMax = _mm_max_epi16(vMax, vH);
+                hStore[s] = vH;
+
+                vH = _mm_subs_epi16(vH, vOpen);
+                vE = _mm_subs_epi16(vE, vExtension);
+                e[s] = _mm_max_epi16(vE, vH);
+                vF = _mm_subs_epi16(vF, vExtension);
+                vF = _mm_max_epi16(vF, vH);
+                vH = hLoad[s];
+            }
+
+            // only positive F can raise H, which is never below zero
+            vF = _mm_slli_si128(vF, 2);
+            unsigned int s = 0;
+            vH = hStore[0];
+            while (_mm_movemask_epi8(_mm_cmpgt_epi16(vF, _mm_max_epi16(
+                    _mm_subs_epi16(vH, vOpen), vZero))) != 0) {
+                vH = _mm_max_epi16(vH, vF);
+                hStore[s] = vH;
+                e[s] = _mm_max_epi16(e[s], _mm_subs_epi16(vH, vOpen));
+                vF = _mm_subs_epi16(vF, vExtension);
+                if (++s >= segments) {
+                    s = 0;
+                    vF = _mm_slli_si128(vF, 2);
+                }
+                vH = hStore[s];
+            }
+        }
+
+        short int lanes[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i *> (lanes), vMax);
+        int best = 0;
+        for (unsigned int l = 0; l < 8; l++)
+            if (lanes[l] > best)
+                best = lanes[l];
+        return best;
+    }
+
+#endif
+
+
+    // CONSTRUCTORS:
+
+    /**
+     *
+     * @param sub substitution matrix
+     * @param gf gap function
+     * @param query query sequence
+     */
+    StripedSW::StripedSW(SubMatrix *sub, AGPFunction *gf, const string &query)
+    : sub(sub), gf(gf), segments8(0), segments16(0), profile8(NULL),
+    profile16(NULL), buffer(NULL), lastEngine(SCALAR_ENGINE) {
+        pSetQuery(query);
+    }
+
+    StripedSW::StripedSW(const StripedSW &orig) : sub(NULL), gf(NULL),
+    segments8(0), segments16(0), profile8(NULL), profile16(NULL),
+    buffer(NULL), lastEngine(SCALAR_ENGINE) {
+        copy(orig);
+    }
+
+    StripedSW::~StripedSW() {
+        pFree();
+    }
+
+
+    // OPERATORS:
+
+    StripedSW&
+            StripedSW::operator =(const StripedSW &orig) {
+        if (&orig != this)
+            copy(orig);
+        return *this;
+    }
+
+
+    // PREDICATES:
+
+    string
+    StripedSW::getEngineName(Engine engine) {
+        switch (engine) {
+            case BYTE_ENGINE:
+                return "8 bit";
+            case WORD_ENGINE:
+                return "16 bit";
+            default:
+                return "scalar";
+        }
+    }
+
+
+    // MODIFIERS:
+
+    /**
+     * The 8 bit engine is tried first; its saturated scores are recalculated
+     * with the 16 bit engine, and those with plain loops.
+     * @param target target sequence
+     * @return score
+     */
+    double
+    StripedSW::getScore(const string &target) {
+#ifdef STRIPED_SW_X86
+        if (integral && !query.empty() && !target.empty()) {
+            pBuildProfiles(target);
+            __m128i *columns = static_cast<__m128i *> (buffer);
+            int bias = (minScore < 0) ? -minScore : 0;
+
+            if ((maxScore + bias < 255) && (openPenalty <= 255)
+                    && (extensionPenalty <= 255)) {
+                int best = sScore8(profile8, segments8, target, bias,
+                        static_cast<int> (openPenalty),
+                        static_cast<int> (extensionPenalty), columns);
+                if (best < 255 - bias) {
+                    lastEngine = BYTE_ENGINE;
+                    return best;
+                }
+            }
+
+            if ((openPenalty <= 32767) && (extensionPenalty <= 32767)) {
+                int best = sScore16(profile16, segments16, target,
+                        static_cast<int> (openPenalty),
+                        static_cast<int> (extensionPenalty), columns);
+                if (best < 32767) {
+                    lastEngine = WORD_ENGINE;
+                    return best;
+                }
+            }
+        }
+#endif
+        return getScalarScore(target);
+    }
+
+    /**
+     * Gotoh recurrence on one column of the query.
+     * @param target target sequence
+     * @return score
+     */
+    double
+    StripedSW::getScalarScore(const string &target) {
+        lastEngine = SCALAR_ENGINE;
+        unsigned int n = query.size();
+        vector<double> h(n + 1, 0.0), e(n + 1, 0.0);
+        double best = 0.0;
+
+        for (unsigned int j = 0; j < target.size(); j++) {
+            double diagonal = 0.0, f = 0.0;
+            for (unsigned int i = 1; i <= n; i++) {
+                e[i] = max(e[i] - extensionPenalty, h[i] - openPenalty);
+                f = max(f - extensionPenalty, h[i - 1] - openPenalty);
+                double value = diagonal + pGetScore(query[i - 1], target[j]);
+                value = max(max(value, 0.0), max(e[i], f));
+                diagonal = h[i];
+                h[i] = value;
+                if (value > best)
+                    best = value;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * The alignment is calculated by SWAlign with ScoringS2S, so its score
+     * can be lower than the striped score.
+     * @param target target sequence
+     * @param threshold minimum striped score
+     * @param match query and target lines of the alignment
+     * @param score score of the alignment
+     * @return true if the target was aligned
+     */
+    bool
+    StripedSW::realign(const string &target, double threshold,
+            vector<string> &match, double &score) {
+        if (getScore(target) < threshold)
+            return false;
+
+        SequenceData ad(2, query, target, "query", "target");
+        ScoringS2S ss(sub, &ad, NULL, 1.00);
+        SWAlign a(&ad, gf, &ss);
+        match = a.getMatch();
+        score = a.getScore();
+        return true;
+    }
+
+    void
+    StripedSW::copy(const StripedSW &orig) {
+        sub = orig.sub;
+        gf = orig.gf;
+        pSetQuery(orig.query);
+    }
+
+
+    // HELPERS:
+
+    void
+    StripedSW::pSetQuery(const string &query) {
+        pFree();
+        this->query = query;
+        openPenalty = gf->getOpenPenalty(0);
+        extensionPenalty = gf->getExtensionPenalty(0);
+        // the lazy F loop of the SIMD engines assumes open >= extension
+        integral = (openPenalty >= extensionPenalty) && (extensionPenalty >= 0)
+                && (floor(openPenalty) == openPenalty)
+                && (floor(extensionPenalty) == extensionPenalty);
+
+        minScore = maxScore = 0;
+        for (unsigned int i = 0; i < query.size(); i++)
+            for (unsigned int c = 0; c < sCodes; c++) {
+                int s = pGetScore(query[i], static_cast<char> (c));
+                minScore = min(minScore, s);
+                maxScore = max(maxScore, s);
+            }
+        if (maxScore - minScore > 32767)
+            integral = false;
+
+        segments8 = (query.size() + 15) / 16;
+        segments16 = (query.size() + 7) / 8;
+        built.assign(sCodes, false);
+        if (query.empty())
+            return;
+
+        void *p8, *p16;
+        if ((posix_memalign(&p8, 16, sCodes * segments8 * 16) != 0)
+                || (posix_memalign(&p16, 16, sCodes * segments16 * 16) != 0)
+                || (posix_memalign(&buffer, 16, 3 * segments16 * 16) != 0))
+            ERROR("Could not allocate striped profile.", exception);
+        profile8 = static_cast<unsigned char *> (p8);
+        profile16 = static_cast<short int *> (p16);
+    }
+
+    void
+    StripedSW::pFree() {
+        free(profile8);
+        free(profile16);
+        free(buffer);
+        profile8 = NULL;
+        profile16 = NULL;
+        buffer = NULL;
+    }
+
+    /**
+     * Lane l of vector s holds query position s + l * segments; positions
+     * past the end of the query score 0.
+     * @param target target sequence
+     */
+    void
+    StripedSW::pBuildProfiles(const string &target) {
+        int bias = (minScore < 0) ? -minScore : 0;
+        unsigned int n = query.size();
+
+        for (unsigned int j = 0; j < target.size(); j++) {
+            unsigned int code = sCode(target[j]);
+            if (built[code])
+                continue;
+            built[code] = true;
+
+            unsigned char *row8 = profile8 + code * segments8 * 16;
+            for (unsigned int s = 0; s < segments8; s++)
+                for (unsigned int l = 0; l < 16; l++) {
+                    unsigned int i = s + l * segments8;
+                    int value = (i < n)
+                            ? pGetScore(query[i], static_cast<char> (code)) : 0;
+                    row8[s * 16 + l] = static_cast<unsigned char> (
+                            min(value + bias, 255));
+                }
+
+            short int *row16 = profile16 + code * segments16 * 8;
+            for (unsigned int s = 0; s < segments16; s++)
+                for (unsigned int l = 0; l < 8; l++) {
+                    unsigned int i = s + l * segments16;
+                    row16[s * 8 + l] = static_cast<short int> (
+                            (i < n) ? pGetScore(query[i], static_cast<char> (code)) : 0);
+                }
+        }
+    }
+
+}} // namespace
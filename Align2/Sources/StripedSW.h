@@ -0,0 +1,169 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __StripedSW_H__
+#define __StripedSW_H__
+
+#include <SubMatrix.h>
+#include <AGPFunction.h>
+#include <string>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Score-only striped Smith-Waterman for sequence searches.
+     *
+     *   Calculates the best local alignment score of one query sequence
+     *   against many target sequences, with the striped SIMD scheme of
+     *   Farrar (Bioinformatics 23:156, 2007): the query profile is built
+     *   once, and each target is scored with 16 saturated 8 bit cells at a
+     *   time. Scores that saturate 8 bits are recalculated with 8 cells of
+     *   16 bits, and those that saturate 16 bits with plain loops in double
+     *   precision.
+     *
+     *   The score is the exact affine gap optimum (gap of length L costs
+     *   open + (L - 1) * extension), without traceback. SWAlign chooses
+     *   between opening and extending a gap greedily, so its score can be
+     *   lower on the same pair: realign() runs SWAlign on the targets whose
+     *   striped score reaches a threshold, to get their alignment.
+     **/
+    class StripedSW {
+    public:
+
+        /// Precision used for a score.
+
+        enum Engine {
+            SCALAR_ENGINE, ///< Plain loops, double precision.
+            WORD_ENGINE, ///< 8 cells of 16 bits at a time.
+            BYTE_ENGINE ///< 16 cells of 8 bits at a time.
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        StripedSW(SubMatrix *sub, AGPFunction *gf, const string &query);
+
+        /// Copy constructor.
+        StripedSW(const StripedSW &orig);
+
+        /// Destructor.
+        virtual ~StripedSW();
+
+
+        // OPERATORS:
+
+        /// Assignment operator.
+        StripedSW& operator =(const StripedSW &orig);
+
+
+        // PREDICATES:
+
+        /// Return query sequence.
+        string getQuery() const;
+
+        /// Return precision used for the last score.
+        Engine getLastEngine() const;
+
+        /// Return name of an engine.
+        static string getEngineName(Engine engine);
+
+
+        // MODIFIERS:
+
+        /// Return best local alignment score of query and target.
+        double getScore(const string &target);
+
+        /// Return best local alignment score of query and target, plain loops.
+        double getScalarScore(const string &target);
+
+        /// Align query and target with SWAlign if their score reaches threshold.
+        bool realign(const string &target, double threshold,
+                vector<string> &match, double &score);
+
+        /// Copy orig object to this object ("deep copy").
+        void copy(const StripedSW &orig);
+
+
+    protected:
+
+
+    private:
+
+        // HELPERS:
+
+        /// Prepare penalties, score range and buffers for the query.
+        void pSetQuery(const string &query);
+
+        /// Free profiles and buffers.
+        void pFree();
+
+        /// Return substitution score of residues a and b.
+        int pGetScore(char a, char b) const;
+
+        /// Build the profile rows of the residues of target.
+        void pBuildProfiles(const string &target);
+
+
+        // ATTRIBUTES:
+
+        SubMatrix *sub; ///< Substitution matrix.
+        AGPFunction *gf; ///< Gap function.
+        string query; ///< Query sequence.
+        double openPenalty; ///< Penalty of the first residue of a gap.
+        double extensionPenalty; ///< Penalty of the other residues of a gap.
+        int minScore; ///< Lowest substitution score of a query residue.
+        int maxScore; ///< Highest substitution score of a query residue.
+        bool integral; ///< Penalties usable by the SIMD engines.
+
+        unsigned int segments8; ///< Vectors per column, 8 bit engine.
+        unsigned int segments16; ///< Vectors per column, 16 bit engine.
+        unsigned char *profile8; ///< Striped query profile, 8 bit.
+        short int *profile16; ///< Striped query profile, 16 bit.
+        vector<bool> built; ///< Profile rows already built, by residue.
+        void *buffer; ///< H and E columns of the SIMD engines.
+
+        Engine lastEngine; ///< Precision used for the last score.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                                  StripedSW
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline string
+    StripedSW::getQuery() const {
+        return query;
+    }
+
+    inline StripedSW::Engine
+    StripedSW::getLastEngine() const {
+        return lastEngine;
+    }
+
+    inline int
+    StripedSW::pGetScore(char a, char b) const {
+        int i = static_cast<unsigned char> (a), j = static_cast<unsigned char> (b);
+        if ((i >= 128) || (j >= 128))
+            return 0;
+        return sub->score[i][j];
+    }
+
+}} // namespace
+
+#endif
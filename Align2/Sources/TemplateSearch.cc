@@ -0,0 +1,386 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// --*- C++ -*------x-----------------------------------------------------------
+//
+// Description:     Alignment of one query against a database of templates,
+//                  on a pool of threads, with ranked hits.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <TemplateSearch.h>
+#include <SequenceData.h>
+#include <SecSequenceData.h>
+#include <ScoringS2S.h>
+#include <ScoringP2S.h>
+#include <ScoringP2P.h>
+#include <Sec.h>
+#include <NWAlign.h>
+#include <SWAlign.h>
+#include <FSAlign.h>
+#include <ReverseScore.h>
+#include <CrossProduct.h>
+#include <LogAverage.h>
+#include <DotPFreq.h>
+#include <DotPOdds.h>
+#include <EDistance.h>
+#include <Pearson.h>
+#include <JensenShannon.h>
+#include <AtchleyDistance.h>
+#include <AtchleyCorrelation.h>
+#include <algorithm>
+#include <ctype.h>
+
+namespace Victor { namespace Align2{
+
+    /**
+     * Higher score first, then database order.
+     */
+    static bool
+    sBetterScore(const TemplateSearch::Hit &a, const TemplateSearch::Hit &b) {
+        if (a.score != b.score)
+            return a.score > b.score;
+        return a.index < b.index;
+    }
+
+    /**
+     * Higher z-score first, then higher score and database order.
+     */
+    static bool
+    sBetterZScore(const TemplateSearch::Hit &a, const TemplateSearch::Hit &b) {
+        if (a.zScore != b.zScore)
+            return a.zScore > b.zScore;
+        return sBetterScore(a, b);
+    }
+
+
+    // CONSTRUCTORS:
+
+    /**
+     *
+     * @param sub substitution matrix
+     * @param gf gap function, only read by the threads
+     * @param queryName
+     * @param query query sequence
+     */
+    TemplateSearch::TemplateSearch(SubMatrix *sub, GapFunction *gf,
+            const string &queryName, const string &query) : sub(sub), gf(gf),
+    queryName(queryName), query(getCleanSequence(sub, query)),
+    queryProfile(NULL), scoringFunction(1), precompute(false), querySec(""),
+    subStr(NULL), cSeq(1.00), cStr(0.00), mode(GLOBAL_MODE), threads(1),
+    samples(0), shuffled(false), count(0) {
+    }
+
+    TemplateSearch::~TemplateSearch() {
+        for (unsigned int i = 0; i < queue.size(); i++)
+            delete queue[i].pro;
+    }
+
+
+    // PREDICATES:
+
+    /**
+     *
+     * @param maxHits maximum number of hits (0 = all)
+     * @return hits
+     */
+    vector<TemplateSearch::Hit>
+    TemplateSearch::getHits(unsigned int maxHits) const {
+        vector<Hit> ranked = hits;
+        if (samples > 0)
+            sort(ranked.begin(), ranked.end(), sBetterZScore);
+        else
+            sort(ranked.begin(), ranked.end(), sBetterScore);
+        if ((maxHits > 0) && (ranked.size() > maxHits))
+            ranked.resize(maxHits);
+        return ranked;
+    }
+
+    /**
+     * Sequence databases contain residues (e.g. lower case, O, J, *) that
+     * would make ScoringScheme abort the whole search.
+     * @param sub substitution matrix
+     * @param seq sequence
+     * @return sequence accepted by ScoringScheme
+     */
+    string
+    TemplateSearch::getCleanSequence(SubMatrix *sub, const string &seq) {
+        string residues = sub->getResidues();
+        string clean = seq;
+        for (unsigned int i = 0; i < clean.size(); i++) {
+            clean[i] = toupper(clean[i]);
+            if (residues.find(clean[i]) == string::npos)
+                clean[i] = 'X';
+        }
+        return clean;
+    }
+
+
+    // MODIFIERS:
+
+    /**
+     * Templates with a profile are aligned profile-to-profile, the others
+     * profile-to-sequence.
+     * @param pro query profile, not owned
+     * @param scoringFunction function number, as subali --sf
+     * @param precompute precompute the profile-to-profile scores
+     */
+    void
+    TemplateSearch::setQueryProfile(Profile *pro, unsigned int scoringFunction,
+            bool precompute) {
+        queryProfile = pro;
+        this->scoringFunction = scoringFunction;
+        this->precompute = precompute;
+    }
+
+    /**
+     * Every template must then be added with its secondary structure.
+     * @param sec query secondary structure
+     * @param subStr structural substitution matrix
+     * @param cSeq coefficient of the sequence scores
+     * @param cStr coefficient of the structural scores
+     */
+    void
+    TemplateSearch::setQuerySecondary(const string &sec, SubMatrix *subStr,
+            double cSeq, double cStr) {
+        if (sec.size() != query.size())
+            ERROR("Query secondary structure and sequence differ in length.",
+                exception);
+        querySec = sec;
+        this->subStr = subStr;
+        this->cSeq = cSeq;
+        this->cStr = cStr;
+    }
+
+    /**
+     *
+     * @param name template name
+     * @param seq template sequence
+     * @param pro template profile, deleted by the search
+     * @param sec template secondary structure
+     */
+    void
+    TemplateSearch::addTemplate(const string &name, const string &seq,
+            Profile *pro, const string &sec) {
+        if (!querySec.empty() && (sec.size() != seq.size()))
+            ERROR("Secondary structure of template " + name
+                + " missing or of wrong length.", exception);
+
+        Template t;
+        t.index = count++;
+        t.name = name;
+        t.seq = getCleanSequence(sub, seq);
+        t.sec = sec;
+        t.pro = pro;
+        queue.push_back(t);
+
+        if (queue.size() >= 16 * threads)
+            alignQueued();
+    }
+
+    void
+    TemplateSearch::alignQueued() {
+        if (queue.empty())
+            return;
+
+        Batch batch;
+        batch.search = this;
+        batch.next = 0;
+        batch.hits.resize(queue.size());
+        batch.failed = queue.size();
+
+        unsigned int nThreads = min(threads,
+                static_cast<unsigned int> (queue.size()));
+        if (nThreads <= 1)
+            for (unsigned int i = 0; i < queue.size(); i++)
+                pAlign(queue[i], batch.hits[i]);
+        else {
+            pthread_mutex_init(&batch.lock, NULL);
+            vector<pthread_t> pool(nThreads);
+            for (unsigned int t = 0; t < nThreads; t++)
+                if (pthread_create(&pool[t], NULL, pWorker, &batch) != 0)
+                    ERROR("Could not start search thread.", exception);
+            for (unsigned int t = 0; t < nThreads; t++)
+                pthread_join(pool[t], NULL);
+            pthread_mutex_destroy(&batch.lock);
+            // the exception itself cannot be passed between threads
+            if (batch.failed < queue.size())
+                ERROR("Could not align template " + queue[batch.failed].name
+                    + ".", exception);
+        }
+
+        hits.insert(hits.end(), batch.hits.begin(), batch.hits.end());
+        queue.clear();
+    }
+
+
+    // HELPERS:
+
+    void*
+    TemplateSearch::pWorker(void *batch) {
+        Batch &b = *static_cast<Batch *> (batch);
+        vector<Template> &queue = b.search->queue;
+
+        while (true) {
+            pthread_mutex_lock(&b.lock);
+            unsigned int i = b.next++;
+            pthread_mutex_unlock(&b.lock);
+            if (i >= queue.size())
+                break;
+            // an exception must not leave the thread, alignQueued() reports it
+            try {
+                b.search->pAlign(queue[i], b.hits[i]);
+            } catch (...) {
+                pthread_mutex_lock(&b.lock);
+                b.failed = min(b.failed, i);
+                b.next = queue.size();
+                pthread_mutex_unlock(&b.lock);
+            }
+        }
+        return NULL;
+    }
+
+    /**
+     * The z-score follows ReverseScore, with a second scoring scheme that
+     * reverses its own copy of the template data. Shuffled reversals are
+     * scored without traceback, so their alignment is not stored either.
+     * @param t template, its profile is deleted
+     * @param hit result
+     */
+    void
+    TemplateSearch::pAlign(Template &t, Hit &hit) {
+        hit.index = t.index;
+        hit.name = t.name;
+        hit.length = t.seq.size();
+        hit.zScore = 0.00;
+        hit.pValue = 1.00;
+
+        AlignmentData *ad;
+        if (querySec.empty())
+            ad = new SequenceData(2, query, t.seq, queryName, t.name);
+        else
+            ad = new SecSequenceData(4, query, t.seq, querySec, t.sec,
+                queryName, t.name);
+
+        Structure *str;
+        ScoringFunction *fun;
+        ScoringScheme *ss = pNewScoringScheme(ad, t.pro, str, fun);
+        Align *a = pNewAlign(ad, ss);
+        hit.match = a->getMatch();
+        hit.score = a->getScore();
+
+        if (samples > 0) {
+            Profile *reversedPro = (t.pro != NULL) ? t.pro->newCopy() : NULL;
+            Structure *reversedStr;
+            ScoringFunction *reversedFun;
+            ScoringScheme *reversedSs = pNewScoringScheme(ad, reversedPro,
+                    reversedStr, reversedFun);
+            reversedSs->reverse();
+            Align *inv = pNewAlign(ad, reversedSs, shuffled);
+
+            double forward, reverse;
+            ReverseScore rs(a, inv);
+            if (shuffled) {
+                hit.zScore = rs.getShuffledZScore(forward, reverse, samples);
+                hit.pValue = rs.getPValue(forward);
+            } else
+                hit.zScore = rs.getZScore(forward, reverse, samples);
+
+            delete inv;
+            delete reversedSs;
+            delete reversedFun;
+            delete reversedStr;
+            delete reversedPro;
+        }
+
+        delete a;
+        delete ss;
+        delete fun;
+        delete str;
+        delete ad;
+        delete t.pro;
+        t.pro = NULL;
+    }
+
+    /**
+     *
+     * @param ad alignment data of query and template
+     * @param pro template profile, or NULL
+     * @param str structure created for the scheme, or NULL
+     * @param fun scoring function created for the scheme, or NULL
+     * @return scoring scheme
+     */
+    ScoringScheme*
+    TemplateSearch::pNewScoringScheme(AlignmentData *ad, Profile *pro,
+            Structure *&str, ScoringFunction *&fun) {
+        str = querySec.empty() ? NULL : new Sec(subStr, ad, cStr);
+        fun = NULL;
+
+        if (queryProfile == NULL)
+            return new ScoringS2S(sub, ad, str, cSeq);
+        if (pro == NULL)
+            return new ScoringP2S(sub, ad, str, queryProfile, cSeq);
+
+        fun = pNewScoringFunction(pro);
+        ScoringP2P *ss = new ScoringP2P(sub, ad, str, queryProfile, pro, fun,
+                cSeq);
+        if (precompute)
+            ss->setPrecomputed();
+        return ss;
+    }
+
+    Align*
+    TemplateSearch::pNewAlign(AlignmentData *ad, ScoringScheme *ss,
+            bool linearSpace) {
+        switch (mode) {
+            case LOCAL_MODE:
+                return new SWAlign(ad, gf, ss, linearSpace);
+            case FREESHIFT_MODE:
+                return new FSAlign(ad, gf, ss, linearSpace);
+            default:
+                return new NWAlign(ad, gf, ss, linearSpace);
+        }
+    }
+
+    /**
+     * Same numbers as subali --sf.
+     * @param pro template profile
+     * @return scoring function
+     */
+    ScoringFunction*
+    TemplateSearch::pNewScoringFunction(Profile *pro) {
+        switch (scoringFunction) {
+            case 1:
+                return new LogAverage(sub, queryProfile, pro);
+            case 2:
+                return new DotPFreq(queryProfile, pro);
+            case 3:
+                return new DotPOdds(queryProfile, pro);
+            case 4:
+                return new EDistance(queryProfile, pro);
+            case 5:
+                return new Pearson(queryProfile, pro);
+            case 6:
+                return new JensenShannon(queryProfile, pro);
+            case 7:
+                return new AtchleyDistance(queryProfile, pro);
+            case 8:
+                return new AtchleyCorrelation(queryProfile, pro);
+            default:
+                return new CrossProduct(sub, queryProfile, pro);
+        }
+    }
+
+}} // namespace
@@ -0,0 +1,221 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TemplateSearch_H__
+#define __TemplateSearch_H__
+
+#include <Align.h>
+#include <Profile.h>
+#include <ScoringFunction.h>
+#include <SubMatrix.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Align one query against a database of templates.
+     *
+     *   The query (sequence, optional profile and secondary structure) and
+     *   the substitution matrices are loaded once. Templates are queued
+     *   with addTemplate() while the database is read; every full batch is
+     *   aligned by a pool of threads, so only one batch of templates is
+     *   held in memory. getHits() returns the hits ranked by ReverseScore
+     *   z-score, or by score when z-scores are disabled. With shuffled
+     *   z-scores the background alignments are calculated score-only and
+     *   every hit gets an EVD p-value as well.
+     *
+     *   The query objects, the matrices and the gap function are shared by
+     *   the threads and only read; everything that depends on the template
+     *   is built by the thread aligning it.
+     **/
+    class TemplateSearch {
+    public:
+
+        /// Alignment modes.
+
+        enum Mode {
+            GLOBAL_MODE, ///< Needleman-Wunsch.
+            LOCAL_MODE, ///< Smith-Waterman.
+            FREESHIFT_MODE ///< Free-shift.
+        };
+
+        /// Alignment of the query with one template.
+
+        struct Hit {
+            unsigned int index; ///< Position of the template in the database.
+            string name; ///< Template name.
+            unsigned int length; ///< Template length.
+            double score; ///< Alignment score.
+            double zScore; ///< ReverseScore z-score (0 if disabled).
+            double pValue; ///< EVD p-value (1 without shuffled z-scores).
+            vector<string> match; ///< Query and template lines.
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        TemplateSearch(SubMatrix *sub, GapFunction *gf,
+                const string &queryName, const string &query);
+
+        /// Destructor.
+        virtual ~TemplateSearch();
+
+
+        // PREDICATES:
+
+        /// Return number of templates aligned so far.
+        unsigned int size() const;
+
+        /// Return hits aligned so far, best first.
+        vector<Hit> getHits(unsigned int maxHits = 0) const;
+
+        /// Return sequence with residues unknown to sub replaced by X.
+        static string getCleanSequence(SubMatrix *sub, const string &seq);
+
+
+        // MODIFIERS:
+
+        /// Set alignment mode.
+        void setMode(Mode mode);
+
+        /// Set number of threads.
+        void setThreads(unsigned int threads);
+
+        /// Set number of reversed alignments of the z-scores (0 = no z-scores).
+        void setZScore(unsigned int samples, bool shuffled = false);
+
+        /// Set query profile, with the subali --sf number of the function.
+        void setQueryProfile(Profile *pro, unsigned int scoringFunction = 1,
+                bool precompute = false);
+
+        /// Set query secondary structure and its structural matrix.
+        void setQuerySecondary(const string &sec, SubMatrix *subStr,
+                double cSeq = 0.80, double cStr = 0.20);
+
+        /// Queue a template (the search owns pro); a full batch is aligned.
+        void addTemplate(const string &name, const string &seq,
+                Profile *pro = NULL, const string &sec = "");
+
+        /// Align the queued templates.
+        void alignQueued();
+
+
+    protected:
+
+
+    private:
+
+        /// Queued template.
+
+        struct Template {
+            unsigned int index; ///< Position in the database.
+            string name; ///< Template name.
+            string seq; ///< Template sequence.
+            string sec; ///< Template secondary structure.
+            Profile *pro; ///< Template profile, or NULL.
+        };
+
+        /// Batch shared by the threads.
+
+        struct Batch {
+            TemplateSearch *search; ///< Search aligning the batch.
+            unsigned int next; ///< Next template to align.
+            pthread_mutex_t lock; ///< Lock of next and failed.
+            vector<Hit> hits; ///< One hit per template.
+            unsigned int failed; ///< First template that threw, or the queue size.
+        };
+
+
+        // HELPERS:
+
+        /// Thread of the pool: align templates until the batch is done.
+        static void* pWorker(void *batch);
+
+        /// Align the query with a template.
+        void pAlign(Template &t, Hit &hit);
+
+        /// Return scoring scheme of query and template.
+        ScoringScheme* pNewScoringScheme(AlignmentData *ad, Profile *pro,
+                Structure *&str, ScoringFunction *&fun);
+
+        /// Return alignment of the current mode.
+        Align* pNewAlign(AlignmentData *ad, ScoringScheme *ss,
+                bool linearSpace = false);
+
+        /// Return profile-to-profile scoring function.
+        ScoringFunction* pNewScoringFunction(Profile *pro);
+
+
+        // ATTRIBUTES:
+
+        SubMatrix *sub; ///< Substitution matrix.
+        GapFunction *gf; ///< Gap function.
+        string queryName; ///< Query name.
+        string query; ///< Query sequence.
+        Profile *queryProfile; ///< Query profile, or NULL.
+        unsigned int scoringFunction; ///< Profile-to-profile function.
+        bool precompute; ///< Precompute profile-to-profile scores.
+        string querySec; ///< Query secondary structure, or empty.
+        SubMatrix *subStr; ///< Structural substitution matrix.
+        double cSeq; ///< Coefficient of the sequence scores.
+        double cStr; ///< Coefficient of the structural scores.
+
+        Mode mode; ///< Alignment mode.
+        unsigned int threads; ///< Number of threads.
+        unsigned int samples; ///< Reversed alignments of the z-scores.
+        bool shuffled; ///< Z-scores of shuffled reversals, score only.
+
+        vector<Template> queue; ///< Templates waiting for alignment.
+        vector<Hit> hits; ///< Hits aligned so far.
+        unsigned int count; ///< Templates added so far.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                               TemplateSearch
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    TemplateSearch::size() const {
+        return hits.size();
+    }
+
+
+    // MODIFIERS:
+
+    inline void
+    TemplateSearch::setMode(Mode mode) {
+        this->mode = mode;
+    }
+
+    inline void
+    TemplateSearch::setThreads(unsigned int threads) {
+        this->threads = (threads > 0) ? threads : 1;
+    }
+
+    inline void
+    TemplateSearch::setZScore(unsigned int samples, bool shuffled) {
+        this->samples = samples;
+        this->shuffled = shuffled;
+    }
+
+}} // namespace
+
+#endif
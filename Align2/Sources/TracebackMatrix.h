@@ -0,0 +1,153 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TracebackMatrix_H__
+#define __TracebackMatrix_H__
+
+#include <Traceback.h>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief    Traceback matrix B of an alignment, two bits per cell.
+     * 
+     *   Each cell stores the move leading to it, so the previous cell is
+     *   known from its position: four cells fit in one byte of a single
+     *   allocation, instead of one Traceback object each. The move also
+     *   tells whether the cell ends a gap in either direction, which is
+     *   all the gap extension of the recurrences needs.
+     **/
+    class TracebackMatrix {
+    public:
+
+        /// Move leading to a cell.
+
+        enum Move {
+            NO_MOVE, ///< Start of the path (invalid traceback).
+            DIAGONAL_MOVE, ///< From (i - 1, j - 1).
+            LEFT_MOVE, ///< From (i, j - 1).
+            UP_MOVE ///< From (i - 1, j).
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        TracebackMatrix();
+
+
+        // PREDICATES:
+
+        /// Return number of rows.
+        unsigned int size() const;
+
+        /// Return move leading to cell (i, j).
+        Move getMove(int i, int j) const;
+
+        /// Return cell preceding (i, j), invalid for NO_MOVE.
+        Traceback getTraceback(int i, int j) const;
+
+
+        // MODIFIERS:
+
+        /// Resize to rows x columns, all cells set to NO_MOVE.
+        void assign(unsigned int rows, unsigned int columns);
+
+        /// Free the matrix.
+        void clear();
+
+        /// Set move leading to cell (i, j).
+        void setMove(int i, int j, Move move);
+
+
+    protected:
+
+
+    private:
+
+        // ATTRIBUTES:
+
+        unsigned int rows; ///< Number of rows.
+        unsigned int columns; ///< Number of columns.
+        std::vector<unsigned char> moves; ///< Four moves per byte.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                               TracebackMatrix
+    // -----------------------------------------------------------------------------
+
+    // CONSTRUCTORS:
+
+    inline
+    TracebackMatrix::TracebackMatrix() : rows(0), columns(0), moves() {
+    }
+
+
+    // PREDICATES:
+
+    inline unsigned int
+    TracebackMatrix::size() const {
+        return rows;
+    }
+
+    inline TracebackMatrix::Move
+    TracebackMatrix::getMove(int i, int j) const {
+        unsigned int k = i * columns + j;
+        return static_cast<Move> ((moves[k >> 2] >> ((k & 3) << 1)) & 3);
+    }
+
+    inline Traceback
+    TracebackMatrix::getTraceback(int i, int j) const {
+        switch (getMove(i, j)) {
+            case DIAGONAL_MOVE:
+                return Traceback(i - 1, j - 1);
+            case LEFT_MOVE:
+                return Traceback(i, j - 1);
+            case UP_MOVE:
+                return Traceback(i - 1, j);
+            default:
+                return Traceback::getInvalidTraceback();
+        }
+    }
+
+
+    // MODIFIERS:
+
+    inline void
+    TracebackMatrix::assign(unsigned int rows, unsigned int columns) {
+        this->rows = rows;
+        this->columns = columns;
+        moves.assign((rows * columns + 3) / 4, 0);
+    }
+
+    inline void
+    TracebackMatrix::clear() {
+        rows = 0;
+        columns = 0;
+        std::vector<unsigned char>().swap(moves);
+    }
+
+    inline void
+    TracebackMatrix::setMove(int i, int j, Move move) {
+        unsigned int k = i * columns + j;
+        unsigned int shift = (k & 3) << 1;
+        moves[k >> 2] = (moves[k >> 2] & ~(3 << shift)) | (move << shift);
+    }
+
+}} // namespace
+
+#endif
@@ -18,6 +18,9 @@
 #include <AlignmentBase.h>
 #include <Alignment.h>
 #include <NWAlign.h>
+#include <SWAlign.h>
+#include <FSAlign.h>
+#include <NWAlignNoTermGaps.h>
 #include <Align.h>
 using namespace std;
 using namespace Victor;
@@ -103,6 +106,12 @@ public:
                 &TestAlign::testAlign_B));
         suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test3 - setting penalty values.",
                 &TestAlign::testAlign_C));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test4 - linear-space alignment.",
+                &TestAlign::testAlign_D));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test5 - banded alignment.",
+                &TestAlign::testAlign_E));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test6 - compact matrices.",
+                &TestAlign::testAlign_F));
 
         return suiteOfTests;
     }
@@ -140,4 +149,139 @@ protected:
         CPPUNIT_ASSERT((testAlign->penaltyMul== 14 )&&(testAlign->penaltyAdd== 10 ));
     }
 
+    Align* newAlign(unsigned int type, AlignmentData *data, GapFunction *gap,
+            ScoringScheme *scoring, bool linearSpace, unsigned int band = 0) {
+        switch (type) {
+            case 0: return new NWAlign(data, gap, scoring, linearSpace, band);
+            case 1: return new SWAlign(data, gap, scoring, linearSpace, band);
+            case 2: return new FSAlign(data, gap, scoring, linearSpace, band);
+            default: return new NWAlignNoTermGaps(data, gap, scoring, linearSpace, band);
+        }
+    }
+
+    void testAlign_D() {
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        // unrelated sequences of different length, so that gaps are needed
+        string seq1 = "MKVLAAGIVGLLLAHSTEQWRDGKPLYAACDEFGHIKLMNPQRSTVWYRRTE";
+        string seq2 = "GSHMKVLSAGIVGLAHSTEQWRPLYAACDNPQRSTVWYRGHIKLMKKDE";
+        SequenceData data(2, seq1, seq2, "seq1", "seq2");
+        ScoringS2S scoring(&sub, &data, NULL, 1.00);
+        AGPFunction gap(12, 3);
+
+        // same optimal alignment as with the full matrices
+        for (unsigned int type = 0; type < 4; type++) {
+            Align *full = newAlign(type, &data, &gap, &scoring, false);
+            Align *linear = newAlign(type, &data, &gap, &scoring, true);
+            CPPUNIT_ASSERT(linear->isLinearSpace() && (linear->F.size() == 0));
+            CPPUNIT_ASSERT(linear->getScore() == full->getScore());
+            CPPUNIT_ASSERT(linear->getMatch() == full->getMatch());
+            CPPUNIT_ASSERT(linear->getMatchSubset() == full->getMatchSubset());
+
+            // suboptimal alignments switch to the full matrices
+            vector<double> fullScores = full->getMultiMatchScore(3);
+            vector<double> linearScores = linear->getMultiMatchScore(3);
+            CPPUNIT_ASSERT(!linear->isLinearSpace());
+            CPPUNIT_ASSERT(linearScores == fullScores);
+            delete full;
+            delete linear;
+        }
+    }
+
+    void testAlign_E() {
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        // related sequences: the optimal path stays near the diagonal
+        string seq1 = "MKVLAAGIVGLLLAHSTEQWRDGKPLYAACDEFGHIKLMNPQRSTVWYRRTE";
+        string seq2 = "MKVLSAGIVGLLAHSTEQWRDGKPLYAACDEFGHIKMNPQRSTVWYRGRTE";
+        SequenceData data(2, seq1, seq2, "seq1", "seq2");
+        ScoringS2S scoring(&sub, &data, NULL, 1.00);
+        AGPFunction gap(12, 3);
+
+        for (unsigned int type = 0; type < 4; type++) {
+            Align *full = newAlign(type, &data, &gap, &scoring, false);
+            Align *banded = newAlign(type, &data, &gap, &scoring, false, 2);
+            CPPUNIT_ASSERT((banded->getBandWidth() >= 2) && (banded->F.size() == 0));
+            CPPUNIT_ASSERT(banded->getScore() == full->getScore());
+            CPPUNIT_ASSERT(banded->getMatch() == full->getMatch());
+
+            // band around a previous alignment, narrower than its gaps
+            banded->setBand(1, full->getMatchSubset());
+            CPPUNIT_ASSERT(banded->getBandWidth() >= 1);
+            CPPUNIT_ASSERT(banded->getScore() == full->getScore());
+            CPPUNIT_ASSERT(banded->getMatch() == full->getMatch());
+
+            // suboptimal alignments switch to the full matrices
+            vector<double> fullScores = full->getMultiMatchScore(3);
+            vector<double> bandedScores = banded->getMultiMatchScore(3);
+            CPPUNIT_ASSERT(banded->getBandWidth() == 0);
+            CPPUNIT_ASSERT(bandedScores == fullScores);
+            delete full;
+            delete banded;
+        }
+
+        // a band of width 1 is widened until the gap of seq3 fits in it
+        string seq3 = seq1.substr(0, 20) + seq1.substr(26);
+        SequenceData gapped(2, seq1, seq3, "seq1", "seq3");
+        ScoringS2S gappedScoring(&sub, &gapped, NULL, 1.00);
+        NWAlign full(&gapped, &gap, &gappedScoring);
+        NWAlign banded(&gapped, &gap, &gappedScoring, false, 1);
+        CPPUNIT_ASSERT(banded.getBandWidth() > 1);
+        CPPUNIT_ASSERT(banded.getMatch() == full.getMatch());
+    }
+
+    void testAlign_F() {
+        // moves of neighbouring cells share a byte
+        TracebackMatrix moves;
+        moves.assign(3, 5);
+        for (unsigned int i = 0; i < 3; i++)
+            for (unsigned int j = 0; j < 5; j++)
+                moves.setMove(i, j, static_cast<TracebackMatrix::Move> ((i + j) % 4));
+        moves.setMove(1, 2, TracebackMatrix::LEFT_MOVE);
+        for (unsigned int i = 0; i < 3; i++)
+            for (unsigned int j = 0; j < 5; j++)
+                if ((i != 1) || (j != 2))
+                    CPPUNIT_ASSERT(moves.getMove(i, j) == (i + j) % 4);
+        CPPUNIT_ASSERT(moves.getMove(1, 2) == TracebackMatrix::LEFT_MOVE);
+        CPPUNIT_ASSERT(moves.getTraceback(1, 2).i == 1);
+        CPPUNIT_ASSERT(moves.getTraceback(1, 2).j == 1);
+        CPPUNIT_ASSERT(Traceback::isInvalidTraceback(moves.getTraceback(0, 0)));
+
+        // scores that are not floats switch the matrix to double precision
+        ScoreMatrix scores;
+        scores.assign(2, 2);
+        scores.set(0, 1, -12.0);
+        CPPUNIT_ASSERT(scores.isSinglePrecision());
+        scores.set(1, 1, 0.1);
+        CPPUNIT_ASSERT(!scores.isSinglePrecision());
+        CPPUNIT_ASSERT((scores.get(0, 1) == -12.0) && (scores.get(1, 1) == 0.1));
+
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        string seq1 = "MKVLAAGIVGLLLAHSTEQWRDGKPLYAACDEFGHIKLMNPQRSTVWYRRTE";
+        string seq2 = "GSHMKVLSAGIVGLAHSTEQWRPLYAACDNPQRSTVWYRGHIKLMKKDE";
+        SequenceData data(2, seq1, seq2, "seq1", "seq2");
+        ScoringS2S scoring(&sub, &data, NULL, 1.00);
+        AGPFunction gap(12, 3);
+
+        // integer scores and penalties: single precision, same alignment
+        for (unsigned int type = 0; type < 4; type++) {
+            Align *full = newAlign(type, &data, &gap, &scoring, false);
+            Align *linear = newAlign(type, &data, &gap, &scoring, true);
+            CPPUNIT_ASSERT(full->F.isSinglePrecision());
+            CPPUNIT_ASSERT(full->getScore() == linear->getScore());
+            CPPUNIT_ASSERT(full->getMatch() == linear->getMatch());
+
+            // suboptimal penalties (0.98 * F) need double precision
+            vector<double> multi = full->getMultiMatchScore(3);
+            CPPUNIT_ASSERT(!full->F.isSinglePrecision());
+            CPPUNIT_ASSERT(multi[0] == linear->getScore());
+            delete full;
+            delete linear;
+        }
+    }
+
 };
@@ -11,6 +11,10 @@
 #include <TestAlignmentData.h>
 #include <TestAlign.h>
 #include <TestAlignment.h>
+#include <TestProfileFeatures.h>
+#include <TestStripedSW.h>
+#include <TestTemplateSearch.h>
+#include <TestReverseScore.h>
 using namespace std;
 using namespace Victor;
 
@@ -21,6 +25,10 @@ int main() {
         runner.addTest(TestAlignmentData::suite());
         runner.addTest(TestAlignment::suite());
         runner.addTest(TestAlign::suite());
+        runner.addTest(TestProfileFeatures::suite());
+        runner.addTest(TestStripedSW::suite());
+        runner.addTest(TestTemplateSearch::suite());
+        runner.addTest(TestReverseScore::suite());
 	cout<< "Running the unit tests."<<endl;
 	runner.run();
 
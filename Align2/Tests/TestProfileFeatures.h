@@ -0,0 +1,145 @@
+/*
+ * TestProfileFeatures.h
+ *
+ *  Precomputed profile-to-profile scores: SIMD kernels against plain loops
+ *  and against the per-cell scoring functions.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+#include <ProfileFeatures.h>
+#include <Profile.h>
+#include <Alignment.h>
+#include <DotPFreq.h>
+#include <EDistance.h>
+#include <Pearson.h>
+using namespace std;
+using namespace Victor;
+using namespace Victor::Align2;
+
+class TestProfileFeatures : public CppUnit::TestFixture {
+public:
+
+    TestProfileFeatures() {
+    }
+
+    virtual ~TestProfileFeatures() {
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestProfileFeatures");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestProfileFeatures>("Test1 - SIMD kernels against plain loops.",
+                &TestProfileFeatures::testProfileFeatures_A));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestProfileFeatures>("Test2 - Score matrix against per-cell scores.",
+                &TestProfileFeatures::testProfileFeatures_B));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+        ProfileFeatures::setKernel(ProfileFeatures::AVX2_KERNEL);
+    }
+
+protected:
+
+    /// Random profile of n positions, with some zero frequencies.
+
+    Profile* makeProfile(unsigned int n) {
+        const string residues = "ARNDCQEGHILKMFPSTWYV";
+        string seq;
+        for (unsigned int i = 0; i < n; i++)
+            seq += residues[rand() % residues.size()];
+        stringstream fasta;
+        fasta << ">target\n" << seq << "\n>template\n" << seq << "\n";
+        Alignment ali;
+        ali.loadFasta(fasta);
+
+        stringstream freq;
+        for (unsigned int i = 0; i < n; i++) {
+            double value[20], total = 0.0;
+            for (unsigned int k = 0; k < 20; k++) {
+                value[k] = (rand() % 4 == 0) ? 0.0 : rand() / (double) RAND_MAX;
+                total += value[k];
+            }
+            for (unsigned int k = 0; k < 20; k++)
+                freq << value[k] / total << " ";
+            freq << 0 << "\n";
+        }
+        Profile *pro = new Profile();
+        pro->setProfile(ali, freq);
+        return pro;
+    }
+
+    void testProfileFeatures_A() {
+        // sizes not multiple of the vector length, to test the borders
+        const unsigned int n = 13, m = 45, width = 5;
+        ProfileFeatures target(n, width), templ(m, width);
+        for (unsigned int k = 0; k < width; k++) {
+            for (unsigned int i = 0; i < n; i++)
+                target.set(k, i, rand() / (float) RAND_MAX - 0.5f);
+            for (unsigned int j = 0; j < m; j++)
+                templ.set(k, j, rand() / (float) RAND_MAX - 0.5f);
+        }
+
+        for (int kernel = ProfileFeatures::AVX2_KERNEL;
+                kernel >= ProfileFeatures::SCALAR_KERNEL; kernel--) {
+            ProfileFeatures::setKernel((ProfileFeatures::Kernel) kernel);
+            vector<float> dot, distance;
+            ProfileFeatures::dotProduct(target, templ, dot);
+            ProfileFeatures::squaredDistance(target, templ, distance);
+            CPPUNIT_ASSERT((dot.size() == n * m) && (distance.size() == n * m));
+
+            for (unsigned int i = 0; i < n; i++)
+                for (unsigned int j = 0; j < m; j++) {
+                    double d = 0.0, s = 0.0;
+                    for (unsigned int k = 0; k < width; k++) {
+                        d += target.get(k, i) * templ.get(k, j);
+                        double diff = target.get(k, i) - templ.get(k, j);
+                        s += diff * diff;
+                    }
+                    CPPUNIT_ASSERT(fabs(dot[i * m + j] - d) < 1e-5);
+                    CPPUNIT_ASSERT(fabs(distance[i * m + j] - s) < 1e-5);
+                }
+        }
+    }
+
+    void testProfileFeatures_B() {
+        const unsigned int n = 21, m = 34;
+        Profile *pro1 = makeProfile(n);
+        Profile *pro2 = makeProfile(m);
+        ScoringFunction *sf[3] = {new DotPFreq(pro1, pro2),
+            new EDistance(pro1, pro2), new Pearson(pro1, pro2)};
+
+        for (unsigned int f = 0; f < 3; f++) {
+            vector<float> matrix;
+            sf[f]->scoringSeqMatrix(n, m, matrix);
+            CPPUNIT_ASSERT(matrix.size() == n * m);
+            for (unsigned int i = 0; i < n; i++)
+                for (unsigned int j = 0; j < m; j++) {
+                    double score = sf[f]->scoringSeq(i + 1, j + 1);
+                    CPPUNIT_ASSERT(fabs(matrix[i * m + j] - score)
+                            < 1e-4 * (1.0 + fabs(score)));
+                }
+            delete sf[f];
+        }
+
+        delete pro1;
+        delete pro2;
+    }
+
+};
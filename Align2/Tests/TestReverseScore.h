@@ -0,0 +1,167 @@
+/*
+ * TestReverseScore.h
+ *
+ *  Score-only alignments, shuffled reversals on a pool of threads and the
+ *  extreme value fit of their scores.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+#include <ReverseScore.h>
+#include <NWAlign.h>
+#include <SWAlign.h>
+#include <FSAlign.h>
+#include <ScoringS2S.h>
+#include <SequenceData.h>
+#include <AGPFunction.h>
+using namespace std;
+using namespace Victor;
+using namespace Victor::Align2;
+
+class TestReverseScore : public CppUnit::TestFixture {
+private:
+    SubMatrix *sub;
+
+public:
+
+    TestReverseScore() : sub(NULL) {
+    }
+
+    virtual ~TestReverseScore() {
+        delete sub;
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestReverseScore");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestReverseScore>("Test1 - Score-only and shuffled alignments.",
+                &TestReverseScore::testReverseScore_A));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestReverseScore>("Test2 - Shuffled z-scores with threads.",
+                &TestReverseScore::testReverseScore_B));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+        string path = getenv("VICTOR_ROOT");
+        string matrixFileName = path + "Align2/Tests/data/blosum62.dat";
+        ifstream matrixFile(matrixFileName.c_str());
+        if (!matrixFile)
+            ERROR("Error opening substitution matrix file.", exception);
+        sub = new SubMatrix(matrixFile);
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+        delete sub;
+        sub = NULL;
+    }
+
+protected:
+
+    /// Random sequence of n residues.
+
+    string makeSequence(unsigned int n) {
+        const string residues = "ACDEFGHIKLMNPQRSTVWY";
+        string seq;
+        for (unsigned int i = 0; i < n; i++)
+            seq += residues[rand() % residues.size()];
+        return seq;
+    }
+
+    /// Alignment of mode 0 (global), 1 (local) or 2 (free-shift).
+
+    Align* makeAlign(unsigned int mode, AlignmentData *ad, GapFunction *gf,
+            ScoringScheme *ss) {
+        if (mode == 1)
+            return new SWAlign(ad, gf, ss);
+        if (mode == 2)
+            return new FSAlign(ad, gf, ss);
+        return new NWAlign(ad, gf, ss);
+    }
+
+    void testReverseScore_A() {
+        AGPFunction gf(10.0, 1.0);
+        srand(23);
+        string seq1 = makeSequence(45);
+        string seq2 = makeSequence(38);
+
+        vector<unsigned int> columns = ReverseScore::getShuffle(seq2.size(), 3);
+        CPPUNIT_ASSERT(columns == ReverseScore::getShuffle(seq2.size(), 3));
+        CPPUNIT_ASSERT(columns != ReverseScore::getShuffle(seq2.size(), 4));
+        vector<unsigned int> sorted = columns;
+        sort(sorted.begin(), sorted.end());
+        CPPUNIT_ASSERT(sorted == ReverseScore::getShuffle(seq2.size(), 0));
+        CPPUNIT_ASSERT((sorted.front() == 1) && (sorted.back() == seq2.size()));
+
+        string shuffled;
+        for (unsigned int j = 0; j < columns.size(); j++)
+            shuffled += seq2[columns[j] - 1];
+
+        SequenceData ad(2, seq1, seq2, "seq1", "seq2");
+        ScoringS2S ss(sub, &ad, NULL, 1.00);
+        SequenceData adShuffled(2, seq1, shuffled, "seq1", "shuffled");
+        ScoringS2S ssShuffled(sub, &adShuffled, NULL, 1.00);
+
+        for (unsigned int mode = 0; mode < 3; mode++) {
+            Align *a = makeAlign(mode, &ad, &gf, &ss);
+            Align *b = makeAlign(mode, &adShuffled, &gf, &ssShuffled);
+            CPPUNIT_ASSERT(EQUALS(a->getScoreOnly(), a->getScore()));
+            CPPUNIT_ASSERT(EQUALS(a->getScoreOnly(&columns), b->getScore()));
+            delete a;
+            delete b;
+        }
+    }
+
+    void testReverseScore_B() {
+        AGPFunction gf(12.0, 3.0);
+        srand(29);
+        string query = makeSequence(60);
+        string related = query;
+        for (unsigned int k = 0; k < 10; k++)
+            related[rand() % related.size()] = makeSequence(1)[0];
+
+        SequenceData ad(2, query, related, "query", "related");
+        ScoringS2S ss(sub, &ad, NULL, 1.00);
+        ScoringS2S reversedSs(sub, &ad, NULL, 1.00);
+        reversedSs.reverse();
+        SWAlign a(&ad, &gf, &ss);
+        SWAlign inv(&ad, &gf, &reversedSs, true);
+
+        vector<double> background[2];
+        double z[2];
+        for (unsigned int run = 0; run < 2; run++) {
+            ReverseScore rs(&a, &inv);
+            rs.setThreads(run == 0 ? 1 : 4);
+            double forward, reverse;
+            z[run] = rs.getShuffledZScore(forward, reverse, 20);
+            background[run] = rs.getBackgroundScores();
+            CPPUNIT_ASSERT(forward == a.getScore());
+            CPPUNIT_ASSERT(EQUALS(background[run][0], inv.getScore()));
+            CPPUNIT_ASSERT(rs.getPValue(forward) < 0.001);
+            CPPUNIT_ASSERT(rs.getPValue(reverse) > 0.1);
+        }
+        CPPUNIT_ASSERT(background[0] == background[1]);
+        CPPUNIT_ASSERT(background[0].size() == 20);
+        CPPUNIT_ASSERT((z[0] == z[1]) && (z[0] > 5.0));
+
+        // Gumbel fit: mean mu + 0.5772 / lambda, variance pi^2 / (6 lambda^2)
+        vector<double> scores;
+        scores.push_back(10.0);
+        scores.push_back(14.0);
+        double lambda, mu;
+        ReverseScore::fitEvd(scores, lambda, mu);
+        double sd = standardDeviation(scores);
+        CPPUNIT_ASSERT(fabs(M_PI * M_PI / (6 * lambda * lambda) - sd * sd) < 1E-6);
+        CPPUNIT_ASSERT(fabs(mu + 0.5772156649 / lambda - 12.0) < 1E-6);
+    }
+
+};
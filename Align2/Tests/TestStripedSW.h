@@ -0,0 +1,154 @@
+/*
+ * TestStripedSW.h
+ *
+ *  Striped Smith-Waterman scores against the plain recurrence, with 8 bit,
+ *  16 bit and scalar engines, and re-alignment of the hits.
+ */
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+#include <StripedSW.h>
+#include <SubMatrix.h>
+#include <AGPFunction.h>
+using namespace std;
+using namespace Victor;
+using namespace Victor::Align2;
+
+class TestStripedSW : public CppUnit::TestFixture {
+private:
+    SubMatrix *sub;
+
+public:
+
+    TestStripedSW() : sub(NULL) {
+    }
+
+    virtual ~TestStripedSW() {
+        delete sub;
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestStripedSW");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestStripedSW>("Test1 - Striped scores against plain loops.",
+                &TestStripedSW::testStripedSW_A));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestStripedSW>("Test2 - Re-alignment of hits above threshold.",
+                &TestStripedSW::testStripedSW_B));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+        string path = getenv("VICTOR_ROOT");
+        string matrixFileName = path + "Align2/Tests/data/blosum62.dat";
+        ifstream matrixFile(matrixFileName.c_str());
+        if (!matrixFile)
+            ERROR("Error opening substitution matrix file.", exception);
+        sub = new SubMatrix(matrixFile);
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+        delete sub;
+        sub = NULL;
+    }
+
+protected:
+
+    /// Random sequence of n residues.
+
+    string makeSequence(unsigned int n) {
+        const string residues = "ACDEFGHIKLMNPQRSTVWY";
+        string seq;
+        for (unsigned int i = 0; i < n; i++)
+            seq += residues[rand() % residues.size()];
+        return seq;
+    }
+
+    /// Copy of seq with about 25% substitutions and some indels.
+
+    string mutate(const string &seq) {
+        string mutant = "";
+        for (unsigned int i = 0; i < seq.size(); i++) {
+            int r = rand() % 100;
+            if (r < 4)
+                continue;
+            if (r < 7)
+                mutant += makeSequence(1);
+            mutant += (r < 30) ? makeSequence(1) : seq.substr(i, 1);
+        }
+        return mutant;
+    }
+
+    void testStripedSW_A() {
+        AGPFunction gf(12.0, 3.0);
+        bool engine[3] = {false, false, false};
+        srand(7);
+
+        for (unsigned int t = 0; t < 40; t++) {
+            string query = makeSequence(1 + rand() % 200);
+            string target = (t % 2) ? mutate(query) : makeSequence(1 + rand() % 200);
+            StripedSW sw(sub, &gf, query);
+            double score = sw.getScore(target);
+            engine[sw.getLastEngine()] = true;
+            CPPUNIT_ASSERT(score == sw.getScalarScore(target));
+        }
+
+        // saturates 8 bits
+        string query = makeSequence(150);
+        StripedSW sw(sub, &gf, query);
+        double score = sw.getScore(query);
+        engine[sw.getLastEngine()] = true;
+        CPPUNIT_ASSERT(sw.getLastEngine() == StripedSW::WORD_ENGINE);
+        CPPUNIT_ASSERT(score == sw.getScalarScore(query));
+
+        // saturates 16 bits (W-W scores 11)
+        string longQuery(3000, 'W');
+        StripedSW longSw(sub, &gf, longQuery);
+        CPPUNIT_ASSERT(longSw.getScore(longQuery) == 33000);
+        CPPUNIT_ASSERT(longSw.getLastEngine() == StripedSW::SCALAR_ENGINE);
+
+        // non-integer penalties use plain loops
+        AGPFunction fractional(10.5, 1.0);
+        StripedSW fractionalSw(sub, &fractional, query);
+        fractionalSw.getScore(query);
+        CPPUNIT_ASSERT(fractionalSw.getLastEngine() == StripedSW::SCALAR_ENGINE);
+
+        CPPUNIT_ASSERT(engine[StripedSW::WORD_ENGINE]);
+#if defined(__x86_64__) || defined(__i386__)
+        CPPUNIT_ASSERT(engine[StripedSW::BYTE_ENGINE]);
+#endif
+    }
+
+    void testStripedSW_B() {
+        AGPFunction gf(12.0, 3.0);
+        srand(11);
+        string query = makeSequence(120);
+        StripedSW sw(sub, &gf, query);
+
+        vector<string> match;
+        double score = -1.0;
+        string unrelated = makeSequence(120);
+        double threshold = sw.getScore(unrelated) + 1.0;
+        CPPUNIT_ASSERT(!sw.realign(unrelated, threshold, match, score));
+        CPPUNIT_ASSERT(match.empty());
+
+        string related = mutate(query);
+        double stripedScore = sw.getScore(related);
+        CPPUNIT_ASSERT(stripedScore >= threshold);
+        CPPUNIT_ASSERT(sw.realign(related, threshold, match, score));
+        CPPUNIT_ASSERT(match.size() == 2);
+        CPPUNIT_ASSERT((match[0].size() == match[1].size()) && !match[0].empty());
+        CPPUNIT_ASSERT((score > 0) && (score <= stripedScore));
+    }
+
+};
@@ -0,0 +1,150 @@
+/*
+ * TestTemplateSearch.h
+ *
+ *  One-vs-many search: ranking of related templates, z-scores and
+ *  independence of the results from the number of threads.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+#include <TemplateSearch.h>
+#include <ReverseScore.h>
+#include <NWAlign.h>
+#include <ScoringS2S.h>
+#include <SequenceData.h>
+#include <AGPFunction.h>
+using namespace std;
+using namespace Victor;
+using namespace Victor::Align2;
+
+class TestTemplateSearch : public CppUnit::TestFixture {
+private:
+    SubMatrix *sub;
+
+public:
+
+    TestTemplateSearch() : sub(NULL) {
+    }
+
+    virtual ~TestTemplateSearch() {
+        delete sub;
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestTemplateSearch");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestTemplateSearch>("Test1 - Ranking of related templates.",
+                &TestTemplateSearch::testTemplateSearch_A));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestTemplateSearch>("Test2 - Same hits with threads and z-scores.",
+                &TestTemplateSearch::testTemplateSearch_B));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+        string path = getenv("VICTOR_ROOT");
+        string matrixFileName = path + "Align2/Tests/data/blosum62.dat";
+        ifstream matrixFile(matrixFileName.c_str());
+        if (!matrixFile)
+            ERROR("Error opening substitution matrix file.", exception);
+        sub = new SubMatrix(matrixFile);
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+        delete sub;
+        sub = NULL;
+    }
+
+protected:
+
+    /// Random sequence of n residues.
+
+    string makeSequence(unsigned int n) {
+        const string residues = "ACDEFGHIKLMNPQRSTVWY";
+        string seq;
+        for (unsigned int i = 0; i < n; i++)
+            seq += residues[rand() % residues.size()];
+        return seq;
+    }
+
+    /// Database of 12 templates, related to query at positions 2, 5 and 9.
+
+    void fill(TemplateSearch &search, const string &query) {
+        for (unsigned int i = 0; i < 12; i++)
+            if ((i == 2) || (i == 5) || (i == 9)) {
+                string related = query;
+                for (unsigned int k = 0; k < query.size() / (i + 2); k++)
+                    related[rand() % related.size()] = makeSequence(1)[0];
+                search.addTemplate("related", related);
+            } else
+                search.addTemplate("random", makeSequence(40 + rand() % 40));
+    }
+
+    void testTemplateSearch_A() {
+        AGPFunction gf(12.0, 3.0);
+        srand(13);
+        string query = makeSequence(60);
+        TemplateSearch search(sub, &gf, "query", query);
+        fill(search, query);
+        search.alignQueued();
+
+        CPPUNIT_ASSERT(search.size() == 12);
+        vector<TemplateSearch::Hit> hits = search.getHits(3);
+        CPPUNIT_ASSERT(hits.size() == 3);
+        for (unsigned int i = 0; i < hits.size(); i++) {
+            CPPUNIT_ASSERT(hits[i].name == "related");
+            CPPUNIT_ASSERT(hits[i].match.size() == 2);
+        }
+        CPPUNIT_ASSERT((hits[0].score >= hits[1].score)
+                && (hits[1].score >= hits[2].score));
+
+        // residues unknown to the matrix do not abort the search
+        CPPUNIT_ASSERT(TemplateSearch::getCleanSequence(sub, "acd*j") == "ACDXX");
+    }
+
+    void testTemplateSearch_B() {
+        AGPFunction gf(12.0, 3.0);
+        string query = makeSequence(50);
+        vector<TemplateSearch::Hit> hits[2];
+
+        for (unsigned int run = 0; run < 2; run++) {
+            srand(17);
+            TemplateSearch search(sub, &gf, "query", query);
+            search.setMode(TemplateSearch::LOCAL_MODE);
+            search.setZScore(10);
+            search.setThreads(run == 0 ? 1 : 3);
+            fill(search, query);
+            search.alignQueued();
+            hits[run] = search.getHits();
+        }
+
+        CPPUNIT_ASSERT(hits[0].size() == 12);
+        CPPUNIT_ASSERT(hits[0].size() == hits[1].size());
+        for (unsigned int i = 0; i < hits[0].size(); i++) {
+            CPPUNIT_ASSERT(hits[0][i].index == hits[1][i].index);
+            CPPUNIT_ASSERT(hits[0][i].score == hits[1][i].score);
+            CPPUNIT_ASSERT(hits[0][i].zScore == hits[1][i].zScore);
+        }
+        CPPUNIT_ASSERT(hits[0][0].name == "related");
+        CPPUNIT_ASSERT(hits[0][0].zScore > hits[0][3].zScore);
+
+        // ReverseScore copying a sequence-only alignment
+        SequenceData ad(2, query, query, "query", "query");
+        ScoringS2S ss(sub, &ad, NULL, 1.00);
+        NWAlign a(&ad, &gf, &ss);
+        ReverseScore rs(&a);
+        double forward, reverse;
+        CPPUNIT_ASSERT(rs.getZScore(forward, reverse, 10) > 0);
+        CPPUNIT_ASSERT(forward == a.getScore());
+    }
+
+};
@@ -0,0 +1,106 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ */
+#include <Protein.h>
+#include <PdbLoader.h>
+#include <BinSaver.h>
+#include <IoTools.h>
+#include <GetArg.h>
+
+using namespace Victor;using namespace Victor::Biopool;
+
+void sShowHelp() {
+    cout << "Pdb 2 Bin -- converts a PDB file into a binary structure file,\n"
+            << "loaded by BinLoader without parsing the PDB file again\n"
+            << " Options: \n"
+            << "\t-i <filename> \t Input PDB file\n"
+            << "\t-o <filename> \t Output binary file\n"
+            << "\t-c <id>       \t Chain identifier to read\n"
+            << "\t--all         \t All chains\n"
+            << "\t-m <number>   \t Model number to read (NMR only, default is first model)\n"
+            << "\t--noH         \t Without hydrogens (nor DSSP)\n"
+            << "\t-v            \t verbose output\n\n"
+            << "\tIf both -c and --all are missing, only the first chain is processed.\n\n";
+
+}
+
+int main(int argc, char* argv[]) {
+
+    if (getArg("h", argc, argv)) {
+        sShowHelp();
+        return 1;
+    }
+
+    string inputFile, outputFile, chainID;
+    unsigned int modelNum;
+    bool all;
+
+    getArg("i", inputFile, argc, argv, "!");
+    getArg("o", outputFile, argc, argv, "!");
+    getArg("c", chainID, argc, argv, "!");
+    getArg("m", modelNum, argc, argv, 999);
+    all = getArg("-all", argc, argv);
+
+    // Check input and output files
+    if ((inputFile == "!") || (outputFile == "!")) {
+        cout << "Missing file specification. Aborting. (-h for help)" << endl;
+        return -1;
+    }
+    ifstream inFile(inputFile.c_str());
+    if (!inFile)
+        ERROR("Input file not found.", exception);
+
+
+    PdbLoader pl(inFile);
+
+    // Set PdbLoader variables
+    pl.setModel(modelNum);
+    if (getArg("-noH", argc, argv))
+        pl.setNoHAtoms();
+    if (!getArg("v", argc, argv)) {
+        pl.setNoVerbose();
+    }
+
+    // Check chain args
+    if ((chainID != "!") && all) {
+        ERROR("You can use --all or -c, not both", error);
+    }
+    // User selected chain
+    if (chainID != "!") {
+        if (chainID.size() > 1)
+            ERROR("You can choose only 1 chain", error);
+        pl.setChain(chainID[0]);
+    }// All chains
+    else if (all) {
+        pl.setAllChains();
+    }// First chain
+    else {
+        pl.setChain(pl.getAllChains()[0]);
+    }
+
+    // Load the protein object
+    Protein prot;
+    prot.load(pl);
+
+    ofstream fout(outputFile.c_str(), ios::out | ios::binary);
+    if (!fout)
+        ERROR("Could not open file for writing.", exception);
+    BinSaver bs(fout);
+    prot.save(bs);
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+@Description Throughput of PDB reading and ATOM record parsing, in MB/s, on
+ an ensemble built by repeating the atoms of a PDB file as models.
+ */
+#include <string>
+#include <sstream>
+#include <cstring>
+#include <sys/time.h>
+#include <GetArg.h>
+#include <IoTools.h>
+#include <String2Number.h>
+#include <PdbFile.h>
+#include <PdbLoader.h>
+#include <Protein.h>
+
+using namespace Victor;using namespace Victor::Biopool;
+
+void sShowHelp() {
+    cout << "PDB Bench\n"
+            << "Times reading and ATOM record parsing of a large PDB ensemble.\n"
+            << " Options: \n"
+            << "\t[-i <filename>] \t Input PDB file (def = samples/1DP5.pdb)\n"
+            << "\t[-n <number>] \t\t Number of models of the ensemble (def = 50)\n"
+            << "\n";
+}
+
+double sNow() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+void sReport(string label, double bytes, double elapsed, double check) {
+    cout << setw(28) << label << "\t s= " << setprecision(4) << elapsed
+            << "\t MB/s= " << setprecision(4) << bytes / elapsed / 1.0e6
+            << "\t (checksum " << setprecision(10) << check << ")\n";
+}
+
+/**
+ *  Fields of a record as PdbLoader read them before PdbFile::parseAtomRecord()
+ */
+double sParseSubstr(const string& atomLine) {
+    int atNum = stoiDEF(atomLine.substr(6, 5));
+    int aaNum = stoiDEF(atomLine.substr(22, 4));
+    char altAaID = atomLine.substr(26, 1)[0];
+    double x = stodDEF(atomLine.substr(30, 8));
+    double y = stodDEF(atomLine.substr(38, 8));
+    double z = stodDEF(atomLine.substr(46, 8));
+    double bfac = 0.0;
+    if (atomLine.length() >= 66)
+        if (atomLine.substr(60, 6) != "      ")
+            bfac = stodDEF(atomLine.substr(60, 6));
+    string atType = "";
+    for (int i = 11; i < 17; i++)
+        if (atomLine[i] != ' ')
+            atType.append(atomLine.substr(i, 1));
+    string aaType = "";
+    for (int i = 17; i < 20; i++)
+        if (atomLine[i] != ' ')
+            aaType.append(atomLine.substr(i, 1));
+    return atNum + aaNum + altAaID + x + y + z + bfac + atType.size()
+            + aaType.size();
+}
+
+int main(int nArgs, char* argv[]) {
+    if (getArg("h", nArgs, argv)) {
+        sShowHelp();
+        return 1;
+    };
+
+    string inputFile;
+    unsigned int models;
+    getArg("i", inputFile, nArgs, argv, "!");
+    getArg("n", models, nArgs, argv, 50);
+
+    if (inputFile == "!") {
+        char* victor = getenv("VICTOR_ROOT");
+        if (victor == NULL)
+            ERROR("Environment variable VICTOR_ROOT was not found.", exception);
+        inputFile = string(victor) + "samples/1DP5.pdb";
+    }
+
+    ifstream inFile(inputFile.c_str());
+    if (!inFile)
+        ERROR("File does not exist.\n", exception);
+    PdbFile pdb;
+    pdb.readFile(inFile);
+    inFile.close();
+    if ((pdb.sizeBuffer() == 0) || (models == 0))
+        ERROR("Nothing to benchmark.", exception);
+
+    // the atom records of the file, repeated as models
+    ostringstream os;
+    os << pdb.getHeader() << "\n";
+    vector<string> atoms;
+    for (unsigned int i = 0; i < pdb.sizeBlocks(); i++)
+        if (pdb.getBlock(i).model == pdb.getFirstModel()) {
+            vector<PdbFile::Line> lines = pdb.getAtomLines(pdb.getBlock(i).chain,
+                    pdb.getFirstModel());
+            for (unsigned int j = 0; j < lines.size(); j++)
+                atoms.push_back(string(lines[j].data, lines[j].length));
+            break;
+        }
+    for (unsigned int m = 1; m <= models; m++) {
+        os << "MODEL     " << setw(4) << m << "\n";
+        for (unsigned int j = 0; j < atoms.size(); j++)
+            os << atoms[j] << "\n";
+        os << "ENDMDL\n";
+    }
+    os << "END\n";
+    string text = os.str();
+    double bytes = text.size();
+    cout << "Ensemble of " << models << " models, " << models * atoms.size()
+            << " atom records, " << setprecision(4) << bytes / 1.0e6 << " MB\n";
+
+    // reading lines
+    double start = sNow();
+    istringstream in1(text);
+    double check = 0;
+    while (in1) {
+        string line = readLine(in1);
+        check += line.size();
+    }
+    sReport("readLine()", bytes, sNow() - start, check);
+
+    start = sNow();
+    istringstream in2(text);
+    PdbFile ensemble;
+    ensemble.readFile(in2);
+    sReport("PdbFile::readFile()", bytes, sNow() - start, ensemble.sizeBuffer());
+
+    start = sNow();
+    PdbFile inPlace;
+    inPlace.readBuffer(text.data(), text.size());
+    sReport("PdbFile::readBuffer()", bytes, sNow() - start, inPlace.sizeBlocks());
+
+    // parsing the fields of every atom record
+    vector<PdbFile::Line> lines;
+    for (unsigned int m = 1; m <= models; m++) {
+        for (unsigned int c = 0; c < ensemble.getChains().size(); c++) {
+            vector<PdbFile::Line> chain = ensemble.getAtomLines(
+                    ensemble.getChains()[c], m);
+            lines.insert(lines.end(), chain.begin(), chain.end());
+        }
+    }
+    double recordBytes = 0;
+    vector<string> copies(lines.size());
+    for (unsigned int i = 0; i < lines.size(); i++) {
+        copies[i] = string(lines[i].data, lines[i].length);
+        recordBytes += lines[i].length + 1;
+    }
+
+    start = sNow();
+    check = 0;
+    for (unsigned int i = 0; i < copies.size(); i++)
+        check += sParseSubstr(copies[i]);
+    sReport("substr() + String2Number", recordBytes, sNow() - start, check);
+
+    start = sNow();
+    check = 0;
+    PdbFile::AtomRecord rec;
+    for (unsigned int i = 0; i < lines.size(); i++)
+        if (PdbFile::parseAtomRecord(lines[i].data, lines[i].length, rec))
+            check += rec.serial + rec.resSeq + rec.iCode + rec.x + rec.y
+                + rec.z + rec.bFactor + strlen(rec.name) + strlen(rec.resName);
+    sReport("PdbFile::parseAtomRecord()", recordBytes, sNow() - start, check);
+
+    // whole loader, last model only
+    start = sNow();
+    istringstream in3(text);
+    PdbLoader pl(in3);
+    pl.setNoHAtoms();
+    pl.setNoVerbose();
+    pl.setNoSecondary();
+    pl.setAllChains();
+    pl.setModel(models);
+    Protein prot;
+    prot.load(pl);
+    sReport("PdbLoader, one model", bytes, sNow() - start, prot.sizeProtein());
+
+    return 0;
+}
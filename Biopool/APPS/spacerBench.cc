@@ -0,0 +1,123 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+@Description Microbenchmark for Spacer::getAmino on a long chain, both flat
+ and split into sub-spacers.
+ */
+#include <string>
+#include <sys/time.h>
+#include <GetArg.h>
+#include <PdbLoader.h>
+#include <Protein.h>
+
+using namespace Victor;using namespace Victor::Biopool;
+
+void sShowHelp() {
+    cout << "Spacer Bench\n"
+            << "Times Spacer::getAmino() over a chain built from a PDB file.\n"
+            << " Options: \n"
+            << "\t[-i <filename>] \t Input PDB file (def = samples/1DP5.pdb)\n"
+            << "\t[-n <number>] \t\t Number of residues in the chain (def = 1000)\n"
+            << "\t[-r <number>] \t\t Number of sweeps over the chain (def = 1000)\n"
+            << "\t[-s <number>] \t\t Residues per sub-spacer (def = 10)\n"
+            << "\n";
+}
+
+double sNow() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/**
+ *  Sweeps the chain with getAmino() and prints the time per call
+ */
+void sTimeGetAmino(Spacer& sp, unsigned int rounds, string label) {
+    unsigned long check = 0;
+    unsigned int size = sp.sizeAmino();
+    for (unsigned int i = 0; i < size; i++) // warm-up, not timed
+        check += sp.getAmino(i).size();
+    check = 0;
+
+    double start = sNow();
+    for (unsigned int r = 0; r < rounds; r++)
+        for (unsigned int i = 0; i < size; i++)
+            check += sp.getAmino(i).size();
+    double elapsed = sNow() - start;
+
+    cout << setw(12) << label << "\t residues= " << size
+            << "\t sub-spacers= " << sp.sizeSpacer()
+            << "\t ns/call= " << setprecision(4)
+            << elapsed * 1e9 / (static_cast<double> (rounds) * size)
+            << "\t (checksum " << check << ")\n";
+}
+
+int main(int nArgs, char* argv[]) {
+    if (getArg("h", nArgs, argv)) {
+        sShowHelp();
+        return 1;
+    };
+
+    string inputFile;
+    unsigned int length, rounds, block;
+    getArg("i", inputFile, nArgs, argv, "!");
+    getArg("n", length, nArgs, argv, 1000);
+    getArg("r", rounds, nArgs, argv, 1000);
+    getArg("s", block, nArgs, argv, 10);
+
+    if (inputFile == "!") {
+        char* victor = getenv("VICTOR_ROOT");
+        if (victor == NULL)
+            ERROR("Environment variable VICTOR_ROOT was not found.", exception);
+        inputFile = string(victor) + "samples/1DP5.pdb";
+    }
+
+    ifstream inFile(inputFile.c_str());
+    if (!inFile)
+        ERROR("File does not exist.\n", exception);
+    PdbLoader pl(inFile);
+    pl.setNoHAtoms();
+    pl.setNoVerbose();
+    Protein prot;
+    prot.load(pl);
+    inFile.close();
+
+    if ((prot.sizeProtein() == 0) || (prot.getSpacer(0u)->sizeAmino() == 0)
+            || (length == 0) || (block == 0))
+        ERROR("Nothing to benchmark.", exception);
+    Spacer& ref = *prot.getSpacer(0u);
+
+    // build the chain by replicating the residues of the reference:
+    Spacer sp;
+    for (unsigned int i = 0; i < length; i++)
+        sp.insertComponent(ref.getAmino(i % ref.sizeAmino()).clone());
+
+    sTimeGetAmino(sp, rounds, "flat");
+
+    // group consecutive residues into sub-spacers, starting from the end
+    // so that the component indexes still to be split are not shifted:
+    for (int i = ((length - 1) / block) * block; i >= 0; i -= block) {
+        unsigned int end = i + block - 1;
+        if (end >= length)
+            end = length - 1;
+        if (end > static_cast<unsigned int> (i))
+            sp.splitSpacer(i, end);
+    }
+
+    sTimeGetAmino(sp, rounds, "sub-spacers");
+
+    return 0;
+}
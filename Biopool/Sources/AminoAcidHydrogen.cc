@@ -31,11 +31,16 @@ map<AminoAcidCode, vector<vector<string> > > AminoAcidHydrogen::paramH;
 
 /**
  *    Load a file "AminoAcidHydrogenData.txt", containing angles and reference atoms to build hydrogens. 
+ *    The parameters are read only once, later calls do nothing. After the first
+ *    call they are only read, so structures can be loaded from concurrent threads.
  *@param   string inputFile name
  *@return  void
  */
 void
 AminoAcidHydrogen::loadParam(string inputFile) {
+    if (!paramH.empty())
+        return;
+
     ifstream input(inputFile.c_str());
     if (!input)
         ERROR("File not found.", exception);
@@ -108,7 +113,11 @@ AminoAcidHydrogen::setHydrogen(AminoAcid* aa, bool verbose) {
 
     }
 
-    vector<vector<string > > paramList = paramH[aaCode];
+    map<AminoAcidCode, vector<vector<string> > >::const_iterator param =
+            paramH.find(aaCode);
+    vector<vector<string > > paramList;
+    if (param != paramH.end())
+        paramList = param->second;
     vector<string> args;
 
 
@@ -42,7 +42,7 @@ modified(false) {
  *  Constructor. Copy another Atom object.
  *@param Atom
  */
-Atom::Atom(const Atom& orig) {
+Atom::Atom(const Atom& orig) : SimpleBond(), superior(NULL), modified(false) {
     PRINT_NAME;
     this->copy(orig);
 }
@@ -64,8 +64,10 @@ Atom::~Atom() {
  */
 double
 Atom::distance(Atom& other) {
-    sync();
-    other.sync();
+    if (modified)
+        sync();
+    if (other.modified)
+        other.sync();
 
     double tmp = sqrt(
             (coords[0] - other.coords[0]) * (coords[0] - other.coords[0])
@@ -147,7 +149,7 @@ Atom::copy(const Atom& orig) {
 void
 Atom::sync() 
 {
-    if (inSync())
+    if (!modified)
         return;
 
     vgMatrix3<double> tmpMatrix(1);
@@ -175,13 +177,15 @@ Atom::sync()
 
 /**
  *   Set the "Modified" flag. Sync() will syncronize only if "Modified" is true.
- *
+ * The group is told too, so that Spacer::sync() knows which residues to visit.
  */
 void
 Atom::setModified() {
     if (modified)
         return;
     modified = true;
+    if (superior != NULL)
+        superior->setAtomsModified();
 
     for (unsigned int i = 0; i < sizeOutBonds(); i++)
         getOutBond(i).setModified();
@@ -219,6 +223,7 @@ Atom&
  * NB:  Cyclic structures (PRO, PHE, TYR, TRP & HIS) are special cases 
  *  when propagating the rotation, because the the re-conjunction of 
  *  two branches, the rotation would be added twice.
+ *  The atom codes are tested before the residue type, which is a string.
  */
 
 void
@@ -229,18 +234,17 @@ Atom::propagateRotation() {
 
     for (unsigned int i = 0; i < sizeOutBonds(); i++)
         if (!hasSuperior() ||
-                (!((getSuperior().getType() == "PRO") && (getCode() == CD)
-                && (getOutBond(i).getCode() == N))
-                && !((getSuperior().getType() == "PHE") && (getCode() == CE2)
-                && (getOutBond(i).getCode() == CZ))
-                && !((getSuperior().getType() == "TYR") && (getCode() == CE2)
-                && (getOutBond(i).getCode() == CZ))
-                && !((getSuperior().getType() == "TRP") && (getCode() == NE1)
-                && (getOutBond(i).getCode() == CE2))
-                && !((getSuperior().getType() == "TRP") && (getCode() == CZ3)
-                && (getOutBond(i).getCode() == CH2))
-                && !((getSuperior().getType() == "HIS" && (getCode() == CE1)
-                && (getOutBond(i).getCode() == NE2)))
+                (!((getCode() == CD) && (getOutBond(i).getCode() == N)
+                && (getSuperior().getType() == "PRO"))
+                && !((getCode() == CE2) && (getOutBond(i).getCode() == CZ)
+                && ((getSuperior().getType() == "PHE")
+                || (getSuperior().getType() == "TYR")))
+                && !((getCode() == NE1) && (getOutBond(i).getCode() == CE2)
+                && (getSuperior().getType() == "TRP"))
+                && !((getCode() == CZ3) && (getOutBond(i).getCode() == CH2)
+                && (getSuperior().getType() == "TRP"))
+                && !((getCode() == CE1) && (getOutBond(i).getCode() == NE2)
+                && (getSuperior().getType() == "HIS"))
                 )
                 ) {
             getOutBond(i).addRot(rot);
@@ -259,8 +263,8 @@ Atom::propagateRotation() {
 
 inline bool
 Atom::isNotFirstAtomInStructure() {
-    if (sizeInBonds() && !((getSuperior().getType() == "PRO")
-            && (getCode() == N) && (getInBond(0).getCode() == CD)))
+    if (sizeInBonds() && !((getCode() == N) && (getInBond(0).getCode() == CD)
+            && (getSuperior().getType() == "PRO")))
         
         return true;
     else
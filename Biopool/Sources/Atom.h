@@ -143,7 +143,7 @@ namespace Victor { namespace Biopool {
 
     inline vgVector3<double>
     Atom::getCoords() {
-        if (!inSync())
+        if (modified)
             sync();
         return coords;
     }
@@ -0,0 +1,340 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <BackboneBuilder.h>
+#include <Spacer.h>
+#include <IntCoordConverter.h>
+#include <Debug.h>
+#include <math.h>
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// Global constants, typedefs, etc. (to avoid):
+
+/**
+ *  Angle at b between a and c, in radians.
+ */
+static double
+sAngle(const vgVector3<double>& a, const vgVector3<double>& b,
+        const vgVector3<double>& c) {
+    return angle(a - b, c - b);
+}
+
+/**
+ *  Torsion angle of a, b, c, d about b-c, in radians, with the sign used
+ * by IntCoordConverter::getTorsionAngle().
+ */
+static double
+sTorsion(const vgVector3<double>& a, const vgVector3<double>& b,
+        const vgVector3<double>& c, const vgVector3<double>& d) {
+    vgVector3<double> b1 = b - a;
+    vgVector3<double> b2 = c - b;
+    vgVector3<double> b3 = d - c;
+    vgVector3<double> n1 = b1.cross(b2);
+    vgVector3<double> n2 = b2.cross(b3);
+    return atan2(b2.length() * (b1 * n2), n1 * n2);
+}
+
+/**
+ *  Places atom d of nv variants from the three atoms a, b, c before it.
+ * The nv variants of an atom are contiguous, b starts at a + nv and c at
+ * a + 2 nv. The loop has no calls and no dependency between iterations;
+ * __restrict__ tells the compiler that d is never read through a, b or
+ * c, so that it vectorizes the loop.
+ *@param along, across, bond length times -cos and sin of the bond angle
+ *@param ct, st, cos and sin of the torsions of d
+ */
+static void
+sPlace(unsigned int nv, double along, double across,
+        const double* __restrict__ ct, const double* __restrict__ st,
+        const double* __restrict__ ax, const double* __restrict__ ay,
+        const double* __restrict__ az, double* __restrict__ dx,
+        double* __restrict__ dy, double* __restrict__ dz) {
+    const double* bx = ax + nv;
+    const double* by = ay + nv;
+    const double* bz = az + nv;
+    const double* cx = bx + nv;
+    const double* cy = by + nv;
+    const double* cz = bz + nv;
+
+    for (unsigned int v = 0; v < nv; v++) {
+        double bcx = cx[v] - bx[v];
+        double bcy = cy[v] - by[v];
+        double bcz = cz[v] - bz[v];
+        double inv = 1.0 / sqrt(bcx * bcx + bcy * bcy + bcz * bcz);
+        bcx *= inv;
+        bcy *= inv;
+        bcz *= inv;
+
+        double abx = bx[v] - ax[v];
+        double aby = by[v] - ay[v];
+        double abz = bz[v] - az[v];
+        double nx = aby * bcz - abz * bcy;
+        double ny = abz * bcx - abx * bcz;
+        double nz = abx * bcy - aby * bcx;
+        inv = 1.0 / sqrt(nx * nx + ny * ny + nz * nz);
+        nx *= inv;
+        ny *= inv;
+        nz *= inv;
+
+        double mx = ny * bcz - nz * bcy;
+        double my = nz * bcx - nx * bcz;
+        double mz = nx * bcy - ny * bcx;
+
+        double u = across * ct[v];
+        double w = across * st[v];
+        dx[v] = cx[v] + along * bcx + u * mx + w * nx;
+        dy[v] = cy[v] + along * bcy + u * my + w * ny;
+        dz[v] = cz[v] + along * bcz + u * mz + w * nz;
+    }
+}
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Basic constructor, creates an empty chain of one variant
+ */
+BackboneBuilder::BackboneBuilder() : nVariants(1), length(), angle(),
+torsion(), cosTorsion(), sinTorsion(), x(), y(), z() {
+    PRINT_NAME;
+}
+
+/**
+ *  Basic destructor
+ */
+BackboneBuilder::~BackboneBuilder() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *@param i, atom index, at least 1
+ *@return length of the bond between atoms i - 1 and i
+ */
+double BackboneBuilder::getBondLength(unsigned int i) const {
+    PRECOND((i >= 1) && (i < size()), exception);
+    return length[i];
+}
+
+/**
+ *@param i, atom index, at least 2
+ *@return angle between atoms i - 2, i - 1 and i, in degrees
+ */
+double BackboneBuilder::getBondAngle(unsigned int i) const {
+    PRECOND((i >= 2) && (i < size()), exception);
+    return RAD2DEG * angle[i];
+}
+
+/**
+ *@param i, atom index, at least 3
+ *@param v, variant
+ *@return torsion angle of atoms i - 3 .. i, in degrees
+ */
+double BackboneBuilder::getTorsion(unsigned int i, unsigned int v) const {
+    PRECOND((i >= 3) && (i < size()) && (v < nVariants), exception);
+    return RAD2DEG * torsion[pIndex(i, v)];
+}
+
+/**
+ *@param n, residue, at least 1
+ */
+double BackboneBuilder::getPhi(unsigned int n, unsigned int v) const {
+    return getTorsion(3 * n + 2, v);
+}
+
+/**
+ *@param n, residue, not the last one
+ */
+double BackboneBuilder::getPsi(unsigned int n, unsigned int v) const {
+    return getTorsion(3 * n + 3, v);
+}
+
+/**
+ *@param n, residue, not the last one
+ */
+double BackboneBuilder::getOmega(unsigned int n, unsigned int v) const {
+    return getTorsion(3 * n + 4, v);
+}
+
+/**
+ *  Coordinates of atom i of variant v, as of the last build().
+ */
+vgVector3<double> BackboneBuilder::getCoords(unsigned int i, unsigned int v) const {
+    PRECOND((i < size()) && (v < nVariants), exception);
+    unsigned int k = pIndex(i, v);
+    return vgVector3<double>(x[k], y[k], z[k]);
+}
+
+// MODIFIERS:
+
+/**
+ *  Sets up an extended chain (all torsions 180) of standard geometry, see
+ * the Spacer::BOND_* constants, starting at the origin.
+ *@param nAmino, number of residues
+ */
+void BackboneBuilder::setIdeal(unsigned int nAmino) {
+    pResize(3 * nAmino);
+    for (unsigned int n = 0; n < nAmino; n++) {
+        length[3 * n] = Spacer::BOND_LENGTH_CPRIME_TO_N;
+        length[3 * n + 1] = Spacer::BOND_LENGTH_N_TO_CALPHA;
+        length[3 * n + 2] = Spacer::BOND_LENGTH_CALPHA_TO_CPRIME;
+        angle[3 * n] = DEG2RAD * Spacer::BOND_ANGLE_AT_CPRIME_TO_N;
+        angle[3 * n + 1] = DEG2RAD * Spacer::BOND_ANGLE_AT_N_TO_CALPHA;
+        angle[3 * n + 2] = DEG2RAD * Spacer::BOND_ANGLE_AT_CALPHA_TO_CPRIME;
+    }
+    for (unsigned int k = 0; k < torsion.size(); k++)
+        torsion[k] = M_PI;
+
+    double ca = Spacer::BOND_LENGTH_N_TO_CALPHA;
+    double c = Spacer::BOND_LENGTH_CALPHA_TO_CPRIME;
+    double a = DEG2RAD * Spacer::BOND_ANGLE_AT_CALPHA_TO_CPRIME;
+    setStart(vgVector3<double>(0, 0, 0), vgVector3<double>(ca, 0, 0),
+            vgVector3<double>(ca - c * cos(a), c * sin(a), 0));
+}
+
+/**
+ *  Takes the internal coordinates, and the position of the first residue,
+ * from the backbone of residues first .. last. build() then reproduces
+ * their N, CA and C coordinates. Keeps one variant.
+ *@param sp, reference to the spacer
+ *@param first, last, residue range
+ */
+void BackboneBuilder::setFromSpacer(Spacer& sp, unsigned int first,
+        unsigned int last) {
+    PRECOND((first <= last) && (last < sp.sizeAmino()), exception);
+    nVariants = 1;
+    pResize(3 * (last - first + 1));
+
+    vector<vgVector3<double> > p;
+    p.reserve(size());
+    for (unsigned int n = first; n <= last; n++) {
+        AminoAcid& aa = sp.getAmino(n);
+        p.push_back(aa[N].getCoords());
+        p.push_back(aa[CA].getCoords());
+        p.push_back(aa[C].getCoords());
+    }
+
+    for (unsigned int i = 1; i < p.size(); i++)
+        length[i] = (p[i] - p[i - 1]).length();
+    for (unsigned int i = 2; i < p.size(); i++)
+        angle[i] = sAngle(p[i - 2], p[i - 1], p[i]);
+    for (unsigned int i = 3; i < p.size(); i++)
+        torsion[i] = sTorsion(p[i - 3], p[i - 2], p[i - 1], p[i]);
+
+    setStart(p[0], p[1], p[2]);
+}
+
+/**
+ *  Sets the position of the first residue, which build() does not move.
+ */
+void BackboneBuilder::setStart(const vgVector3<double>& n,
+        const vgVector3<double>& ca, const vgVector3<double>& c) {
+    start[0] = n;
+    start[1] = ca;
+    start[2] = c;
+}
+
+/**
+ *  Sets the number of variants. Every variant starts with the torsions of
+ * the first one.
+ */
+void BackboneBuilder::setVariants(unsigned int n) {
+    PRECOND(n > 0, exception);
+    vector<double> old(torsion);
+    unsigned int oldVariants = nVariants;
+    nVariants = n;
+    pResize(size());
+    for (unsigned int i = 0; i < size(); i++)
+        for (unsigned int v = 0; v < nVariants; v++)
+            torsion[pIndex(i, v)] = old[i * oldVariants];
+}
+
+/**
+ *@param i, atom index, at least 3
+ *@param a, torsion angle of atoms i - 3 .. i, in degrees
+ *@param v, variant
+ */
+void BackboneBuilder::setTorsion(unsigned int i, double a, unsigned int v) {
+    PRECOND((i >= 3) && (i < size()) && (v < nVariants), exception);
+    torsion[pIndex(i, v)] = DEG2RAD * a;
+}
+
+void BackboneBuilder::setPhi(unsigned int n, double a, unsigned int v) {
+    setTorsion(3 * n + 2, a, v);
+}
+
+void BackboneBuilder::setPsi(unsigned int n, double a, unsigned int v) {
+    setTorsion(3 * n + 3, a, v);
+}
+
+void BackboneBuilder::setOmega(unsigned int n, double a, unsigned int v) {
+    setTorsion(3 * n + 4, a, v);
+}
+
+/**
+ *  Places all atoms of all variants. Atom i goes at its bond length from
+ * atom i - 1, in the frame of atoms i - 3 .. i - 1:
+ *
+ *      bc = unit(c - b), n = unit((b - a) x bc), m = n x bc
+ *      d  = c + bc * (-l cos(angle)) + m * (l sin(angle) cos(torsion))
+ *             + n * (l sin(angle) sin(torsion))
+ *
+ *  Atoms are visited in chain order, the variants of one atom at once by
+ * sPlace(). The trigonometry of the torsions is done beforehand, so that
+ * the placing loop has no calls.
+ */
+void BackboneBuilder::build() {
+    unsigned int nAtoms = size();
+    unsigned int nv = nVariants;
+
+    for (unsigned int i = 0; (i < 3) && (i < nAtoms); i++)
+        for (unsigned int v = 0; v < nv; v++) {
+            x[pIndex(i, v)] = start[i].x;
+            y[pIndex(i, v)] = start[i].y;
+            z[pIndex(i, v)] = start[i].z;
+        }
+
+    for (unsigned int k = 0; k < torsion.size(); k++) {
+        cosTorsion[k] = cos(torsion[k]);
+        sinTorsion[k] = sin(torsion[k]);
+    }
+
+    for (unsigned int i = 3; i < nAtoms; i++) {
+        unsigned int k = i * nv;
+        sPlace(nv, -length[i] * cos(angle[i]), length[i] * sin(angle[i]),
+                &cosTorsion[k], &sinTorsion[k], &x[k - 3 * nv], &y[k - 3 * nv],
+                &z[k - 3 * nv], &x[k], &y[k], &z[k]);
+    }
+}
+
+// HELPERS:
+
+/**
+ *  Sizes the arrays for nAtoms atoms of sizeVariants() variants. Lengths
+ * and angles are kept, torsions and coordinates are cleared.
+ */
+void BackboneBuilder::pResize(unsigned int nAtoms) {
+    length.resize(nAtoms, 0.0);
+    angle.resize(nAtoms, 0.0);
+    torsion.assign(nAtoms * nVariants, 0.0);
+    cosTorsion.assign(nAtoms * nVariants, 0.0);
+    sinTorsion.assign(nAtoms * nVariants, 0.0);
+    x.assign(nAtoms * nVariants, 0.0);
+    y.assign(nAtoms * nVariants, 0.0);
+    z.assign(nAtoms * nVariants, 0.0);
+}
@@ -0,0 +1,128 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _BACKBONEBUILDER_H_
+#define _BACKBONEBUILDER_H_
+
+// Includes:
+#include <vector>
+#include <vector3.h>
+using namespace std;
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    class Spacer;
+
+    /**@brief Builds backbone coordinates from internal coordinates.
+     *
+     *  The chain N, CA, C, N, CA, C, ... is held as arrays of bond lengths,
+     *  bond angles and torsion angles; build() places every atom from the
+     *  three before it (Natural Extension Reference Frame), in one pass and
+     *  without touching any Atom.
+     *  Lengths and angles are shared by a number of variants, each with its
+     *  own torsions. Torsions and coordinates are stored atom-major, the
+     *  variants of an atom next to each other, so that build() places atom i
+     *  of all variants in one branch-free inner loop, which the compiler
+     *  vectorizes. A single chain is one variant.
+     *  Atom i is N, CA or C of residue i / 3. Angles are in degrees at the
+     *  interface, as in AminoAcid::setPhi().
+     * */
+    class BackboneBuilder {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        BackboneBuilder();
+        virtual ~BackboneBuilder();
+
+        // PREDICATES:
+
+        /**
+         *   Number of atoms of each variant
+         */
+        unsigned int size() const {
+            return length.size();
+        }
+
+        unsigned int sizeAmino() const {
+            return size() / 3;
+        }
+
+        unsigned int sizeVariants() const {
+            return nVariants;
+        }
+
+        double getBondLength(unsigned int i) const;
+        double getBondAngle(unsigned int i) const;
+        double getTorsion(unsigned int i, unsigned int v = 0) const;
+        double getPhi(unsigned int n, unsigned int v = 0) const;
+        double getPsi(unsigned int n, unsigned int v = 0) const;
+        double getOmega(unsigned int n, unsigned int v = 0) const;
+
+        double getX(unsigned int i, unsigned int v = 0) const {
+            return x[pIndex(i, v)];
+        }
+
+        double getY(unsigned int i, unsigned int v = 0) const {
+            return y[pIndex(i, v)];
+        }
+
+        double getZ(unsigned int i, unsigned int v = 0) const {
+            return z[pIndex(i, v)];
+        }
+
+        vgVector3<double> getCoords(unsigned int i, unsigned int v = 0) const;
+
+        // MODIFIERS:
+        void setIdeal(unsigned int nAmino);
+        void setFromSpacer(Spacer& sp, unsigned int first, unsigned int last);
+        void setStart(const vgVector3<double>& n, const vgVector3<double>& ca,
+                const vgVector3<double>& c);
+        void setVariants(unsigned int n);
+
+        void setTorsion(unsigned int i, double a, unsigned int v = 0);
+        void setPhi(unsigned int n, double a, unsigned int v = 0);
+        void setPsi(unsigned int n, double a, unsigned int v = 0);
+        void setOmega(unsigned int n, double a, unsigned int v = 0);
+
+        void build();
+
+    protected:
+
+    private:
+
+        // HELPERS:
+        unsigned int pIndex(unsigned int i, unsigned int v) const {
+            return i * nVariants + v;
+        }
+
+        void pResize(unsigned int nAtoms);
+
+        // ATTRIBUTES:
+        unsigned int nVariants;
+        vector<double> length; // of the bond to the previous atom
+        vector<double> angle; // at the previous atom, radians
+        vector<double> torsion; // about the bond to the previous atom, radians
+        vector<double> cosTorsion; // filled by build()
+        vector<double> sinTorsion;
+        vector<double> x; // size() * sizeVariants() entries, as torsion
+        vector<double> y;
+        vector<double> z;
+        vgVector3<double> start[3]; // first N, CA and C
+    };
+
+}} //namespace
+#endif //_BACKBONEBUILDER_H_
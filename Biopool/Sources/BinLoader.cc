@@ -0,0 +1,187 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <BinLoader.h>
+#include <vglEndian.h>
+#include <algorithm>
+#include <cstring>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+/**
+ *   Reads a number stored as little-endian bytes.
+ */
+template <class T> static T
+sRead(istream& is) {
+    char bytes[sizeof (T)];
+    if (!is.read(bytes, sizeof (T)))
+        ERROR("Binary structure file is truncated.", exception);
+#if BYTE_ORDER == BIG_ENDIAN
+    reverse(bytes, bytes + sizeof (T));
+#endif
+    T value;
+    memcpy(&value, bytes, sizeof (T));
+    return value;
+}
+
+// MODIFIERS:
+
+/**
+ *   Loads the first chain of the file.
+ *@param sp spacer
+ */
+void
+BinLoader::loadSpacer(Spacer& sp) {
+    PRINT_NAME;
+    if (pLoadHeader() == 0)
+        ERROR("Binary structure file has no chains.", exception);
+    valid = true;
+    LigandSet ls;
+    pLoadChain(sp, ls);
+}
+
+/**
+ *   Loads all chains of the file, with their ligands.
+ *@param prot protein
+ */
+void
+BinLoader::loadProtein(Protein& prot) {
+    PRINT_NAME;
+    unsigned int chains = pLoadHeader();
+    valid = true;
+
+    for (unsigned int i = 0; i < chains; i++) {
+        Spacer* sp = new Spacer();
+        LigandSet* ls = new LigandSet();
+        char chain = pLoadChain(*sp, *ls);
+
+        Polymer* pol = new Polymer();
+        pol->insertComponent(sp);
+        if (ls->sizeLigand() > 0)
+            pol->insertComponent(ls);
+        else
+            delete ls;
+        prot.addChain(chain);
+        prot.insertComponent(pol);
+    }
+}
+
+// HELPERS:
+
+/**
+ *   Checks the magic string and the version.
+ *@return number of chains
+ */
+unsigned int
+BinLoader::pLoadHeader() {
+    char magic[sizeof (BIN_MAGIC)];
+    if (!input.read(magic, sizeof (BIN_MAGIC))
+            || (memcmp(magic, BIN_MAGIC, sizeof (BIN_MAGIC)) != 0))
+        ERROR("Not a binary structure file.", exception);
+    version = sRead<vg_uint32>(input);
+    if ((version == 0) || (version > BIN_VERSION))
+        ERROR("Unknown version of binary structure file.", exception);
+    return sRead<vg_uint32>(input);
+}
+
+/**
+ *@param sp amino acids of the chain
+ *@param ls ligands of the chain
+ *@return chain ID
+ */
+char
+BinLoader::pLoadChain(Spacer& sp, LigandSet& ls) {
+    char chain = sRead<vg_uint8>(input);
+    sp.setType(pLoadString());
+    sp.setStartOffset(sRead<vg_int32>(input));
+    unsigned int gaps = sRead<vg_uint32>(input);
+    for (unsigned int i = 0; i < gaps; i++)
+        sp.addGap(sRead<vg_int32>(input));
+
+    unsigned int aminos = sRead<vg_uint32>(input);
+    vector<StateCode> states(aminos);
+    for (unsigned int i = 0; i < aminos; i++) {
+        AminoAcid* aa = new AminoAcid();
+        string type = pLoadString();
+        aa->setType(type);
+        aa->getSideChain().setType(type);
+        states[i] = static_cast<StateCode> (sRead<vg_uint8>(input));
+        pLoadAtoms(*aa);
+        pLoadAtoms(aa->getSideChain());
+        sp.insertComponent(aa);
+    }
+    if (aminos > 0) {
+        pConnect(sp);
+        for (unsigned int i = 0; i < aminos; i++)
+            sp.getAmino(i).setState(states[i]);
+    }
+
+    unsigned int ligands = sRead<vg_uint32>(input);
+    for (unsigned int i = 0; i < ligands; i++) {
+        Ligand* lig = new Ligand();
+        lig->setType(pLoadString());
+        pLoadAtoms(*lig);
+        ls.insertComponent(lig);
+    }
+    return chain;
+}
+
+void
+BinLoader::pLoadAtoms(Group& gr) {
+    unsigned int atoms = sRead<vg_uint32>(input);
+    for (unsigned int i = 0; i < atoms; i++) {
+        Atom at;
+        at.setType(pLoadString());
+        at.setNumber(sRead<vg_int32>(input));
+        double x = sRead<vg_ieee64>(input);
+        double y = sRead<vg_ieee64>(input);
+        double z = sRead<vg_ieee64>(input);
+        at.setCoords(x, y, z);
+        at.setBFac(sRead<vg_ieee64>(input));
+        gr.addAtom(at);
+    }
+}
+
+string
+BinLoader::pLoadString() {
+    unsigned int length = sRead<vg_uint32>(input);
+    string s(length, ' ');
+    if ((length > 0) && !input.read(&s[0], length))
+        ERROR("Binary structure file is truncated.", exception);
+    return s;
+}
+
+/**
+ *   Connects the residues and fixes the leading N atom, as PdbLoader.
+ *@param sp spacer
+ */
+void
+BinLoader::pConnect(Spacer& sp) {
+    sp.getAmino(0).setBondsFromPdbCode(true);
+    for (unsigned int i = 1; i < sp.size(); i++)
+        if (!sp.getAmino(i).setBondsFromPdbCode(true, &(sp.getAmino(i - 1)))) {
+            valid = false;
+            break;
+        }
+
+    sp.setTrans(sp.getAmino(0)[N].getTrans());
+    vgVector3<double> tmp(0.0, 0.0, 0.0);
+    sp.getAmino(0)[N].setTrans(tmp);
+    sp.getAmino(0).adjustLeadingN();
+}
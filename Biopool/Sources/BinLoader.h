@@ -0,0 +1,77 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BIN_LOADER_H_
+#define _BIN_LOADER_H_
+
+// Includes:
+#include <BinSaver.h>
+#include <Loader.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    /**@brief Loads proteins saved by BinSaver.
+     *
+     *    No text is parsed and no hydrogens, DSSP or secondary structure
+     *    are computed again: the atoms and states are read as saved and
+     *    only the bonds are rebuilt, from the atom types, as PdbLoader
+     *    does. Open the stream with ios::binary.
+     * */
+    class BinLoader : public Loader {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+
+        BinLoader(istream& _input = cin) : input(_input), valid(true),
+        version(0) {
+        }
+        // this class uses the implicit copy operator.
+
+        virtual ~BinLoader() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+
+        /**
+         *   Residues of the last load could all be connected
+         */
+        bool isValid() {
+            return valid;
+        }
+
+        // MODIFIERS:
+        virtual void loadSpacer(Spacer& sp);
+        virtual void loadProtein(Protein& prot);
+
+    protected:
+        // HELPERS:
+        unsigned int pLoadHeader();
+        char pLoadChain(Spacer& sp, LigandSet& ls);
+        void pLoadAtoms(Group& gr);
+        string pLoadString();
+        void pConnect(Spacer& sp);
+
+    private:
+        istream& input; // input stream
+        bool valid; // residues connected
+        unsigned int version; // format of the file read
+    };
+
+}} //namespace
+#endif //_BIN_LOADER_H_
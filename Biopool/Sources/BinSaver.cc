@@ -0,0 +1,130 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <BinSaver.h>
+#include <vglEndian.h>
+#include <algorithm>
+#include <cstring>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+/**
+ *   Writes a number as little-endian bytes.
+ */
+template <class T> static void
+sWrite(ostream& os, T value) {
+    char bytes[sizeof (T)];
+    memcpy(bytes, &value, sizeof (T));
+#if BYTE_ORDER == BIG_ENDIAN
+    reverse(bytes, bytes + sizeof (T));
+#endif
+    os.write(bytes, sizeof (T));
+}
+
+// MODIFIERS:
+
+/**
+ *   Saves the spacer as a protein with one chain, without ligands.
+ *@param sp spacer
+ */
+void
+BinSaver::saveSpacer(Spacer& sp) {
+    PRINT_NAME;
+    pSaveHeader(1);
+    pSaveChain(' ', sp, NULL);
+}
+
+/**
+ *   Saves all chains of the protein, with their ligands.
+ *@param prot protein
+ */
+void
+BinSaver::saveProtein(Protein& prot) {
+    PRINT_NAME;
+    pSaveHeader(prot.sizeProtein());
+    for (unsigned int i = 0; i < prot.sizeProtein(); i++)
+        pSaveChain(prot.getChainLetter(i), *prot.getSpacer(i),
+            prot.getLigandSet(i));
+}
+
+// HELPERS:
+
+void
+BinSaver::pSaveHeader(unsigned int chains) {
+    output.write(BIN_MAGIC, sizeof (BIN_MAGIC));
+    sWrite<vg_uint32>(output, BIN_VERSION);
+    sWrite<vg_uint32>(output, chains);
+}
+
+/**
+ *@param chain chain ID
+ *@param sp amino acids of the chain
+ *@param ls ligands of the chain, or NULL
+ */
+void
+BinSaver::pSaveChain(char chain, Spacer& sp, LigandSet* ls) {
+    sWrite<vg_uint8>(output, chain);
+    pSaveString(sp.getType());
+    sWrite<vg_int32>(output, sp.getStartOffset());
+    sWrite<vg_uint32>(output, sp.sizeGaps());
+    for (unsigned int i = 0; i < sp.sizeGaps(); i++)
+        sWrite<vg_int32>(output, sp.getGap(i));
+
+    sWrite<vg_uint32>(output, sp.sizeAmino());
+    for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        pSaveString(aa.getType());
+        sWrite<vg_uint8>(output, aa.getState());
+        pSaveAtoms(aa, aa.sizeBackbone());
+        pSaveAtoms(aa.getSideChain(), aa.getSideChain().size());
+    }
+
+    unsigned int ligands = (ls != NULL) ? ls->sizeLigand() : 0;
+    sWrite<vg_uint32>(output, ligands);
+    for (unsigned int i = 0; i < ligands; i++) {
+        pSaveString(ls->getLigand(i).getType());
+        pSaveAtoms(ls->getLigand(i), ls->getLigand(i).size());
+    }
+}
+
+/**
+ *   Writes the first atoms of a group, with their absolute coordinates.
+ *@param gr group
+ *@param n number of atoms (the backbone only, for an amino acid)
+ */
+void
+BinSaver::pSaveAtoms(Group& gr, unsigned int n) {
+    sWrite<vg_uint32>(output, n);
+    for (unsigned int i = 0; i < n; i++) {
+        Atom& at = gr[i];
+        pSaveString(at.getType());
+        sWrite<vg_int32>(output, at.getNumber());
+        vgVector3<double> c = at.getCoords();
+        sWrite<vg_ieee64>(output, c.x);
+        sWrite<vg_ieee64>(output, c.y);
+        sWrite<vg_ieee64>(output, c.z);
+        sWrite<vg_ieee64>(output, at.getBFac());
+    }
+}
+
+void
+BinSaver::pSaveString(const string& s) {
+    sWrite<vg_uint32>(output, s.size());
+    output.write(s.data(), s.size());
+}
@@ -0,0 +1,84 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BIN_SAVER_H_
+#define _BIN_SAVER_H_
+
+// Includes:
+#include <Atom.h>
+#include <AminoAcid.h>
+#include <Spacer.h>
+#include <Ligand.h>
+#include <LigandSet.h>
+#include <Protein.h>
+#include <Saver.h>
+#include <Debug.h>
+#include <string>
+#include <iostream>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    /// First bytes of a binary structure file.
+    const char BIN_MAGIC[] = "VICTORBIN";
+
+    /// Format written by BinSaver; BinLoader reads this one and older ones.
+    const unsigned int BIN_VERSION = 1;
+
+    /**@brief Saves proteins in a compact binary format, read by BinLoader.
+     *
+     *    The file holds what loading a PDB file has computed: for each
+     *    chain, the residue types and secondary states, the atom types,
+     *    numbers, coordinates and B-factors (hydrogens included), the
+     *    start offset and gaps, and the ligands. Bonds follow from the
+     *    atom types and are rebuilt by BinLoader as PdbLoader does.
+     *
+     *    The file starts with BIN_MAGIC and BIN_VERSION. Numbers are
+     *    stored little-endian whatever the byte order of the host, reals
+     *    as IEEE doubles, strings as their length and characters.
+     *    Open the stream with ios::binary.
+     * */
+    class BinSaver : public Saver {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+
+        BinSaver(ostream& _output = cout) : output(_output) {
+        }
+        // this class uses the implicit copy operator.
+
+        virtual ~BinSaver() {
+            PRINT_NAME;
+        }
+
+        // MODIFIERS:
+        virtual void saveSpacer(Spacer& sp);
+        virtual void saveProtein(Protein& prot);
+
+    protected:
+        // HELPERS:
+        void pSaveHeader(unsigned int chains);
+        void pSaveChain(char chain, Spacer& sp, LigandSet* ls);
+        void pSaveAtoms(Group& gr, unsigned int n);
+        void pSaveString(const string& s);
+
+    private:
+        ostream& output; // output stream
+    };
+
+}} //namespace
+#endif //_BIN_SAVER_H_
@@ -27,7 +27,7 @@ using namespace Victor; using namespace Victor::Biopool;
 // CONSTRUCTORS/DESTRUCTOR:
 
 Group::Group(unsigned int mI, unsigned int mO) : Monomer(mI, mO),
-atoms(), trans(0, 0, 0), rot(1) {
+atoms(), trans(0, 0, 0), rot(1), atomsModified(false) {
 }
 
 Group::Group(const Group& orig) {
@@ -77,6 +77,20 @@ Group::setModified() {
     if (atoms.size())
         atoms[0].setModified();
 }
+
+/**
+ *   Records that atoms of the group have to be synchronized, and marks the
+ * superior as modified. Unlike setModified() the atoms are left alone:
+ * Atom::setModified() has already marked the ones that moved.
+ */
+void
+Group::setAtomsModified() {
+    if (atomsModified)
+        return;
+    atomsModified = true;
+    if (hasSuperior())
+        getSuperior().setModified();
+}
 /**
  *   Removes an atom from the group.
  * @param a (Atom)
@@ -134,6 +148,7 @@ Group::copy(const Group& orig) {
     trans = orig.trans;
     rot = orig.rot;
     modified = orig.modified;
+    atomsModified = orig.atomsModified;
 
     id = orig.id;
     // not initializing Bond in order to avoid copying the inBond 
@@ -149,13 +164,14 @@ Group::copy(const Group& orig) {
 void
 Group::sync() 
 {
-    if (!modified)
+    if (!modified && !atomsModified)
         return;
 
     for (unsigned int i = 0; i < atoms.size(); i++)
         atoms[i].sync();
 
     modified = false;
+    atomsModified = false;
     vgMatrix3<double> tmp(1);
     rot = tmp;
 
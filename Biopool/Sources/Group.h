@@ -56,6 +56,7 @@ namespace Victor { namespace Biopool {
 
         vgVector3<double> getTrans() const;
         vgMatrix3<double> getRot() const;
+        bool isModified() const;
 
         virtual bool isMember(const AtomCode& ac) const;
 
@@ -73,6 +74,7 @@ namespace Victor { namespace Biopool {
         void addRot(vgMatrix3<double> r);
         virtual void sync(); // synchronize coords with structure
         virtual void setModified();
+        virtual void setAtomsModified();
 
         virtual const Group& getInBond(unsigned int n) const;
         virtual Group& getInBond(unsigned int n);
@@ -105,6 +107,7 @@ namespace Victor { namespace Biopool {
         vector<Atom> atoms;
         vgVector3<double> trans; // group translation
         vgMatrix3<double> rot; // group rotation
+        bool atomsModified; // atoms moved since the last sync()
 
     };
 
@@ -157,6 +160,14 @@ namespace Victor { namespace Biopool {
         return rot;
     }
 
+    /**
+     *   True if the group, or one of its atoms, changed since the last sync().
+     */
+    inline bool
+    Group::isModified() const {
+        return (modified || atomsModified);
+    }
+
     inline bool
     Group::isMember(const AtomCode& ac) const {
         return (pGetAtom(ac) != NULL);
@@ -76,6 +76,9 @@ namespace Victor { namespace Biopool {
         friend istream& operator >>(istream& is, Identity& id);
 
     private:
+        static long pNextNumber();
+        static void pRaiseCounter(long _number);
+
         long number;
         string name;
 
@@ -91,14 +94,14 @@ namespace Victor { namespace Biopool {
         if (n != 0) {
             number = n;
         } else {
-            number = ++counter;
+            number = pNextNumber();
         }
     }
 
     inline
     Identity::Identity(const Identity& orig)
     : name(orig.name) {
-        number = ++counter;
+        number = pNextNumber();
     }
 
     inline
@@ -135,8 +138,41 @@ namespace Victor { namespace Biopool {
     void
     Identity::setNumber(long _number) {
         number = _number;
+        pRaiseCounter(_number);
+    }
+
+    /**
+     *  Returns a new unique number. Safe to call from concurrent threads,
+     * so that structures can be loaded in parallel.
+     */
+    inline
+    long
+    Identity::pNextNumber() {
+#ifdef __GNUC__
+        return __sync_add_and_fetch(&counter, 1);
+#else
+        return ++counter;
+#endif
+    }
+
+    /**
+     *  Makes sure that numbers handed out later are above _number.
+     */
+    inline
+    void
+    Identity::pRaiseCounter(long _number) {
+#ifdef __GNUC__
+        long old = counter;
+        while (_number > old) {
+            long seen = __sync_val_compare_and_swap(&counter, old, _number);
+            if (seen == old)
+                break;
+            old = seen;
+        }
+#else
         if (_number >= counter)
             counter = _number;
+#endif
     }
 
     // ---------------------------------------------------------------------------
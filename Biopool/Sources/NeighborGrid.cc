@@ -0,0 +1,337 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <NeighborGrid.h>
+#include <SpacerCoordinates.h>
+#include <Protein.h>
+#include <algorithm>
+#include <Debug.h>
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// Global constants, typedefs, etc. (to avoid):
+
+// relative tolerance on the query radius, covers rounding of squared distances
+static const double RADIUS_TOLERANCE = 1.0e-9;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Basic constructor, creates an empty grid
+ *@param cellSize, side of the cells (Angstrom)
+ */
+NeighborGrid::NeighborGrid(double cellSize) : cellSize(cellSize),
+gridSize(cellSize), x(), y(), z(), minX(0.0), minY(0.0), minZ(0.0), nX(0),
+nY(0), nZ(0), cellStart(), cellPoint() {
+    PRINT_NAME;
+    PRECOND(cellSize > 0.0, exception);
+}
+
+/**
+ *  Creates a grid on all atoms of a coordinate view
+ *@param coords, coordinate view of a spacer
+ *@param cellSize, side of the cells (Angstrom)
+ */
+NeighborGrid::NeighborGrid(const SpacerCoordinates& coords, double cellSize) :
+cellSize(cellSize), gridSize(cellSize), x(), y(), z(), minX(0.0), minY(0.0),
+minZ(0.0), nX(0), nY(0), nZ(0), cellStart(), cellPoint() {
+    PRINT_NAME;
+    PRECOND(cellSize > 0.0, exception);
+    build(coords);
+}
+
+/**
+ *  Creates a grid on a set of points
+ *@param points, coordinates of the points
+ *@param cellSize, side of the cells (Angstrom)
+ */
+NeighborGrid::NeighborGrid(const vector<vgVector3<double> >& points,
+        double cellSize) : cellSize(cellSize), gridSize(cellSize), x(), y(),
+z(), minX(0.0), minY(0.0), minZ(0.0), nX(0), nY(0), nZ(0), cellStart(),
+cellPoint() {
+    PRINT_NAME;
+    PRECOND(cellSize > 0.0, exception);
+    build(points);
+}
+
+/**
+ *  Basic destructor
+ */
+NeighborGrid::~NeighborGrid() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *  Finds all points within a given radius of a position.
+ *@param p, query position
+ *@param radius, search radius (Angstrom), can exceed the cell size
+ *@param res, returns the indexes of the points found, in increasing order
+ */
+void NeighborGrid::getNeighbors(const vgVector3<double>& p, double radius,
+        vector<unsigned int>& res) const {
+    res.clear();
+    if (x.empty() || (radius < 0.0))
+        return;
+
+    double lim = radius * (1.0 + RADIUS_TOLERANCE);
+    double lim2 = lim * lim;
+
+    // clamped on both sides: points moved outside the grid sit in its
+    // border cells
+    long loX = min(max(pGetCell(p.x - lim, minX), 0L), nX - 1);
+    long hiX = min(max(pGetCell(p.x + lim, minX), 0L), nX - 1);
+    long loY = min(max(pGetCell(p.y - lim, minY), 0L), nY - 1);
+    long hiY = min(max(pGetCell(p.y + lim, minY), 0L), nY - 1);
+    long loZ = min(max(pGetCell(p.z - lim, minZ), 0L), nZ - 1);
+    long hiZ = min(max(pGetCell(p.z + lim, minZ), 0L), nZ - 1);
+
+    for (long i = loX; i <= hiX; i++)
+        for (long j = loY; j <= hiY; j++)
+            for (long k = loZ; k <= hiZ; k++) {
+                long cell = (i * nY + j) * nZ + k;
+                for (unsigned int n = cellStart[cell]; n < cellStart[cell + 1]; n++) {
+                    unsigned int m = cellPoint[n];
+                    double dx = x[m] - p.x;
+                    double dy = y[m] - p.y;
+                    double dz = z[m] - p.z;
+                    if (dx * dx + dy * dy + dz * dz <= lim2)
+                        res.push_back(m);
+                }
+            }
+
+    sort(res.begin(), res.end());
+}
+
+/**
+ *  Finds all points within a given radius of a stored point,
+ * the point itself excluded.
+ *@param i, index of the query point
+ *@param radius, search radius (Angstrom)
+ *@param res, returns the indexes of the points found, in increasing order
+ */
+void NeighborGrid::getNeighbors(unsigned int i, double radius,
+        vector<unsigned int>& res) const {
+    PRECOND(i < size(), exception);
+    getNeighbors(getPoint(i), radius, res);
+    vector<unsigned int>::iterator self = find(res.begin(), res.end(), i);
+    if (self != res.end()) // not found e.g. for a negative radius
+        res.erase(self);
+}
+
+/**
+ *  Enumerates all pairs of points within a given radius. Every pair is
+ * reported once as (i, j) with i < j, pairs are sorted by i and then j.
+ *@param radius, search radius (Angstrom)
+ *@param res, returns the pairs found
+ */
+void NeighborGrid::getPairs(double radius,
+        vector<pair<unsigned int, unsigned int> >& res) const {
+    res.clear();
+    vector<unsigned int> nb;
+    for (unsigned int i = 0; i < size(); i++) {
+        getNeighbors(getPoint(i), radius, nb);
+        for (unsigned int n = 0; n < nb.size(); n++)
+            if (nb[n] > i)
+                res.push_back(pair<unsigned int, unsigned int>(i, nb[n]));
+    }
+}
+
+// MODIFIERS:
+
+/**
+ *  Changes the cell size. Should be about the largest radius queried.
+ *@param size, side of the cells (Angstrom)
+ */
+void NeighborGrid::setCellSize(double size) {
+    PRECOND(size > 0.0, exception);
+    cellSize = size;
+    pIndex();
+}
+
+/**
+ *  Moves one point. Only the cells between its old and its new cell are
+ * touched, the grid is not rebuilt.
+ *@param i, index of the point
+ *@param p, new position
+ */
+void NeighborGrid::setPoint(unsigned int i, const vgVector3<double>& p) {
+    PRECOND(i < size(), exception);
+    long from = pGetCellOf(x[i], y[i], z[i]);
+    long to = pGetCellOf(p.x, p.y, p.z);
+    x[i] = p.x;
+    y[i] = p.y;
+    z[i] = p.z;
+    if (from == to)
+        return;
+
+    vector<unsigned int>::iterator first = cellPoint.begin();
+    unsigned int pos = find(first + cellStart[from], first + cellStart[from + 1], i)
+            - first;
+    if (from < to) { // to the end of cell to, the cells between move down
+        rotate(first + pos, first + pos + 1, first + cellStart[to + 1]);
+        for (long c = from + 1; c <= to; c++)
+            cellStart[c]--;
+    } else { // to the start of cell to, the cells between move up
+        rotate(first + cellStart[to + 1], first + pos, first + pos + 1);
+        for (long c = to + 1; c <= from; c++)
+            cellStart[c]++;
+    }
+}
+
+/**
+ *  Removes all points.
+ */
+void NeighborGrid::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    pIndex();
+}
+
+/**
+ *  Fills the grid with all atoms of a coordinate view.
+ *@param coords, coordinate view of a spacer
+ */
+void NeighborGrid::build(const SpacerCoordinates& coords) {
+    x.assign(coords.getXArray(), coords.getXArray() + coords.size());
+    y.assign(coords.getYArray(), coords.getYArray() + coords.size());
+    z.assign(coords.getZArray(), coords.getZArray() + coords.size());
+    pIndex();
+}
+
+/**
+ *  Fills the grid with a set of points.
+ *@param points, coordinates of the points
+ */
+void NeighborGrid::build(const vector<vgVector3<double> >& points) {
+    x.resize(points.size());
+    y.resize(points.size());
+    z.resize(points.size());
+    for (unsigned int i = 0; i < points.size(); i++) {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+        z[i] = points[i].z;
+    }
+    pIndex();
+}
+
+/**
+ *  Fills the grid with all atoms of a spacer, see Spacer::getCoordinates().
+ *@param sp, reference to the spacer
+ */
+void NeighborGrid::build(Spacer& sp) {
+    build(sp.getCoordinates());
+}
+
+/**
+ *  Fills the grid with all atoms of all chains of a protein. Atoms are
+ * numbered chain after chain, in the order of Spacer::getCoordinates().
+ *@param prot, reference to the protein
+ */
+void NeighborGrid::build(Protein& prot) {
+    x.clear();
+    y.clear();
+    z.clear();
+    for (unsigned int i = 0; i < prot.sizeProtein(); i++) {
+        const SpacerCoordinates& coords = prot.getSpacer(i)->getCoordinates();
+        x.insert(x.end(), coords.getXArray(), coords.getXArray() + coords.size());
+        y.insert(y.end(), coords.getYArray(), coords.getYArray() + coords.size());
+        z.insert(z.end(), coords.getZArray(), coords.getZArray() + coords.size());
+    }
+    pIndex();
+}
+
+// HELPERS:
+
+/**
+ *  Bins the points into cells (counting sort). The cell size is enlarged
+ * if the bounding box would need too many cells for the number of points.
+ */
+void NeighborGrid::pIndex() {
+    const double MAX_CELLS_PER_POINT = 8.0;
+    const double MIN_CELLS = 1024.0;
+
+    gridSize = cellSize;
+    cellStart.clear();
+    cellPoint.clear();
+    nX = nY = nZ = 0;
+    if (x.empty())
+        return;
+
+    double maxX = x[0], maxY = y[0], maxZ = z[0];
+    minX = x[0];
+    minY = y[0];
+    minZ = z[0];
+    for (unsigned int i = 1; i < size(); i++) {
+        minX = min(minX, x[i]);
+        maxX = max(maxX, x[i]);
+        minY = min(minY, y[i]);
+        maxY = max(maxY, y[i]);
+        minZ = min(minZ, z[i]);
+        maxZ = max(maxZ, z[i]);
+    }
+
+    double maxCells = max(MIN_CELLS, MAX_CELLS_PER_POINT * size());
+    double cells;
+    do {
+        nX = pGetCell(maxX, minX) + 1;
+        nY = pGetCell(maxY, minY) + 1;
+        nZ = pGetCell(maxZ, minZ) + 1;
+        cells = static_cast<double> (nX) * nY * nZ;
+        if (cells > maxCells)
+            gridSize *= 1.25;
+    } while (cells > maxCells);
+
+    cellStart.assign(nX * nY * nZ + 1, 0);
+    vector<unsigned int> cellOf(size());
+    for (unsigned int i = 0; i < size(); i++) {
+        cellOf[i] = pGetCellOf(x[i], y[i], z[i]);
+        cellStart[cellOf[i] + 1]++;
+    }
+    for (unsigned int c = 1; c < cellStart.size(); c++)
+        cellStart[c] += cellStart[c - 1];
+
+    cellPoint.resize(size());
+    vector<unsigned int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (unsigned int i = 0; i < size(); i++)
+        cellPoint[fill[cellOf[i]]++] = i;
+}
+
+/**
+ *  Cell coordinate of a value along one axis, not clamped to the grid.
+ *@param v, coordinate value
+ *@param min, lowest coordinate of the grid along the axis
+ *@return cell coordinate
+ */
+long NeighborGrid::pGetCell(double v, double min) const {
+    return static_cast<long> (floor((v - min) / gridSize));
+}
+
+/**
+ *  Index of the cell holding a position, positions outside the grid go to
+ * the nearest border cell.
+ *@param px, py, pz, coordinates
+ *@return cell index
+ */
+long NeighborGrid::pGetCellOf(double px, double py, double pz) const {
+    long i = min(max(pGetCell(px, minX), 0L), nX - 1);
+    long j = min(max(pGetCell(py, minY), 0L), nY - 1);
+    long k = min(max(pGetCell(pz, minZ), 0L), nZ - 1);
+    return (i * nY + j) * nZ + k;
+}
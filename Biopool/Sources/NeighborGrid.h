@@ -0,0 +1,114 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _NEIGHBORGRID_H_
+#define _NEIGHBORGRID_H_
+
+// Includes:
+#include <vector>
+#include <utility>
+#include <vector3.h>
+#include <Debug.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    class Spacer;
+    class Protein;
+    class SpacerCoordinates;
+
+    /**@brief Uniform grid (cell list) for fixed radius neighbour searches.
+     *
+     *  Points are binned into cubic cells of side getCellSize(), usually the
+     *  largest cutoff that will be queried, so that a radius query only needs
+     *  to visit the cells around the query point instead of all points.
+     *  Points are referred to by their insertion index: when the grid is
+     *  built from a Spacer this is the atom index of Spacer::getCoordinates(),
+     *  when built from a Protein atoms of the chains follow each other.
+     *  The grid keeps its own copy of the coordinates and has to be rebuilt
+     *  after the structure moves, or told about single points moving with
+     *  setPoint(). Points moved out of the initial bounding box are kept in
+     *  its border cells, so many such moves make queries slower.
+     *  All points at distance <= radius are reported, plus possibly points
+     *  beyond it by no more than rounding errors: callers applying a strict
+     *  cutoff should test the distance themselves.
+     * */
+    class NeighborGrid {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        NeighborGrid(double cellSize = 10.0);
+        NeighborGrid(const SpacerCoordinates& coords, double cellSize);
+        NeighborGrid(const vector<vgVector3<double> >& points, double cellSize);
+        virtual ~NeighborGrid();
+
+        // PREDICATES:
+
+        /**
+         *   Number of points stored
+         */
+        unsigned int size() const {
+            return x.size();
+        }
+
+        double getCellSize() const {
+            return cellSize;
+        }
+
+        vgVector3<double> getPoint(unsigned int i) const {
+            return vgVector3<double>(x[i], y[i], z[i]);
+        }
+
+        void getNeighbors(const vgVector3<double>& p, double radius,
+                vector<unsigned int>& res) const;
+        void getNeighbors(unsigned int i, double radius,
+                vector<unsigned int>& res) const;
+        void getPairs(double radius,
+                vector<pair<unsigned int, unsigned int> >& res) const;
+
+        // MODIFIERS:
+        void setCellSize(double size);
+        void setPoint(unsigned int i, const vgVector3<double>& p);
+        void clear();
+        void build(const SpacerCoordinates& coords);
+        void build(const vector<vgVector3<double> >& points);
+        void build(Spacer& sp);
+        void build(Protein& prot);
+
+    protected:
+
+        // HELPERS:
+        void pIndex();
+        long pGetCell(double v, double min) const;
+        long pGetCellOf(double px, double py, double pz) const;
+
+    private:
+
+        // ATTRIBUTES:
+        double cellSize; // requested cell size
+        double gridSize; // cell size in use, can be larger than cellSize
+        vector<double> x;
+        vector<double> y;
+        vector<double> z;
+
+        double minX, minY, minZ;
+        long nX, nY, nZ;
+        vector<unsigned int> cellStart; // nX * nY * nZ + 1 entries
+        vector<unsigned int> cellPoint; // point indexes sorted by cell
+    };
+
+}} //namespace
+#endif //_NEIGHBORGRID_H_
@@ -0,0 +1,334 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <PdbFile.h>
+#include <String2Number.h>
+#include <Debug.h>
+#include <sstream>
+#include <cstring>
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// Global constants, typedefs, etc. (to avoid):
+
+/// Powers of ten up to the digits of the longest PDB field, exact as double.
+static const double POWER_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+    1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+/**
+ *  Reads an integer from a fixed-width field: blanks, optional sign,
+ *  digits. Anything else ends the number.
+ *@return false if the field has no digits
+ */
+static bool
+sParseInt(const char* p, unsigned int width, int& value) {
+    const char* end = p + width;
+    while ((p < end) && (*p == ' '))
+        p++;
+    bool negative = false;
+    if ((p < end) && ((*p == '-') || (*p == '+')))
+        negative = (*(p++) == '-');
+    if ((p == end) || (*p < '0') || (*p > '9'))
+        return false;
+    int v = 0;
+    for (; (p < end) && (*p >= '0') && (*p <= '9'); p++)
+        v = 10 * v + (*p - '0');
+    value = negative ? -v : v;
+    return true;
+}
+
+/**
+ *  Reads a decimal number from a fixed-width field. Digits are gathered
+ *  in an integer mantissa and divided once by a power of ten: both are
+ *  exact, so the result is the correctly rounded value strtod() returns.
+ *@return false if the field has no digits
+ */
+static bool
+sParseReal(const char* p, unsigned int width, double& value) {
+    const char* end = p + width;
+    while ((p < end) && (*p == ' '))
+        p++;
+    bool negative = false;
+    if ((p < end) && ((*p == '-') || (*p == '+')))
+        negative = (*(p++) == '-');
+    double mantissa = 0.0;
+    unsigned int digits = 0, decimals = 0;
+    bool point = false;
+    for (; p < end; p++) {
+        if ((*p >= '0') && (*p <= '9')) {
+            mantissa = 10.0 * mantissa + (*p - '0');
+            digits++;
+            if (point)
+                decimals++;
+        } else if ((*p == '.') && (!point))
+            point = true;
+        else
+            break;
+    }
+    if ((digits == 0) || (digits > 15))
+        return false;
+    value = negative ? -mantissa / POWER_OF_TEN[decimals]
+            : mantissa / POWER_OF_TEN[decimals];
+    return true;
+}
+
+/**
+ *  Copies the non-blank characters of a field, NUL-terminated.
+ */
+static void
+sCopyName(const char* p, unsigned int width, char* name) {
+    for (unsigned int i = 0; i < width; i++)
+        if (p[i] != ' ')
+            *(name++) = p[i];
+    *name = '\0';
+}
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Basic constructor, nothing read yet
+ */
+PdbFile::PdbFile() : loaded(false), header(""), expdtaModels(0), models(),
+chains(), blocks(), buffer(), source(NULL), helixData(), helixCode(""), sheetData(),
+sheetCode("") {
+    PRINT_NAME;
+}
+
+/**
+ *  Basic destructor
+ */
+PdbFile::~PdbFile() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *   Returns the atom records of a chain in a model, in file order. The
+ *   records preceding the first MODEL record belong to every model.
+ *@param chain chain ID
+ *@param model model number, NO_MODEL for a file without MODEL records
+ *@return spans of the lines, valid until the next readFile() or clear()
+ *   and, after readBuffer(), as long as its data
+ */
+vector<PdbFile::Line>
+PdbFile::getAtomLines(char chain, unsigned int model) const {
+    const char* base = (source != NULL) ? source : buffer.data();
+    vector<Line> res;
+    for (unsigned int i = 0; i < blocks.size(); i++)
+        if ((blocks[i].chain == chain)
+                && ((blocks[i].model == NO_MODEL) || (blocks[i].model == model)))
+            for (unsigned int j = 0; j < blocks[i].lines.size(); j++) {
+                Line l;
+                l.data = base + blocks[i].lines[j].first;
+                l.length = blocks[i].lines[j].second;
+                res.push_back(l);
+            }
+    return res;
+}
+
+/**
+ *   Parses the fixed columns of an ATOM or HETATM record in place.
+ *   Columns beyond the end of the line count as blanks. A serial number
+ *   that is not decimal (e.g. hybrid-36 in very large files) reads as 0.
+ *@param line the record, not necessarily NUL-terminated
+ *@param length characters of the record
+ *@param rec fields read
+ *@return false if the coordinates are missing
+ */
+bool
+PdbFile::parseAtomRecord(const char* line, unsigned int length,
+        AtomRecord& rec) {
+    char pad[80];
+    if (length < 66) { // pad short lines up to the B-factor with blanks
+        for (unsigned int i = 0; i < 66; i++)
+            pad[i] = (i < length) ? line[i] : ' ';
+        line = pad;
+    }
+
+    rec.het = (line[0] == 'H');
+    if (!sParseInt(line + 6, 5, rec.serial))
+        rec.serial = 0;
+    sCopyName(line + 11, 6, rec.name);
+    sCopyName(line + 17, 3, rec.resName);
+    rec.chain = line[21];
+    if (!sParseInt(line + 22, 4, rec.resSeq))
+        rec.resSeq = 0;
+    rec.iCode = line[26];
+    if (!sParseReal(line + 30, 8, rec.x) || !sParseReal(line + 38, 8, rec.y)
+            || !sParseReal(line + 46, 8, rec.z))
+        return false;
+    if ((length < 66) || !sParseReal(line + 60, 6, rec.bFactor))
+        rec.bFactor = 0.0;
+    return true;
+}
+
+// MODIFIERS:
+
+/**
+ *   Reads the whole file, from the current position of input.
+ *@param input PDB file
+ */
+void
+PdbFile::readFile(istream& input) {
+    clear();
+    unsigned int readingModel = NO_MODEL;
+    bool expdta = false;
+    string atomLine;
+
+    while (getline(input, atomLine)) {
+        if ((atomLine.size() > 0) && (atomLine[atomLine.size() - 1] == '\r'))
+            atomLine.erase(atomLine.size() - 1);
+        if (readRecord(atomLine.data(), atomLine.size(), buffer.size(),
+                readingModel, expdta))
+            buffer += atomLine;
+    }
+
+    loaded = true;
+}
+
+/**
+ *   Reads a whole file already in memory, splitting its records in place.
+ *   The atom records are not copied: data must stay valid while they are
+ *   used.
+ *@param data contents of a PDB file
+ *@param size bytes of data
+ */
+void
+PdbFile::readBuffer(const char* data, unsigned long size) {
+    clear();
+    unsigned int readingModel = NO_MODEL;
+    bool expdta = false;
+    const char* end = data + size;
+
+    for (const char* p = data; p < end;) {
+        const char* eol = static_cast<const char*> (memchr(p, '\n', end - p));
+        if (eol == NULL)
+            eol = end;
+        unsigned int length = eol - p;
+        if ((length > 0) && (p[length - 1] == '\r'))
+            length--;
+        readRecord(p, length, p - data, readingModel, expdta);
+        p = eol + 1;
+    }
+
+    source = data;
+    loaded = true;
+}
+
+void
+PdbFile::clear() {
+    loaded = false;
+    header = "";
+    expdtaModels = 0;
+    models.clear();
+    chains.clear();
+    blocks.clear();
+    buffer.clear();
+    source = NULL;
+    helixData.clear();
+    helixCode = "";
+    sheetData.clear();
+    sheetCode = "";
+}
+
+// HELPERS:
+
+/**
+ *   Files one record. Atom records go to their block, the header, EXPDTA,
+ *   MODEL, HELIX and SHEET records to their lists; others are ignored.
+ *@param line the record, without line end
+ *@param length characters of the record
+ *@param offset position of the record in the lines of getAtomLines()
+ *@param readingModel model of the record, updated by MODEL records
+ *@param expdta an EXPDTA record was read before
+ *@return true if the record is an atom record
+ */
+bool
+PdbFile::readRecord(const char* line, unsigned int length, unsigned int offset,
+        unsigned int& readingModel, bool& expdta) {
+    if (length < 6)
+        return false;
+
+    // atom records first, without building the line
+    if ((memcmp(line, "ATOM  ", 6) == 0) || (memcmp(line, "HETATM", 6) == 0)) {
+        addAtomLine(line, length, offset, readingModel);
+        return true;
+    }
+
+    string tag(line, 6);
+    if ((tag == "HEADER") && (header == "")) {
+        header = string(line, length);
+    } else if ((tag == "EXPDTA") && (!expdta)) {
+        // e.g. "EXPDTA    NMR, 20 STRUCTURES", zero otherwise
+        istringstream str(string(line, length));
+        string name, method;
+        unsigned int num = 0;
+        str >> name >> method >> num;
+        expdtaModels = num;
+        expdta = true;
+    } else if (tag == "MODEL ") {
+        readingModel = stouiDEF(string(line, length).substr(6, 10));
+        models.push_back(readingModel);
+    } else if (tag == "HELIX ") {
+        string atomLine(line, length);
+        int start = stoiDEF(atomLine.substr(21, 4));
+        int end = stoiDEF(atomLine.substr(33, 4));
+        helixData.push_back(pair<int, int>(start, end));
+        helixCode += atomLine.substr(19, 1).c_str()[0];
+    } else if (tag == "SHEET ") {
+        string atomLine(line, length);
+        int start = stoiDEF(atomLine.substr(22, 4));
+        int end = stoiDEF(atomLine.substr(33, 4));
+        sheetData.push_back(pair<int, int>(start, end));
+        sheetCode += atomLine.substr(21, 1).c_str()[0];
+    }
+    return false;
+}
+
+/**
+ *   Adds an ATOM or HETATM record to the block of its model and chain.
+ *   A new chain ID of ATOM records in the first model is added to the
+ *   chain list.
+ *@param line the whole PDB line
+ *@param length characters of the line
+ *@param offset position of the line in the lines of getAtomLines()
+ *@param model model number of the line
+ */
+void
+PdbFile::addAtomLine(const char* line, unsigned int length,
+        unsigned int offset, unsigned int model) {
+    char chain = (length > 21) ? line[21] : ' ';
+    char lastChain = (chains.size() > 0) ? chains.back() : ' ';
+
+    if ((models.size() <= 1) && (line[0] == 'A') && (chain != lastChain))
+        chains.push_back(chain);
+
+    int k = blocks.size() - 1;
+    if ((k < 0) || (blocks[k].model != model) || (blocks[k].chain != chain))
+        for (k = 0; k < static_cast<int> (blocks.size()); k++)
+            if ((blocks[k].model == model) && (blocks[k].chain == chain))
+                break;
+
+    if (k == static_cast<int> (blocks.size())) {
+        Block b;
+        b.model = model;
+        b.chain = chain;
+        blocks.push_back(b);
+    }
+    blocks[k].lines.push_back(pair<unsigned int, unsigned int>(offset, length));
+}
@@ -0,0 +1,205 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PDB_FILE_H_
+#define _PDB_FILE_H_
+
+// Includes:
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    /**@brief Records of a PDB file, read in a single pass.
+     *
+     *  readFile() scans the file once and groups the ATOM and HETATM records by
+     *  model and chain, next to the header, the HELIX and SHEET records and
+     *  the lists of models and chains. Any chain of any model (with its
+     *  ligands) can then be selected with getAtomLines() without reading
+     *  the file again: PdbLoader keeps one PdbFile for all its queries and
+     *  loads.
+     *
+     *  The atom records are stored back to back in one buffer and handed
+     *  out as Line spans over it. parseAtomRecord() reads the fixed columns
+     *  of a record in place, with hand-rolled number conversions, so that
+     *  parsing allocates nothing. readBuffer() scans a file already in
+     *  memory (e.g. a MappedFile) and keeps spans into it instead, so that
+     *  no record is copied at all.
+     * */
+    class PdbFile {
+    public:
+
+        /// Model of the records preceding the first MODEL record.
+        static const unsigned int NO_MODEL = 0;
+
+        /**
+         *  One record, as a span of the line buffer (like a string view).
+         */
+        struct Line {
+            const char* data;
+            unsigned int length;
+        };
+
+        /**
+         *  Fields of an ATOM or HETATM record, names without blanks.
+         */
+        struct AtomRecord {
+            bool het; // HETATM record
+            int serial;
+            char name[7]; // columns 12-17: atom name and alternate location
+            char resName[4];
+            char chain;
+            int resSeq;
+            char iCode; // code for insertion of residues
+            double x;
+            double y;
+            double z;
+            double bFactor; // zero if missing
+        };
+
+        /**
+         *  ATOM and HETATM records of one chain in one model, in file order.
+         */
+        struct Block {
+            unsigned int model;
+            char chain;
+            std::vector<std::pair<unsigned int, unsigned int> > lines; // start and length in buffer
+        };
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        PdbFile();
+        virtual ~PdbFile();
+
+        // PREDICATES:
+
+        bool isRead() const {
+            return loaded;
+        }
+
+        /**
+         *   First HEADER record, empty if missing
+         */
+        std::string getHeader() const {
+            return header;
+        }
+
+        /**
+         *   Number of MODEL records
+         */
+        unsigned int getMaxModels() const {
+            return models.size();
+        }
+
+        /**
+         *   Number of models declared by the EXPDTA record, zero otherwise
+         */
+        unsigned int getExpdtaModels() const {
+            return expdtaModels;
+        }
+
+        /**
+         *   Model numbers, in file order
+         */
+        const std::vector<unsigned int>& getModels() const {
+            return models;
+        }
+
+        /**
+         *   First model number, NO_MODEL if the file has no MODEL records
+         */
+        unsigned int getFirstModel() const {
+            return models.empty() ? NO_MODEL : models[0];
+        }
+
+        /**
+         *   Chain IDs of the ATOM records of the first model
+         */
+        const std::vector<char>& getChains() const {
+            return chains;
+        }
+
+        unsigned int sizeBlocks() const {
+            return blocks.size();
+        }
+
+        const Block& getBlock(unsigned int i) const {
+            return blocks[i];
+        }
+
+        /**
+         *   Bytes of the atom records copied by readFile(), none after
+         *   readBuffer()
+         */
+        unsigned int sizeBuffer() const {
+            return buffer.size();
+        }
+
+        std::vector<Line> getAtomLines(char chain, unsigned int model) const;
+
+        static bool parseAtomRecord(const char* line, unsigned int length,
+                AtomRecord& rec);
+
+        const std::vector<std::pair<int, int> >& getHelixData() const {
+            return helixData;
+        }
+
+        const std::string& getHelixCode() const {
+            return helixCode;
+        }
+
+        const std::vector<std::pair<int, int> >& getSheetData() const {
+            return sheetData;
+        }
+
+        const std::string& getSheetCode() const {
+            return sheetCode;
+        }
+
+        // MODIFIERS:
+        void readFile(std::istream& input);
+        void readBuffer(const char* data, unsigned long size);
+        void clear();
+
+    protected:
+        // HELPERS:
+        bool readRecord(const char* line, unsigned int length,
+                unsigned int offset, unsigned int& readingModel, bool& expdta);
+        void addAtomLine(const char* line, unsigned int length,
+                unsigned int offset, unsigned int model);
+
+        // ATTRIBUTES
+    private:
+        bool loaded; // readFile() was called
+        std::string header; // first HEADER record
+        unsigned int expdtaModels; // models declared by EXPDTA
+        std::vector<unsigned int> models; // MODEL numbers
+        std::vector<char> chains; // chains of the ATOM records, first model
+        std::vector<Block> blocks; // atom records by model and chain
+        std::string buffer; // atom records, back to back
+        const char* source; // records scanned by readBuffer(), else NULL
+
+        std::vector<std::pair<int, int> > helixData; // first and last residue
+        std::string helixCode; // chain of each helixData element
+        std::vector<std::pair<int, int> > sheetData;
+        std::string sheetCode;
+
+    };
+
+}} //namespace
+#endif //_PDB_FILE_H_
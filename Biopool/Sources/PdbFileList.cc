@@ -0,0 +1,135 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Includes:
+#include <PdbFileList.h>
+#include <IoTools.h>
+#include <Debug.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+extern "C" {
+#include <dirent.h>
+#include <sys/stat.h>
+}
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Basic constructor, no files
+ */
+PdbFileList::PdbFileList() : entries() {
+    PRINT_NAME;
+}
+
+/**
+ *  Basic destructor
+ */
+PdbFileList::~PdbFileList() {
+    PRINT_NAME;
+}
+
+// MODIFIERS:
+
+/**
+ *@param path PDB file
+ *@param chain chain ID, blank for the default one
+ */
+void
+PdbFileList::addFile(const string& path, char chain) {
+    Entry e;
+    e.path = path;
+    e.chain = chain;
+    entries.push_back(e);
+}
+
+/**
+ *   Adds the files of a directory and of its subdirectories, sorted by
+ *   path so that runs are reproducible.
+ *@param dir directory
+ *@param suffix end of the file names to add (e.g. ".ent" for a PDB mirror)
+ */
+void
+PdbFileList::addDirectory(const string& dir, const string& suffix) {
+    vector<string> paths;
+    findFiles(dir, suffix, paths);
+    sort(paths.begin(), paths.end());
+    for (unsigned int i = 0; i < paths.size(); i++)
+        addFile(paths[i]);
+}
+
+/**
+ *   Adds the files of a file list, one path per line. Blank lines are
+ *   skipped.
+ *@param fileList file list
+ *@param withChains read the chain ID following the path, if any
+ */
+void
+PdbFileList::addFileList(const string& fileList, bool withChains) {
+    ifstream in(fileList.c_str());
+    if (!in)
+        ERROR("File not found: " + fileList, exception);
+
+    while (in) {
+        istringstream line(readLine(in));
+        string path, chain;
+        line >> path >> chain;
+        if (path.empty())
+            continue;
+        addFile(path, (withChains && !chain.empty()) ? chain[0] : ' ');
+    }
+}
+
+// HELPERS:
+
+/**
+ *   Collects the files of dir ending in suffix, recursively.
+ *@param dir directory
+ *@param suffix end of the file names
+ *@param paths files found
+ */
+void
+PdbFileList::findFiles(const string& dir, const string& suffix,
+        vector<string>& paths) {
+    DIR* d = opendir(dir.c_str());
+    if (d == NULL)
+        ERROR("Directory not found: " + dir, exception);
+
+    string prefix = dir;
+    if ((prefix.size() > 0) && (prefix[prefix.size() - 1] != '/'))
+        prefix += "/";
+
+    struct dirent* de;
+    while ((de = readdir(d)) != NULL) {
+        string name = de->d_name;
+        if ((name == ".") || (name == ".."))
+            continue;
+
+        string path = prefix + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+            findFiles(path, suffix, paths);
+        else if ((name.size() >= suffix.size())
+                && (name.compare(name.size() - suffix.size(), suffix.size(),
+                suffix) == 0))
+            paths.push_back(path);
+    }
+    closedir(d);
+}
@@ -0,0 +1,80 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PDB_FILE_LIST_H_
+#define _PDB_FILE_LIST_H_
+
+// Includes:
+#include <string>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    /**@brief PDB files to process, from directories and file lists.
+     *
+     *  Collects the files of a whole directory tree (e.g. a PDB mirror) or
+     *  of a file list in the format of the APPS "-I" option: one path per
+     *  line, optionally followed by a chain ID. The entries are walked by
+     *  index, or handed to a PdbPipeline.
+     * */
+    class PdbFileList {
+    public:
+
+        /**
+         *  One file and the chain to load, blank for the default one.
+         */
+        struct Entry {
+            std::string path;
+            char chain;
+        };
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        PdbFileList();
+        virtual ~PdbFileList();
+
+        // PREDICATES:
+
+        unsigned int size() const {
+            return entries.size();
+        }
+
+        const Entry& operator[](unsigned int n) const {
+            return entries[n];
+        }
+
+        // MODIFIERS:
+        void addFile(const std::string& path, char chain = ' ');
+        void addDirectory(const std::string& dir, const std::string& suffix = ".pdb");
+        void addFileList(const std::string& fileList, bool withChains = false);
+
+        void clear() {
+            entries.clear();
+        }
+
+    protected:
+        // HELPERS:
+        void findFiles(const std::string& dir, const std::string& suffix,
+                std::vector<std::string>& paths);
+
+        // ATTRIBUTES
+    private:
+        std::vector<Entry> entries;
+
+    };
+
+}} //namespace
+#endif //_PDB_FILE_LIST_H_
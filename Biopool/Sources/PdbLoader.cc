@@ -25,6 +25,7 @@
 #include <Ligand.h>
 #include <Nucleotide.h>
 #include <AminoAcidHydrogen.h>
+#include <Profiler.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -41,19 +42,19 @@ using namespace Victor; using namespace Victor::Biopool;
 
 unsigned int
 PdbLoader::getMaxModels() {
-    input.clear(); // reset file to previous content 
-    input.seekg(0);
-
-    unsigned int max = 0;
-
-    while (input) {
-        string atomLine = readLine(input);
-        string tag = atomLine.substr(0, 6);
+    readFile();
+    return pdbFile.getMaxModels();
+}
 
-        if (tag == "MODEL ")
-            max++;
-    }
-    return max;
+/**
+ *  Reads in the numbers of the NMR models, in file order
+ *@param none
+ *@return  vector of model numbers, empty if there are no MODEL records
+ */
+vector<unsigned int>
+PdbLoader::getModels() {
+    readFile();
+    return pdbFile.getModels();
 }
 
 /**
@@ -94,62 +95,27 @@ PdbLoader::checkModel() {
 
 /**
  *    Reads in the maximum allowed number of NMR models, zero otherwise.
- *    This is a faster version because we only need to read the line with
- *    EXPDTA
+ *    Only uses the line with EXPDTA, which may disagree with the MODEL
+ *    records counted by getMaxModels()
  *@param   void
  *@return  unsigned int
  */
 unsigned int
 PdbLoader::getMaxModelsFast() {
-    input.clear();
-    input.seekg(0);
-    while (input) {
-        string line = readLine(input);
-        if (line.substr(0, 6) == "EXPDTA") {
-            istringstream str(line);
-            string header, nmr, structures;
-            unsigned int models;
-            str >> header >> nmr >> models >> structures;
-            return models;
-        }
-    }
-
-    return 0;
+    readFile();
+    return pdbFile.getExpdtaModels();
 }
 
 /**
  *    Returns all available chain IDs for a PDB file.
- *    
+ *    Only the first model is considered: others duplicate chainIDs
  *@param   void
  *@return  vector of chars
  */
 vector<char>
 PdbLoader::getAllChains() {
-    vector<char> res;
-    char lastChain = ' ';
-    input.clear(); // reset file to previous content 
-    input.seekg(0);
-    unsigned int max = 0;
-
-    while (input) {
-        string atomLine = readLine(input);
-
-        if (atomLine.substr(0, 5) == "MODEL")
-            max++;
-        if (max > 1) // only consider first model: others duplicate chainIDs
-            break;
-
-        // check for new chains containing amino acids
-        if ((atomLine.substr(0, 4) == "ATOM")
-                && (atomLine.substr(21, 1)[0] != lastChain))
-            //&& (aminoAcidThreeLetterTranslator(atomLine.substr(17,3)) != XXX))
-        {
-            lastChain = atomLine.substr(21, 1)[0];
-            res.push_back(lastChain);
-        }
-    }
-
-    return res;
+    readFile();
+    return pdbFile.getChains();
 }
 
 /**
@@ -250,7 +216,33 @@ PdbLoader::loadSpacer(Spacer& sp){
  */
 
 /**
- *   Core function for PDB file parsing. 
+ *   Reads the records of input, the first time only.
+ */
+void
+PdbLoader::readFile() {
+    if (pdbFile.isRead())
+        return;
+    input.clear(); // reset file to previous content 
+    if (input.tellg() > 0)
+        input.seekg(0, ios::beg);
+    pdbFile.readFile(input);
+}
+
+/**
+ *   Reads the records of a PDB file in memory, in place of input. The
+ *   atom records are not copied.
+ *@param data contents of the PDB file, valid as long as the loader is used
+ *@param size bytes of data
+ */
+void
+PdbLoader::readBuffer(const char* data, unsigned long size) {
+    pdbFile.readBuffer(data, size);
+}
+
+/**
+ *   Core function for PDB file parsing. The selected chains and model are
+ *   built from the records read once by readFile(): chain and model are
+ *   left as they were, so that the same loader can load other ones.
  * @param prot (Protein&)
  */
 
@@ -258,6 +250,7 @@ void
 PdbLoader::loadProtein(Protein& prot) {
 
     PRINT_NAME;
+    PROFILE_REGION("PdbLoader::loadProtein");
 
     vector<char> chainList = getAllChains();
 
@@ -268,11 +261,16 @@ PdbLoader::loadProtein(Protein& prot) {
     }
 
 
-    unsigned int readingModel = model;
+    const char userChain = chain;
+    char selectedChain = chain;
+    unsigned int readingModel = (model == 999) ? pdbFile.getFirstModel() : model;
     bool loadChain = false;
+    valid = true;
 
-    helixCode = "";
-    sheetCode = "";
+    helixData = pdbFile.getHelixData();
+    helixCode = pdbFile.getHelixCode();
+    sheetData = pdbFile.getSheetData();
+    sheetCode = pdbFile.getSheetCode();
 
 
     string path = "data/AminoAcidHydrogenData.txt";
@@ -289,13 +287,13 @@ PdbLoader::loadProtein(Protein& prot) {
             loadChain = true;
         } else {
             // Load only first chain
-            if (chain == ' ') {
+            if (selectedChain == ' ') {
                 loadChain = true;
-                chain = '#';
+                selectedChain = '#';
             }                // Load only selected chain
-            else if (chainList[i] == chain) {
+            else if (chainList[i] == selectedChain) {
                 loadChain = true;
-                chain = '#';
+                selectedChain = '#';
             }
         }
 
@@ -306,15 +304,9 @@ PdbLoader::loadProtein(Protein& prot) {
             }
             setChain(chainList[i]);
 
-            input.clear(); // reset file to previous content 
-            input.seekg(0, ios::beg);
-
             Spacer* sp = new Spacer();
             LigandSet* ls = new LigandSet();
 
-            string atomLine;
-            atomLine = readLine(input);
-
             int aaNum = -100000; // infinite negative
             int oldAaNum = -100000;
             //int lastAa = -10000;
@@ -322,104 +314,68 @@ PdbLoader::loadProtein(Protein& prot) {
             AminoAcid* aa = new AminoAcid();
             Ligand* lig = new Ligand();
 
+            if (pdbFile.getHeader() != "")
+                sp->setType(pdbFile.getHeader());
 
-            int start, end;
+            // "ATOM" and "HETATM" records of the chain in the model
+            vector<PdbFile::Line> atomLines =
+                    pdbFile.getAtomLines(chainList[i], readingModel);
+            PdbFile::AtomRecord rec;
 
-            string name = "";
-            string tag = "";
+            for (unsigned int k = 0; k < atomLines.size(); k++) {
+                if (!PdbFile::parseAtomRecord(atomLines[k].data,
+                        atomLines[k].length, rec)) {
+                    if (verbose)
+                        cout << "Warning: Skipping atom record without coordinates: "
+                            << string(atomLines[k].data, atomLines[k].length) << "\n";
+                    continue;
+                }
+                aaNum = rec.resSeq;
+
+                // Insert the Ligand object into LigandSet
+                if (aaNum != oldAaNum) {
+                    // Print some indexes for the debug
+                    /* 
+                    cout << aa->getType1L() << " offset:" << sp->getStartOffset() << " gaps:" 
+                         << sp->sizeGaps() << " sizeAmino:" <<  sp->sizeAmino() <<  " maxPdbNum:" 
+                         << sp->maxPdbNumber() << " aaNum:" << aaNum  
+                         << " oldAaNum:" << oldAaNum << " lastAa:" << lastAa << "\n";
+                     */
+                    if ((aa->size() > 0) && (aa->getType1L() != 'X')) { // Skip the first empty AminoAcid
+                        if (sp->sizeAmino() == 0) {
+                            sp->setStartOffset(oldAaNum - 1);
+                        } else {
+                            // Add gaps
+                            //for (int i = lastAa+1; i < oldAaNum; i++){
+                            for (int i = sp->maxPdbNumber() + 1; i < oldAaNum; i++) {
+                                sp->addGap(i);
+                            }
 
-            // read all lines
-            do {
+                        }
 
-                tag = atomLine.substr(0, 6);
+                        sp->insertComponent(aa);
 
-                if ((tag == "HEADER") && (name == "")) {
-                    name = atomLine;
-                    sp->setType(name);
-                } else if (tag == "MODEL ") {
-                    readingModel = stouiDEF(atomLine.substr(6, 10));
-                    if (readingModel > model)
-                        break;
-                    // Get only the first model if not specified
-                    if (model == 999) {
-                        model = readingModel;
                     }
-                }
-
-                    // read helix entry
-                else if (tag == "HELIX ") {
-                    start = stoiDEF(atomLine.substr(21, 4));
-                    end = stoiDEF(atomLine.substr(33, 4));
 
-                    helixData.push_back(pair<const int, int>(start, end));
-                    helixCode += atomLine.substr(19, 1).c_str()[0];
-                }                    // read sheet entry
-                else if (tag == "SHEET ") {
-                    start = stoiDEF(atomLine.substr(22, 4));
-                    end = stoiDEF(atomLine.substr(33, 4));
+                    // Ligand
+                    if (lig->size() > 0) {
 
-                    sheetData.push_back(pair<const int, int>(start, end));
-                    sheetCode += atomLine.substr(21, 1).c_str()[0];
-                }
-
-                    // Parse one line of the "ATOM" and "HETATM" fields
-                else if ((tag == "ATOM  ") || (tag == "HETATM")) {
-
-                    char chainID = atomLine.substr(21, 1)[0];
-                    if (chainList[i] == chainID) {
-
-                        if ((model == 999) || (model == readingModel)) {
-                            aaNum = stoiDEF(atomLine.substr(22, 4));
-
-                            // Insert the Ligand object into LigandSet
-                            if (aaNum != oldAaNum) {
-                                // Print some indexes for the debug
-                                /* 
-                                cout << aa->getType1L() << " offset:" << sp->getStartOffset() << " gaps:" 
-                                     << sp->sizeGaps() << " sizeAmino:" <<  sp->sizeAmino() <<  " maxPdbNum:" 
-                                     << sp->maxPdbNumber() << " aaNum:" << aaNum  
-                                     << " oldAaNum:" << oldAaNum << " lastAa:" << lastAa << "\n";
-                                 */
-                                if ((aa->size() > 0) && (aa->getType1L() != 'X')) { // Skip the first empty AminoAcid
-                                    if (sp->sizeAmino() == 0) {
-                                        sp->setStartOffset(oldAaNum - 1);
-                                    } else {
-                                        // Add gaps
-                                        //for (int i = lastAa+1; i < oldAaNum; i++){
-                                        for (int i = sp->maxPdbNumber() + 1; i < oldAaNum; i++) {
-                                            sp->addGap(i);
-                                        }
-
-                                    }
-
-                                    sp->insertComponent(aa);
-
-                                }
-
-                                // Ligand
-                                if (lig->size() > 0) {
-
-                                    if (onlyMetalHetAtoms) {
-                                        if (lig->isSimpleMetalIon()) { // skip not metal ions  
-                                            ls->insertComponent(lig);
-                                        }
-                                    } else {
-                                        ls->insertComponent(lig);
-                                    }
-                                }
-
-                                aa = new AminoAcid();
-                                lig = new Ligand();
+                        if (onlyMetalHetAtoms) {
+                            if (lig->isSimpleMetalIon()) { // skip not metal ions  
+                                ls->insertComponent(lig);
                             }
+                        } else {
+                            ls->insertComponent(lig);
+                        }
+                    }
 
-                            oldAaNum = parsePDBline(atomLine, tag, lig, aa);
-
-                        } // end model check
-                    } // end chain check
+                    aa = new AminoAcid();
+                    lig = new Ligand();
                 }
-                atomLine = readLine(input);
 
-            } while (input);
+                oldAaNum = parsePDBline(rec, lig, aa);
+
+            }
 
             
             /*
@@ -560,43 +516,27 @@ PdbLoader::loadProtein(Protein& prot) {
         } // end loadChain
     } // chains iteration
 
+    chain = userChain;
+
 }
 
 /**
- *   Parse a single line of a PDB file.
- * @param atomLine (string) the whole PDB line as it is
- * @param tag (string) = the first field (keyword) in a PDB line
+ *   Adds the atom of a single line of a PDB file.
+ * @param rec (PdbFile::AtomRecord) fields of the line, see PdbFile::parseAtomRecord()
  * @param lig (Ligand) pointer
  * @param aa (AminoAcid) pointer
  * @return Residue number read from the PDB line (int)
  */
 int
-PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa) {
-
-    int atNum = stoiDEF(atomLine.substr(6, 5)); // stoi convert from string to int
-    //char altAtID = atomLine.substr(16,1)[0];    // "Alternate location indicator"               
-    int aaNum = stoiDEF(atomLine.substr(22, 4));
-    char altAaID = atomLine.substr(26, 1)[0]; // "Code for insertion of residues"
-    vgVector3<double> coord;
-    coord.x = stodDEF(atomLine.substr(30, 8));
-    coord.y = stodDEF(atomLine.substr(38, 8));
-    coord.z = stodDEF(atomLine.substr(46, 8));
-    double bfac = 0.0;
-    if (atomLine.length() >= 66) {
-        if (atomLine.substr(60, 6) != "      ") { // empty bfac
-            bfac = stodDEF(atomLine.substr(60, 6));
-        }
-    }
-    string atType = "";
-    for (int i = 11; i < 17; i++) {
-        if (atomLine[i] != ' ')
-            atType.append(atomLine.substr(i, 1));
-    }
-    string aaType = "";
-    for (int i = 17; i < 20; i++) {
-        if (atomLine[i] != ' ')
-            aaType.append(atomLine.substr(i, 1));
-    }
+PdbLoader::parsePDBline(const PdbFile::AtomRecord& rec, Ligand* lig, AminoAcid* aa) {
+
+    int atNum = rec.serial;
+    int aaNum = rec.resSeq;
+    char altAaID = rec.iCode; // "Code for insertion of residues"
+    vgVector3<double> coord(rec.x, rec.y, rec.z);
+    double bfac = rec.bFactor;
+    string atType = rec.name; // includes the "Alternate location indicator"
+    string aaType = rec.resName;
     // take care of deuterium atoms
     if (atType == "D") {
         cerr << "--> " << atType << "\n";
@@ -604,27 +544,26 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
     }
 
     // Initialize the Atom object
-    Atom* at = new Atom();
-    at->setNumber(atNum);
-    at->setType(atType);
-    at->setCoords(coord);
-    //at->setCoords(stod(atomLine.substr(30,8)),stod(atomLine.substr(38,8)),stod(atomLine.substr(46,8)));
-    at->setBFac(bfac);
+    Atom at;
+    at.setNumber(atNum);
+    at.setType(atType);
+    at.setCoords(coord);
+    at.setBFac(bfac);
 
     // Ligand object (includes DNA/RNA in "ATOM" field)
-    if ((tag == "HETATM") || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType))) {
+    if ((rec.het) || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType))) {
 
         if (noWater) {
             if (!(aaType == "HOH")) {
-                lig->addAtom(*at);
+                lig->addAtom(at);
                 lig->setType(aaType);
             }
         } else {
-            lig->addAtom(*at);
+            lig->addAtom(at);
             lig->setType(aaType);
         }
     }        // AminoAcid
-    else if ((tag == "ATOM  ")) {
+    else {
 
         // skip N-terminal ACE groups
         if (aaType != "ACE") {
@@ -638,12 +577,12 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
                 aa->setType(aaType);
                 aa->getSideChain().setType(aaType);
 
-                if (!noHAtoms || isHeavyAtom(at->getCode())) {
+                if (!noHAtoms || isHeavyAtom(at.getCode())) {
 
-                    if (!inSideChain(*aa, *at))
-                        aa->addAtom(*at);
+                    if (!inSideChain(*aa, at))
+                        aa->addAtom(at);
                     else {
-                        aa->getSideChain().addAtom(*at);
+                        aa->getSideChain().addAtom(at);
                     }
                 }
             }
@@ -653,6 +592,5 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
                 cout << "Warning: Skipping N-terminal ACE group " << aaNum << " " << atNum << ".\n";
         }
     }
-    delete at;
     return aaNum;
 }
@@ -25,6 +25,7 @@
 #include <Spacer.h>
 #include <LigandSet.h>
 #include <Protein.h>
+#include <PdbFile.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -32,6 +33,12 @@ namespace Victor { namespace Biopool {
 
     /**@brief Loads components (Atoms, Groups, Spacer, etc.) in standard PDB format.
      *   
+     *  The input is read only once, into a PdbFile, the first time it is
+     *  needed. The queries (chains, models) and every loadProtein() use
+     *  those records, so other chains and models can be selected with
+     *  setChain() and setModel() and loaded again without re-reading.
+     *  A file already in memory (e.g. a MappedFile) is given with
+     *  readBuffer() instead of the stream.
      * */
     class PdbLoader : public Loader {
     public:
@@ -63,7 +70,7 @@ namespace Victor { namespace Biopool {
         allChains(_allChains), chain(' '), model(999), altAtom('A'), helixCode(_NULL),
         //sheetCode(_NULL), helixData(), sheetData(), onlyMetalHetAtoms(_onlyMetal), 
         sheetCode(_NULL), onlyMetalHetAtoms(_onlyMetal),
-        noNucleotideChains(_noNucleotideChains) {
+        noNucleotideChains(_noNucleotideChains), pdbFile() {
         }
 
         // this class uses the implicit copy operator.
@@ -82,6 +89,7 @@ namespace Victor { namespace Biopool {
         unsigned int getMaxModels();
         unsigned int getMaxModelsFast();
         vector<char> getAllChains();
+        vector<unsigned int> getModels();
 
         // MODIFIERS:
 
@@ -144,6 +152,8 @@ namespace Victor { namespace Biopool {
             allChains = true;
         }
 
+        void readBuffer(const char* data, unsigned long size);
+
 
 
         //virtual void loadSpacer(Spacer& sp);
@@ -160,7 +170,8 @@ namespace Victor { namespace Biopool {
         bool inSideChain(const AminoAcid& aa, const Atom& at);
         void loadSecondary();
         void assignSecondary(Spacer& sp);
-        int parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa);
+        int parsePDBline(const PdbFile::AtomRecord& rec, Ligand* lig, AminoAcid* aa);
+        void readFile();
 
 
 
@@ -189,6 +200,8 @@ namespace Victor { namespace Biopool {
         vector<pair<int, int> > helixData; //inizio e fine dell'elica
         vector<pair<int, int> > sheetData;
 
+        PdbFile pdbFile; // records of input, read once
+
     };
 
 }} //namespace
@@ -0,0 +1,217 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Includes:
+#include <PdbPipeline.h>
+#include <AminoAcidHydrogen.h>
+#include <Debug.h>
+#include <Profiler.h>
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *@param files files to process, not copied
+ *@param threads threads reading and building files
+ */
+PdbPipeline::PdbPipeline(const PdbFileList& files, unsigned int threads) :
+files(files), threads((threads > 0) ? threads : 1), window(0), items(),
+next(0), analyzed(0), stopped(false) {
+    PRINT_NAME;
+    window = 4 * this->threads;
+}
+
+/**
+ *  Basic destructor
+ */
+PdbPipeline::~PdbPipeline() {
+    PRINT_NAME;
+    for (unsigned int i = 0; i < items.size(); i++)
+        pRelease(i);
+}
+
+// MODIFIERS:
+
+/**
+ *   Processes all files, or until analyze() returns false. A file that
+ * cannot be built ends the run with an error once the files before it
+ * are analyzed, whatever the number of threads.
+ */
+void
+PdbPipeline::run() {
+    Item empty = {NULL, NULL, NULL, false, false};
+    items.assign(files.size(), empty);
+    next = 0;
+    analyzed = 0;
+    stopped = false;
+
+    if (threads <= 1) {
+        for (unsigned int i = 0; i < items.size(); i++) {
+            pBuild(i);
+            bool goOn = pAnalyze(i);
+            pRelease(i);
+            if (!goOn)
+                break;
+        }
+        return;
+    }
+
+    // PdbLoader reads the hydrogen parameters on first use, which must not
+    // happen in several workers at once
+    const char* root = getenv("VICTOR_ROOT");
+    if (root == NULL)
+        ERROR("Environment variable VICTOR_ROOT was not found.", exception);
+    AminoAcidHydrogen::loadParam(string(root) + "data/AminoAcidHydrogenData.txt");
+
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&builtCond, NULL);
+    pthread_cond_init(&roomCond, NULL);
+    vector<pthread_t> pool(threads);
+    for (unsigned int t = 0; t < threads; t++)
+        if (pthread_create(&pool[t], NULL, pWorker, this) != 0)
+            ERROR("Could not start pipeline thread.", exception);
+
+    unsigned int failed = items.size();
+    for (unsigned int i = 0; i < items.size(); i++) {
+        pthread_mutex_lock(&lock);
+        while (!items[i].built)
+            pthread_cond_wait(&builtCond, &lock);
+        if (items[i].failed) {
+            failed = i;
+            stopped = true;
+            pthread_cond_broadcast(&roomCond);
+        }
+        pthread_mutex_unlock(&lock);
+        if (failed < items.size())
+            break;
+
+        bool goOn = pAnalyze(i);
+        pRelease(i);
+
+        pthread_mutex_lock(&lock);
+        analyzed = i + 1;
+        stopped = !goOn;
+        pthread_cond_broadcast(&roomCond);
+        pthread_mutex_unlock(&lock);
+        if (!goOn)
+            break;
+    }
+
+    for (unsigned int t = 0; t < threads; t++)
+        pthread_join(pool[t], NULL);
+    pthread_cond_destroy(&roomCond);
+    pthread_cond_destroy(&builtCond);
+    pthread_mutex_destroy(&lock);
+    for (unsigned int i = 0; i < items.size(); i++)
+        pRelease(i);
+
+    // the exception itself cannot be passed between threads
+    if (failed < items.size())
+        ERROR("Could not build " + files[failed].path, exception);
+}
+
+/**
+ *@param entry file and chain
+ *@param pl loader of the file, already read
+ *@param prot structure to load
+ */
+void
+PdbPipeline::build(const PdbFileList::Entry& entry, PdbLoader& pl,
+        Protein& prot) {
+    pl.setNoHAtoms();
+    pl.setNoVerbose();
+    pl.setPermissive();
+    if (entry.chain != ' ')
+        pl.setChain(entry.chain);
+    prot.load(pl);
+}
+
+// HELPERS:
+
+/**
+ *   Maps a file, splits its records and builds its structure.
+ *@param i index of the file
+ */
+void
+PdbPipeline::pBuild(unsigned int i) {
+    PROFILE_REGION("PdbPipeline::build");
+    Item& it = items[i];
+    it.file = new MappedFile(files[i].path);
+    if (!it.file->isOpen())
+        ERROR("File not found: " + files[i].path, exception);
+    it.loader = new PdbLoader();
+    it.loader->readBuffer(it.file->getData(), it.file->size());
+    it.prot = new Protein();
+    build(files[i], *it.loader, *it.prot);
+}
+
+bool
+PdbPipeline::pAnalyze(unsigned int i) {
+    PROFILE_REGION("PdbPipeline::analyze");
+    return analyze(files[i], *items[i].loader, *items[i].prot);
+}
+
+/**
+ *   Frees the stages of a file.
+ *@param i index of the file
+ */
+void
+PdbPipeline::pRelease(unsigned int i) {
+    Item& it = items[i];
+    delete it.prot;
+    delete it.loader;
+    delete it.file;
+    it.prot = NULL;
+    it.loader = NULL;
+    it.file = NULL;
+}
+
+/**
+ *   Builds files in list order, at most window files ahead of analyze().
+ * A failed build is recorded on its item.
+ */
+void*
+PdbPipeline::pWorker(void* pipeline) {
+    PdbPipeline& p = *static_cast<PdbPipeline*> (pipeline);
+
+    while (true) {
+        pthread_mutex_lock(&p.lock);
+        while (!p.stopped && (p.next < p.items.size())
+                && (p.next >= p.analyzed + p.window))
+            pthread_cond_wait(&p.roomCond, &p.lock);
+        if (p.stopped || (p.next >= p.items.size())) {
+            pthread_mutex_unlock(&p.lock);
+            break;
+        }
+        unsigned int i = p.next++;
+        pthread_mutex_unlock(&p.lock);
+
+        // an exception must not leave the thread, run() reports it
+        bool failed = false;
+        try {
+            p.pBuild(i);
+        } catch (...) {
+            failed = true;
+        }
+
+        pthread_mutex_lock(&p.lock);
+        p.items[i].failed = failed;
+        p.items[i].built = true;
+        pthread_cond_broadcast(&p.builtCond);
+        pthread_mutex_unlock(&p.lock);
+    }
+    return NULL;
+}
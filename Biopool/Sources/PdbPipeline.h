@@ -0,0 +1,105 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PDB_PIPELINE_H_
+#define _PDB_PIPELINE_H_
+
+// Includes:
+#include <PdbFileList.h>
+#include <PdbLoader.h>
+#include <Protein.h>
+#include <MappedFile.h>
+#include <pthread.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    /**@brief Reads, builds and analyzes the structures of many PDB files.
+     *
+     *  The files of a PdbFileList go through three stages: read (the file
+     *  is memory-mapped and its records split in place), build (build()
+     *  loads the structure) and analyze (analyze() uses it). Reading and
+     *  building run on a pool of threads, a bounded number of files ahead,
+     *  while analyze() is called on the thread of run(), one file at a
+     *  time and in list order, so it needs no locking and its output is
+     *  the same with any number of threads.
+     *
+     *  An application derives from PdbPipeline and overrides analyze(),
+     *  and build() if the default loading does not fit.
+     *  A file that cannot be read or built stops the run at its place in
+     *  the list, with the files before it analyzed, as with one thread.
+     * */
+    class PdbPipeline {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        PdbPipeline(const PdbFileList& files, unsigned int threads = 1);
+        virtual ~PdbPipeline();
+
+        // MODIFIERS:
+        void run();
+
+    protected:
+        /**
+         *  Loads the structure of a file, on a worker thread. By default
+         *  the chain of the entry (or the first one), without hydrogens,
+         *  permissive.
+         */
+        virtual void build(const PdbFileList::Entry& entry, PdbLoader& pl,
+                Protein& prot);
+
+        /**
+         *  Uses the structure of a file, in list order.
+         *@return false to stop the run
+         */
+        virtual bool analyze(const PdbFileList::Entry& entry, PdbLoader& pl,
+                Protein& prot) = 0;
+
+        // HELPERS:
+        void pBuild(unsigned int i);
+        bool pAnalyze(unsigned int i);
+        void pRelease(unsigned int i);
+        static void* pWorker(void* pipeline);
+
+        /**
+         *  Stages of one file, until it is analyzed.
+         */
+        struct Item {
+            MappedFile* file;
+            PdbLoader* loader;
+            Protein* prot;
+            bool built;
+            bool failed; // build() threw on a worker
+        };
+
+        // ATTRIBUTES
+    private:
+        const PdbFileList& files;
+        unsigned int threads;
+        unsigned int window; // files read ahead of analyze()
+
+        std::vector<Item> items;
+        unsigned int next; // next file to build
+        unsigned int analyzed; // files analyzed
+        bool stopped;
+        pthread_mutex_t lock;
+        pthread_cond_t builtCond; // a file was built
+        pthread_cond_t roomCond; // a file was analyzed
+
+    };
+
+}} //namespace
+#endif //_PDB_PIPELINE_H_
@@ -89,6 +89,16 @@ void SideChain::setBackboneRef(AminoAcid* br) {
         (*this)[0].bindIn((*backboneRef)[CA]);
 }
 
+/**
+ *   Marks the backbone as well: the side chain has no superior, and the
+ * Spacer only looks at its residues.
+ */
+void SideChain::setAtomsModified() {
+    Group::setAtomsModified();
+    if (backboneRef != NULL)
+        backboneRef->setAtomsModified();
+}
+
 /**
  *   Determines the 3-letter code from sidechain atoms and sets the AminoAcid Type
  */
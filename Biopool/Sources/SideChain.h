@@ -59,6 +59,7 @@ namespace Victor { namespace Biopool {
         void setChi(unsigned int n, double c);
         void setChi(vector<double> cv);
         void setBackboneRef(AminoAcid* br);
+        virtual void setAtomsModified();
 
         void copy(const SideChain& orig);
         void load(Loader& l); // data loader
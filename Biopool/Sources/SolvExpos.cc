@@ -15,9 +15,14 @@
  */
 
 #include <SolvExpos.h>
+#include <SpacerCoordinates.h>
+#include <NeighborGrid.h>
 
 using namespace Victor; using namespace Victor::Biopool;
 
+// residues whose representative atoms are closer than this are neighbours
+static const double NEIGHBOUR_CUTOFF = 10; // Angstrom
+
 SolvExpos::SolvExpos(){
 }
 SolvExpos::~SolvExpos(){
@@ -73,8 +78,6 @@ Atom& SolvExpos::getReprAtom(AminoAcid &amino) {
 unsigned int SolvExpos::getNumNeighbours(Spacer &chain, const unsigned int tgt,
 
         const unsigned int start, const unsigned int end) {
-    const double CUTOFF = 10; // Angstrom
-
     AminoAcid& ta = chain.getAmino(tgt);
     Atom& tr = getReprAtom(ta);
 
@@ -84,7 +87,7 @@ unsigned int SolvExpos::getNumNeighbours(Spacer &chain, const unsigned int tgt,
         try {
             Atom &ir = getReprAtom(ia);
             double dist = tr.distance(ir);
-            if (dist <= CUTOFF)
+            if (dist <= NEIGHBOUR_CUTOFF)
                 tot++;
         } catch (const char* err) {
             ;
@@ -152,8 +155,16 @@ vector<SolvExpos::SolvExposEnum>* SolvExpos::getSolvExposVec(Spacer& chain,
     const unsigned int tgtNum = tgtE - tgtS;
     vector<SolvExpos::SolvExposEnum>* seVec = new vector<SolvExpos::SolvExposEnum>(tgtNum);
 
+    const unsigned int NGB_MIN = 20;
+    const SpacerCoordinates& coords = chain.getCoordinates();
+    vector<int> repr = pGetReprAtomIndexes(chain, coords);
+    NeighborGrid grid(NEIGHBOUR_CUTOFF);
+    vector<unsigned int> reprResidue;
+    pBuildReprGrid(coords, repr, grid, reprResidue);
+
     for (unsigned int t = 0; t < tgtNum; ++t)
-        (*seVec)[t] = getSolvExpos(chain, tgtS + t, envS, envE);
+        (*seVec)[t] = (pGetNumNeighbours(chain, coords, repr, grid, reprResidue,
+            tgtS + t, envS, envE) > NGB_MIN) ? CORE : EXPOSED;
 
     return seVec;
 }
@@ -214,10 +225,102 @@ vector<double> SolvExpos::getSolvAccessVec(Spacer &chain, unsigned int tgtS,
         unsigned int tgtE, unsigned int envS, unsigned int envE) {
     const unsigned int tgtNum = tgtE - tgtS;
 
+    const double NGB_MAX = 30;
+    const SpacerCoordinates& coords = chain.getCoordinates();
+    vector<int> repr = pGetReprAtomIndexes(chain, coords);
+    NeighborGrid grid(NEIGHBOUR_CUTOFF);
+    vector<unsigned int> reprResidue;
+    pBuildReprGrid(coords, repr, grid, reprResidue);
+
     vector<double> seVec(tgtNum);
 
-    for (unsigned int t = 0; t < tgtNum; ++t)
-        seVec[t] = getSolvAccess(chain, tgtS + t, envS, envE);
+    for (unsigned int t = 0; t < tgtNum; ++t) {
+        double ngb = (double) pGetNumNeighbours(chain, coords, repr, grid,
+                reprResidue, tgtS + t, envS, envE);
+        seVec[t] = (NGB_MAX - min(ngb, NGB_MAX)) / NGB_MAX;
+    }
 
     return seVec;
 }
+
+/**
+ *  Looks up the representative atom of every residue in the coordinate view.
+ *  Residues without a representative atom are marked with -1.
+ *@param chain: a Spacer object representing an entire protein chain.
+ *       coords: coordinate view of the chain.
+ *@return vector of atom indexes in the coordinate view, one per residue.
+ */
+vector<int> SolvExpos::pGetReprAtomIndexes(Spacer &chain,
+        const SpacerCoordinates& coords) {
+    vector<int> repr(coords.sizeResidue(), -1);
+    for (unsigned int i = 0; i < coords.sizeResidue(); ++i) {
+        try {
+            Atom& ir = getReprAtom(chain.getAmino(i));
+            for (unsigned int j = coords.getResidueStart(i); j < coords.getResidueEnd(i); ++j)
+                if (&coords.getAtom(j) == &ir) {
+                    repr[i] = static_cast<int> (j);
+                    break;
+                }
+        } catch (const char* err) {
+            ;
+        }
+    }
+    return repr;
+}
+
+/**
+ *  Puts the representative atoms of all residues on a neighbour grid.
+ *@param coords: coordinate view of the chain.
+ *       repr: representative atom indexes, see pGetReprAtomIndexes().
+ *       grid: the grid to fill.
+ *       reprResidue: returns the residue of each point of the grid.
+ */
+void SolvExpos::pBuildReprGrid(const SpacerCoordinates& coords,
+        const vector<int>& repr, NeighborGrid& grid,
+        vector<unsigned int>& reprResidue) {
+    vector<vgVector3<double> > points;
+    reprResidue.clear();
+    for (unsigned int i = 0; i < repr.size(); ++i)
+        if (repr[i] >= 0) {
+            points.push_back(vgVector3<double>(coords.getX(repr[i]),
+                    coords.getY(repr[i]), coords.getZ(repr[i])));
+            reprResidue.push_back(i);
+        }
+    grid.build(points);
+}
+
+/**
+ *  Same as getNumNeighbours(), working on the coordinate view of the chain.
+ *  Only the residues found near the target on the grid are checked.
+ *@param chain: a Spacer object representing an entire protein chain.
+ *       coords: coordinate view of the chain.
+ *       repr: representative atom indexes, see pGetReprAtomIndexes().
+ *       grid, reprResidue: representative atoms, see pBuildReprGrid().
+ *       tgt, start, end: see getNumNeighbours().
+ *@return number of residues, in the fragment, that are neighbour to the target
+ *    residue.
+ */
+unsigned int SolvExpos::pGetNumNeighbours(Spacer &chain,
+        const SpacerCoordinates& coords, const vector<int>& repr,
+        const NeighborGrid& grid, const vector<unsigned int>& reprResidue,
+        const unsigned int tgt, const unsigned int start, const unsigned int end) {
+    if (repr[tgt] < 0) // reports the missing atom
+        getReprAtom(chain.getAmino(tgt));
+
+    vector<unsigned int> nb;
+    grid.getNeighbors(vgVector3<double>(coords.getX(repr[tgt]),
+            coords.getY(repr[tgt]), coords.getZ(repr[tgt])), NEIGHBOUR_CUTOFF, nb);
+
+    unsigned int tot = 0;
+    for (unsigned int n = 0; n < nb.size(); ++n) {
+        unsigned int i = reprResidue[nb[n]];
+        if ((i >= start) && (i < end)
+                && (coords.distance(repr[tgt], repr[i]) <= NEIGHBOUR_CUTOFF))
+            tot++;
+    }
+
+    if ((tgt >= start) && (tgt < end))
+        tot--;
+
+    return tot;
+}
@@ -21,6 +21,8 @@
 
 namespace Victor { namespace Biopool { 
 
+    class NeighborGrid;
+
     class SolvExpos {
     public:
 
@@ -54,7 +56,19 @@ namespace Victor { namespace Biopool {
 
         
     private:
-        
+
+        vector<int> pGetReprAtomIndexes(Spacer &chain,
+                const SpacerCoordinates& coords);
+        void pBuildReprGrid(const SpacerCoordinates& coords,
+                const vector<int>& repr, NeighborGrid& grid,
+                vector<unsigned int>& reprResidue);
+        unsigned int pGetNumNeighbours(Spacer &chain,
+                const SpacerCoordinates& coords, const vector<int>& repr,
+                const NeighborGrid& grid,
+                const vector<unsigned int>& reprResidue,
+                const unsigned int tgt, const unsigned int start,
+                const unsigned int end);
+
     };
 }} //namespace
 
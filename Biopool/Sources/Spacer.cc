@@ -16,6 +16,8 @@
 
 // Includes:
 #include <Spacer.h>
+#include <SpacerCoordinates.h>
+#include <NeighborGrid.h>
 #include <Debug.h>
 #include <IntCoordConverter.h>
 #include <limits.h>
@@ -48,7 +50,8 @@ double Spacer::BOND_ANGLE_AT_N_TO_CALPHA = 121.9;
  *  Basic constructor
  */
 Spacer::Spacer() : Polymer(1, 1), startOffset(0), startAtomOffset(0), gaps(),
-subSpacerList() {
+subSpacerList(), coordinates(NULL), coordinatesValid(false), aminoIndex(),
+aminoIndexValid(false) {
     PRINT_NAME;
 }
 
@@ -56,7 +59,8 @@ subSpacerList() {
  *  constructor based in another object
  *@param orig, reference to the original object to copy
  */
-Spacer::Spacer(const Spacer& orig) : subSpacerList() {
+Spacer::Spacer(const Spacer& orig) : subSpacerList(), coordinates(NULL),
+coordinatesValid(false), aminoIndex(), aminoIndexValid(false) {
     PRINT_NAME;
     this->copy(orig);
 }
@@ -66,6 +70,7 @@ Spacer::Spacer(const Spacer& orig) : subSpacerList() {
  */
 Spacer::~Spacer() {
     PRINT_NAME;
+    delete coordinates;
 }
 
 // PREDICATES:
@@ -203,6 +208,21 @@ const unsigned int Spacer::sizeAmino() const {
     return ( size() + count);
 }
 
+/**
+ *  Returns the flat (structure-of-arrays) coordinate view of the spacer.
+ * The view is attached to the spacer on first use and refreshed from the
+ * atoms at every call, so it is always consistent with the current structure.
+ * The reference stays valid until detachCoordinates() or destruction.
+ *@return  reference to the coordinate view
+ */
+const SpacerCoordinates& Spacer::getCoordinates() {
+    if (coordinates == NULL)
+        coordinates = new SpacerCoordinates;
+    coordinates->update(*this);
+    coordinatesValid = true;
+    return *coordinates;
+}
+
 /**
  *  Predicate used to get the range for the Helix amino acids
  *@return  vector containing the ranges
@@ -453,6 +473,7 @@ void Spacer::insertAminoAfterWithGaps(
     aa->addTrans(caTransBack);
     aa->sync();
     components.push_back(aa);
+    pInvalidateAminoIndex();
 }
 
 /**
@@ -589,6 +610,7 @@ void Spacer::insertAminoAfter(string code, unsigned int n, double phi, double ps
 
     static int XXX = 0;
     components.insert(components.begin() + n + 1, aa);
+    pInvalidateAminoIndex();
     if ((nOldSizeAmino >= 2) && ((int) n < nOldSizeAmino - 2)) {
         ++XXX;
         cout << "((" << XXX << "))";
@@ -735,25 +757,51 @@ void Spacer::insertAminoBefore(string code, unsigned int p, double phi, double p
     aa->patchBetaPosition();
 
     components.insert(components.begin() + p, aa);
+    pInvalidateAminoIndex();
 }
 
 
 
 /**
- *  Synchronizes coords with structure
+ *  Synchronizes coords with structure. Moved atoms mark their residue
+ * (see Group::setAtomsModified()), and the marked residues are synchronized
+ * in chain order: every atom then finds the atom it is bonded to already
+ * in place, instead of recursing back along the chain. Residues before the
+ * first marked one are not touched, nor copied into the coordinate view.
  */
-// 
-
 void Spacer::sync() {
     if (!modified)
         return;
 
-    for (unsigned int i = 0; i < sizeAmino(); i++)
-        getAmino(i).sync();
+    unsigned int sizeA = sizeAmino();
+    unsigned int first = sizeA;
+    for (unsigned int i = 0; i < sizeA; i++) {
+        AminoAcid& aa = getAmino(i);
+        if (!aa.isModified())
+            continue;
+        if (first == sizeA)
+            first = i;
+        aa.sync();
+    }
 
     modified = false;
 
     resetBoundaries();
+    if (coordinates != NULL) {
+        if (coordinatesValid)
+            coordinates->update(*this, first);
+        else
+            coordinates->update(*this);
+        coordinatesValid = true;
+    }
+}
+
+/**
+ *  Releases the coordinate view created by getCoordinates()
+ */
+void Spacer::detachCoordinates() {
+    delete coordinates;
+    coordinates = NULL;
 }
 
 /**
@@ -815,6 +863,7 @@ void Spacer::copy(const Spacer& orig) {
     for (unsigned int n = 0; n < orig.sizeSpacer(); n++)
         subSpacerList.push_back(orig.getSubSpacerListEntry(n));
     Polymer::copy(orig);
+    pInvalidateAminoIndex();
 
     if ((sizeAmino() > 1) && (orig.getAmino(0)[C].isBond(orig.getAmino(1)[N])))
         for (unsigned int i = 0; i < sizeAmino() - 1; i++) {
@@ -881,6 +930,7 @@ void Spacer::insertComponent(Component* c) {
             ERROR("The component is neither an aminoacid nor a spacer.", exception);
     }
     Polymer::insertComponent(c);
+    pInvalidateAminoIndex();
     setModified();
     if (hasSuperior())
         (dynamic_cast<Spacer&> (getSuperior()))
@@ -900,6 +950,7 @@ void Spacer::modifySubSpacerList(Spacer* s, int count) {
     while (&getSpacer(index) != s)
         index++;
     subSpacerList[index].second = subSpacerList[index].second + count;
+    pInvalidateAminoIndex();
     index++;
     for (unsigned int loop = index; loop < subSpacerList.size(); loop++) {
         subSpacerList[loop].first = subSpacerList[loop].first + count;
@@ -954,84 +1005,6 @@ const Spacer& Spacer::getSpacer(unsigned int n) const {
 
 }
 
-/**
- *   Returns the aminoacid of the index 
- * @param n, AminoAcid index
- * @return aminoacid reference
- */
-
-AminoAcid& Spacer::getAmino(unsigned int n) { // needs to be recoded & optimized
-    PRECOND(n < this->sizeAmino(), exception);
-    unsigned int idxOffset = 0;
-    unsigned int lastMax = 0;
-    unsigned int subSpacerSize = subSpacerList.size();
-    unsigned int betweenOffset = 0;
-    for (unsigned int loop = 0; loop < subSpacerSize; loop++) {
-        betweenOffset += subSpacerList[loop].first - lastMax;
-        // count aminoacids between the spacers and the spacer itself
-        if ((n >= subSpacerList[loop].first) &&
-                (n <= subSpacerList[loop].second)) {
-            return ( dynamic_cast<AminoAcid&>
-                    (dynamic_cast<Spacer*>
-                    (components[betweenOffset])
-                    ->getAmino(n - subSpacerList[loop].first)));
-        }
-        if ((n >= lastMax) && (n < subSpacerList[loop].first)) {
-            if ((*components[n - idxOffset])
-                    .getClassName() != "AminoAcid")
-                ERROR("Component is not an aminoacid !", exception);
-            return (dynamic_cast<AminoAcid&>
-                    (*components[n - idxOffset])); // return aminoacid
-        }
-        lastMax = subSpacerList[loop].second;
-        idxOffset += lastMax - subSpacerList[loop].first;
-    }
-    if ((*components[n - idxOffset])
-            .getClassName() != "AminoAcid")
-        ERROR("The component is not an aminoacid !", exception);
-    return (dynamic_cast<AminoAcid&>
-            (*components[n - idxOffset])); // return aminoacid
-}
-
-/**
- *   Returns the aminoacid of index
- * @param n, AminoAcid index 
- * @return  aminoacid reference
- */
-const AminoAcid& Spacer::getAmino(unsigned int n) const { // needs to be recoded & optimized
-
-    PRECOND(n < this->sizeAmino(), exception);
-    unsigned int idxOffset = 0;
-    unsigned int lastMax = 0;
-    unsigned int subSpacerSize = subSpacerList.size();
-    unsigned int betweenOffset = 0;
-    for (unsigned int loop = 0; loop < subSpacerSize; loop++) {
-        betweenOffset += subSpacerList[loop].first - lastMax;
-        // count aminoacids between the spacers and the spacer itself
-        if ((n >= subSpacerList[loop].first) &&
-                (n <= subSpacerList[loop].second)) {
-            return ( dynamic_cast<AminoAcid&>
-                    (dynamic_cast<Spacer*>
-                    (components[betweenOffset])
-                    ->getAmino(n - subSpacerList[loop].first)));
-        }
-        if ((n >= lastMax) && (n < subSpacerList[loop].first)) {
-            if ((*components[n - idxOffset])
-                    .getClassName() != "AminoAcid")
-                ERROR("Component is not an aminoacid !", exception);
-            return (dynamic_cast<AminoAcid&>
-                    (*components[n - idxOffset])); // return aminoacid
-        }
-        lastMax = subSpacerList[loop].second;
-        idxOffset += lastMax - subSpacerList[loop].first;
-    }
-    if ((*components[n - idxOffset])
-            .getClassName() != "AminoAcid")
-        ERROR("The component is not an aminoacid !", exception);
-    return (dynamic_cast<AminoAcid&>
-            (*components[n - idxOffset])); // return aminoacid
-}
-
 /**
  *  Merge the components of the sub-spacer <s> at the place of <s> in the spacer <this>..
  *@param s, spacer reference 
@@ -1250,12 +1223,52 @@ void Spacer::groupLikeStateCode() {
     }
 }
 
+/**
+ *   Marks the flattened residue index of this spacer, and of all spacers
+ *                 containing it, as outdated. The index is rebuilt by
+ *                 the next getAmino().
+ */
+
+void Spacer::pInvalidateAminoIndex() {
+    aminoIndexValid = false;
+    coordinatesValid = false;
+    if (hasSuperior()) {
+        Spacer* sup = dynamic_cast<Spacer*> (&getSuperior());
+        if ((sup != NULL) && (sup->aminoIndexValid))
+            sup->pInvalidateAminoIndex();
+    }
+}
+
+/**
+ *   Rebuilds the flattened residue index by walking the components
+ *                 (and sub-spacers) in order.
+ */
+
+void Spacer::pBuildAminoIndex() const {
+    aminoIndex.clear();
+    for (unsigned int n = 0; n < components.size(); n++) {
+        if (components[n]->getClassName() == "Spacer") {
+            const Spacer* sub = dynamic_cast<const Spacer*> (components[n]);
+            if (!sub->aminoIndexValid)
+                sub->pBuildAminoIndex();
+            aminoIndex.insert(aminoIndex.end(), sub->aminoIndex.begin(),
+                    sub->aminoIndex.end());
+        } else {
+            if (components[n]->getClassName() != "AminoAcid")
+                ERROR("The component is not an aminoacid !", exception);
+            aminoIndex.push_back(dynamic_cast<AminoAcid*> (components[n]));
+        }
+    }
+    aminoIndexValid = true;
+}
+
 /**
  *   Update the internal structure of a spacer after a change
  *                 in the structure of a spacer.
  */
 
 void Spacer::updateSubSpacerList() {
+    pInvalidateAminoIndex();
     subSpacerList.clear();
     pair < unsigned int, unsigned int > tmp;
     unsigned int countAA = 0;
@@ -1521,30 +1534,47 @@ void Spacer::getBackboneHbonds() {
         ss.push_back(tmp);
     }
 
+    // Acceptors (O) on a grid, only those close to a donor are checked
+    const double HBOND_DISTANCE = 5.2;
+    vector<vgVector3<double> > oCoords;
+    vector<unsigned int> oAmino;
+    for (unsigned int i = 0; i < sizeAmino(); i++)
+        if (getAmino(i).isMember(O)) {
+            oCoords.push_back(getAmino(i)[O].getCoords());
+            oAmino.push_back(i);
+        }
+    NeighborGrid oGrid(oCoords, HBOND_DISTANCE);
+    vector<unsigned int> nb;
+
     // Get H bonds for the backbone
-    for (unsigned int i = 0; i < (sizeAmino()); i++) {
-        for (unsigned int j = 0; j < sizeAmino(); j++) {
-            if ((i != j) &&
-                    (getAmino(j).isMember(N)) &&
-                    (getAmino(j).isMember(H)) &&
-                    (getAmino(i).isMember(O))) {
+    for (unsigned int j = 0; j < sizeAmino(); j++) {
+        if ((!getAmino(j).isMember(N)) || (!getAmino(j).isMember(H)))
+            continue;
 
-                ACoords = getAmino(i)[O].getCoords();
-                HCoords = getAmino(j)[H].getCoords();
-                DCoords = getAmino(j)[N].getCoords();
+        HCoords = getAmino(j)[H].getCoords();
+        DCoords = getAmino(j)[N].getCoords();
+        HVector = getAmino(j)[H].getTrans();
 
-                HVector = getAmino(j)[H].getTrans();
-                bondVector = icc.calculateTrans(DCoords, ACoords);
-                Hangle = RAD2DEG * icc.getAngle(bondVector, HVector);
+        oGrid.getNeighbors(DCoords, HBOND_DISTANCE, nb);
+        for (unsigned int n = 0; n < nb.size(); n++) {
+            unsigned int i = oAmino[nb[n]];
+            if (i == j)
+                continue;
 
-                distance = getAmino(j)[N].distance(getAmino(i)[O]);
+            ACoords = getAmino(i)[O].getCoords();
+            bondVector = icc.calculateTrans(DCoords, ACoords);
+            Hangle = RAD2DEG * icc.getAngle(bondVector, HVector);
 
-                if ((Hangle <= 63.0) && (distance <= 5.2)) {
-                    // It is important to preserve the direction
-                    backboneHbonds[i][j] = true; // Rigth,   O ---> H-N
-                }
+            distance = getAmino(j)[N].distance(getAmino(i)[O]);
+
+            if ((Hangle <= 63.0) && (distance <= HBOND_DISTANCE)) {
+                // It is important to preserve the direction
+                backboneHbonds[i][j] = true; // Rigth,   O ---> H-N
             }
         }
+    }
+
+    for (unsigned int i = 0; i < (sizeAmino()); i++) {
 
         // Calculate bends
         if ((i > 1) && (i < (sizeAmino() - 2))) {
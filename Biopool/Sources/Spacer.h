@@ -31,6 +31,8 @@
 
 namespace Victor { namespace Biopool { 
 
+    class SpacerCoordinates;
+
     /**@brief Implements a "Spacer" for a protein chain. Includes methods to obtain values from the atoms and its pdb information.
      * 
      *  ***Attention*** The current implementation allows for "1 to 1" spacers,
@@ -72,6 +74,10 @@ namespace Victor { namespace Biopool {
             return gaps.size();
         }
 
+        int getGap(unsigned int n) {
+            return gaps[n];
+        }
+
         virtual string getClassName() const {
             return "Spacer";
         }
@@ -84,6 +90,12 @@ namespace Victor { namespace Biopool {
         const Spacer& getSpacer(unsigned int n) const;
         const unsigned int sizeSpacer() const;
 
+        const SpacerCoordinates& getCoordinates();
+
+        bool hasCoordinates() const {
+            return (coordinates != NULL);
+        }
+
         vector<pair<unsigned int, unsigned int> > getHelixData();
         vector<pair<unsigned int, unsigned int> > getStrandData();
 
@@ -155,6 +167,7 @@ namespace Victor { namespace Biopool {
         void setRot(vgMatrix3<double> r);
         void addRot(vgMatrix3<double> r);
         void sync();
+        void detachCoordinates();
 
         void setStateFromSecondary(string sec);
         void setStateFromTorsionAngles();
@@ -211,6 +224,8 @@ namespace Victor { namespace Biopool {
         void modifySubSpacerList(Spacer*, int);
         void updateSubSpacerList();
         void getBackboneHbonds(); // backbone H bonds (for SS)
+        void pInvalidateAminoIndex();
+        void pBuildAminoIndex() const;
 
         // ATTRIBUTES
 
@@ -226,6 +241,10 @@ namespace Victor { namespace Biopool {
 
     private:
         vector<pair<unsigned int, unsigned int> > subSpacerList;
+        SpacerCoordinates* coordinates; // optional flat copy of the atom coordinates
+        bool coordinatesValid; // false once residues are added or removed
+        mutable vector<AminoAcid*> aminoIndex; // flattened residues, see getAmino()
+        mutable bool aminoIndexValid;
     };
 
     // ---------------------------------------------------------------------------
@@ -250,6 +269,31 @@ namespace Victor { namespace Biopool {
         return subSpacerList.size();
     }
 
+    /**
+     *   Returns the aminoacid of the index. Uses the flattened residue
+     * index, which is rebuilt only after the structure of the spacer changed.
+     * @param n, AminoAcid index
+     * @return aminoacid reference
+     */
+    inline AminoAcid& Spacer::getAmino(unsigned int n) {
+        if (!aminoIndexValid)
+            pBuildAminoIndex();
+        PRECOND(n < aminoIndex.size(), exception);
+        return *aminoIndex[n];
+    }
+
+    /**
+     *   Returns the aminoacid of the index (const version)
+     * @param n, AminoAcid index
+     * @return aminoacid reference
+     */
+    inline const AminoAcid& Spacer::getAmino(unsigned int n) const {
+        if (!aminoIndexValid)
+            pBuildAminoIndex();
+        PRECOND(n < aminoIndex.size(), exception);
+        return *aminoIndex[n];
+    }
+
     // MODIFIERS:
 
     /**
@@ -258,6 +302,7 @@ namespace Victor { namespace Biopool {
      */
     inline void Spacer::removeComponent(Component* c) {
         Polymer::removeComponent(c);
+        pInvalidateAminoIndex();
         setModified();
     }
 
@@ -267,6 +312,7 @@ namespace Victor { namespace Biopool {
      */
     inline void Spacer::removeComponentFromIndex(unsigned int i) {
         Polymer::removeComponentFromIndex(i);
+        pInvalidateAminoIndex();
         setModified();
     }
 
@@ -275,6 +321,7 @@ namespace Victor { namespace Biopool {
      *@param c, pointer to the Component to delete
      */inline void Spacer::deleteComponent(Component* c) {
         Polymer::deleteComponent(c);
+        pInvalidateAminoIndex();
         setModified();
     }
 
@@ -284,6 +331,7 @@ namespace Victor { namespace Biopool {
      */
     inline void Spacer::load(Loader& l) {
         l.loadSpacer(*this);
+        pInvalidateAminoIndex();
         resetBoundaries();
     }
 
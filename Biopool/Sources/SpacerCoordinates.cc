@@ -0,0 +1,135 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <SpacerCoordinates.h>
+#include <Spacer.h>
+#include <Debug.h>
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// Global constants, typedefs, etc. (to avoid):
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Basic constructor, creates an empty view
+ */
+SpacerCoordinates::SpacerCoordinates() : x(), y(), z(), code(), residue(),
+atoms(), residueStart(1, 0), residueType() {
+    PRINT_NAME;
+}
+
+/**
+ *  Basic destructor
+ */
+SpacerCoordinates::~SpacerCoordinates() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *  Looks up an atom of a residue by its code.
+ *@param n, residue index
+ *@param ac, atom code
+ *@return index of the atom, -1 if the residue has no such atom
+ */
+int SpacerCoordinates::getAtomIndex(unsigned int n, AtomCode ac) const {
+    PRECOND(n < sizeResidue(), exception);
+    for (unsigned int i = residueStart[n]; i < residueStart[n + 1]; i++)
+        if (code[i] == ac)
+            return static_cast<int> (i);
+    return -1;
+}
+
+// MODIFIERS:
+
+/**
+ *  Removes all atoms. Allocated memory is kept for the next update().
+ */
+void SpacerCoordinates::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    code.clear();
+    residue.clear();
+    atoms.clear();
+    residueStart.clear();
+    residueStart.push_back(0);
+    residueType.clear();
+}
+
+/**
+ *  Copies the coordinates of all atoms of the spacer into the flat arrays.
+ * Atoms are synchronized as needed.
+ *@param sp, reference to the spacer
+ */
+void SpacerCoordinates::update(Spacer& sp) {
+    clear();
+    unsigned int nAmino = sp.sizeAmino();
+    residueStart.reserve(nAmino + 1);
+    residueType.reserve(nAmino);
+
+    for (unsigned int i = 0; i < nAmino; i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        residueType.push_back(static_cast<AminoAcidCode> (aa.getCode()));
+        for (unsigned int j = 0; j < aa.size(); j++) {
+            Atom& at = aa[j];
+            vgVector3<double> tmp = at.getCoords();
+            x.push_back(tmp.x);
+            y.push_back(tmp.y);
+            z.push_back(tmp.z);
+            code.push_back(at.getCode());
+            residue.push_back(i);
+            atoms.push_back(&at);
+        }
+        residueStart.push_back(x.size());
+    }
+}
+
+/**
+ *  Refreshes the coordinates of the residues from first on, which must hold
+ * the same atoms as at the last update(). Falls back to a full update() if
+ * the number of residues, or of atoms in one of them, has changed.
+ *@param sp, reference to the spacer
+ *@param first, index of the first residue to refresh
+ */
+void SpacerCoordinates::update(Spacer& sp, unsigned int first) {
+    unsigned int nAmino = sp.sizeAmino();
+    if (nAmino != sizeResidue()) {
+        update(sp);
+        return;
+    }
+
+    for (unsigned int i = first; i < nAmino; i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        unsigned int k = residueStart[i];
+        if (aa.size() != residueStart[i + 1] - k) {
+            update(sp);
+            return;
+        }
+        for (unsigned int j = 0; j < aa.size(); j++, k++) {
+            Atom& at = aa[j];
+            vgVector3<double> tmp = at.getCoords();
+            x[k] = tmp.x;
+            y[k] = tmp.y;
+            z[k] = tmp.z;
+            code[k] = at.getCode();
+            atoms[k] = &at;
+        }
+    }
+}
@@ -0,0 +1,176 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SPACERCOORDINATES_H_
+#define _SPACERCOORDINATES_H_
+
+// Includes:
+#include <vector>
+#include <math.h>
+#include <AtomCode.h>
+#include <AminoAcidCode.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool {
+
+    class Atom;
+    class Spacer;
+
+    /**@brief Flat (structure-of-arrays) copy of the atom coordinates of a Spacer.
+     *
+     *  Stores x, y, z, atom code and residue index of every atom in
+     *  contiguous arrays, in the same order as Spacer::getAmino(i)[j].
+     *  Meant as a read-only view for geometry kernels which would otherwise
+     *  walk the Component tree for every atom pair.
+     *  The view is filled by update() and does not track later changes
+     *  to the atoms: use Spacer::getCoordinates() to obtain an up-to-date copy.
+     *  Spacer::sync() refreshes an attached view from the first moved residue.
+     * */
+    class SpacerCoordinates {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        SpacerCoordinates();
+        virtual ~SpacerCoordinates();
+
+        // PREDICATES:
+
+        /**
+         *   Number of atoms stored
+         */
+        unsigned int size() const {
+            return x.size();
+        }
+
+        /**
+         *   Number of residues stored
+         */
+        unsigned int sizeResidue() const {
+            return residueType.size();
+        }
+
+        double getX(unsigned int i) const {
+            return x[i];
+        }
+
+        double getY(unsigned int i) const {
+            return y[i];
+        }
+
+        double getZ(unsigned int i) const {
+            return z[i];
+        }
+
+        AtomCode getCode(unsigned int i) const {
+            return code[i];
+        }
+
+        /**
+         *   Index of the residue the i-th atom belongs to
+         */
+        unsigned int getResidue(unsigned int i) const {
+            return residue[i];
+        }
+
+        /**
+         *   Index of the first atom of residue n. Atoms of residue n are
+         * getResidueStart(n) .. getResidueEnd(n) - 1
+         */
+        unsigned int getResidueStart(unsigned int n) const {
+            return residueStart[n];
+        }
+
+        unsigned int getResidueEnd(unsigned int n) const {
+            return residueStart[n + 1];
+        }
+
+        AminoAcidCode getResidueType(unsigned int n) const {
+            return residueType[n];
+        }
+
+        Atom& getAtom(unsigned int i) const {
+            return *atoms[i];
+        }
+
+        const double* getXArray() const {
+            return x.empty() ? NULL : &x[0];
+        }
+
+        const double* getYArray() const {
+            return y.empty() ? NULL : &y[0];
+        }
+
+        const double* getZArray() const {
+            return z.empty() ? NULL : &z[0];
+        }
+
+        int getAtomIndex(unsigned int n, AtomCode ac) const;
+
+        double distance(unsigned int i, unsigned int j) const;
+        double squareDistance(unsigned int i, unsigned int j) const;
+
+        // MODIFIERS:
+        void clear();
+        void update(Spacer& sp);
+        void update(Spacer& sp, unsigned int first);
+
+    protected:
+
+    private:
+
+        // ATTRIBUTES:
+        vector<double> x;
+        vector<double> y;
+        vector<double> z;
+        vector<AtomCode> code;
+        vector<unsigned int> residue;
+        vector<Atom*> atoms;
+
+        vector<unsigned int> residueStart; // sizeResidue() + 1 entries
+        vector<AminoAcidCode> residueType;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                              SpacerCoordinates
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    /**
+     *   Euclidean distance between atoms i and j. Same arithmetic as
+     * Atom::distance(), so results are identical.
+     *@param i, j atom indexes
+     *@return distance (double)
+     */
+    inline double SpacerCoordinates::distance(unsigned int i, unsigned int j) const {
+        return sqrt((x[i] - x[j]) * (x[i] - x[j])
+                + (y[i] - y[j]) * (y[i] - y[j])
+                + (z[i] - z[j]) * (z[i] - z[j]));
+    }
+
+    /**
+     *   Squared euclidean distance between atoms i and j.
+     *@param i, j atom indexes
+     *@return squared distance (double)
+     */
+    inline double SpacerCoordinates::squareDistance(unsigned int i, unsigned int j) const {
+        return (x[i] - x[j]) * (x[i] - x[j])
+                + (y[i] - y[j]) * (y[i] - y[j])
+                + (z[i] - z[j]) * (z[i] - z[j]);
+    }
+
+}} //namespace
+#endif //_SPACERCOORDINATES_H_
@@ -0,0 +1,147 @@
+/*
+ * TestBackboneBuilder.h
+ *
+ *  Checks the backbone built from internal coordinates against the atoms
+ *  of a loaded chain, before and after a torsion change.
+ */
+
+#include <iostream>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <Spacer.h>
+#include <BackboneBuilder.h>
+
+#include <PdbLoader.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestBackboneBuilder : public CppUnit::TestFixture {
+public:
+
+    TestBackboneBuilder() {
+    }
+
+    virtual ~TestBackboneBuilder() {
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestBackboneBuilder");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestBackboneBuilder>("Test1 - rebuilding the backbone of a chain.",
+                &TestBackboneBuilder::testTestBackboneBuilder_A));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestBackboneBuilder>("Test2 - variants against AminoAcid::setPhi().",
+                &TestBackboneBuilder::testTestBackboneBuilder_B));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestBackboneBuilder>("Test3 - standard geometry.",
+                &TestBackboneBuilder::testTestBackboneBuilder_C));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+    }
+
+protected:
+
+    void load(Protein& prot) {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+    }
+
+    /// Largest distance between the backbone of residues first .. and the builder.
+
+    double maxDeviation(Spacer& sp, unsigned int first, BackboneBuilder& bb,
+            unsigned int v) {
+        double dev = 0.0;
+        for (unsigned int i = 0; i < bb.size(); i++) {
+            AminoAcid& aa = sp.getAmino(first + i / 3);
+            AtomCode code = (i % 3 == 0) ? N : ((i % 3 == 1) ? CA : C);
+            double d = (aa[code].getCoords() - bb.getCoords(i, v)).length();
+            if (d > dev)
+                dev = d;
+        }
+        return dev;
+    }
+
+    void testTestBackboneBuilder_A() {
+        Protein prot;
+        load(prot);
+        Spacer& sp = *prot.getSpacer(0u);
+
+        BackboneBuilder bb;
+        bb.setFromSpacer(sp, 0, sp.sizeAmino() - 1);
+        CPPUNIT_ASSERT(bb.sizeAmino() == sp.sizeAmino());
+        for (unsigned int n = 1; n + 1 < sp.sizeAmino(); n++) {
+            CPPUNIT_ASSERT(fabs(bb.getPhi(n) - sp.getAmino(n).getPhi()) < 1e-6);
+            CPPUNIT_ASSERT(fabs(bb.getPsi(n) - sp.getAmino(n).getPsi()) < 1e-6);
+        }
+        bb.build();
+        CPPUNIT_ASSERT(maxDeviation(sp, 0, bb, 0) < 1e-6);
+    }
+
+    void testTestBackboneBuilder_B() {
+        Protein prot;
+        load(prot);
+        Spacer& sp = *prot.getSpacer(0u);
+        const unsigned int first = 10, last = 40, turned = 25;
+
+        BackboneBuilder bb;
+        bb.setFromSpacer(sp, first, last);
+        bb.setVariants(3);
+        double phi = bb.getPhi(turned - first);
+        bb.setPhi(turned - first, phi + 40.0, 1);
+        bb.setPsi(turned - first, bb.getPsi(turned - first) - 25.0, 2);
+        bb.build();
+        CPPUNIT_ASSERT(maxDeviation(sp, first, bb, 0) < 1e-6);
+
+        sp.getAmino(turned).setPhi(sp.getAmino(turned).getPhi() + 40.0);
+        sp.sync();
+        CPPUNIT_ASSERT(maxDeviation(sp, first, bb, 1) < 1e-6);
+        CPPUNIT_ASSERT(maxDeviation(sp, first, bb, 0) > 0.1);
+        CPPUNIT_ASSERT(maxDeviation(sp, first, bb, 2) > 0.1);
+    }
+
+    void testTestBackboneBuilder_C() {
+        BackboneBuilder bb;
+        bb.setIdeal(8);
+        for (unsigned int n = 0; n < bb.sizeAmino(); n++) {
+            if (n > 0)
+                bb.setPhi(n, -63.0);
+            if (n + 1 < bb.sizeAmino())
+                bb.setPsi(n, -42.0);
+        }
+        bb.build();
+        CPPUNIT_ASSERT(fabs((bb.getCoords(4) - bb.getCoords(3)).length()
+                - Spacer::BOND_LENGTH_N_TO_CALPHA) < 1e-9);
+        CPPUNIT_ASSERT(fabs(bb.getOmega(2) - 180.0) < 1e-9);
+
+        // alpha helix: trans peptides, and CA i, i + 3 about 5 A apart
+        for (unsigned int n = 0; n + 3 < bb.sizeAmino(); n++) {
+            double d1 = (bb.getCoords(3 * n + 4) - bb.getCoords(3 * n + 1)).length();
+            double d3 = (bb.getCoords(3 * n + 10) - bb.getCoords(3 * n + 1)).length();
+            CPPUNIT_ASSERT(fabs(d1 - 3.8) < 0.1);
+            CPPUNIT_ASSERT((d3 > 4.8) && (d3 < 5.5));
+        }
+    }
+
+};
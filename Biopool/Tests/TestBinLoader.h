@@ -0,0 +1,119 @@
+/*
+ * TestBinLoader.h
+ *
+ *  Checks that a protein saved by BinSaver loads back as it was.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <PdbLoader.h>
+#include <PdbSaver.h>
+#include <BinSaver.h>
+#include <BinLoader.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestBinLoader : public CppUnit::TestFixture {
+public:
+
+    TestBinLoader() {
+    }
+
+    virtual ~TestBinLoader() {
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestBinLoader");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestBinLoader>("Test1 - binary round trip of a protein.",
+                &TestBinLoader::testTestBinLoader_A));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestBinLoader>("Test2 - byte order of the binary format.",
+                &TestBinLoader::testTestBinLoader_B));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+    }
+
+protected:
+
+    string pdbText(Protein& prot) {
+        ostringstream os;
+        PdbSaver ps(os);
+        prot.save(ps);
+        return os.str();
+    }
+
+    void testTestBinLoader_A() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+
+        // with hydrogens and DSSP, which the binary file keeps
+        PdbLoader pl(inFile);
+        pl.setNoVerbose();
+        Protein prot;
+        prot.load(pl);
+
+        ostringstream bin(ios::out | ios::binary);
+        BinSaver bs(bin);
+        prot.save(bs);
+
+        istringstream in(bin.str(), ios::in | ios::binary);
+        BinLoader bl(in);
+        Protein copy;
+        copy.load(bl);
+        CPPUNIT_ASSERT(bl.isValid());
+        CPPUNIT_ASSERT(copy.sizeProtein() == prot.sizeProtein());
+        CPPUNIT_ASSERT(copy.getChainLetter(0) == prot.getChainLetter(0));
+
+        Spacer* sp1 = prot.getSpacer(0u);
+        Spacer* sp2 = copy.getSpacer(0u);
+        CPPUNIT_ASSERT(sp2->sizeAmino() == sp1->sizeAmino());
+        CPPUNIT_ASSERT(sp2->getStartOffset() == sp1->getStartOffset());
+        CPPUNIT_ASSERT(sp2->sizeGaps() == sp1->sizeGaps());
+        for (unsigned int i = 0; i < sp1->sizeAmino(); i++) {
+            CPPUNIT_ASSERT(sp2->getAmino(i).getState() == sp1->getAmino(i).getState());
+            CPPUNIT_ASSERT(sp2->getAmino(i).size() == sp1->getAmino(i).size());
+        }
+        CPPUNIT_ASSERT(pdbText(copy) == pdbText(prot));
+    }
+
+    void testTestBinLoader_B() {
+        Spacer sp;
+        ostringstream bin(ios::out | ios::binary);
+        BinSaver bs(bin);
+        sp.save(bs);
+        string b = bin.str();
+
+        // magic, then version 1 and one chain as little-endian numbers
+        unsigned int m = sizeof (BIN_MAGIC);
+        CPPUNIT_ASSERT(b.compare(0, m, string(BIN_MAGIC, m)) == 0);
+        CPPUNIT_ASSERT(b.compare(m, 8, string("\1\0\0\0\1\0\0\0", 8)) == 0);
+
+        istringstream in(b, ios::in | ios::binary);
+        BinLoader bl(in);
+        Spacer empty;
+        empty.load(bl);
+        CPPUNIT_ASSERT(empty.sizeAmino() == 0);
+    }
+
+};
@@ -13,6 +13,10 @@
 #include <TestGroup.h>
 #include <TestAminoAcid.h>
 #include <TestSpacer.h>
+#include <TestNeighborGrid.h>
+#include <TestPdbLoader.h>
+#include <TestBinLoader.h>
+#include <TestBackboneBuilder.h>
 using namespace std;
 
 
@@ -24,6 +28,10 @@ int main() {
         runner.addTest(TestGroup::suite());
         runner.addTest(TestAminoAcid::suite());
         runner.addTest(TestSpacer::suite());
+        runner.addTest(TestNeighborGrid::suite());
+        runner.addTest(TestPdbLoader::suite());
+        runner.addTest(TestBinLoader::suite());
+        runner.addTest(TestBackboneBuilder::suite());
 	cout<< "Running the unit tests."<<endl;
 	runner.run();
 
@@ -0,0 +1,146 @@
+/*
+ * TestNeighborGrid.h
+ *
+ *  Checks the neighbour grid against a brute force search.
+ */
+
+#include <iostream>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <Spacer.h>
+#include <SpacerCoordinates.h>
+#include <NeighborGrid.h>
+
+#include <PdbLoader.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestNeighborGrid : public CppUnit::TestFixture {
+public:
+
+    TestNeighborGrid() {
+    }
+
+    virtual ~TestNeighborGrid() {
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestNeighborGrid");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestNeighborGrid>("Test1 - radius queries on a chain.",
+                &TestNeighborGrid::testTestNeighborGrid_A));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestNeighborGrid>("Test2 - pairs within a cutoff.",
+                &TestNeighborGrid::testTestNeighborGrid_B));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestNeighborGrid>("Test3 - moving single points.",
+                &TestNeighborGrid::testTestNeighborGrid_C));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+    }
+
+protected:
+
+    void testTestNeighborGrid_A() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/test.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer* sp = prot.getSpacer('A');
+        const SpacerCoordinates& coords = sp->getCoordinates();
+
+        // cell size smaller than some of the radii queried
+        NeighborGrid grid(coords, 3.0);
+        CPPUNIT_ASSERT(grid.size() == coords.size());
+
+        double radius[] = {1.6, 3.0, 4.5, 12.0};
+        vector<unsigned int> nb;
+        for (unsigned int r = 0; r < 4; r++)
+            for (unsigned int i = 0; i < coords.size(); i++) {
+                grid.getNeighbors(i, radius[r], nb);
+                vector<unsigned int> brute;
+                for (unsigned int j = 0; j < coords.size(); j++)
+                    if ((j != i) && (coords.distance(i, j) <= radius[r]))
+                        brute.push_back(j);
+                CPPUNIT_ASSERT(nb == brute);
+            }
+
+        // query point outside the chain
+        grid.getNeighbors(vgVector3<double>(1000.0, 1000.0, 1000.0), 10.0, nb);
+        CPPUNIT_ASSERT(nb.empty());
+
+        // a negative radius finds nothing, not even the point itself
+        grid.getNeighbors(0u, -1.0, nb);
+        CPPUNIT_ASSERT(nb.empty());
+    }
+
+    void testTestNeighborGrid_B() {
+        vector<vgVector3<double> > points;
+        points.push_back(vgVector3<double>(0.0, 0.0, 0.0));
+        points.push_back(vgVector3<double>(1.0, 0.0, 0.0));
+        points.push_back(vgVector3<double>(0.0, 2.5, 0.0));
+        points.push_back(vgVector3<double>(-40.0, 0.0, 0.0));
+        points.push_back(vgVector3<double>(-40.0, 0.0, 1.5));
+
+        NeighborGrid grid(points, 2.0);
+        vector<pair<unsigned int, unsigned int> > pairs;
+        grid.getPairs(2.0, pairs);
+        CPPUNIT_ASSERT(pairs.size() == 2);
+        CPPUNIT_ASSERT((pairs[0].first == 0) && (pairs[0].second == 1));
+        CPPUNIT_ASSERT((pairs[1].first == 3) && (pairs[1].second == 4));
+
+        grid.getPairs(3.0, pairs);
+        CPPUNIT_ASSERT(pairs.size() == 4);
+        CPPUNIT_ASSERT((pairs[1].first == 0) && (pairs[1].second == 2));
+        CPPUNIT_ASSERT((pairs[2].first == 1) && (pairs[2].second == 2));
+    }
+
+    void testTestNeighborGrid_C() {
+        vector<vgVector3<double> > points;
+        for (unsigned int i = 0; i < 200; i++)
+            points.push_back(vgVector3<double>((i * 37) % 23, (i * 11) % 17,
+                    (i * 7) % 13));
+        NeighborGrid grid(points, 4.0);
+
+        // moves within the grid, and out of it on either side
+        vector<unsigned int> nb;
+        for (unsigned int n = 0; n < 300; n++) {
+            unsigned int i = (n * 53) % points.size();
+            double far = (n % 10 == 0) ? 30.0 : 0.0;
+            points[i] = vgVector3<double>((n * 13) % 29 - 3.0 + far,
+                    (n * 5) % 19 - 1.0 - far, (n * 3) % 11 - 2.0);
+            grid.setPoint(i, points[i]);
+
+            unsigned int q = (n * 31) % points.size();
+            grid.getNeighbors(q, 5.0, nb);
+            vector<unsigned int> brute;
+            for (unsigned int j = 0; j < points.size(); j++)
+                if ((j != q) && ((points[j] - points[q]).length() <= 5.0))
+                    brute.push_back(j);
+            CPPUNIT_ASSERT(nb == brute);
+        }
+    }
+
+};
@@ -0,0 +1,246 @@
+/*
+ * TestPdbLoader.h
+ *
+ *  Checks chain and model selection on an ensemble read once, and the
+ *  reading of many files through a PdbPipeline.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <Spacer.h>
+#include <PdbFile.h>
+#include <PdbLoader.h>
+#include <PdbPipeline.h>
+#include <IoTools.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestPdbLoader : public CppUnit::TestFixture {
+public:
+
+    TestPdbLoader() {
+    }
+
+    virtual ~TestPdbLoader() {
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestPdbLoader");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test1 - records of an ensemble.",
+                &TestPdbLoader::testTestPdbLoader_A));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test2 - loading chains and models after the fact.",
+                &TestPdbLoader::testTestPdbLoader_B));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test3 - records split in memory.",
+                &TestPdbLoader::testTestPdbLoader_C));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test4 - pipeline over a directory.",
+                &TestPdbLoader::testTestPdbLoader_D));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/test.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+
+        // two models of chains A and B, model m shifted by 10 * m along x
+        vector<string> atoms;
+        while (inFile) {
+            string line = readLine(inFile);
+            if (line.substr(0, 4) == "ATOM")
+                atoms.push_back(line);
+        }
+        ostringstream os;
+        os << "HEADER    TEST ENSEMBLE\n";
+        for (unsigned int m = 1; m <= 2; m++) {
+            os << "MODEL     " << setw(4) << m << "\n";
+            for (unsigned int c = 0; c < 2; c++)
+                for (unsigned int i = 0; i < atoms.size(); i++) {
+                    string line = atoms[i];
+                    line[21] = 'A' + c;
+                    double x = atof(line.substr(30, 8).c_str()) + 10.0 * m;
+                    os << line.substr(0, 30) << fixed << setprecision(3)
+                            << setw(8) << x << line.substr(38) << "\n";
+                }
+            os << "ENDMDL\n";
+        }
+        os << "END\n";
+        ensemble = os.str();
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+    }
+
+protected:
+
+    void testTestPdbLoader_A() {
+        istringstream input(ensemble);
+        PdbFile pdb;
+        pdb.readFile(input);
+        CPPUNIT_ASSERT(pdb.isRead() && (pdb.getHeader() == "HEADER    TEST ENSEMBLE"));
+        CPPUNIT_ASSERT((pdb.getMaxModels() == 2) && (pdb.getFirstModel() == 1));
+        CPPUNIT_ASSERT((pdb.getChains().size() == 2) && (pdb.getChains()[1] == 'B'));
+        CPPUNIT_ASSERT(pdb.sizeBlocks() == 4);
+        vector<PdbFile::Line> lines = pdb.getAtomLines('B', 2);
+        CPPUNIT_ASSERT(lines.size() == pdb.getAtomLines('A', 1).size());
+        CPPUNIT_ASSERT((lines[0].length >= 54) && (lines[0].data[21] == 'B'));
+        CPPUNIT_ASSERT(pdb.getAtomLines('C', 1).size() == 0);
+
+        // fixed columns read in place, numbers as strtod() reads them
+        PdbFile::AtomRecord rec;
+        string atom = string("HETATM12345 HG1 AGLN B-123A   ") + "  -0.313 118.726   3.5"
+                + "    1.00 21.00           N";
+        CPPUNIT_ASSERT(PdbFile::parseAtomRecord(atom.c_str(), atom.size(), rec));
+        CPPUNIT_ASSERT(rec.het && (rec.serial == 12345) && (rec.resSeq == -123));
+        CPPUNIT_ASSERT((string(rec.name) == "HG1A") && (string(rec.resName) == "GLN"));
+        CPPUNIT_ASSERT((rec.chain == 'B') && (rec.iCode == 'A'));
+        CPPUNIT_ASSERT((rec.x == strtod("-0.313", NULL)) && (rec.y == strtod("118.726", NULL)));
+        CPPUNIT_ASSERT((rec.z == 3.5) && (rec.bFactor == 21.0));
+        string shortAtom = atom.substr(0, 54);
+        CPPUNIT_ASSERT(PdbFile::parseAtomRecord(shortAtom.c_str(), shortAtom.size(), rec));
+        CPPUNIT_ASSERT(rec.bFactor == 0.0);
+        CPPUNIT_ASSERT(!PdbFile::parseAtomRecord(shortAtom.c_str(), 40, rec));
+    }
+
+    void testTestPdbLoader_B() {
+        istringstream input(ensemble);
+        PdbLoader pl(input);
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        CPPUNIT_ASSERT(pl.getAllChains().size() == 2);
+        CPPUNIT_ASSERT(pl.getMaxModels() == 2);
+
+        // default: first chain of the first model
+        Protein first;
+        first.load(pl);
+        CPPUNIT_ASSERT((first.sizeProtein() == 1) && (first.getChainLetter(0) == 'A'));
+
+        // same loader, other chain and model, nothing read again
+        pl.setChain('B');
+        pl.setModel(2);
+        Protein second;
+        second.load(pl);
+        CPPUNIT_ASSERT((second.sizeProtein() == 1) && (second.getChainLetter(0) == 'B'));
+        Spacer* sp1 = first.getSpacer('A');
+        Spacer* sp2 = second.getSpacer('B');
+        CPPUNIT_ASSERT(sp1->sizeAmino() == sp2->sizeAmino());
+        double shift = sp2->getAmino(1)[CA].getCoords().x
+                - sp1->getAmino(1)[CA].getCoords().x;
+        CPPUNIT_ASSERT(fabs(shift - 10.0) < 0.0001);
+
+        // all chains of model 1
+        pl.setAllChains();
+        pl.setModel(1);
+        Protein all;
+        all.load(pl);
+        CPPUNIT_ASSERT(all.sizeProtein() == 2);
+        CPPUNIT_ASSERT(all.getSpacer('B')->getAmino(1)[CA].getCoords().x
+                == sp1->getAmino(1)[CA].getCoords().x);
+    }
+
+    void testTestPdbLoader_C() {
+        istringstream input(ensemble);
+        PdbFile streamed;
+        streamed.readFile(input);
+
+        // same records in place, also with DOS line ends
+        string dos;
+        for (unsigned int i = 0; i < ensemble.size(); i++) {
+            if (ensemble[i] == '\n')
+                dos += '\r';
+            dos += ensemble[i];
+        }
+        PdbFile mapped;
+        mapped.readBuffer(dos.data(), dos.size());
+        CPPUNIT_ASSERT(mapped.isRead() && (mapped.sizeBuffer() == 0));
+        CPPUNIT_ASSERT(mapped.getHeader() == streamed.getHeader());
+        CPPUNIT_ASSERT(mapped.getModels() == streamed.getModels());
+        CPPUNIT_ASSERT(mapped.getChains() == streamed.getChains());
+        vector<PdbFile::Line> a = streamed.getAtomLines('B', 2);
+        vector<PdbFile::Line> b = mapped.getAtomLines('B', 2);
+        CPPUNIT_ASSERT(a.size() == b.size());
+        for (unsigned int i = 0; i < a.size(); i++)
+            CPPUNIT_ASSERT(string(a[i].data, a[i].length)
+                == string(b[i].data, b[i].length));
+        CPPUNIT_ASSERT((b[0].data >= dos.data())
+                && (b[0].data < dos.data() + dos.size()));
+
+        PdbLoader pl;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        pl.readBuffer(dos.data(), dos.size());
+        pl.setChain('B');
+        pl.setModel(2);
+        Protein prot;
+        prot.load(pl);
+        CPPUNIT_ASSERT((prot.sizeProtein() == 1) && (prot.getChainLetter(0) == 'B'));
+    }
+
+    /**
+     *  Records the files it analyzes.
+     */
+    class Collect : public PdbPipeline {
+    public:
+
+        Collect(const PdbFileList& files, unsigned int threads)
+        : PdbPipeline(files, threads) {
+        }
+
+        vector<string> paths;
+        vector<unsigned int> aminos;
+
+    protected:
+
+        virtual bool analyze(const PdbFileList::Entry& entry, PdbLoader& pl,
+                Protein& prot) {
+            paths.push_back(entry.path);
+            aminos.push_back((prot.sizeProtein() > 0)
+                    ? prot.getSpacer(0u)->sizeAmino() : 0);
+            return true;
+        }
+    };
+
+    void testTestPdbLoader_D() {
+        string path = getenv("VICTOR_ROOT");
+        PdbFileList files;
+        files.addDirectory(path + "Biopool/Tests/data", "3DFR.pdb");
+        files.addDirectory(path + "Biopool/Tests/data", "test.pdb");
+        CPPUNIT_ASSERT(files.size() == 2);
+        CPPUNIT_ASSERT(files[1].path == path + "Biopool/Tests/data/test.pdb");
+
+        // the same files, in the same order, with any number of threads
+        PdbFileList many;
+        for (unsigned int i = 0; i < 20; i++)
+            many.addFile(files[i % 2].path);
+        Collect serial(many, 1);
+        serial.run();
+        Collect parallel(many, 3);
+        parallel.run();
+        CPPUNIT_ASSERT(serial.paths.size() == 20);
+        CPPUNIT_ASSERT(serial.paths == parallel.paths);
+        CPPUNIT_ASSERT(serial.aminos == parallel.aminos);
+        CPPUNIT_ASSERT((serial.aminos[0] > 0) && (serial.aminos[1] > 0));
+    }
+
+    string ensemble;
+
+};
@@ -13,6 +13,7 @@
 #include <cppunit/TestCase.h>
 
 #include <Spacer.h>
+#include <SpacerCoordinates.h>
 
 #include <PdbLoader.h>
 
@@ -43,6 +44,12 @@ public:
         suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test3 - loading amino acids from pdb without chain.",
                 &TestSpacer::testTestSpacer_C));
 
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test4 - coordinate view of a chain.",
+                &TestSpacer::testTestSpacer_D));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test5 - synchronizing after a torsion change.",
+                &TestSpacer::testTestSpacer_E));
+
         return suiteOfTests;
     }
 
@@ -125,5 +132,84 @@ protected:
         CPPUNIT_ASSERT((sp->getAmino(0).size() == 7) && (sp->getAmino(1).size() == 5) && (sp->getAmino(2).size() == 11));
     }
 
+    void testTestSpacer_D() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/test.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        Spacer* sp;
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        sp = prot.getSpacer('A');
+        const SpacerCoordinates& coords = sp->getCoordinates();
+        CPPUNIT_ASSERT(coords.sizeResidue() == sp->sizeAmino());
+        CPPUNIT_ASSERT(coords.getResidueEnd(2) - coords.getResidueStart(2) == 11);
+        unsigned int i = coords.getResidueStart(1);
+        CPPUNIT_ASSERT(coords.getX(i) == sp->getAmino(1)[0].getCoords().x);
+        CPPUNIT_ASSERT(coords.getResidue(i) == 1);
+        int ca = coords.getAtomIndex(0, CA);
+        int cb = coords.getAtomIndex(0, CB);
+        CPPUNIT_ASSERT((ca >= 0) && (cb >= 0));
+        CPPUNIT_ASSERT(coords.distance(ca, cb) == sp->getAmino(0)[CA].distance(sp->getAmino(0).getSideChain()[CB]));
+
+        // the view follows the atoms once the spacer is synchronized
+        sp->getAmino(0)[CA].setCoords(1.0, 2.0, 3.0);
+        sp->getAmino(0)[CA].sync();
+        sp->setModified();
+        sp->sync();
+        CPPUNIT_ASSERT((coords.getX(ca) == 1.0) && (coords.getZ(ca) == 3.0));
+    }
+
+    void testTestSpacer_E() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/test.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        ifstream refFile(inputFile.c_str());
+        if (!inFile || !refFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile), refPl(refFile);
+        Protein prot, refProt;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        refPl.setNoVerbose();
+        refPl.setNoHAtoms();
+        refProt.load(refPl);
+        Spacer* sp = prot.getSpacer('A');
+        Spacer& ref = *refProt.getSpacer('A');
+        const SpacerCoordinates& coords = sp->getCoordinates();
+        unsigned int last = sp->sizeAmino() - 1;
+        vgVector3<double> before = sp->getAmino(0)[C].getCoords();
+        vgVector3<double> end = sp->getAmino(last)[CA].getCoords();
+
+        // one sync() brings every atom after the turned residue in place
+        sp->getAmino(1).setPhi(sp->getAmino(1).getPhi() + 30.0);
+        sp->getAmino(1).setPsi(sp->getAmino(1).getPsi() - 30.0);
+        sp->sync();
+        for (unsigned int i = 0; i < sp->sizeAmino(); i++)
+            for (unsigned int j = 0; j < sp->getAmino(i).size(); j++)
+                CPPUNIT_ASSERT(sp->getAmino(i)[j].inSync());
+        CPPUNIT_ASSERT(sp->getAmino(0)[C].getCoords() == before);
+        CPPUNIT_ASSERT(sp->getAmino(last)[CA].distance(ref.getAmino(last)[CA]) > 0.1);
+        int ca = coords.getAtomIndex(last, CA);
+        CPPUNIT_ASSERT(coords.getX(ca) == sp->getAmino(last)[CA].getCoords().x);
+
+        // same coordinates as the atoms synchronized one by one on read
+        ref.getAmino(1).setPhi(ref.getAmino(1).getPhi() + 30.0);
+        ref.getAmino(1).setPsi(ref.getAmino(1).getPsi() - 30.0);
+        CPPUNIT_ASSERT(ref.getAmino(last)[CA].distance(sp->getAmino(last)[CA]) < 1e-9);
+
+        // and back
+        sp->getAmino(1).setPsi(sp->getAmino(1).getPsi() + 30.0);
+        sp->getAmino(1).setPhi(sp->getAmino(1).getPhi() - 30.0);
+        sp->sync();
+        CPPUNIT_ASSERT((sp->getAmino(last)[CA].getCoords() - end).length() < 1e-6);
+    }
 
 };
@@ -29,6 +29,8 @@
 #include <TorsionPotential.h>
 #include <PhiPsi.h>
 #include <PhiPsiOmegaChi1Chi2PreAngle.h>
+#include <AminoAcidHydrogen.h>
+#include <BatchScoring.h>
 
 using namespace Victor::Biopool;
 using namespace Victor::Energy;
@@ -60,6 +62,11 @@ void sShowHelp(){
 	<< "\t[--casp] \t\t\t CASP QA mode 1\n"
 	<< "\t[-C <# residues>] \t\t\t CASP QA mode2 , n. residues to assume\n"
 	<< "\t[-p] \t\t\t Per residue energy calculation\n"
+	<< "\t[-j <threads>] \t\t Number of threads scoring the filelist (default = 1)\n"
+	<< "\t               \t\t Results keep the filelist order, PDB warnings are not shown\n"
+	<< "\n"
+	<< "\tA file lacking the chain given with -c is reported and skipped, the\n"
+	<< "\tother files are still scored; the exit status is then -1.\n"
 	
 	<< "\n"
 	<< "\tRemember to set VICTOR_ROOT enviroment variable" <<endl<<endl;
@@ -84,103 +91,73 @@ double sHydrogen(Spacer& sp){
 }
 
 
-int main(int nArgs, char* argv[]){ 
-        char *victor=getenv("VICTOR_ROOT");
-	if (victor  == NULL)
-		ERROR("Environment variable VICTOR_ROOT was not found.\n Use the command:\n export VICTOR_ROOT=......", exception);
-	
-	if (getArg( "h", nArgs, argv)) {
-		sShowHelp();
-		return 1;
-        };
-	string victorRoot =getenv("VICTOR_ROOT");
-        cout<<victorRoot;
-	string inputFile, inputFilelist, solvOut, rapdfOut, torOut, chainID;
-	bool newTorsion = getArg( "T", nArgs, argv);
-	bool newSolvation = getArg( "S", nArgs, argv);
-	bool verbose = getArg( "v", nArgs, argv);
-	
-	bool casp = getArg( "-casp", nArgs, argv);
+/**
+ * Scores the models of a filelist with shared potentials.
+ */
+class FrstScoring : public BatchScoring {
+public:
+	FrstScoring(Potential* solv, RapdfPotential* rapdf, TorsionPotential* tors,
+		string chainID, bool verbose, bool casp, unsigned int caspAll,
+		bool perResidue, unsigned int threads)
+	: BatchScoring(threads), solv(solv), rapdf(rapdf), tors(tors),
+	chainID(chainID), verbose(verbose), casp(casp), caspAll(caspAll),
+	perResidue(perResidue) {
+	}
+
+protected:
+	virtual bool scoreFile(const string& inputFile, ostream& out);
+
+private:
+	Potential* solv;
+	RapdfPotential* rapdf;
+	TorsionPotential* tors;
+	string chainID;
+	bool verbose, casp;
 	unsigned int caspAll;
-	getArg( "C", caspAll, nArgs, argv, 9999);
-	if (caspAll < 9999)
-		casp = true;
-	
-	bool perResidue = getArg( "p", nArgs, argv);
-	getArg( "i", inputFile, nArgs, argv, "!");
-	getArg( "I", inputFilelist, nArgs, argv, "!");
-	getArg( "c", chainID, nArgs, argv, "!");
-	
-	unsigned int solvRes;
-	getArg( "s", solvRes, nArgs, argv, 1);
-	
-	if ((inputFile == "!") && (inputFilelist == "!"))    {
-		cout << "Missing file specification. Aborting. (-h for help)" << endl;
-		return -1;
-        }
-	
-	if ((inputFile != "!") && (inputFilelist != "!")){
-		cout << "Please choose between filelist and file mode. Aborting. "
-	    << "(-h for help)" << endl;
-		return -2;     
-        }
-	
-	Potential* solv = NULL;
-	if (!newSolvation)
-		solv = new SolvationPotential(solvRes);
-	else
-		solv = new EffectiveSolvationPotential;
-	RapdfPotential rapdf;
-	TorsionPotential* tors = NULL;
-	if (!newTorsion)
-		tors =  new PhiPsi(10);//default ARCSTEP = 10
-	else
-		tors =  new PhiPsiOmegaChi1Chi2PreAngle(20);//ARCSTEP 20, ARCSTEP2 40 
-		
-	ifstream inFile(inputFilelist.c_str());
-	if ((!inFile) && (inputFilelist != "!"))
-		ERROR("File not found.", exception);
-		
-	while ((inFile) || (inputFile != "!"))		{
-		if (inputFilelist != "!") {
-			inFile >> inputFile;
-			if (!inFile)
-				break;
-		}
+	bool perResidue;
+};
+
+/**
+ * Scores one file, false if the chain asked for is missing.
+ */
+bool FrstScoring::scoreFile(const string& inputFile, ostream& out){
 		ifstream inFile2(inputFile.c_str());
 		if (!inFile2)
 			ERROR("File not found.", exception);
 		PdbLoader pl(inFile2);
 		Spacer *sp; 
                 pl.setNoHAtoms();
+                if (getThreads() > 1)
+                    pl.setNoVerbose();
                 vector<char> allCh;
                 allCh = pl.getAllChains(); 
                 for (unsigned int i = 0; i < allCh.size(); i++)
-                  cout << "\t," << allCh[i] << ",";
-                cout << "\n";
+                  out << "\t," << allCh[i] << ",";
+                out << "\n";
 
                 /*check on validity of chain: 
                 if user select a chain then check validity
                  else select firs valid one by default*/
+                string chainID = this->chainID;
                 if (chainID != "!") {
                     bool validChain=false;
                     for (unsigned int i = 0; i < allCh.size(); i++ ) {
                       if (allCh[i]==chainID[0])  {
                         pl.setChain(chainID[0]);
-                        cout << "Loading chain " << chainID << "\n";
+                        out << "Loading chain " << chainID << "\n";
                         validChain=true;
                         break;
                       }
                     }
                     if (!validChain) {
-                       cout << "Chain " << chainID << " is not available\n";
-                      return -1;
+                       out << "Chain " << chainID << " is not available\n";
+                       return false;
                     }
 
                 }
                 else{
                     chainID[0]=allCh[0];
-                      cout << "Using chain " << chainID <<"\n";
+                      out << "Using chain " << chainID <<"\n";
                 }
                 Protein prot;
                 prot.load(pl);
@@ -188,20 +165,19 @@ int main(int nArgs, char* argv[]){
                 sp=prot.getSpacer(chainID[0]);
 		if (!pl.isValid()){
                     cerr << "Warning: Invalid PDB file found.\n";
-                    inputFile = "!";
-                    continue;
+                    return true;
                 }
 			
-		long double res = rapdf.calculateEnergy(*sp);
+		long double res = rapdf->calculateEnergy(*sp);
 		long double sres = solv->calculateEnergy(*sp);
 		long double hres = - 1.0 *  sHydrogen(*sp);
 		long double tres = tors->calculateEnergy(*sp);
 		long double sum = W_RAPDF * res + W_SOLV * sres + W_HYDB * hres 
 				+ W_TORS * tres;
-		cout.setf(ios::fixed, ios::floatfield);
+		out.setf(ios::fixed, ios::floatfield);
 		double divisor = (perResidue == true) ? sp->sizeAmino() : 1;
 		if ((verbose) || (casp)){
-                    cout << inputFile << "\t";
+                    out << inputFile << "\t";
 		}
                 if (casp) {
                     double num = sp->sizeAmino();
@@ -212,11 +188,11 @@ int main(int nArgs, char* argv[]){
                                     gdt = 0.1;
                             else if (gdt > 1.0)
                                     gdt = 1.0;
-                            cout << setw(9) << setprecision(4) << (gdt / divisor);
+                            out << setw(9) << setprecision(4) << (gdt / divisor);
                             if (caspAll < 9999){
 				for (unsigned int index = 1; index <= caspAll; index++){
 					if (sp->isGap(index)){
-						cout << " " << setw(4) << setprecision(1) << "X";
+						out << " " << setw(4) << setprecision(1) << "X";
 					}
 					else{
                                             unsigned int i = sp->getIndexFromPdbNumber(index);	
@@ -228,13 +204,13 @@ int main(int nArgs, char* argv[]){
                                             for (unsigned int j = 0; j < 20; j++){
 						double d = 20.0 - j;	
 						if (i >= j){
-						    res += d * rapdf.calculateEnergy(sp->getAmino(i-j), *sp);
+						    res += d * rapdf->calculateEnergy(sp->getAmino(i-j), *sp);
                                                     sres += d * solv->calculateEnergy(sp->getAmino(i-j), *sp);
                                                     tres += d * tors->calculateEnergy(sp->getAmino(i-j), *sp);
                                                     num += d * 1.0;
 						}
 						if (i+j < sp->sizeAmino()){
-                                                    res += d * rapdf.calculateEnergy(sp->getAmino(i+j), *sp);
+                                                    res += d * rapdf->calculateEnergy(sp->getAmino(i+j), *sp);
                                                     sres += d * solv->calculateEnergy(sp->getAmino(i+j),   *sp);
                                                     tres += d * tors->calculateEnergy(sp->getAmino(i+j), *sp);
                                                     num += d * 1.0;
@@ -246,25 +222,94 @@ int main(int nArgs, char* argv[]){
 						caErr = 1.0;
                                             else if (caErr > 20.0)
 						caErr = 20.0;
-                                            cout << " " << setw(4) << setprecision(1) << caErr;
+                                            out << " " << setw(4) << setprecision(1) << caErr;
                                         }
 					if (((index+1) % 50) == 0)
-						cout << "\n";
+						out << "\n";
                                     }
 				}
 				
 		}
 		else 
-                    cout << setw(9) << setprecision(4) << (sum / divisor);
+                    out << setw(9) << setprecision(4) << (sum / divisor);
 		if (verbose){
-			cout << "\t" << setw(9) << setprecision(4) << (res / divisor) << "\t" 
+			out << "\t" << setw(9) << setprecision(4) << (res / divisor) << "\t" 
 			<< setw(9) << setprecision(4) << (sres / divisor) << "\t" 
 			<< setw(9) << setprecision(4) << (hres / divisor) << "\t" 
 			<< setw(9) << setprecision(4) << (tres / divisor);
 		}
-		cout << endl;
-		// reset variable to trigger break condition:
-                inputFile = "!";
-	}
+		out << endl;
+		return true;
+}
+
+int main(int nArgs, char* argv[]){ 
+        char *victor=getenv("VICTOR_ROOT");
+	if (victor  == NULL)
+		ERROR("Environment variable VICTOR_ROOT was not found.\n Use the command:\n export VICTOR_ROOT=......", exception);
+	
+	if (getArg( "h", nArgs, argv)) {
+		sShowHelp();
+		return 1;
+        };
+	string victorRoot =getenv("VICTOR_ROOT");
+        cout<<victorRoot;
+	string inputFile, inputFilelist, solvOut, rapdfOut, torOut, chainID;
+	bool newTorsion = getArg( "T", nArgs, argv);
+	bool newSolvation = getArg( "S", nArgs, argv);
+	bool verbose = getArg( "v", nArgs, argv);
+	
+	bool casp = getArg( "-casp", nArgs, argv);
+	unsigned int caspAll;
+	getArg( "C", caspAll, nArgs, argv, 9999);
+	if (caspAll < 9999)
+		casp = true;
+	
+	bool perResidue = getArg( "p", nArgs, argv);
+	getArg( "i", inputFile, nArgs, argv, "!");
+	getArg( "I", inputFilelist, nArgs, argv, "!");
+	getArg( "c", chainID, nArgs, argv, "!");
+	
+	unsigned int solvRes, threads;
+	getArg( "s", solvRes, nArgs, argv, 1);
+	getArg( "j", threads, nArgs, argv, 1);
+	
+	if ((inputFile == "!") && (inputFilelist == "!"))    {
+		cout << "Missing file specification. Aborting. (-h for help)" << endl;
+		return -1;
+        }
+	
+	if ((inputFile != "!") && (inputFilelist != "!")){
+		cout << "Please choose between filelist and file mode. Aborting. "
+	    << "(-h for help)" << endl;
+		return -2;     
+        }
+	
+	Potential* solv = NULL;
+	if (!newSolvation)
+		solv = new SolvationPotential(solvRes);
+	else
+		solv = new EffectiveSolvationPotential;
+	RapdfPotential rapdf;
+	TorsionPotential* tors = NULL;
+	if (!newTorsion)
+		tors =  new PhiPsi(10);//default ARCSTEP = 10
+	else
+		tors =  new PhiPsiOmegaChi1Chi2PreAngle(20);//ARCSTEP 20, ARCSTEP2 40 
+		
+	vector<string> files;
+	if (inputFilelist != "!")
+		files = BatchScoring::readFileList(inputFilelist);
+	else
+		files.push_back(inputFile);
+
+	// loaded once here, the threads only read them
+	AminoAcidHydrogen::loadParam(victorRoot + "data/AminoAcidHydrogenData.txt");
+
+	FrstScoring frst(solv, &rapdf, tors, chainID, verbose, casp, caspAll,
+		perResidue, threads);
+	bool allScored = frst.run(files, cout);
+
 	delete tors;
+	delete solv;
+	return allScored ? 0 : -1;
 }
@@ -25,8 +25,10 @@
       *the original amino acid sequence.
  */
 #include <string>
+#include <algorithm>
 #include <GetArg.h>
 #include <PdbLoader.h>
+#include <PdbPipeline.h>
 #include <PdbSaver.h>
 #include <SolvationPotential.h>
 #include <EffectiveSolvationPotential.h>
@@ -65,6 +67,7 @@ void sShowHelp(){
        << "   Options: \n"
        << "\t-I <filelist> \t\t Input *filelist* file for PDB templates\n"
        << "\t-i <filename> \t\t Input file for PDB template\n"
+       << "\t-D <dir> \t\t Input directory (all its *.pdb files, with subdirectories)\n"
        << "\t-c <id>  \t\t ID of chain to load from PDB file\n"
        << "\t[-z] \t\t\t Get Z-Score Value\n"
        << "\t[--perc <double>] \t Percentace of residues to permute\n"
@@ -73,6 +76,7 @@ void sShowHelp(){
        << "\t[-S] \t\t\t New (Mk2) solvation potential \n"
        << "\t[-v] \t\t\t Verbose mode\n"
        << "\t[-p] \t\t\t Per residue energy calculation\n"
+       << "\t[-t <number>] \t\t Threads reading the files (def = 1)\n"
       
        << "\n";
 }
@@ -166,6 +170,152 @@ void permuteAminoSequence(Spacer& sp, double permute){
     }
 }
   
+/**
+ *  Prints the frst value or Z-score of each file of the list, in list order.
+ */
+class FrstZscore : public PdbPipeline {
+public:
+
+    FrstZscore(const PdbFileList& files, unsigned int threads,
+            RapdfPotential& rapdf, Potential* solv, Potential* tors,
+            bool perResidue, bool verbose, bool zScore, double pPercentage,
+            unsigned int rndModels) : PdbPipeline(files, threads), status(0),
+    rapdf(rapdf), solv(solv), tors(tors), perResidue(perResidue),
+    verbose(verbose), zScore(zScore), pPercentage(pPercentage),
+    rndModels(rndModels) {
+    }
+
+    int status;
+
+protected:
+
+    /**
+     *  Chain given for the file, else its first chain.
+     */
+    char getChain(const PdbFileList::Entry& entry, PdbLoader& pl) {
+        if (entry.chain != ' ')
+            return entry.chain;
+        vector<char> allCh = pl.getAllChains();
+        return allCh.empty() ? ' ' : allCh[0];
+    }
+
+    bool isAvailable(char chain, PdbLoader& pl) {
+        vector<char> allCh = pl.getAllChains();
+        return find(allCh.begin(), allCh.end(), chain) != allCh.end();
+    }
+
+    virtual void build(const PdbFileList::Entry& entry, PdbLoader& pl,
+            Protein& prot) {
+        pl.setNoHAtoms();
+        pl.setNoVerbose();
+        pl.setPermissive();
+        char chain = getChain(entry, pl);
+        if (!isAvailable(chain, pl))
+            return;
+        pl.setChain(chain);
+        prot.load(pl);
+    }
+
+    virtual bool analyze(const PdbFileList::Entry& entry, PdbLoader& pl,
+            Protein& prot) {
+        vector<char> allCh;
+        allCh = pl.getAllChains();
+        for (unsigned int i = 0; i < allCh.size(); i++)
+            cout << "\t," << allCh[i] << ",";
+        cout << "\n";
+
+        /*check on validity of chain: 
+        if user select a chain then check validity
+         else select firs valid one by default*/
+        string chainID(1, getChain(entry, pl));
+        if (entry.chain != ' ') {
+            if (!isAvailable(chainID[0], pl)) {
+                cout << "Chain " << chainID << " is not available\n";
+                status = -1;
+                return false;
+            }
+            cout << "Loading chain " << chainID << "\n";
+        }
+        else
+            cout << "Using chain " << chainID << "\n";
+
+        if (!pl.isValid() || allCh.empty()) {
+            cout << "Warning: Invalid PDB file found.\n";
+            return true;
+        }
+        Spacer *sp;
+        sp = prot.getSpacer(chainID[0]);
+        if (verbose) {
+            cout << "\n" << entry.path << "\n\n";
+        }
+        cout.setf(ios::fixed, ios::floatfield);
+        if (!zScore) {
+            if (verbose)
+                frstEval(*sp, perResidue, verbose, rapdf, solv, tors);
+            else {
+                double frstValue = frstEval(*sp, perResidue, verbose, rapdf, solv, tors);
+                cout << setw(9) << setprecision(4) << frstValue << "\n";
+            }
+        }
+        else {
+            vector<long double> energies;
+            Spacer reverseModel;
+            long double revEn;
+            long double rndEn;
+            //evaluate energy of original spacer
+            long double frstValue = frstEval(*sp, perResidue, false, rapdf, solv, tors);
+            //remove sidechains of all aminoacids in spacer
+            //add CB atom to allow evaluation of torsion potential
+            for (unsigned int a = 0; a < sp->sizeAmino(); a++) {
+                AminoAcid amino = sp->getAmino(a);
+                amino.removeSideChain();
+                amino.patchBetaPosition();
+            }
+            //reverse sequence
+            reverseModel = reverseAminoSequence(*sp);
+            revEn = frstEval(reverseModel, perResidue, false, rapdf, solv, tors);
+            energies.push_back(revEn);
+            //generate RND_MODELS permutations of aminoacid sequence and calculate their energies
+            for (unsigned int m = 1; m <= rndModels; m++) {
+                permuteAminoSequence(reverseModel, pPercentage);
+                rndEn = frstEval(reverseModel, perResidue, false, rapdf, solv, tors);
+                energies.push_back(rndEn);
+            }
+            unsigned int length = energies.size();
+            //calculate mean value
+            long double sum = 0;
+            for (unsigned int i = 0; i < length; i++)
+                sum += energies[i];
+            long double mean = sum / length;
+            //calculate standard deviation
+            long double nvariance = 0;
+            for (unsigned int i = 0; i < length; i++)
+                nvariance += pow((energies[i] - mean), 2);
+            long double stdDev = sqrt(nvariance / length);
+            //calculate Z-Score
+            long double zScore = (frstValue - mean) / stdDev;
+            cout << setw(9) << setprecision(4) << zScore << "\n\n";
+            if (verbose) {
+                cout << "mean value:" << "\t\t\t" << setw(9) << setprecision(4) << mean << "\n";
+                cout << "standard deviation:" << "\t\t" << setw(9) << setprecision(4) << stdDev << "\n";
+                cout << "energy frst value of sequence:" << "\t" << setw(9) << setprecision(4) << frstValue << "\n\n";
+            }
+        }
+        cout << endl;
+        return true;
+    }
+
+private:
+    RapdfPotential& rapdf;
+    Potential* solv;
+    Potential* tors;
+    bool perResidue;
+    bool verbose;
+    bool zScore;
+    double pPercentage;
+    unsigned int rndModels;
+};
+
 //
 //main method
 //
@@ -180,9 +330,9 @@ int main(int nArgs, char* argv[]){
       return 1;
   };
 
-  string inputFile, inputFilelist, solvOut, rapdfOut, torOut, chainID;
+  string inputFile, inputFilelist, inputDir, solvOut, rapdfOut, torOut, chainID;
   double pPercentage;
-  unsigned int rndModels;
+  unsigned int rndModels, threads;
   bool newTorsion = getArg( "T", nArgs, argv);
   bool newSolvation = getArg( "S", nArgs, argv);
   bool verbose = getArg( "v", nArgs, argv);
@@ -190,20 +340,23 @@ int main(int nArgs, char* argv[]){
   bool zScore = getArg( "z", nArgs, argv);
   getArg( "i", inputFile, nArgs, argv, "!");
   getArg( "I", inputFilelist, nArgs, argv, "!");
+  getArg( "D", inputDir, nArgs, argv, "!");
   getArg( "c", chainID, nArgs, argv, "!");
+  getArg( "t", threads, nArgs, argv, 1);
   // percentage of permutated aminoacids in order to generate a randon structure
   // default is 80%
   getArg( "-perc", pPercentage, nArgs, argv, 0.8);
   // number of structures to be generated to calculate Zscore, default is 99
   getArg( "-rnd", rndModels, nArgs, argv, 20);
   
-  if ((inputFile == "!") && (inputFilelist == "!")){
+  int inputs = (inputFile != "!") + (inputFilelist != "!") + (inputDir != "!");
+  if (inputs == 0){
       cout << "Missing file specification. Aborting. (-h for help)" << endl;
       return -1;
     }
 
-  if ((inputFile != "!") && (inputFilelist != "!")){
-       cout << "Please choose between filelist and file mode. Aborting. "
+  if (inputs > 1){
+       cout << "Please choose between filelist, directory and file mode. Aborting. "
 	    << "(-h for help)" << endl;
       return -2;     
     }
@@ -223,122 +376,22 @@ int main(int nArgs, char* argv[]){
   else
     tors =  new PhiPsiOmegaChi1Chi2PreAngle(20);//ARCSTEP 20, ARCSTEP2 40 
    
-  ifstream inFile(inputFilelist.c_str());
-  if ((!inFile) && (inputFilelist != "!"))
-    ERROR("File not found.", exception);
-
-  while ((inFile) || (inputFile != "!")){
-      if (inputFilelist != "!")	{
-	  inFile >> inputFile;
-	  if (!inFile)
-	    break;
-	}
+  PdbFileList files;
+  if (inputFile != "!")
+    files.addFile(inputFile, (chainID != "!") ? chainID[0] : ' ');
+  else {
+    PdbFileList list;
+    if (inputFilelist != "!")
+      list.addFileList(inputFilelist);
+    else
+      list.addDirectory(inputDir);
+    for (unsigned int i = 0; i < list.size(); i++)
+      files.addFile(list[i].path, (chainID != "!") ? chainID[0] : ' ');
+  }
 
-  Spacer *sp;
-  ifstream inFile2(inputFile.c_str());
-  if (!inFile2)
-	ERROR("File not found.", exception);
-  PdbLoader pl(inFile2);
-  pl.setNoHAtoms();
-  pl.setNoVerbose();
-  pl.setPermissive();
-  pl.setNoHAtoms();
-  vector<char> allCh;
-  allCh = pl.getAllChains(); 
-  for (unsigned int i = 0; i < allCh.size(); i++)
-      cout << "\t," << allCh[i] << ",";
-  cout << "\n";
- 
-  /*check on validity of chain: 
-  if user select a chain then check validity
-   else select firs valid one by default*/
-  if (chainID != "!")  {
-      bool validChain=false;
-      for (unsigned int i = 0; i < allCh.size(); i++ ) {
-        if (allCh[i]==chainID[0]) {
-          pl.setChain(chainID[0]);
-          cout << "Loading chain " << chainID << "\n";
-          validChain=true;
-          break;
-        }
-      }
-      if (!validChain) {
-            cout << "Chain " << chainID << " is not available\n";
-            return -1;
-      }
-    }
-    else{
-       chainID[0]=allCh[0];
-       cout << "Using chain " << chainID <<"\n";
-    }
-    Protein prot;
-    prot.load(pl);
-    sp=prot.getSpacer(chainID[0]);
-      if (!pl.isValid()){
-	  cout << "Warning: Invalid PDB file found.\n";
-	  inputFile = "!";
-	  continue;
-	}
-      if (verbose){
-	  cout << "\n" << inputFile << "\n\n";
-        }
-      cout.setf(ios::fixed, ios::floatfield);      
-      if (!zScore){
-	  if (verbose)
-	    frstEval(*sp, perResidue, verbose, rapdf, solv, tors);
-	  else{
-	      double frstValue = frstEval(*sp, perResidue, verbose, rapdf, solv, tors);
-	      cout << setw(9) << setprecision(4) << frstValue << "\n";
-	  }
-	}
-      else{
-	vector<long double> energies;
-	Spacer reverseModel;
-	Spacer randomModel;
-	long double revEn;
-	long double rndEn;
-	//evaluate energy of original spacer
-	long double frstValue = frstEval(*sp, perResidue, false, rapdf, solv, tors);
-	//remove sidechains of all aminoacids in spacer
-	//add CB atom to allow evaluation of torsion potential
-	for (unsigned int a = 0; a < sp->sizeAmino(); a++) {	
-	    AminoAcid amino = sp->getAmino(a);
-	    amino.removeSideChain();
-	    amino.patchBetaPosition();
-	  }
-	//reverse sequence
-	reverseModel = reverseAminoSequence(*sp);
-	revEn = frstEval(reverseModel, perResidue, false, rapdf, solv, tors);
-	energies.push_back(revEn);
-	//generate RND_MODELS permutations of aminoacid sequence and calculate their energies
-	for (unsigned int m = 1; m <= rndModels; m++) {
-	    permuteAminoSequence(reverseModel, pPercentage);
-	    rndEn = frstEval(reverseModel, perResidue, false, rapdf, solv, tors);
-	    energies.push_back(rndEn);
-	  }
-	unsigned int length = energies.size();
-	//calculate mean value
-	long double sum = 0;
-	for( unsigned int i = 0; i < length; i++)
-	  sum += energies[i];
-	long double mean = sum/length;
-	//calculate standard deviation
-	long double nvariance = 0;
-	for( unsigned int i = 0; i < length; i++)
-	  nvariance += pow((energies[i]-mean), 2);
-	long double stdDev = sqrt(nvariance/length);
-	//calculate Z-Score
-	long double zScore = (frstValue - mean)/stdDev;
-	cout << setw(9) << setprecision(4) << zScore << "\n\n" ;
-	if (verbose)  {
-	    cout << "mean value:" << "\t\t\t" << setw(9) << setprecision(4) << mean << "\n";
-	    cout << "standard deviation:" << "\t\t" << setw(9) << setprecision(4) << stdDev << "\n";
-	    cout << "energy frst value of sequence:" << "\t" << setw(9) << setprecision(4) << frstValue << "\n\n";
-	  }
-      }
-      cout << endl;
-      // reset variable to trigger break condition:
-      inputFile = "!";
-   }
+  FrstZscore pipeline(files, threads, rapdf, solv, tors, perResidue, verbose,
+          zScore, pPercentage, rndModels);
+  pipeline.run();
   delete tors;
+  return pipeline.status;
 }
@@ -392,8 +392,12 @@ main(int nArgs, char* argv[])
 		if ( !pdbfile2 )
 			ERROR( "File not found", exception );
 		
-		//load components in standard PDB format from pdbfile2
+		//load components in standard PDB format from pdbfile2,
+		//read once for all chains and models
 		PdbLoader pl(pdbfile2);
+		pl.setNoHAtoms();
+		pl.setNoVerbose();
+		pl.setPermissive();
 		if ( allchains )
 		{
 			//insert all ID of chains present in PDB file
@@ -440,11 +444,7 @@ main(int nArgs, char* argv[])
 			//for each chain
 			for ( unsigned int ch = 0; ch < totalchain.size(); ch++ )
 			{
-				PdbLoader pl(pdbfile2);
 				pl.setChain(totalchain[ch]);
-				pl.setNoHAtoms();
-				pl.setNoVerbose();
-				pl.setPermissive();
 				if (!force)
 				{		
 					nmrmodel = i;	     
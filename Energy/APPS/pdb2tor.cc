@@ -17,8 +17,10 @@
  @Description This program give information about the torsion angle  of a given protein structural model. 
  */
 #include <string>
+#include <algorithm>
 #include <GetArg.h>
 #include <PdbLoader.h>
+#include <PdbPipeline.h>
 #include <AminoAcid.h>
 #include <String2Number.h>
 using namespace Victor::Biopool; 
@@ -38,6 +40,8 @@ void sShowHelp(){
        << "\t-I <filelist> \t\t Input filelist (a file containing the list of PDB file)." <<"\n"
        << "\t\t\t\t For major information upon the format of the input filelist and the option\n"
        << "\t\t\t\t type: pdb2tor --filelist \n"
+       << "\t-D <dir> \t\t Input directory (all its *.pdb files, with subdirectories).\n"
+       << "\t[-t <number>] \t\t Threads reading the files (def = 1).\n"
        << "Output option: \n"
        << "\t -P \t\t\t Give per residue phi and psi angles.\n"
        << "\t -O \t\t\t Give per residue phi, psi and omega angles.\n"
@@ -62,156 +66,103 @@ void sSpecification()
        <<"....\n\n";
 }
 
-int main(int nArgs, char* argv[])
-{
-  if (getArg( "h", nArgs, argv)) {
-      sShowHelp();
-      return 1;
-    };
-  if (getArg( "-filelist", nArgs, argv)) {
-      sSpecification();
-      return 1;
-    }
-  
-  string inputFile, inputFilelist, chainID;
-  vector<char> allCh; 
-  getArg( "i", inputFile, nArgs, argv, "!");
-  getArg( "I", inputFilelist, nArgs, argv, "!");
-  getArg( "c", chainID, nArgs, argv, " ");
-  bool nmr = getArg( "-nmr", nArgs, argv);
-  bool complete = getArg( "-complete", nArgs, argv);
-  bool p = getArg( "P", nArgs, argv);
-  bool o = getArg( "O", nArgs, argv);
-  bool c = getArg( "C", nArgs, argv);
-  bool a = getArg( "A", nArgs, argv);
-  bool verbose = getArg( "r", nArgs, argv);
-
-  //Control for ChaiId option
-  if ((chainID != " ") && (complete))
-    ERROR("You are using the 'chainID' option and the 'complete' option at the same time.", exception);
+/**
+ *  Prints the torsion angles of each file of the list, in list order.
+ */
+class Pdb2Tor : public PdbPipeline {
+public:
 
-  //Control for input file
-  if ((inputFile == "!") && (inputFilelist == "!")) {
-      cout << "Missing file specification. Aborting. (-h for help)" << endl;
-      return -1;
-    }
-  
-  if ((inputFile != "!") && (inputFilelist != "!")) {
-      cout << "Please choose between filelist and file mode. Aborting. "
-	   << "(-h for help)" << endl;
-      return -2;     
+    Pdb2Tor(const PdbFileList& files, unsigned int threads, bool nmr, bool p,
+            bool o, bool c, bool a, bool verbose) : PdbPipeline(files, threads),
+    status(0), totalanalized(0), totalmodel(0), nmr(nmr), p(p), o(o), c(c),
+    a(a), verbose(verbose) {
     }
-  if (( !a ) && ( !c ) && ( !o ) && ( !p ) && ( !verbose ))
-    ERROR("Choose a valid option for output.", exception);
 
-  ifstream inFile(inputFilelist.c_str());
-  
-  if ((!inFile) && (inputFilelist != "!"))
-    ERROR("File not found.", exception);
+    int status;
+    int totalanalized;
+    int totalmodel;
 
-  int totalanalized = 0;
-  int totalmodel = 0;
+protected:
 
-  while ((inFile) || (inputFile != "!")) {
-        if (inputFilelist != "!"){
-            inFile >> inputFile;
+    /**
+     *  Chain given for the file, else its first chain.
+     */
+    char getChain(const PdbFileList::Entry& entry, PdbLoader& pl) {
+        if (entry.chain != ' ')
+            return entry.chain;
+        vector<char> allCh = pl.getAllChains();
+        return allCh.empty() ? ' ' : allCh[0];
+    }
 
-            if (!inFile)
-              break;
-            if (complete) {
-                int check = checkForBlankLine(inFile, true);
-                cout<<"check value"<<check;
-                if ( check == 1 )
-                  chainID = " ";
-                else
-                  inFile >> chainID;
-                skipToNewLine(inFile);
-              }
-	}
-      
-        if ( inputFile == "!" ){
-            cout << "Missing file specification. Aborting. (-h for help)" << endl;
-            return -1;
-          }
-      
-        ifstream inFile2(inputFile.c_str());
-        if (!inFile2)
-          ERROR("File not found.", exception);
+    bool isAvailable(char chain, PdbLoader& pl) {
+        vector<char> allCh = pl.getAllChains();
+        return find(allCh.begin(), allCh.end(), chain) != allCh.end();
+    }
 
-        PdbLoader pl(inFile2);
+    virtual void build(const PdbFileList::Entry& entry, PdbLoader& pl,
+            Protein& prot) {
         pl.setNoHAtoms();
         pl.setNoVerbose();
+        char chain = getChain(entry, pl);
+        if (!isAvailable(chain, pl))
+            return;
+        pl.setChain(chain);
+        pl.setPermissive();
+        prot.load(pl);
+    }
 
-        allCh = pl.getAllChains(); 
-
-
-        /*check on validity of chain: 
-        if user select a chain then check validity
-        else select first valid one by default*/
-
-        if (chainID != " ")  {
-          bool validChain=false;
-          for (unsigned int i = 0; i < allCh.size(); i++ ) {
-            if (allCh[i]==chainID[0])  {
-              pl.setChain(chainID[0]);
-              cout << "Loading chain " << chainID << "\n";
-              validChain=true;
-              break;
+    virtual bool analyze(const PdbFileList::Entry& entry, PdbLoader& pl,
+            Protein& prot) {
+        string inputFile = entry.path;
+        string chainID(1, getChain(entry, pl));
+        if (entry.chain != ' ') {
+            if (!isAvailable(chainID[0], pl)) {
+                cout << "Chain " << chainID << " is not available\n";
+                status = -1;
+                return false;
             }
-          }
-          if (!validChain) {
-             cout << "Chain " << chainID << " is not available\n";
-            return -1;
-          }
-
+            cout << "Loading chain " << chainID << "\n";
         }
-        else{
-            chainID=allCh[0];
-        }
-
-        
-        
-        pl.setPermissive();
-        Protein prot;
-        prot.load(pl);
 
         unsigned int max;
 
-        if (!pl.isValid()){
+        if (!pl.isValid()) {
             if (!verbose)
-              cout << "Warning: Invalid PDB file found "<<inputFile<<".\n";
-            inputFile = "!";
-            continue;
-          }
+                cout << "Warning: Invalid PDB file found " << inputFile << ".\n";
+            return true;
+        }
 
         if (!nmr)
-          max = 1;
-        else{
+            max = 1;
+        else {
             max = pl.getMaxModels();
-            if ( max == 0)
-              {
+            if (max == 0) {
                 max = 1;
-                if ( !verbose )
-                  cout <<"Warning: the file "<<inputFile<<" probably is not an nmr structure.\n";
-              }
-          }
+                if (!verbose)
+                    cout << "Warning: the file " << inputFile << " probably is not an nmr structure.\n";
+            }
+        }
 
         totalanalized += 1;
 
-        for (unsigned int j = 1; j <= max; j++){
-            pl.setModel(j);
+        for (unsigned int j = 1; j <= max; j++) {
+            // the first model is already built, the others are loaded here
+            Protein other;
+            Protein* model = &prot;
+            if (j > 1) {
+                pl.setModel(j);
+                other.load(pl);
+                model = &other;
+            }
             Spacer *sp;
-            sp=prot.getSpacer(chainID[0]);
-            if (!pl.isValid())  {
-                if ( !verbose )
-                  cout << "Warning: Invalid PDB file found:"<<inputFile<<".\n";
-                if ( j == max )
-                  {
-                    inputFile = "!";
+            sp = model->getSpacer(chainID[0]);
+            if (!pl.isValid()) {
+                if (!verbose)
+                    cout << "Warning: Invalid PDB file found:" << inputFile << ".\n";
+                if (j == max)
                     totalanalized -= 1;
-                  }
                 continue;
-              }
+            }
             totalmodel += 1;
             int n , i;
             n = sp->sizeAmino()-1;
@@ -314,12 +265,81 @@ int main(int nArgs, char* argv[])
                    }
               }
           }
-        // reset variable to trigger break condition:
-        inputFile = "!";
+        return true;
     }
+
+private:
+    bool nmr;
+    bool p, o, c, a;
+    bool verbose;
+};
+
+int main(int nArgs, char* argv[])
+{
+  if (getArg( "h", nArgs, argv)) {
+      sShowHelp();
+      return 1;
+    };
+  if (getArg( "-filelist", nArgs, argv)) {
+      sSpecification();
+      return 1;
+    }
+  
+  string inputFile, inputFilelist, inputDir, chainID;
+  unsigned int threads;
+  getArg( "i", inputFile, nArgs, argv, "!");
+  getArg( "I", inputFilelist, nArgs, argv, "!");
+  getArg( "D", inputDir, nArgs, argv, "!");
+  getArg( "c", chainID, nArgs, argv, " ");
+  getArg( "t", threads, nArgs, argv, 1);
+  bool nmr = getArg( "-nmr", nArgs, argv);
+  bool complete = getArg( "-complete", nArgs, argv);
+  bool p = getArg( "P", nArgs, argv);
+  bool o = getArg( "O", nArgs, argv);
+  bool c = getArg( "C", nArgs, argv);
+  bool a = getArg( "A", nArgs, argv);
+  bool verbose = getArg( "r", nArgs, argv);
+
+  //Control for ChaiId option
+  if ((chainID != " ") && (complete))
+    ERROR("You are using the 'chainID' option and the 'complete' option at the same time.", exception);
+
+  //Control for input file
+  int inputs = (inputFile != "!") + (inputFilelist != "!") + (inputDir != "!");
+  if (inputs == 0) {
+      cout << "Missing file specification. Aborting. (-h for help)" << endl;
+      return -1;
+    }
+  
+  if (inputs > 1) {
+      cout << "Please choose between filelist, directory and file mode. Aborting. "
+	   << "(-h for help)" << endl;
+      return -2;     
+    }
+  if (( !a ) && ( !c ) && ( !o ) && ( !p ) && ( !verbose ))
+    ERROR("Choose a valid option for output.", exception);
+
+  PdbFileList list;
+  if (inputFile != "!")
+    list.addFile(inputFile);
+  else if (inputFilelist != "!")
+    list.addFileList(inputFilelist, complete);
+  else
+    list.addDirectory(inputDir);
+
+  // the chain of the -c option applies to every file
+  PdbFileList files;
+  for (unsigned int i = 0; i < list.size(); i++)
+    files.addFile(list[i].path, (chainID != " ") ? chainID[0] : list[i].chain);
+
+  Pdb2Tor pipeline(files, threads, nmr, p, o, c, a, verbose);
+  pipeline.run();
+  if (pipeline.status != 0)
+    return pipeline.status;
+
   if ( !verbose )  {
-      cout <<"Total file analized:"<<"\t"<<totalanalized<<"\n";
+      cout <<"Total file analized:"<<"\t"<<pipeline.totalanalized<<"\n";
       if ( nmr )
-	cout <<"Total nmr model analized:\t"<<totalmodel<<"\n";
+	cout <<"Total nmr model analized:\t"<<pipeline.totalmodel<<"\n";
     }
 }
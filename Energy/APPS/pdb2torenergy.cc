@@ -281,8 +281,12 @@ main(int nArgs, char* argv[])
       vector<char> totalchain;
       ifstream pdbfile2(inputFile.c_str());
       
-      //load components in standard PDB format from pdbfile2
+      //load components in standard PDB format from pdbfile2,
+      //read once for all chains and models
       PdbLoader pl(pdbfile2);
+      pl.setNoHAtoms();
+      pl.setNoVerbose();
+      pl.setPermissive();
       if ( allchains )
 	{
 	  //insert all ID of chains present in PDB file
@@ -319,11 +323,7 @@ main(int nArgs, char* argv[])
 	  //for each chain
 	  for ( unsigned int ch = 0; ch < totalchain.size(); ch++ )
 	    {
-	      PdbLoader pl(pdbfile2);
 	      pl.setChain(totalchain[ch]);
-	      pl.setNoHAtoms();
-	      pl.setNoVerbose();
-	      pl.setPermissive();
 	      nmrmodel = i;
 
 	      if (!force)
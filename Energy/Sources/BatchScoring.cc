@@ -0,0 +1,151 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <BatchScoring.h>
+#include <sstream>
+#include <fstream>
+
+using namespace Victor;
+
+using namespace Victor::Energy;
+
+// Global constants, typedefs, etc. (to avoid):
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Basic constructor
+ *@param threads, number of threads used by run()
+ */
+BatchScoring::BatchScoring(unsigned int threads) : threads(1), files(NULL),
+results(), done(), scored(), next(0) {
+    setThreads(threads);
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&finished, NULL);
+}
+
+/**
+ *  Basic destructor
+ */
+BatchScoring::~BatchScoring() {
+    PRINT_NAME;
+    pthread_cond_destroy(&finished);
+    pthread_mutex_destroy(&lock);
+}
+
+// PREDICATES:
+
+/**
+ *  Reads a list of file names, separated by white space.
+ *@param fileName, name of the list
+ *@return the file names, in order
+ */
+vector<string> BatchScoring::readFileList(const string& fileName) {
+    ifstream in(fileName.c_str());
+    if (!in)
+        ERROR("File not found.", exception);
+    vector<string> files;
+    string name;
+    while (in >> name)
+        files.push_back(name);
+    return files;
+}
+
+// MODIFIERS:
+
+/**
+ *  Scores all files and writes the results in the order of the list.
+ *@param files, names of the input files
+ *@param out, output stream
+ *@return true if all files were scored
+ */
+bool BatchScoring::run(const vector<string>& files, ostream& out) {
+    bool allScored = true;
+    if ((threads == 1) || (files.size() < 2)) {
+        for (unsigned int i = 0; i < files.size(); i++)
+            if (!scoreFile(files[i], out))
+                allScored = false;
+        return allScored;
+    }
+
+    this->files = &files;
+    results.assign(files.size(), "");
+    done.assign(files.size(), false);
+    scored.assign(files.size(), false);
+    next = 0;
+
+    unsigned int nThreads = (threads < files.size()) ? threads : files.size();
+    vector<pthread_t> pool(nThreads);
+    for (unsigned int t = 0; t < nThreads; t++)
+        if (pthread_create(&pool[t], NULL, pWorker, this) != 0)
+            ERROR("Could not create thread.", exception);
+
+    for (unsigned int i = 0; i < files.size(); i++) {
+        string result;
+        pthread_mutex_lock(&lock);
+        while (!done[i])
+            pthread_cond_wait(&finished, &lock);
+        result.swap(results[i]);
+        if (!scored[i])
+            allScored = false;
+        pthread_mutex_unlock(&lock);
+        out << result << flush;
+    }
+
+    for (unsigned int t = 0; t < nThreads; t++)
+        pthread_join(pool[t], NULL);
+    this->files = NULL;
+    return allScored;
+}
+
+// HELPERS:
+
+/**
+ *  Entry point of the threads.
+ *@param batch, pointer to the BatchScoring
+ */
+void* BatchScoring::pWorker(void* batch) {
+    static_cast<BatchScoring*> (batch)->pWork();
+    return NULL;
+}
+
+/**
+ *  Takes the next file until all are handed out, scores it and stores
+ * its results.
+ */
+void BatchScoring::pWork() {
+    while (true) {
+        pthread_mutex_lock(&lock);
+        unsigned int i = next;
+        if (next < files->size())
+            next++;
+        pthread_mutex_unlock(&lock);
+        if (i >= files->size())
+            break;
+
+        ostringstream result;
+        bool ok = scoreFile((*files)[i], result);
+
+        pthread_mutex_lock(&lock);
+        results[i] = result.str();
+        scored[i] = ok;
+        done[i] = true;
+        pthread_cond_broadcast(&finished);
+        pthread_mutex_unlock(&lock);
+    }
+}
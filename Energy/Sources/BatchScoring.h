@@ -0,0 +1,98 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BATCHSCORING_H_
+#define _BATCHSCORING_H_
+
+// Includes:
+#include <vector>
+#include <string>
+#include <pthread.h>
+#include <Debug.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Energy {
+
+    /**
+     * @brief Scores a list of input files on a pool of threads.
+     *
+     * Derived classes implement scoreFile(), which loads and scores one file
+     * and writes its results to the stream it is given. The potentials are
+     * meant to be members of the derived class, loaded once and only read
+     * by scoreFile(), so that all threads share the same parameter tables.
+     * run() hands the files out to the threads and writes the results in
+     * the order of the list, as soon as all earlier files are done.
+     * With a single thread the files are scored one after the other and
+     * written directly to the output stream. A file failing does not stop
+     * the others, run() reports it after all files are done.
+     *
+     * */
+    class BatchScoring {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        BatchScoring(unsigned int threads = 1);
+        virtual ~BatchScoring();
+
+        // PREDICATES:
+
+        unsigned int getThreads() const {
+            return threads;
+        }
+
+        static vector<string> readFileList(const string& fileName);
+
+        // MODIFIERS:
+
+        void setThreads(unsigned int threads) {
+            this->threads = (threads > 0) ? threads : 1;
+        }
+
+        bool run(const vector<string>& files, ostream& out);
+
+    protected:
+
+        /**
+         * Scores one input file. Called concurrently from several threads,
+         * so it must not modify shared state.
+         *@param file, name of the input file
+         *@param out, stream for the results of this file
+         *@return false if the file could not be scored
+         */
+        virtual bool scoreFile(const string& file, ostream& out) = 0;
+
+    private:
+
+        // HELPERS:
+        static void* pWorker(void* batch);
+        void pWork();
+
+        // ATTRIBUTES:
+        unsigned int threads;
+
+        // state of the current run(), guarded by lock:
+        const vector<string>* files;
+        vector<string> results;
+        vector<bool> done;
+        vector<bool> scored; // return values of scoreFile()
+        unsigned int next; // next file to hand out
+        pthread_mutex_t lock;
+        pthread_cond_t finished;
+    };
+
+}} // namespace
+#endif //_BATCHSCORING_H_
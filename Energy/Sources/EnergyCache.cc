@@ -0,0 +1,415 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <EnergyCache.h>
+#include <TorsionPotential.h>
+#include <NeighborGrid.h>
+#include <algorithm>
+
+using namespace Victor;
+
+using namespace Victor::Biopool;
+
+using namespace Victor::Energy;
+
+// Global constants, typedefs, etc. (to avoid):
+
+/**
+ *  Squared distance, same arithmetic as SpacerCoordinates::squareDistance().
+ */
+static inline double sSquareDistance(const vgVector3<double>& a,
+        const vgVector3<double>& b) {
+    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)
+            + (a.z - b.z) * (a.z - b.z);
+}
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Basic constructor. The potentials are not owned by the cache and must
+ * outlive it.
+ *@param rapdf, solv, tors potentials to keep track of, NULL to skip one
+ */
+EnergyCache::EnergyCache(RapdfPotential* rapdf, SolvationPotential* solv,
+        TorsionPotential* tors) : sp(NULL), rapdf(rapdf), solv(solv), tors(tors),
+rapdfWeight(1.0), solvWeight(1.0), torsWeight(1.0), rapdfGrid(),
+maxRadius(0.0), solvGrid(), rapdfEnergy(0.0), solvEnergy(0.0),
+torsEnergy(0.0) {
+}
+
+/**
+ *  Basic destructor
+ */
+EnergyCache::~EnergyCache() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *  Returns the spacer the cache is attached to.
+ *@return spacer reference (Spacer&)
+ */
+Spacer& EnergyCache::getSpacer() {
+    if (sp == NULL)
+        ERROR("EnergyCache is not attached to a spacer.", exception);
+    return *sp;
+}
+
+/**
+ *  Weighted sum of the energies of all potentials.
+ *@return energy value (long double)
+ */
+long double EnergyCache::getEnergy() const {
+    return rapdfWeight * rapdfEnergy + solvWeight * solvEnergy
+            + torsWeight * torsEnergy;
+}
+
+// MODIFIERS:
+
+/**
+ *  Sets the weights used by getEnergy(), all 1 by default.
+ *@param rapdfWeight, solvWeight, torsWeight (double)
+ */
+void EnergyCache::setWeights(double rapdfWeight, double solvWeight,
+        double torsWeight) {
+    this->rapdfWeight = rapdfWeight;
+    this->solvWeight = solvWeight;
+    this->torsWeight = torsWeight;
+}
+
+/**
+ *  Attaches the cache to a spacer and evaluates all terms.
+ *@param sp, spacer reference
+ */
+void EnergyCache::attach(Spacer& sp) {
+    this->sp = &sp;
+    refresh();
+}
+
+/**
+ *  Releases the spacer and all cached terms.
+ */
+void EnergyCache::detach() {
+    sp = NULL;
+    residue.clear();
+    rapdfPair.clear();
+    solvContact.clear();
+    solvTerm.clear();
+    torsTerm.clear();
+    rapdfGrid.clear();
+    solvGrid.clear();
+    maxRadius = 0.0;
+    rapdfEnergy = solvEnergy = torsEnergy = 0.0;
+}
+
+/**
+ *  Updates the terms involving one residue, after its coordinates or its
+ * type changed. The other residues must not have moved.
+ *@param index, position of the residue in the spacer
+ */
+void EnergyCache::update(unsigned int index) {
+    if (sp == NULL)
+        ERROR("EnergyCache is not attached to a spacer.", exception);
+    if (index >= residue.size())
+        ERROR("Residue index out of range.", exception);
+
+    pReadResidue(index);
+    if (rapdf != NULL)
+        pUpdateRapdf(index);
+    if (solv != NULL)
+        pUpdateSolvation(index);
+    if (tors != NULL)
+        pUpdateTorsion(index);
+}
+
+/**
+ *  Re-reads the whole spacer and recomputes all terms.
+ */
+void EnergyCache::refresh() {
+    Spacer& sp = getSpacer();
+    unsigned int size = sp.sizeAmino();
+    residue.resize(size);
+    for (unsigned int i = 0; i < size; i++)
+        pReadResidue(i);
+
+    rapdfPair.assign(size, map<unsigned int, long double>());
+    rapdfEnergy = 0.0;
+    if (rapdf != NULL)
+        pBuildRapdf();
+
+    solvContact.assign(size, vector<unsigned int>());
+    solvTerm.assign(size, 0.0);
+    solvEnergy = 0.0;
+    if (solv != NULL)
+        pBuildSolvation();
+
+    torsTerm.assign(size, 0.0);
+    torsEnergy = 0.0;
+    if (tors != NULL)
+        for (unsigned int i = 0; i < size; i++) {
+            torsTerm[i] = pGetTorsion(i);
+            torsEnergy += torsTerm[i];
+        }
+}
+
+// HELPERS:
+
+/**
+ *  Copies coordinates, atom types and C-beta of a residue from the spacer.
+ *@param i, residue index
+ */
+void EnergyCache::pReadResidue(unsigned int i) {
+    AminoAcid& aa = sp->getAmino(i);
+    Residue& res = residue[i];
+    res.code = static_cast<AminoAcidCode> (aa.getCode());
+    string aaType = aa.getType();
+    res.atom.resize(aa.size());
+    res.type.resize(aa.size());
+    res.centre = vgVector3<double>(0.0, 0.0, 0.0);
+    for (unsigned int j = 0; j < aa.size(); j++) {
+        res.atom[j] = aa[j].getCoords();
+        res.type[j] = (rapdf != NULL) ? rapdf->pGetAtomType(aa[j], aaType)
+                : MAX_TYPES;
+        res.centre += res.atom[j];
+    }
+    if (aa.size() > 0)
+        res.centre /= static_cast<double> (aa.size());
+    res.radius = 0.0;
+    for (unsigned int j = 0; j < aa.size(); j++)
+        res.radius = max(res.radius, (res.atom[j] - res.centre).length());
+
+    res.hasCb = aa.getSideChain().isMember(CB);
+    if (res.hasCb)
+        res.cb = aa.getSideChain()[CB].getCoords();
+}
+
+/**
+ *  RAPDF energy between two residues, atoms of the lower index first as in
+ * RapdfPotential::calculateEnergy(Spacer&).
+ *@param i, j residue indexes
+ *@return energy value (long double)
+ */
+long double EnergyCache::pGetRapdfPair(unsigned int i, unsigned int j) const {
+    if (i > j)
+        swap(i, j);
+    const Residue& res1 = residue[i];
+    const Residue& res2 = residue[j];
+    long double en = 0.0;
+    for (unsigned int a = 0; a < res1.atom.size(); a++) {
+        if (res1.type[a] >= MAX_TYPES)
+            continue;
+        for (unsigned int b = 0; b < res2.atom.size(); b++) {
+            unsigned int bin = rapdf->pGetDistanceBinSquare(
+                    sSquareDistance(res1.atom[a], res2.atom[b]));
+            if ((bin < MAX_BINS) && (res2.type[b] < MAX_TYPES))
+                en += rapdf->prob[res1.type[a]][res2.type[b]][bin];
+        }
+    }
+    return en;
+}
+
+/**
+ *  Checks whether two residues have atoms within the RAPDF cutoff,
+ * comparing their enclosing spheres.
+ *@param i, j residue indexes
+ *@return true if the pair may contribute (bool)
+ */
+bool EnergyCache::pIsRapdfCandidate(unsigned int i, unsigned int j) const {
+    return ((residue[i].centre - residue[j].centre).length()
+            <= RAPDF_CUTOFF + residue[i].radius + residue[j].radius + RAPDF_TOLERANCE);
+}
+
+/**
+ *  Checks whether the C-beta atoms of two residues count for each other's
+ * solvation, as in SolvationPotential::calculateSolvation(Spacer&).
+ *@param i, j residue indexes
+ *@return true if they are neighbours (bool)
+ */
+bool EnergyCache::pIsSolvationContact(unsigned int i, unsigned int j) const {
+    if ((!residue[i].hasCb) || (!residue[j].hasCb))
+        return false;
+    double d = sqrt(sSquareDistance(residue[i].cb, residue[j].cb));
+    return ((d <= SOLVATION_CUTOFF_DISTANCE) && (d > 0.0)); // check not identical
+}
+
+/**
+ *  Solvation term of a residue from its current number of contacts.
+ *@param i, residue index
+ *@return energy value (long double)
+ */
+long double EnergyCache::pGetSolvation(unsigned int i) const {
+    if ((residue[i].code == GLY) || (!residue[i].hasCb))
+        return 0.0;
+    return solv->pGetSolvation(residue[i].code, solvContact[i].size());
+}
+
+/**
+ *  Torsion term of a residue, zero for the residues the potential skips
+ * at the ends of the chain.
+ *@param i, residue index
+ *@return energy value (long double)
+ */
+long double EnergyCache::pGetTorsion(unsigned int i) const {
+    return tors->calculateEnergy(*sp, i, i + 1);
+}
+
+/**
+ *  Computes all non-zero residue pair energies of the RAPDF potential.
+ */
+void EnergyCache::pBuildRapdf() {
+    unsigned int size = residue.size();
+    vector<vgVector3<double> > centre(size);
+    maxRadius = 0.0;
+    for (unsigned int i = 0; i < size; i++) {
+        centre[i] = residue[i].centre;
+        maxRadius = max(maxRadius, residue[i].radius);
+    }
+
+    rapdfGrid = NeighborGrid(centre, RAPDF_CUTOFF + 2 * maxRadius);
+    vector<unsigned int> nb;
+    for (unsigned int i = 0; i < size; i++) {
+        rapdfGrid.getNeighbors(i, RAPDF_CUTOFF + residue[i].radius + maxRadius
+                + RAPDF_TOLERANCE, nb);
+        for (unsigned int n = 0; n < nb.size(); n++) {
+            unsigned int j = nb[n];
+            if ((j <= i) || (!pIsRapdfCandidate(i, j)))
+                continue;
+            long double en = pGetRapdfPair(i, j);
+            if (en != 0.0) {
+                rapdfPair[i][j] = en;
+                rapdfPair[j][i] = en;
+                rapdfEnergy += en;
+            }
+        }
+    }
+}
+
+/**
+ *  Collects the C-beta contacts of all residues and their solvation terms.
+ */
+void EnergyCache::pBuildSolvation() {
+    unsigned int size = residue.size();
+    vector<vgVector3<double> > point(size);
+    for (unsigned int i = 0; i < size; i++)
+        point[i] = residue[i].hasCb ? residue[i].cb : residue[i].centre;
+
+    solvGrid = NeighborGrid(point, SOLVATION_CUTOFF_DISTANCE);
+    vector<unsigned int> nb;
+    for (unsigned int i = 0; i < size; i++) {
+        if (!residue[i].hasCb)
+            continue;
+        solvGrid.getNeighbors(i, SOLVATION_CUTOFF_DISTANCE, nb);
+        for (unsigned int n = 0; n < nb.size(); n++)
+            if (pIsSolvationContact(i, nb[n]))
+                solvContact[i].push_back(nb[n]);
+    }
+
+    for (unsigned int i = 0; i < size; i++) {
+        solvTerm[i] = pGetSolvation(i);
+        solvEnergy += solvTerm[i];
+    }
+}
+
+/**
+ *  Replaces the RAPDF row of a residue, with the partners found on the grid.
+ *@param index, residue index
+ */
+void EnergyCache::pUpdateRapdf(unsigned int index) {
+    map<unsigned int, long double>& row = rapdfPair[index];
+    for (map<unsigned int, long double>::iterator it = row.begin();
+            it != row.end(); ++it) {
+        rapdfEnergy -= it->second;
+        rapdfPair[it->first].erase(index);
+    }
+    row.clear();
+
+    rapdfGrid.setPoint(index, residue[index].centre);
+    maxRadius = max(maxRadius, residue[index].radius);
+    vector<unsigned int> nb;
+    rapdfGrid.getNeighbors(index, RAPDF_CUTOFF + residue[index].radius
+            + maxRadius + RAPDF_TOLERANCE, nb);
+    for (unsigned int n = 0; n < nb.size(); n++) {
+        unsigned int j = nb[n];
+        if (!pIsRapdfCandidate(index, j))
+            continue;
+        long double en = pGetRapdfPair(index, j);
+        if (en != 0.0) {
+            row[j] = en;
+            rapdfPair[j][index] = en;
+            rapdfEnergy += en;
+        }
+    }
+}
+
+/**
+ *  Updates the C-beta contacts of a residue and the solvation terms of all
+ * residues whose number of contacts changed.
+ *@param index, residue index
+ */
+void EnergyCache::pUpdateSolvation(unsigned int index) {
+    const Residue& res = residue[index];
+    solvGrid.setPoint(index, res.hasCb ? res.cb : res.centre);
+    vector<unsigned int> nb, contact;
+    if (res.hasCb)
+        solvGrid.getNeighbors(index, SOLVATION_CUTOFF_DISTANCE, nb);
+    for (unsigned int n = 0; n < nb.size(); n++)
+        if (pIsSolvationContact(index, nb[n]))
+            contact.push_back(nb[n]);
+
+    // residues losing the moved one as neighbour, then those gaining it
+    vector<unsigned int> lost, gained;
+    set_difference(solvContact[index].begin(), solvContact[index].end(),
+            contact.begin(), contact.end(), back_inserter(lost));
+    set_difference(contact.begin(), contact.end(),
+            solvContact[index].begin(), solvContact[index].end(),
+            back_inserter(gained));
+    for (unsigned int n = 0; n < lost.size(); n++) {
+        vector<unsigned int>& other = solvContact[lost[n]];
+        other.erase(lower_bound(other.begin(), other.end(), index));
+    }
+    for (unsigned int n = 0; n < gained.size(); n++) {
+        vector<unsigned int>& other = solvContact[gained[n]];
+        other.insert(lower_bound(other.begin(), other.end(), index), index);
+    }
+    solvContact[index].swap(contact);
+
+    lost.insert(lost.end(), gained.begin(), gained.end());
+    lost.push_back(index);
+    for (unsigned int n = 0; n < lost.size(); n++) {
+        unsigned int i = lost[n];
+        long double term = pGetSolvation(i);
+        solvEnergy += term - solvTerm[i];
+        solvTerm[i] = term;
+    }
+}
+
+/**
+ *  Updates the torsion terms depending on the atoms of a residue: its own
+ * and those of its neighbours, whose angles or preceding angles include it.
+ *@param index, residue index
+ */
+void EnergyCache::pUpdateTorsion(unsigned int index) {
+    unsigned int start = (index >= 2) ? index - 2 : 0;
+    unsigned int end = min(index + 3, static_cast<unsigned int> (residue.size()));
+    for (unsigned int i = start; i < end; i++) {
+        long double term = pGetTorsion(i);
+        torsEnergy += term - torsTerm[i];
+        torsTerm[i] = term;
+    }
+}
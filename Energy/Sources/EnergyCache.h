@@ -0,0 +1,147 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ENERGYCACHE_H_
+#define _ENERGYCACHE_H_
+
+// Includes:
+#include <vector>
+#include <map>
+#include <Spacer.h>
+#include <NeighborGrid.h>
+#include <RapdfPotential.h>
+#include <SolvationPotential.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Energy {
+
+    class TorsionPotential;
+
+    /**
+     * @brief Keeps the energy of a Spacer up to date after single residue moves.
+     *
+     * The cache is attached to a Spacer and stores the contribution of every
+     * residue pair to the RAPDF potential, the C-beta contacts of the solvation
+     * potential and the per residue terms of a torsion potential (PhiPsi
+     * family). After the coordinates or the type of one residue change,
+     * update() recomputes only the terms involving that residue: its RAPDF
+     * row, the solvation terms of the residues gaining or losing it as
+     * neighbour and the torsion terms of the residues up to two positions
+     * away. The neighbours of the residue are found on grids of the residue
+     * centres and of the C-beta atoms, which are moved along with it, so an
+     * update costs time in the number of neighbours, not the chain length.
+     *
+     * Each potential is optional (NULL). Totals are kept as running sums,
+     * they agree with the full calculateEnergy() up to rounding; refresh()
+     * recomputes everything from scratch.
+     * Moves propagating along the chain, e.g. changing a backbone torsion
+     * angle, displace all following residues and need refresh() instead.
+     *
+     * */
+    class EnergyCache {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        EnergyCache(RapdfPotential* rapdf = NULL, SolvationPotential* solv = NULL,
+                TorsionPotential* tors = NULL);
+        virtual ~EnergyCache();
+
+        // PREDICATES:
+
+        bool isAttached() const {
+            return (sp != NULL);
+        }
+
+        Spacer& getSpacer();
+
+        long double getEnergy() const;
+
+        long double getRapdfEnergy() const {
+            return rapdfEnergy;
+        }
+
+        long double getSolvationEnergy() const {
+            return solvEnergy;
+        }
+
+        long double getTorsionEnergy() const {
+            return torsEnergy;
+        }
+
+        // MODIFIERS:
+        void setWeights(double rapdfWeight, double solvWeight, double torsWeight);
+
+        void attach(Spacer& sp);
+        void detach();
+        void update(unsigned int index);
+        void refresh();
+
+    protected:
+
+    private:
+
+        /**
+         * Copy of the data of one residue used by the potentials.
+         */
+        struct Residue {
+            AminoAcidCode code;
+            vector<vgVector3<double> > atom;
+            vector<unsigned int> type; // RAPDF atom types
+            vgVector3<double> centre; // sphere enclosing all atoms
+            double radius;
+            bool hasCb;
+            vgVector3<double> cb;
+        };
+
+        // HELPERS:
+        void pReadResidue(unsigned int i);
+        long double pGetRapdfPair(unsigned int i, unsigned int j) const;
+        bool pIsRapdfCandidate(unsigned int i, unsigned int j) const;
+        bool pIsSolvationContact(unsigned int i, unsigned int j) const;
+        long double pGetSolvation(unsigned int i) const;
+        long double pGetTorsion(unsigned int i) const;
+        void pBuildRapdf();
+        void pBuildSolvation();
+        void pUpdateRapdf(unsigned int index);
+        void pUpdateSolvation(unsigned int index);
+        void pUpdateTorsion(unsigned int index);
+
+        // ATTRIBUTES:
+        Spacer* sp;
+        RapdfPotential* rapdf;
+        SolvationPotential* solv;
+        TorsionPotential* tors;
+        double rapdfWeight, solvWeight, torsWeight;
+
+        vector<Residue> residue;
+        // RAPDF energy of residue pairs, by partner; zero pairs are not stored
+        vector<map<unsigned int, long double> > rapdfPair;
+        vector<vector<unsigned int> > solvContact; // sorted C-beta neighbours
+        vector<long double> solvTerm;
+        vector<long double> torsTerm;
+
+        NeighborGrid rapdfGrid; // residue centres
+        double maxRadius; // largest residue radius, not lowered by update()
+        NeighborGrid solvGrid; // C-beta atoms, centres of residues without one
+
+        long double rapdfEnergy;
+        long double solvEnergy;
+        long double torsEnergy;
+    };
+
+}} // namespace
+#endif //_ENERGYCACHE_H_
@@ -59,13 +59,19 @@ void EnergyFeatures::showFeatures() {
  *@return  quantity of hydrogen bonds (double)
  */
 double EnergyFeatures::calculateBackboneHydrogenBonds(Spacer& sp) {
+    const SpacerCoordinates& coords = sp.getCoordinates();
+    vector<unsigned int> n = pGetAtomIndexes(coords, N);
+    vector<unsigned int> ca = pGetAtomIndexes(coords, CA);
+    vector<unsigned int> c = pGetAtomIndexes(coords, C);
+    vector<unsigned int> o = pGetAtomIndexes(coords, O);
+
     double count = 0;
-    for (int i = 0; i < (int) sp.sizeAmino(); i++)
-        for (int j = 0; j < (int) sp.sizeAmino(); j++)
+    for (int i = 0; i < (int) coords.sizeResidue(); i++)
+        for (int j = 0; j < (int) coords.sizeResidue(); j++)
             if (fabs(i - j) > 1) {
-                double dist = sp.getAmino(i)[N].distance(sp.getAmino(j)[O]);
-                double dist2 = sp.getAmino(i)[N].distance(sp.getAmino(j)[C]);
-                double dist3 = sp.getAmino(i)[CA].distance(sp.getAmino(j)[O]);
+                double dist = coords.distance(n[i], o[j]);
+                double dist2 = coords.distance(n[i], c[j]);
+                double dist3 = coords.distance(ca[i], o[j]);
 
                 if ((dist <= 4.0) && (dist >= 2.0) && (dist < dist2)
                         && (dist < dist3)) {
@@ -178,19 +184,23 @@ vector<double> EnergyFeatures::calculateChainBreaks(Spacer& sp) {
     for (unsigned int i = 0; i < 5; i++)
         chain.push_back(0.0);
 
-    for (unsigned int i = 0; i < sp.sizeAmino() - 1; i++)
-        if (sp.getAmino(i).getAtom(CA).distance(sp.getAmino(i + 1).getAtom(CA)) > 4.5) {
-            if (sp.getAmino(i).getAtom(CA).distance(sp.getAmino(i + 1).getAtom(CA)) > 20.0)
+    const SpacerCoordinates& coords = sp.getCoordinates();
+    vector<unsigned int> ca = pGetAtomIndexes(coords, CA);
+    for (unsigned int i = 0; i + 1 < coords.sizeResidue(); i++) {
+        double d = coords.distance(ca[i], ca[i + 1]);
+        if (d > 4.5) {
+            if (d > 20.0)
                 chain[4]++;
-            else if (sp.getAmino(i).getAtom(CA).distance(sp.getAmino(i + 1).getAtom(CA)) > 15.0)
+            else if (d > 15.0)
                 chain[3]++;
-            else if (sp.getAmino(i).getAtom(CA).distance(sp.getAmino(i + 1).getAtom(CA)) > 10.0)
+            else if (d > 10.0)
                 chain[2]++;
-            else if (sp.getAmino(i).getAtom(CA).distance(sp.getAmino(i + 1).getAtom(CA)) > 7.5)
+            else if (d > 7.5)
                 chain[1]++;
             else
                 chain[0]++;
         }
+    }
     return chain;
 }
 
@@ -200,11 +210,12 @@ vector<double> EnergyFeatures::calculateChainBreaks(Spacer& sp) {
  *@return  double containing the corresponding value ( double)
  */
 double EnergyFeatures::calculateClashes(Spacer& sp) {
+    const SpacerCoordinates& coords = sp.getCoordinates();
+    vector<unsigned int> ca = pGetAtomIndexes(coords, CA);
     double clash = 0.0;
-    for (unsigned int i = 0; i < sp.sizeAmino() - 2; i++)
-        for (unsigned int j = i + 2; j < sp.sizeAmino(); j++) {
-            if (sp.getAmino(i).getAtom(CA).distance(sp.getAmino(j).getAtom(CA))
-                    < 2.75)
+    for (unsigned int i = 0; i + 2 < coords.sizeResidue(); i++)
+        for (unsigned int j = i + 2; j < coords.sizeResidue(); j++) {
+            if (coords.distance(ca[i], ca[j]) < 2.75)
                 clash++;
         }
     return clash;
@@ -248,3 +259,21 @@ vector<double> EnergyFeatures::calculateFeatures(Spacer& sp) {
 
 // HELPERS:
 
+/**
+ *  Collects the index of a given atom for every residue of the coordinate view
+ *@param reference of the coordinate view(SpacerCoordinates&), atom code(AtomCode)
+ *@return  vector of atom indexes, one per residue (vector unsigned int)
+ */
+vector<unsigned int> EnergyFeatures::pGetAtomIndexes(const SpacerCoordinates& coords,
+        AtomCode ac) {
+    vector<unsigned int> idx;
+    idx.reserve(coords.sizeResidue());
+    for (unsigned int i = 0; i < coords.sizeResidue(); i++) {
+        int tmp = coords.getAtomIndex(i, ac);
+        if (tmp < 0)
+            ERROR("Inexistent atom requested.", exception);
+        idx.push_back(static_cast<unsigned int> (tmp));
+    }
+    return idx;
+}
+
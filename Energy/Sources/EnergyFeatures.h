@@ -21,6 +21,7 @@
 // Includes:
 #include <vector>
 #include <Spacer.h>
+#include <SpacerCoordinates.h>
 #include <RapdfPotential.h>
 #include <SolvationPotential.h>
 #include <PhiPsi.h>
@@ -72,6 +73,8 @@ namespace Victor { namespace Energy {
     private:
 
         // HELPERS:
+        static vector<unsigned int> pGetAtomIndexes(const SpacerCoordinates& coords,
+                AtomCode ac);
 
         // ATTRIBUTES:
 
@@ -19,6 +19,10 @@
 #include <RapdfPotential.h>
 #include <AminoAcidCode.h>
 #include <Spacer.h>
+#include <SpacerCoordinates.h>
+#include <NeighborGrid.h>
+#include <Profiler.h>
+#include <algorithm>
 #include <cstring>
 
 using namespace Victor;
@@ -52,9 +56,10 @@ RapdfPotential::RapdfPotential() {
             string dummy;
             in >> dummy;
             for (unsigned int k = 0; k < MAX_TYPES; k++)
-                in >> prob[i][j][k];
+                in >> prob[j][k][i];
         }
     in.close();
+    pInitDistanceBins();
 }
 
 // PREDICATES:
@@ -65,19 +70,57 @@ RapdfPotential::RapdfPotential() {
  *@return energy value (long double)
  */
 long double RapdfPotential::calculateEnergy(Spacer& sp) {
+    PROFILE_REGION("RapdfPotential::calculateEnergy");
     long double en = 0.0;
-    unsigned int size = sp.sizeAmino();
-    for (unsigned int i = 0; i < size - 1; i++) {
-        AminoAcid& aa = sp.getAmino(i);
-        string aaType = aa.getType();
-        for (unsigned int ii = i + 1; ii < size; ii++) {
-            AminoAcid& aa2 = sp.getAmino(ii);
-            string aaType2 = aa2.getType();
-            for (unsigned int j = 0; j < aa.size(); j++)
-                for (unsigned int k = 0; k < aa2.size(); k++)
-                    en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
+    const SpacerCoordinates& coords = sp.getCoordinates();
+    unsigned int size = coords.sizeResidue();
+    vector<unsigned int> type;
+    pGetAtomTypes(sp, coords, type);
+
+    // residues as spheres around the centre of their atoms
+    vector<vgVector3<double> > centre(size, vgVector3<double>(0.0, 0.0, 0.0));
+    vector<double> radius(size, 0.0);
+    double maxRadius = 0.0;
+    for (unsigned int i = 0; i < size; i++) {
+        unsigned int start = coords.getResidueStart(i);
+        unsigned int end = coords.getResidueEnd(i);
+        for (unsigned int j = start; j < end; j++)
+            centre[i] += vgVector3<double>(coords.getX(j), coords.getY(j), coords.getZ(j));
+        if (end > start)
+            centre[i] /= static_cast<double> (end - start);
+        for (unsigned int j = start; j < end; j++)
+            radius[i] = max(radius[i], (vgVector3<double>(coords.getX(j),
+                coords.getY(j), coords.getZ(j)) - centre[i]).length());
+        maxRadius = max(maxRadius, radius[i]);
+    }
+
+    // only residues whose spheres are closer than the cutoff can contribute,
+    // the grid returns them in increasing order as the residue-pair loop
+    NeighborGrid grid(centre, RAPDF_CUTOFF + 2 * maxRadius);
+    vector<unsigned int> nb;
+    unsigned long pairs = 0;
+
+    for (unsigned int i = 0; i + 1 < size; i++) {
+        grid.getNeighbors(centre[i], RAPDF_CUTOFF + radius[i] + maxRadius, nb);
+        for (unsigned int n = 0; n < nb.size(); n++) {
+            unsigned int ii = nb[n];
+            if ((ii <= i) || ((centre[i] - centre[ii]).length()
+                    > RAPDF_CUTOFF + radius[i] + radius[ii] + RAPDF_TOLERANCE))
+                continue;
+
+            for (unsigned int j = coords.getResidueStart(i); j < coords.getResidueEnd(i); j++) {
+                if (type[j] >= MAX_TYPES)
+                    continue;
+                pairs += coords.getResidueEnd(ii) - coords.getResidueStart(ii);
+                for (unsigned int k = coords.getResidueStart(ii); k < coords.getResidueEnd(ii); k++) {
+                    unsigned int bin = pGetDistanceBinSquare(coords.squareDistance(j, k));
+                    if ((bin < MAX_BINS) && (type[k] < MAX_TYPES))
+                        en += prob[type[j]][type[k]][bin];
+                }
+            }
         }
     }
+    PROFILE_COUNT("atom pairs", pairs);
 
     return en;
 }
@@ -89,17 +132,16 @@ long double RapdfPotential::calculateEnergy(Spacer& sp) {
  */
 long double RapdfPotential::calculateEnergy(Spacer& sp, unsigned int index1, unsigned int index2) {
     long double en = 0.0;
-    for (unsigned int i = index1; i < index2; i++) {
-        AminoAcid& aa = sp.getAmino(i);
-        string aaType = aa.getType();
-        for (unsigned int ii = i + 1; ii < index2; ii++) {
-            AminoAcid& aa2 = sp.getAmino(ii);
-            string aaType2 = aa2.getType();
-            for (unsigned int j = 0; j < aa.size(); j++)
-                for (unsigned int k = 0; k < aa2.size(); k++)
-                    en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
-        }
-    }
+    const SpacerCoordinates& coords = sp.getCoordinates();
+    vector<unsigned int> type;
+    pGetAtomTypes(sp, coords, type);
+
+    for (unsigned int i = index1; i < index2; i++)
+        for (unsigned int ii = i + 1; ii < index2; ii++)
+            for (unsigned int j = coords.getResidueStart(i); j < coords.getResidueEnd(i); j++)
+                for (unsigned int k = coords.getResidueStart(ii); k < coords.getResidueEnd(ii); k++)
+                    en += pGetEnergy(type[j], type[k],
+                        pGetDistanceBinSquare(coords.squareDistance(j, k)));
     return en;
 }
 
@@ -110,15 +152,18 @@ long double RapdfPotential::calculateEnergy(Spacer& sp, unsigned int index1, uns
  */
 long double RapdfPotential::calculateEnergy(AminoAcid& aa, Spacer& sp) {
     long double en = 0.0;
-    string aaType = aa.getType();
+    vector<unsigned int> type;
+    vector<unsigned int> type2;
+    pGetAtomTypes(aa, type);
     for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
         AminoAcid& aa2 = sp.getAmino(i);
         if (aa == aa2) // exclude self-energy
             continue;
-        string aaType2 = aa2.getType();
+        pGetAtomTypes(aa2, type2);
         for (unsigned int j = 0; j < aa.size(); j++)
             for (unsigned int k = 0; k < aa2.size(); k++)
-                en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
+                en += pGetEnergy(type[j], type2[k],
+                    pGetDistanceBinOne(aa[j].distance(aa2[k])));
     }
     return en;
 }
@@ -132,11 +177,14 @@ long double RapdfPotential::calculateEnergy(AminoAcid& aa, AminoAcid& aa2) {
     if (aa == aa2) // exclude self-energy
         return 0.0;
     long double en = 0.0;
-    string aaType = aa.getType();
-    string aaType2 = aa2.getType();
+    vector<unsigned int> type;
+    vector<unsigned int> type2;
+    pGetAtomTypes(aa, type);
+    pGetAtomTypes(aa2, type2);
     for (unsigned int j = 0; j < aa.size(); j++)
         for (unsigned int k = 0; k < aa2.size(); k++)
-            en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
+            en += pGetEnergy(type[j], type2[k],
+                pGetDistanceBinOne(aa[j].distance(aa2[k])));
 
     return en;
 }
@@ -179,6 +227,71 @@ unsigned int RapdfPotential::pGetDistanceBinOne(double distance)
 
 /******************************************************************/
 
+/**
+ *  Fills the squared distance limits of the bins, so that
+ * pGetDistanceBinSquare(d * d) gives the same bin as pGetDistanceBinOne(d).
+ * A bin starts at the smallest squared distance whose square root reaches
+ * the start of the bin.
+ */
+void RapdfPotential::pInitDistanceBins() {
+    binStart[0] = 0.0;
+    for (unsigned int b = 1; b <= MAX_BINS; b++) {
+        double limit = b + 2.0;
+        double start = limit * limit;
+        while (sqrt(nextafter(start, 0.0)) >= limit)
+            start = nextafter(start, 0.0);
+        binStart[b] = start;
+    }
+
+    for (unsigned int d = 0; d < MAX_SQUARE_DISTANCE; d++) {
+        unsigned int bin = 0;
+        while ((bin + 1 < MAX_BINS) && (d >= binStart[bin + 1]))
+            bin++;
+        squareBin[d] = bin;
+    }
+}
+
+/******************************************************************/
+
+/**
+ *  Retrieves the group index of an atom, see pGetGroupBin().
+ *@param  atom reference (Atom&), amino acid type of the atom (string)
+ *@return corresponding index (unsigned int), 999 if the atom is not scored
+ */
+unsigned int RapdfPotential::pGetAtomType(Atom& at, const string& aaType) {
+    if ((at.getType() == "OXT") || ((at.getType() == "CB") && (aaType == "GLY")))
+        return 999;
+    string tmp = threeLetter2OneLetter(aaType) + at.getType();
+    return pGetGroupBin(tmp.c_str());
+}
+
+/**
+ *  Retrieves the group index of all atoms of an amino acid.
+ *@param  amino acid reference (AminoAcid&), vector of indexes to fill
+ */
+void RapdfPotential::pGetAtomTypes(AminoAcid& aa, vector<unsigned int>& type) {
+    string aaType = aa.getType();
+    type.resize(aa.size());
+    for (unsigned int j = 0; j < aa.size(); j++)
+        type[j] = pGetAtomType(aa[j], aaType);
+}
+
+/**
+ *  Retrieves the group index of all atoms of a coordinate view.
+ *@param  spacer reference (Spacer&), its coordinate view, vector of indexes to fill
+ */
+void RapdfPotential::pGetAtomTypes(Spacer& sp, const SpacerCoordinates& coords,
+        vector<unsigned int>& type) {
+    type.resize(coords.size());
+    for (unsigned int i = 0; i < coords.sizeResidue(); i++) {
+        string aaType = sp.getAmino(i).getType();
+        for (unsigned int j = coords.getResidueStart(i); j < coords.getResidueEnd(i); j++)
+            type[j] = pGetAtomType(coords.getAtom(j), aaType);
+    }
+}
+
+/******************************************************************/
+
 /**
  *  Retrieves the corresponding index for the given group(AAtype_AtomType)
  *@param  group name (char*)
@@ -20,10 +20,16 @@
 // Includes:
 #include <vector>
 #include <Potential.h>
+#include <SpacerCoordinates.h>
 
 // Global constants, typedefs, etc. (to avoid):
 const unsigned int MAX_BINS = 18;
 const unsigned int MAX_TYPES = 168;
+const unsigned int MAX_SQUARE_DISTANCE = 400; // square of the end of the last bin
+// pairs at or beyond this distance fall past the last bin and score zero
+const double RAPDF_CUTOFF = 20.0;
+// slack on residue distances, covers rounding in the sphere bounds
+const double RAPDF_TOLERANCE = 1.0e-6;
 
  namespace Victor { namespace Energy {
 
@@ -37,6 +43,7 @@ const unsigned int MAX_TYPES = 168;
      * 
      * */
     class RapdfPotential : public Potential {
+        friend class EnergyCache;
     public:
 
         // CONSTRUCTORS/DESTRUCTOR:
@@ -62,10 +69,23 @@ const unsigned int MAX_TYPES = 168;
 
         // HELPERS:
         unsigned int pGetDistanceBinOne(double distance);
+        unsigned int pGetDistanceBinSquare(double squareDistance) const;
         unsigned int pGetGroupBin(const char* group_name);
+        unsigned int pGetAtomType(Atom& at, const string& aaType);
+        void pGetAtomTypes(AminoAcid& aa, vector<unsigned int>& type);
+        void pGetAtomTypes(Spacer& sp, const SpacerCoordinates& coords,
+                vector<unsigned int>& type);
+        double pGetEnergy(unsigned int type1, unsigned int type2,
+                unsigned int bin) const;
+        void pInitDistanceBins();
 
         // ATTRIBUTES:
-        double prob[MAX_BINS][MAX_TYPES][MAX_TYPES];
+        // all bins of a pair of atom types are contiguous
+        double prob[MAX_TYPES][MAX_TYPES][MAX_BINS];
+        // smallest squared distance falling in each bin, last is end of last bin
+        double binStart[MAX_BINS + 1];
+        // bin of each integer squared distance
+        unsigned char squareBin[MAX_SQUARE_DISTANCE];
 
     public:
 
@@ -86,17 +106,39 @@ const unsigned int MAX_TYPES = 168;
     inline long double RapdfPotential::calculateEnergy(Atom& at1, Atom& at2, string aaType,
             string aaType2) {
         double d = at1.distance(at2);
-        if ((d >= 20.0) || (at1.getType() == "OXT") || (at2.getType() == "OXT")
-                || ((at1.getType() == "CB") && (aaType == "GLY"))
-                || ((at2.getType() == "CB") && (aaType2 == "GLY")))
+        if (d >= 20.0)
             return 0.0;
-        string tmp1 = threeLetter2OneLetter(aaType) + at1.getType();
-        string tmp2 = threeLetter2OneLetter(aaType2) + at2.getType();
-        unsigned int dist = pGetDistanceBinOne(d);
-        unsigned int grp1 = pGetGroupBin(tmp1.c_str());
-        unsigned int grp2 = pGetGroupBin(tmp2.c_str());
-        if (dist + grp1 + grp2 < 999)
-            return prob[dist][grp1][grp2];
+        return pGetEnergy(pGetAtomType(at1, aaType), pGetAtomType(at2, aaType2),
+                pGetDistanceBinOne(d));
+    }
+
+    // HELPERS:
+
+    /**
+     *  Retrieves the bin of a squared distance, same as pGetDistanceBinOne()
+     * on its square root.
+     *@param  squareDistance (double)
+     *@return corresponding index (unsigned int), 999 if beyond the last bin
+     */
+    inline unsigned int RapdfPotential::pGetDistanceBinSquare(double squareDistance) const {
+        if (squareDistance >= binStart[MAX_BINS])
+            return 999;
+        unsigned int bin = squareBin[static_cast<unsigned int> (squareDistance)];
+        // at most one bin starts between two integers
+        if (squareDistance >= binStart[bin + 1])
+            bin++;
+        return bin;
+    }
+
+    /**
+     *  Energy of a pair of atom types at a given distance bin.
+     *@param  atom types, see pGetAtomType(), and distance bin (unsigned int)
+     *@return energy value, 0 for unknown types or bins (double)
+     */
+    inline double RapdfPotential::pGetEnergy(unsigned int type1, unsigned int type2,
+            unsigned int bin) const {
+        if ((type1 < MAX_TYPES) && (type2 < MAX_TYPES) && (bin < MAX_BINS))
+            return prob[type1][type2][bin];
         else // ignore errors
             return 0;
     }
@@ -18,6 +18,8 @@
 // Includes:
 #include <float.h>
 #include <SolvationPotential.h>
+#include <SpacerCoordinates.h>
+#include <NeighborGrid.h>
 
 using namespace Victor;
 
@@ -85,9 +87,38 @@ SolvationPotential::SolvationPotential(unsigned int _resol) : sum(), binResoluti
  *@return    value of the total solvation potential(long double)
  */
 long double SolvationPotential::calculateSolvation(Spacer& sp) {
+    const SpacerCoordinates& coords = sp.getCoordinates();
+    unsigned int size = coords.sizeResidue();
+    vector<int> cb; // CB atom index of each residue
+    vector<unsigned int> cbAtom; // the same, for residues having a CB only
+    vector<vgVector3<double> > cbCoords;
+    cb.reserve(size);
+    for (unsigned int i = 0; i < size; i++) {
+        cb.push_back(coords.getAtomIndex(i, CB));
+        if (cb[i] >= 0) {
+            cbAtom.push_back(cb[i]);
+            cbCoords.push_back(vgVector3<double>(coords.getX(cb[i]),
+                    coords.getY(cb[i]), coords.getZ(cb[i])));
+        }
+    }
+    NeighborGrid grid(cbCoords, SOLVATION_CUTOFF_DISTANCE);
+    vector<unsigned int> nb;
+
     long double solv = 0.0;
-    for (unsigned int i = 0; i < sp.sizeAmino(); i++)
-        solv += calculateSolvation(sp.getAmino(i), sp);
+    for (unsigned int i = 0; i < size; i++) {
+        if ((coords.getResidueType(i) == GLY) || (cb[i] < 0))
+            continue;
+        unsigned int count = 0;
+        grid.getNeighbors(vgVector3<double>(coords.getX(cb[i]),
+                coords.getY(cb[i]), coords.getZ(cb[i])),
+                SOLVATION_CUTOFF_DISTANCE, nb);
+        for (unsigned int n = 0; n < nb.size(); n++) {
+            double d = coords.distance(cb[i], cbAtom[nb[n]]);
+            if ((d <= SOLVATION_CUTOFF_DISTANCE) && (d > 0.0)) // check not identical
+                count++;
+        }
+        solv += pGetSolvation(coords.getResidueType(i), count);
+    }
     return solv;
 }
 
@@ -123,15 +154,7 @@ long double SolvationPotential::calculateSolvation(AminoAcid& aa, Spacer& sp, un
                     sp.getAmino(j).getSideChain()[CB]) > 0.0)) // check not identical
                 count++;
     }
-    // adapt to binResolution:
-    count /= binResolution;
-    if (count >= (MAX_BINS / binResolution))
-        count = (MAX_BINS / binResolution) - 1;
-    long double a = static_cast<long double> (sum[aa.getCode()][count] + 1) /
-            static_cast<long double> (sum[aa.getCode()][MAX_BINS / binResolution]);
-    long double b = static_cast<long double> (sum[sum.size() - 1][count] + 1) /
-            static_cast<long double> (sum[sum.size() - 1][MAX_BINS / binResolution]);
-    return -propCoeff() * log(a / b);
+    return pGetSolvation(aa.getCode(), count);
 }
 
 /**
@@ -176,6 +199,23 @@ long double SolvationPotential::calculateSolvation(AminoAcid& resid, AminoAcidCo
     return -propCoeff() * log(caf / ctf);
 }
 
+/**
+ *     solvation energy of a residue type given its number of CB neighbours.
+ *@param  amino acid type (unsigned int), number of CB atoms within SOLVATION_CUTOFF_DISTANCE (unsigned int)
+ *@return  value of the solvation potential(long double)
+ */
+long double SolvationPotential::pGetSolvation(unsigned int type, unsigned int count) const {
+    // adapt to binResolution:
+    count /= binResolution;
+    if (count >= (MAX_BINS / binResolution))
+        count = (MAX_BINS / binResolution) - 1;
+    long double a = static_cast<long double> (sum[type][count] + 1) /
+            static_cast<long double> (sum[type][MAX_BINS / binResolution]);
+    long double b = static_cast<long double> (sum[sum.size() - 1][count] + 1) /
+            static_cast<long double> (sum[sum.size() - 1][MAX_BINS / binResolution]);
+    return -propCoeff() * log(a / b);
+}
+
 /**
  *     obtains the propensity value
  *@param  amino acid type (AminoAcidCode), count (unsigned int)
@@ -42,6 +42,7 @@ namespace Victor { namespace Energy {
      *   were chosen for each number i of surrounding Cβ atoms (i = 0,..., 40). The energy for a given structure is calculated by summing the individual energies over all residues in the protein.
     */
     class SolvationPotential : public Potential {
+        friend class EnergyCache;
     public:
 
         // CONSTRUCTORS/DESTRUCTOR:
@@ -90,6 +91,7 @@ namespace Victor { namespace Energy {
     private:
 
         // PREDICATES
+        long double pGetSolvation(unsigned int type, unsigned int count) const;
         long double pGetPropensity(const AminoAcidCode type,
                 unsigned int count) const;
         long double pGetMaxPropensity(const AminoAcidCode type) const;
@@ -11,6 +11,7 @@
 
 #include <TestRapdfPotential.h>
 #include <TestSolvationPotential.h>
+#include <TestEnergyCache.h>
 using namespace std;
 using namespace Victor;
 using namespace Victor::Biopool;
@@ -22,6 +23,7 @@ int main() {
 	cout << "Creating Test Suites for Energy:" << endl;
         runner.addTest(TestRapdfPotential::suite());
         runner.addTest(TestSolvationPotential::suite());
+        runner.addTest(TestEnergyCache::suite());
 	cout<< "Running the unit tests."<<endl;
 	runner.run();
 
@@ -0,0 +1,133 @@
+/*
+ * TestEnergyCache.h
+ *
+ *  Checks the incremental energies against a full evaluation.
+ */
+
+#include <iostream>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <PdbLoader.h>
+#include <Protein.h>
+#include <RapdfPotential.h>
+#include <SolvationPotential.h>
+#include <EnergyCache.h>
+#include <PhiPsi.h>
+
+using namespace std;
+using namespace Victor;
+using namespace Victor::Biopool;
+using namespace Victor::Energy;
+
+class TestEnergyCache : public CppUnit::TestFixture {
+private:
+        string path;
+public:
+	TestEnergyCache() : path(getenv("VICTOR_ROOT")) {}
+	virtual ~TestEnergyCache() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestEnergyCache");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestEnergyCache>("Test1 - energy after attaching.",
+				&TestEnergyCache::testEnergyCache_attach ));
+
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestEnergyCache>("Test2 - energy after moving residues.",
+				&TestEnergyCache::testEnergyCache_update ));
+
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestEnergyCache>("Test3 - torsion energy after moving residues.",
+				&TestEnergyCache::testEnergyCache_torsion ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+
+	void testEnergyCache_attach() {
+                Protein prot;
+                Spacer& sp = loadSpacer(prot);
+                RapdfPotential rapdf;
+                SolvationPotential solv;
+                EnergyCache cache(&rapdf, &solv);
+                cache.attach(sp);
+
+		CPPUNIT_ASSERT( isClose(cache.getRapdfEnergy(), rapdf.calculateEnergy(sp)) );
+		CPPUNIT_ASSERT( isClose(cache.getSolvationEnergy(), solv.calculateEnergy(sp)) );
+		CPPUNIT_ASSERT( cache.getTorsionEnergy() == 0.0 );
+
+                cache.setWeights(2.5, 500.0, 350.0);
+		CPPUNIT_ASSERT( isClose(cache.getEnergy(), 2.5 * rapdf.calculateEnergy(sp)
+                        + 500.0 * solv.calculateEnergy(sp)) );
+	}
+
+	void testEnergyCache_update() {
+                Protein prot;
+                Spacer& sp = loadSpacer(prot);
+                RapdfPotential rapdf;
+                SolvationPotential solv;
+                EnergyCache cache(&rapdf, &solv);
+                cache.attach(sp);
+
+                // shifts large enough to change contacts and distance bins
+                for (unsigned int i = 0; i < sp.sizeAmino(); i += 3) {
+                    AminoAcid& aa = sp.getAmino(i);
+                    vgVector3<double> shift(2.5, -1.5, 4.0 * ((i % 2 == 0) ? 1 : -1));
+                    for (unsigned int j = 0; j < aa.size(); j++)
+                        aa[j].setCoords(aa[j].getCoords() + shift);
+                    cache.update(i);
+
+                    CPPUNIT_ASSERT( isClose(cache.getRapdfEnergy(), rapdf.calculateEnergy(sp)) );
+                    CPPUNIT_ASSERT( isClose(cache.getSolvationEnergy(), solv.calculateEnergy(sp)) );
+                }
+	}
+
+	void testEnergyCache_torsion() {
+                Protein prot;
+                Spacer& sp = loadSpacer(prot);
+                PhiPsi tors;
+                EnergyCache cache(NULL, NULL, &tors);
+                cache.attach(sp);
+		CPPUNIT_ASSERT( isClose(cache.getTorsionEnergy(), tors.calculateEnergy(sp)) );
+
+                // a residue moved on its own changes the angles of its neighbours,
+                // the first and the last residue included
+                unsigned int last = sp.sizeAmino() - 1;
+                for (unsigned int i = 0; i <= last; i += ((i + 7 < last) ? 7 : 1)) {
+                    AminoAcid& aa = sp.getAmino(i);
+                    vgVector3<double> shift(0.4, -0.3, 0.5 * ((i % 2 == 0) ? 1 : -1));
+                    for (unsigned int j = 0; j < aa.size(); j++)
+                        aa[j].setCoords(aa[j].getCoords() + shift);
+                    cache.update(i);
+
+                    CPPUNIT_ASSERT( isClose(cache.getTorsionEnergy(), tors.calculateEnergy(sp)) );
+                    CPPUNIT_ASSERT( cache.getRapdfEnergy() == 0.0 );
+                }
+	}
+
+        Spacer& loadSpacer(Protein& prot) {
+                string p = path + "Biopool/Tests/data/3DFR.pdb";
+                ifstream inFile(p.c_str());
+                if (!inFile)
+                  ERROR("File not found.", exception);
+                PdbLoader pl(inFile);
+                pl.setNoHAtoms();
+                pl.setNoVerbose();
+                prot.load(pl);
+                return *prot.getSpacer('A');
+        }
+
+        bool isClose(long double a, long double b) {
+                return fabsl(a - b) <= 1.0e-9 * (1.0 + fabsl(b));
+        }
+
+};
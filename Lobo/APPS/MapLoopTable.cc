@@ -0,0 +1,70 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @Description This program converts a table of protein entries for the Lobo
+ * algorithm into the mapped format, which LoopModel loads without decoding.
+ */
+#include <string>
+#include <GetArg.h>
+#include <LoopTable.h>
+using namespace Victor;
+using namespace Victor::Lobo;
+
+int main(int nArgs, char* argv[]) {
+    if (getArg("h", nArgs, argv)) {
+        cout << "This program converts tables of protein entries for the Lobo "
+            << "algorithm into the mapped format.\n"
+            << "Usage: \n"
+            << " MapLoopTable -I<src> [-O<file>] [-v] [-h] \n"
+            << "\t -I<file> \t Name of input file.\n"
+            << "\t -O<file> \t Name of the output file (default: input file + \"m\",\n"
+            << "\t          \t where lobo looks for it).\n"
+            << "\t -v \t\t Verbose.\n"
+            << "\t -h \t\t Display this help.\n"
+            << endl;
+        return 1;
+    }
+
+    bool verbose = getArg("v", nArgs, argv);
+
+    string inputFile, outputFile;
+    getArg("I", inputFile, nArgs, argv, "!");
+    getArg("O", outputFile, nArgs, argv, "!");
+
+    if (inputFile == "!") {
+        cout << "Missing file specification. Aborting. (-h for help)" << endl;
+        return -1;
+    }
+    if (outputFile == "!")
+        outputFile = LoopTable::getMappedFileName(inputFile);
+
+    if (verbose)
+        cout << "Verify: \n" << " Input from: " << inputFile << "\n"
+            << "Output to: " << outputFile << endl;
+
+    LoopTable lt;
+    lt.read(inputFile);
+
+    // store the entries as LoopModel uses them
+    lt.rotateIntoXYPlane();
+
+    lt.writeMapped(outputFile);
+
+    if (verbose)
+        cout << lt.size() << " entries written." << endl;
+
+    return 0;
+}
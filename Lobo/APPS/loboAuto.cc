@@ -54,7 +54,7 @@ int main(int nArgs, char* argv[]) {
 
     string inputFile, outputFile, sequenceFile, scwrlFile, scatterFile,
             tableFile, chainID;
-    unsigned int pdbIndex1, pdbIndex2, pdbLength, num, num2, maxWrite;
+    unsigned int pdbIndex1, pdbIndex2, pdbLength, num, num2, maxWrite, threads;
 
     getArg("i", inputFile, nArgs, argv, "!");
     getArg("c", chainID, nArgs, argv, "!");
@@ -65,6 +65,7 @@ int main(int nArgs, char* argv[]) {
     getArg("l", pdbLength, nArgs, argv, 0);
     getArg("-sol1", num, nArgs, argv, 60);
     getArg("-sol2", num2, nArgs, argv, 1);
+    getArg("-threads", threads, nArgs, argv, 1);
     getArg("-maxWrite", maxWrite, nArgs, argv, 9999);
     getArg("-scatter", scatterFile, nArgs, argv, "!");
     getArg("-table", tableFile, nArgs, argv, "!");
@@ -90,6 +91,7 @@ int main(int nArgs, char* argv[]) {
         lm.setTableFileName(tableFile);
 
     lm.setVerbose(2);
+    lm.setThreads(threads);
 
     double tmpEW = lm.getENDRMS_WEIGHT();
     getOption(tmpEW, "-endrmsWeigth", nArgs, argv);
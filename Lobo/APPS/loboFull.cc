@@ -42,13 +42,14 @@ int main(int nArgs, char* argv[]) {
 
     string inputFile, outputFile, scwrlFile, scatterFile, tableFile, chainID;
     vector<char> allCh;
-    unsigned int windowSize, num, num2, maxWrite;
+    unsigned int windowSize, num, num2, maxWrite, threads;
     getArg("i", inputFile, nArgs, argv, "!");
     getArg("o", outputFile, nArgs, argv, "null");
     getArg("s", windowSize, nArgs, argv, 5);
     windowSize++; // compensate counting scheme of LoopModel
     getArg("-sol1", num, nArgs, argv, LoopModel::MAX_ITER_SOL);
     getArg("-sol2", num2, nArgs, argv, 1);
+    getArg("-threads", threads, nArgs, argv, 1);
     getArg("c", chainID, nArgs, argv, " ");
     getArg("-scwrl", scwrlFile, nArgs, argv, "null");
     getArg("-scatter", scatterFile, nArgs, argv, "!");
@@ -72,6 +73,7 @@ int main(int nArgs, char* argv[]) {
         lm.setTableFileName(tableFile);
 
     lm.setVerbose(2);
+    lm.setThreads(threads);
 
     double tmpEW = lm.getENDRMS_WEIGHT();
 
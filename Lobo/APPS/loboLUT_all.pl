@@ -151,12 +151,14 @@ sub createLUT
     {
 	print "Creating LUT aa2.lt\n";
 	print `$root/loboLUT -A 1 -B 1 -O aa2.lt $LUTopt`;
+	mapLUT(2);
     }
     
     if (($max >= 3) && (askWriteLUT(3))) 
     {
 	print "Creating LUT aa3.lt\n";
 	print `$root/loboLUT -A aa2.lt -B 1 -O aa3.lt $LUTopt`;
+	mapLUT(3);
     }
     
     for ($j = $#list; $j >= 0; $j--)
@@ -168,10 +170,17 @@ sub createLUT
 	    $en = int ($i / 2);
 	    print "Creating LUT aa$i.lt from aa$st.lt and aa$en.lt\n";
 	    print `$root/loboLUT -A aa$st.lt -B aa$en.lt -O aa$i.lt $LUTopt`;
+	    mapLUT($i);
 	}
     }
 }
 
+sub mapLUT($$)
+{
+    # mapped copy of the LUT, loaded by lobo without decoding
+    print `$root/MapLoopTable -I $LUTpath/aa@_.lt`;
+}
+
 sub askWriteLUT($$)
 {
     if (defined($overwrite) || !(-s "$LUTpath/aa@_.lt"))
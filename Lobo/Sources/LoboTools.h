@@ -54,6 +54,8 @@ inline void showCommonOptions() {
             << "\t[--scwrl <filename>] \t Sequence output file for SCWRL (-s option)\n"
             << "\t[--table <name>] \t Path and basename of LUT files (default = "
             << getenv("VICTOR_ROOT") + path << ") \n"
+            << "\t[--threads <n>] \t Number of threads closing the loops"
+            << " (default = 1)\n"
             << "\t[--withOxygen] \t\t Include Oxygen atoms in RMSD calculation\n"
             << "\t[--verbose] \t\t Verbose mode\n"
             << "\t[--silent] \t\t Silent mode\n";
@@ -78,8 +80,8 @@ inline void showSpecialOptions() {
             << " (default= " << LoopModel::PACKING_WEIGTH << ")\n"
             << "\t[--weigthEP] \t\t Choose weigthing of EP compared to ED & EN"
             << " (default= " << LoopTableEntry::LAMBDA_EP << ")\n"
-            << "\t[--maxSearch] \t\t Choose max fraction of tables to search "
-            << "for best result (default= " << LoopTable::MAX_FACTOR << ")\n"
+            << "\t[--maxSearch] \t\t Unused, tables are searched through "
+            << "their index (default= " << LoopTable::MAX_FACTOR << ")\n"
             << "\t[--vdwLimit] \t\t Choose threshold for VDW filter"
             << " (default= " << LoopModel::VDW_LIMIT << ")\n"
             << "\t[--energyLimit] \t Choose threshold for energy filter"
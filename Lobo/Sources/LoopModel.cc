@@ -58,11 +58,27 @@ static double sDistance(vgVector3<double> xv, vgVector3<double> yv) {
     return sqrt(sqr(xv.x - yv.x) + sqr(xv.y - yv.y) + sqr(xv.z - yv.z));
 }
 
+/**
+ * Seed of the random numbers used by one ring closure task, mixing the
+ * task number into the base seed so that neighbouring tasks get unrelated
+ * sequences.
+ * @param base
+ * @param task
+ * @return 
+ */
+static unsigned int sTaskSeed(unsigned int base, unsigned int task) {
+    unsigned int x = base ^ (task * 2654435761u);
+    x ^= x >> 16;
+    x *= 0x45d9f3bu;
+    x ^= x >> 16;
+    return x;
+}
+
 
 // CONSTRUCTORS/DESTRUCTOR:
 
 LoopModel::LoopModel() : pInter(false),
-pPlot(false), pVerbose(0), pScatter(&cout), table(), solution() {
+pPlot(false), pVerbose(0), pThreads(1), pScatter(&cout), table(), solution() {
     string tableFile = getenv("VICTOR_ROOT");
     if (tableFile.length() < 3)
         ERROR("Environment variable VICTOR_ROOT was not found.", exception);
@@ -107,10 +123,12 @@ LoopModel::vdwValues(Spacer& sp, unsigned int index1, unsigned int index2,
         vector<Spacer>& solVec) {
     vector<int> ret_vector;
     int count = 0; // contains the total vdw_forces of a loop (put into vector
+    NeighborGrid caGrid;
+    pBuildCaGrid(sp, caGrid);
 
     for (unsigned int loop = 0; loop < solVec.size(); loop++) {
         count = loop_loop_vdw(solVec[loop], index1 + 1);
-        count += loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp);
+        count += loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp, caGrid);
 
         ret_vector.push_back(count);
     }
@@ -130,11 +148,14 @@ vector<int>
 LoopModel::consistencyValues(Spacer& sp, unsigned int index1,
         unsigned int index2, vector<Spacer>& solVec) {
     vector<int> ret_vector;
+    NeighborGrid caGrid;
+    pBuildCaGrid(sp, caGrid);
     for (unsigned int loop = 0; loop < solVec.size(); loop++)
         ret_vector.push_back(calculateConsistency(sp, index1, index2,
             solVec[loop])
             + 100 * loop_loop_vdw(solVec[loop], index1 + 1)
-            + 100 * loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp)
+            + 100 * loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp,
+            caGrid)
             );
     return ret_vector;
 }
@@ -708,12 +729,14 @@ LoopModel::rankRawScore(Spacer& sp, unsigned int index1, unsigned int index2,
 
     //******  
     vector<double> tmpScore;
+    NeighborGrid caGrid;
+    pBuildCaGrid(sp, caGrid);
     for (unsigned int i = 0; i < solVec.size(); i++) {
         solutionQueueElem sqe;
         sqe.dev = calculateConsistency(sp, index1, index2, solVec[i])
                 + 100 * loop_loop_vdw(solVec[i], index1 + 1)
                 + 100 * loop_spacer_vdw(solVec[i], index1 + 1,
-                index2 + 1, sp);
+                index2 + 1, sp, caGrid);
 
         sqe.index1 = i;
         solutionQueue.push(sqe);
@@ -1375,6 +1398,7 @@ LoopModel::copy(const LoopModel& orig) {
     pInter = orig.pInter;
     pVerbose = orig.pVerbose;
     pPlot = orig.pPlot;
+    pThreads = orig.pThreads;
     //    pScatter = const_cast<ostream&>(orig.pScatter);
 
     //  deep copy of: table = orig.table;
@@ -1608,13 +1632,15 @@ LoopModel::convertCoords(AminoAcid start, vgVector3<float> startN,
  * @param vt
  * @param partialSolution
  * @param currentSelection
+ * @param seed of the random bond angle deviations, NULL to use rand()
  * @return 
  */
 bool
 LoopModel::ringClosure(const LoopTableEntry& source,
         const LoopTableEntry& destination, unsigned int nStart,
         unsigned int nAminoAcids, double offsetPhi, VectorTransformation vt,
-        vector<vgVector3<float> >& partialSolution, unsigned int currentSelection) {
+        vector<vgVector3<float> >& partialSolution, unsigned int currentSelection,
+        unsigned int* seed) {
     PRECOND(((nAminoAcids > 0) && (nAminoAcids <= MAX_CHAIN_LENGTH)), exception);
 
     LoopTableEntry tmpSrc = source;
@@ -1623,7 +1649,7 @@ LoopModel::ringClosure(const LoopTableEntry& source,
     vgVector3<float> refNull(0, 0, 0);
 
     if (tmpSrc.endDirection != refNull)
-        tmpEnd = tmpSrc.setToOrigin(tmpEnd, nStart, vt);
+        tmpEnd = tmpSrc.setToOrigin(tmpEnd, nStart, vt, seed);
 
     // rotate the destination back into the X,Y plane relative to the origin:
     vg_ieee64 phi = -(tmpEnd.rotateIntoXYPlane(vt));
@@ -1671,11 +1697,27 @@ LoopModel::ringClosure(const LoopTableEntry& source,
 
     // ... & conquer:
     return ( ringClosure(origin, newMiddle, 1, midAminoAcids, offsetPhi + phi, vt,
-            partialSolution)
+            partialSolution, 1, seed)
             * ringClosure(newMiddle, tmpEnd, midAminoAcids + 1,
-            (nAminoAcids / 2), 0, vt, partialSolution));
+            (nAminoAcids / 2), 0, vt, partialSolution, 1, seed));
 }
 
+/**
+ * Generates loops between source and destination: takes the num closest
+ * middle points from the table and closes both halves of the loop through
+ * each of them, depth times. The closures run on getThreads() threads;
+ * the solutions are appended in the same order whatever their number.
+ * @param source
+ * @param destination
+ * @param nStart
+ * @param nAminoAcids
+ * @param offsetPhi
+ * @param vt
+ * @param num
+ * @param depth
+ * @param partialSolution
+ * @return 
+ */
 bool
 LoopModel::ringClosureBase(const LoopTableEntry& source,
         const LoopTableEntry& destination, unsigned int nStart,
@@ -1722,35 +1764,102 @@ LoopModel::ringClosureBase(const LoopTableEntry& source,
     }
 
     // divide ...
-    int midAminoAcids = (nAminoAcids / 2) + (nAminoAcids % 2); // eg. 5 = 3 + 2
-
     INVARIANT((nAminoAcids < table.size()) && (table[nAminoAcids] != NULL),
             exception);
 
     vector <LoopTableEntry> middle;
     middle = table[nAminoAcids]->getNClosest(tmpEnd, num, nAminoAcids);
 
-    // define the origin:
-    LoopTableEntry origin;
-    origin.endDirection = refNull;
-
     for (unsigned int i = 0; i < middle.size(); i++) {
         middle[i].endPoint = middle[i].midPoint;
         middle[i].endDirection = middle[i].midDirection;
         middle[i].endNormal = middle[i].midNormal;
+    }
 
-        // ... & conquer:
-
-        for (unsigned int j = 0; j < depth; j++) {
-            ringClosure(origin, middle[i], 1, midAminoAcids, offsetPhi + phi,
-                    vt, partialSolution, j);
-            ringClosure(middle[i], tmpEnd, midAminoAcids + 1, (nAminoAcids / 2),
-                    0, vt, partialSolution, j);
-        }
+    // ... & conquer, one task per middle candidate and selection:
+    RingClosureJob job;
+    job.model = this;
+    job.middle = &middle;
+    job.end = &tmpEnd;
+    job.vt = &vt;
+    job.offsetPhi = offsetPhi + phi;
+    job.nAminoAcids = nAminoAcids;
+    job.depth = depth;
+    job.seed = rand();
+    job.result.resize(middle.size() * depth);
+    job.next = 0;
+
+    unsigned int nThreads = (pThreads < job.result.size()) ? pThreads
+            : job.result.size();
+    if (nThreads <= 1)
+        for (unsigned int t = 0; t < job.result.size(); t++)
+            pRingClosureTask(job, t);
+    else {
+        pthread_mutex_init(&job.lock, NULL);
+        vector<pthread_t> pool(nThreads);
+        for (unsigned int t = 0; t < nThreads; t++)
+            if (pthread_create(&pool[t], NULL, pRingClosureWorker, &job) != 0)
+                ERROR("Could not create thread.", exception);
+        for (unsigned int t = 0; t < nThreads; t++)
+            pthread_join(pool[t], NULL);
+        pthread_mutex_destroy(&job.lock);
     }
+
+    // merge in task order, independent of the number of threads:
+    for (unsigned int t = 0; t < job.result.size(); t++)
+        partialSolution.insert(partialSolution.end(), job.result[t].begin(),
+            job.result[t].end());
     return 0;
 }
 
+/**
+ * Entry point of the threads of ringClosureBase(): takes the next task
+ * until all are handed out.
+ * @param job
+ * @return 
+ */
+void*
+LoopModel::pRingClosureWorker(void* job) {
+    RingClosureJob& rcj = *static_cast<RingClosureJob*> (job);
+    while (true) {
+        pthread_mutex_lock(&rcj.lock);
+        unsigned int t = rcj.next;
+        if (rcj.next < rcj.result.size())
+            rcj.next++;
+        pthread_mutex_unlock(&rcj.lock);
+        if (t >= rcj.result.size())
+            break;
+        rcj.model->pRingClosureTask(rcj, t);
+    }
+    return NULL;
+}
+
+/**
+ * Closes the loop through one middle candidate of ringClosureBase(),
+ * storing the coordinates of both halves in job.result[task]. The
+ * random bond angle deviations are drawn from a seed of the task, so
+ * that the result does not depend on the order the tasks are run in.
+ * Only reads the tables, which have to be loaded and indexed already.
+ * @param job
+ * @param task
+ */
+void
+LoopModel::pRingClosureTask(RingClosureJob& job, unsigned int task) {
+    unsigned int i = task / job.depth;
+    unsigned int j = task % job.depth;
+    unsigned int seed = sTaskSeed(job.seed, task);
+    unsigned int midAminoAcids = (job.nAminoAcids / 2) + (job.nAminoAcids % 2);
+
+    // define the origin:
+    LoopTableEntry origin;
+    origin.endDirection = vgVector3<float>(0, 0, 0);
+
+    ringClosure(origin, (*job.middle)[i], 1, midAminoAcids, job.offsetPhi,
+            *job.vt, job.result[task], j, &seed);
+    ringClosure((*job.middle)[i], *job.end, midAminoAcids + 1,
+            (job.nAminoAcids / 2), 0, *job.vt, job.result[task], j, &seed);
+}
+
 
 // -*- C++ -*-----------------------------------------------------------------
 //
@@ -1826,7 +1935,9 @@ LoopModel::calculateLoop(const vgVector3<float>& startN, unsigned int length,
 
 
 /**
- * Load tables which are really used.
+ * Load tables which are really used. The mapped version of a table
+ * (see LoopTable::readMapped()) is used instead of the .lt file if present.
+ * The tables are indexed for the closest entry searches.
  * @param nAmino
  */
 void
@@ -1855,13 +1966,18 @@ LoopModel::loadTables(unsigned int nAmino) {
             if (pVerbose)
                 cout << "--> " << index[i] << "\n";
 
+            // prefer the mapped version of the table, if there is one
             LoopTable* lt = new LoopTable;
-            lt->read(tableFileName[index[i]]);
-
-            VectorTransformation vt;
+            string mappedName = LoopTable::getMappedFileName(tableFileName[index[i]]);
+            if (ifstream(mappedName.c_str()))
+                lt->readMapped(mappedName);
+            else
+                lt->read(tableFileName[index[i]]);
 
-            for (unsigned int j = 0; j < lt->size(); j++)
-                (*lt)[j].rotateIntoXYPlane(vt);
+            if (!lt->isRotated())
+                lt->rotateIntoXYPlane();
+            if (!lt->isIndexed())
+                lt->buildIndex();
 
             table[index[i]] = lt;
         }
@@ -1927,18 +2043,43 @@ int LoopModel::loop_loop_vdw(Spacer& sp, unsigned int index1) {
  */
 int LoopModel::loop_spacer_vdw(Spacer& loop, unsigned int index1,
         unsigned int index2, Spacer& proteine) {
+    NeighborGrid caGrid;
+    pBuildCaGrid(proteine, caGrid);
+    return loop_spacer_vdw(loop, index1, index2, proteine, caGrid);
+}
+
+/**
+ * Same as above, using a grid of the CA atoms of the proteine built by
+ * pBuildCaGrid(). Only the amino acids of the proteine found near the
+ * loop on the grid are checked. The grid can be reused for all loops
+ * modelled on the same proteine.
+ * 
+ * @param loop
+ * @param index1
+ * @param index2
+ * @param proteine
+ * @param caGrid
+ * @return 
+ */
+int LoopModel::loop_spacer_vdw(Spacer& loop, unsigned int index1,
+        unsigned int index2, Spacer& proteine, const NeighborGrid& caGrid) {
     int ret_value = 0; // used to store the resulting vdw-forces
     const double CHECK_THRESHOLD = 6.0;
     // all amino acids with a distance lower than that are checked
+    vector<unsigned int> nb;
 
-    for (unsigned int i = 0; i < proteine.size(); i++) {
-        if (i + 2 > index1 && i < index2 + 1)
-            // we are currently in the loop section of the proteine
-            continue; // or at the edge of the proteine to the loop
+    for (unsigned int j = 0; j < loop.size(); j++) {
+        vgVector3<double> loopCA = loop.getAmino(j)[CA].getCoords();
+        caGrid.getNeighbors(loopCA, CHECK_THRESHOLD, nb);
+
+        for (unsigned int n = 0; n < nb.size(); n++) {
+            unsigned int i = nb[n];
+            if (i + 2 > index1 && i < index2 + 1)
+                // we are currently in the loop section of the proteine
+                continue; // or at the edge of the proteine to the loop
 
-        for (unsigned int j = 0; j < loop.size(); j++) {
             double dist = sDistance(proteine.getAmino(i)[CA].getCoords(),
-                    loop.getAmino(j)[CA].getCoords());
+                    loopCA);
             if (dist <= CHECK_THRESHOLD)
                 ret_value += amino_amino_collision(proteine.getAmino(i),
                     loop.getAmino(j), i + 1, index1 + j + 1, 2.0);
@@ -1947,6 +2088,22 @@ int LoopModel::loop_spacer_vdw(Spacer& loop, unsigned int index1,
     return ret_value;
 }
 
+/**
+ * Puts the CA atoms of all amino acids of a spacer on a grid, for use
+ * with loop_spacer_vdw(). Points are numbered as the amino acids.
+ * 
+ * @param sp
+ * @param caGrid
+ */
+void LoopModel::pBuildCaGrid(Spacer& sp, NeighborGrid& caGrid) {
+    vector<vgVector3<double> > ca;
+    ca.reserve(sp.sizeAmino());
+    for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+        ca.push_back(sp.getAmino(i)[CA].getCoords());
+    caGrid.setCellSize(6.0);
+    caGrid.build(ca);
+}
+
 void
 LoopModel::pAminoAcidSetup(AminoAcid* aa, string type, double bfac) {
     Atom aN;
@@ -23,6 +23,7 @@
 #include <LoopTable.h>
 #include <VectorTransformation.h>
 #include <Spacer.h>
+#include <NeighborGrid.h>
 #include <SeqConstructor.h>
 #include <set>
 #include <ranking_helper.h>
@@ -31,6 +32,7 @@
 #include <RapdfPotential.h>
 #include <PhiPsi.h>
 #include <ctype.h>
+#include <pthread.h>
 using namespace Victor;
 using namespace Victor::Lobo;
 using namespace Victor::Biopool;
@@ -91,6 +93,10 @@ namespace Victor { namespace Lobo {
         double getENDRMS_WEIGHT(unsigned int len = 0);
         void saveENDRMS_WEIGHT(ostream& output);
 
+        unsigned int getThreads() const {
+            return pThreads;
+        }
+
         static string getSCWRLConservedSequence(const Spacer& sp,
                 unsigned int index1, unsigned int index2);
 
@@ -125,6 +131,11 @@ namespace Victor { namespace Lobo {
             pScatter = _sc;
         }
 
+        // number of threads closing the loops in createLoopModel()
+        void setThreads(unsigned int _threads) {
+            pThreads = (_threads > 0) ? _threads : 1;
+        }
+
         void releaseTables(unsigned int index = 0); // releases memory occupied by loop tables
         void setTableFileName(string basename, string ending = ".lt");
         void setTableFileName(vector<string>& _tFN);
@@ -202,13 +213,34 @@ namespace Victor { namespace Lobo {
         bool ringClosure(const LoopTableEntry&, const LoopTableEntry&, unsigned int,
                 unsigned int, double, VectorTransformation vt,
                 vector<vgVector3<float> >& partialSolution,
-                unsigned int currentSelection = 1);
+                unsigned int currentSelection = 1, unsigned int* seed = NULL);
         // claculates the actual coordinates for output:
         vector<Spacer> calculateLoop(const vgVector3<float>& startN,
                 unsigned int length, vector<string> typeVec);
 
     private:
+
+        /**
+         * Closures of the middle candidates found by ringClosureBase(),
+         * handed out to the threads one at a time. Task t closes the loop
+         * through middle[t / depth] with selection t % depth.
+         */
+        struct RingClosureJob {
+            LoopModel* model;
+            const vector<LoopTableEntry>* middle;
+            const LoopTableEntry* end;
+            const VectorTransformation* vt;
+            double offsetPhi;
+            unsigned int nAminoAcids, depth;
+            unsigned int seed; // base of the random seeds of the tasks
+            vector<vector<vgVector3<float> > > result; // by task
+            unsigned int next; // next task to hand out, guarded by lock
+            pthread_mutex_t lock;
+        };
+
         // HELPERS: 
+        static void* pRingClosureWorker(void* job);
+        void pRingClosureTask(RingClosureJob& job, unsigned int task);
         void pAddRot(AminoAcid& start, vgVector3<float>& startN,
                 AminoAcid& end, vgVector3<float>& endN,
                 const vgMatrix3<float>& rotMat);
@@ -223,6 +255,9 @@ namespace Victor { namespace Lobo {
         int loop_loop_vdw(Spacer& sp, unsigned int index1);
         int loop_spacer_vdw(Spacer& loop, unsigned int index1, unsigned int index2,
                 Spacer& proteine);
+        int loop_spacer_vdw(Spacer& loop, unsigned int index1, unsigned int index2,
+                Spacer& proteine, const NeighborGrid& caGrid);
+        void pBuildCaGrid(Spacer& sp, NeighborGrid& caGrid);
 
         double sCalcEn(AminoAcid& aa, AminoAcid& aa2);
         double sICalcEn(AminoAcid& aa, AminoAcid& aa2);
@@ -232,6 +267,7 @@ namespace Victor { namespace Lobo {
         // ATTRIBUTES:
         bool pInter, pPlot;
         unsigned int pVerbose;
+        unsigned int pThreads;
         ostream* pScatter;
         vector<LoopTable*> table;
         vector<string> tableFileName;
@@ -20,6 +20,12 @@
 #include <LoopTableEntry.h>
 #include <IntCoordConverter.h>
 #include <VectorTransformation.h>
+#include <Profiler.h>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -28,11 +34,22 @@ using namespace Victor::Lobo;
 using namespace Victor::Biopool; 
 
 unsigned int LoopTable::MAX_BINS = 128;
-unsigned int LoopTable::MAX_FACTOR = 5; // ie. applied as / MAX_FACTOR 
+unsigned int LoopTable::MAX_FACTOR = 5; // no longer used, see getNClosest()
 double LoopTable::BOND_ANGLE_AT_CPRIME_TO_N = 112.7;
 
 double LoopTable::BOND_LENGTH_N_TO_CALPHA = 1.46;
 double LoopTable::BOND_ANGLE_AT_N_TO_CALPHA = 121.0;
+unsigned int LoopTable::MAPPED_VERSION = 2;
+unsigned int LoopTable::INDEX_LEAF_SIZE = 8;
+
+// layout of the mapped table files, see writeMapped():
+static const char MAPPED_MAGIC[8] = {'L', 'O', 'B', 'O', 'L', 'T', 'M', '\0'};
+static const unsigned int MAPPED_BYTE_ORDER = 0x01020304;
+static const unsigned int MAPPED_ALIGNMENT = 64; // start of the entries
+
+// relative tolerance on the pruning bound of the k-d tree search, covering
+// the float rounding of LoopTableEntry::calculateDeviation():
+static const double INDEX_TOLERANCE = 1e-5;
 
 const double SIM_WEIGTH = 0.0001;
 
@@ -54,14 +71,94 @@ static double sDistance(vgVector3<float> xv, vgVector3<float> yv) {
     return sqrt(sqr(xv.x - yv.x) + sqr(xv.y - yv.y) + sqr(xv.z - yv.z));
 }
 
+/**
+ *@Description Returns one of the coordinates indexed by the k-d tree
+ *@param  reference to the entry(const LoopTableEntry&), coordinate 0..8
+ *    (endPoint, endDirection, endNormal)(unsigned int)
+ *@return  corresponding value(static float)
+ */
+static float sDescriptor(const LoopTableEntry& e, unsigned int d) {
+    return e[d / 3][d % 3];
+}
+
+/**
+ *@Description Returns the weight of a coordinate in
+ *    LoopTableEntry::calculateDeviation()
+ *@param  coordinate 0..8(unsigned int)
+ *@return  corresponding value(static double)
+ */
+static double sDescriptorWeight(unsigned int d) {
+    if (d < 3)
+        return LoopTableEntry::LAMBDA_EP;
+    return (d < 6) ? LoopTableEntry::LAMBDA_ED : LoopTableEntry::LAMBDA_EN;
+}
+
+/**
+ *@Description Tells whether a float is neither infinite nor NaN, also
+ *    when compiled with -ffast-math
+ *@param  value(float)
+ *@return  corresponding value(static bool)
+ */
+static bool sIsFinite(float x) {
+    unsigned int bits;
+    memcpy(&bits, &x, sizeof (bits));
+    return ((bits & 0x7f800000) != 0x7f800000);
+}
+
+/**
+ *@Description Same as LoopTableEntry::calculateDeviation(), on the nine
+ *    coordinates stored by the k-d tree
+ *@param  coordinates of the entry and of the destination(const float*,
+ *    const float*)
+ *@return  corresponding value(static double)
+ */
+static double sDeviation(const float* x, const float* dest) {
+    double tmpLambda = LoopTableEntry::LAMBDA_EP;
+
+    return tmpLambda * (sqr(x[0] - dest[0]) + sqr(x[1] - dest[1])
+            + sqr(x[2] - dest[2]))
+            + LoopTableEntry::LAMBDA_ED * (sqr(x[3] - dest[3])
+            + sqr(x[4] - dest[4]) + sqr(x[5] - dest[5]))
+            + LoopTableEntry::LAMBDA_EN * (sqr(x[6] - dest[6])
+            + sqr(x[7] - dest[7]) + sqr(x[8] - dest[8]));
+}
+
+/**
+ *@Description Coordinates of an entry, kept next to each other while
+ *    building the k-d tree.
+ */
+struct IndexPoint {
+    float x[9];
+    unsigned int entry;
+};
+
+/**
+ *@Description Orders IndexPoints by one coordinate, for nth_element().
+ */
+class IndexPointLess {
+public:
+
+    IndexPointLess(unsigned int d) : d(d) {
+    }
+
+    bool operator()(const IndexPoint& a, const IndexPoint& b) const {
+        return a.x[d] < b.x[d];
+    }
+
+private:
+    unsigned int d;
+};
+
 
 // CONSTRUCTORS/DESTRUCTOR:
 
 /**
  *@Description basic constructor
  */
-LoopTable::LoopTable() : rama(NULL), nAminoAcid(1), lowerLimit(1000.0),
-upperLimit(-1000.0), stepLimit(0), nextIndex(0), stepWidth(1) {
+LoopTable::LoopTable() : rama(NULL), nAminoAcid(1), mapped(NULL), mappedBin(),
+mapAddress(NULL), mapLength(0), rotated(false), indexNodeData(),
+indexPointData(), indexOrderData(), indexBin(), indexNode(NULL),
+indexPoint(NULL), indexOrder(NULL), indexSize(0), lowerLimit(1000.0), upperLimit(-1000.0), stepLimit(0), nextIndex(0), stepWidth(1) {
     vgVector3<float> tmp(1000, 1000, 1000);
     for (unsigned int i = 0; i < 6; i++) {
         max[i] = -tmp;
@@ -82,7 +179,10 @@ upperLimit(-1000.0), stepLimit(0), nextIndex(0), stepWidth(1) {
  *@Description constructor base from the copy of another object
  *@param reference to the original object (const LoopTable&)
  */
-LoopTable::LoopTable(const LoopTable& orig) {
+LoopTable::LoopTable(const LoopTable& orig) : mapped(NULL), mappedBin(),
+mapAddress(NULL), mapLength(0), indexNodeData(), indexPointData(),
+indexOrderData(), indexBin(), indexNode(NULL), indexPoint(NULL),
+indexOrder(NULL), indexSize(0) {
     this->copy(orig);
 }
 
@@ -91,6 +191,7 @@ LoopTable::LoopTable(const LoopTable& orig) {
  */
 LoopTable::~LoopTable() {
     PRINT_NAME;
+    pUnmap();
 }
 
 
@@ -101,8 +202,8 @@ LoopTable::~LoopTable() {
  *@param  none
  */
 void LoopTable::showDistribution() {
-    for (unsigned int i = 0; i < entry.size(); i++) {
-        cout << " " << entry[i].size() << "\t";
+    for (unsigned int i = 0; i < pGetBinCount(); i++) {
+        cout << " " << pGetBinSize(i) << "\t";
         if ((i + 1) % 5 == 0)
             cout << "\n";
     }
@@ -111,83 +212,56 @@ void LoopTable::showDistribution() {
 
 /**
  *@Description Find a matching entry with "minimal" deviation from destination 
- *    (EP, ED, EN) and return it.
+ *    (EP, ED, EN) and return it. currentSelection = n returns the 
+ *    (n + 1)-th closest entry.
  *@param  reference to the destination loop table entry(const LoopTableEntry&), index of the current selection (unsigned int)
  *@return  the new loop table entry(LoopTableEntry)
  */
 LoopTableEntry LoopTable::getClosest(const LoopTableEntry& dest,
         unsigned int currentSelection) {
-    PRECOND((entry.size() > 0), exception);
-
-    priority_queue<solutionQueueElem> solutionQueue;
-    unsigned int index = pGetBin(dest.endPoint);
-    unsigned int max = size() / MAX_FACTOR;
+    PRECOND((pGetBinCount() > 0), exception);
 
-    pAddToSolutionQueue(index, solutionQueue, dest);
-
-    unsigned int offset = 0;
-    while ((solutionQueue.size() < max) || (offset > MAX_BINS / 2)) {
-        offset++;
-        if (index >= offset)
-            pAddToSolutionQueue(index - offset, solutionQueue, dest);
-        if (index + offset < MAX_BINS)
-            pAddToSolutionQueue(index + offset, solutionQueue, dest);
-    }
-
-    if (solutionQueue.size() > currentSelection)
-        for (unsigned int i = 0; i < currentSelection; i++)
-            solutionQueue.pop();
+    vector<pair<double, unsigned int> > best;
+    pSearchIndex(dest, currentSelection + 1, best);
+    if (best.size() == 0)
+        ERROR("No valid entries found.", exception);
 
-    return entry[solutionQueue.top().index1][solutionQueue.top().index2];
+    if (best.size() > currentSelection)
+        return pGetIndexedEntry(best[currentSelection].second);
+    return pGetIndexedEntry(best[0].second);
 }
 
 /**
- *@Description Gets the closest N 
+ *@Description Gets the closest N entries, ordered by deviation from 
+ *    destination. Entries deviating more than 20 times as much as the 
+ *    closest one are dropped. For nAmino <= 5 the end point of the 
+ *    returned entries is moved onto the destination (the table itself 
+ *    is not changed).
  *@param  reference to the table( LoopTableEntry&), value of N(unsigned int ), number of amino acids (unsigned int )
  *@return  vector containing the loop entry tables(vector<LoopTableEntry> )
  */
 vector<LoopTableEntry> LoopTable::getNClosest(const LoopTableEntry& dest, unsigned int num,
         unsigned int nAmino) {
-    PRECOND((entry.size() > 0), exception);
+    PRECOND((pGetBinCount() > 0), exception);
 
     vector<LoopTableEntry> result;
-    priority_queue<solutionQueueElem> solutionQueue;
-    unsigned int index = pGetBin(dest.endPoint);
-    unsigned int max = size() / MAX_FACTOR;
-
-    pAddToSolutionQueue(index, solutionQueue, dest);
-
-    unsigned int offset = 0;
-    while ((solutionQueue.size() < max) || (offset > MAX_BINS / 2)) {
-        offset++;
-        if (index >= offset)
-            pAddToSolutionQueue(index - offset, solutionQueue, dest);
-        if (index + offset < MAX_BINS)
-            pAddToSolutionQueue(index + offset, solutionQueue, dest);
-    }
-
-    if (solutionQueue.size() == 0)
+    vector<pair<double, unsigned int> > best;
+    pSearchIndex(dest, num, best);
+    if ((best.size() == 0) && (num > 0))
         ERROR("No valid entries found.", exception);
 
-    double maxDev = 20 * solutionQueue.top().dev;
-
-    while ((solutionQueue.size() > 0) && (result.size() < num)) {
-        if (solutionQueue.top().dev > maxDev)
+    for (unsigned int i = 0; i < best.size(); i++) {
+        if (best[i].first > 20 * best[0].first)
             break;
 
-
+        LoopTableEntry top = pGetIndexedEntry(best[i].second);
         if (nAmino <= 5) {
-            vgVector3<float> offsetEP = dest.endPoint -
-                    entry[solutionQueue.top().index1][solutionQueue.top().index2].endPoint;
-            entry[solutionQueue.top().index1][solutionQueue.top().index2].midPoint
-                    += (offsetEP / 2);
-            entry[solutionQueue.top().index1][solutionQueue.top().index2].endPoint
-                    = dest.endPoint;
+            vgVector3<float> offsetEP = dest.endPoint - top.endPoint;
+            top.midPoint += (offsetEP / 2);
+            top.endPoint = dest.endPoint;
         }
 
-        result.push_back(entry[solutionQueue.top().index1]
-                [solutionQueue.top().index2]);
-        solutionQueue.pop();
+        result.push_back(top);
     }
 
     return result;
@@ -195,6 +269,17 @@ vector<LoopTableEntry> LoopTable::getNClosest(const LoopTableEntry& dest, unsign
 }
 
 
+/**
+ *@Description Name of the mapped version of a table file, eg. "aa5.ltm"
+ *    for "aa5.lt".
+ *@param  reference to the file name(const string&)
+ *@return  name of the mapped file(string)
+ */
+string LoopTable::getMappedFileName(const string& fileName) {
+    return fileName + "m";
+}
+
+
 // MODIFIERS:
 
 /**
@@ -204,14 +289,19 @@ vector<LoopTableEntry> LoopTable::getNClosest(const LoopTableEntry& dest, unsign
  */
 void LoopTable::copy(const LoopTable& orig) {
     PRINT_NAME;
+    if (&orig == this)
+        return;
+    pUnmap();
     rama = orig.rama;
     nAminoAcid = orig.nAminoAcid;
+    rotated = orig.rotated;
 
+    // mapped tables are copied into memory
     entry.clear();
-    entry.resize(orig.entry.size());
-    for (unsigned int i = 0; i < orig.entry.size(); i++)
-        for (unsigned int j = 0; j < orig.entry[i].size(); j++)
-            entry[i].push_back(orig.entry[i][j]);
+    entry.resize(orig.pGetBinCount());
+    for (unsigned int i = 0; i < orig.pGetBinCount(); i++)
+        for (unsigned int j = 0; j < orig.pGetBinSize(i); j++)
+            entry[i].push_back(orig.pGetEntry(i, j));
 
     lowerLimit = orig.lowerLimit;
     upperLimit = orig.upperLimit;
@@ -222,6 +312,23 @@ void LoopTable::copy(const LoopTable& orig) {
     psiNormal = orig.psiNormal;
     nextIndex = orig.nextIndex;
     stepWidth = orig.stepWidth;
+
+    // the entries keep their numbers, so the index stays valid:
+    if (orig.indexNode != NULL) {
+        unsigned int n = orig.indexNode[0].end; // entries indexed
+        indexNodeData.assign(orig.indexNode, orig.indexNode + orig.indexSize);
+        indexPointData.assign(orig.indexPoint, orig.indexPoint + 9 * n);
+        indexOrderData.assign(orig.indexOrder, orig.indexOrder + n);
+        indexBin.resize(entry.size());
+        for (unsigned int i = 0, count = 0; i < entry.size(); i++) {
+            indexBin[i] = count;
+            count += entry[i].size();
+        }
+        indexNode = &indexNodeData[0];
+        indexPoint = &indexPointData[0];
+        indexOrder = &indexOrderData[0];
+        indexSize = indexNodeData.size();
+    }
 }
 
 /**
@@ -230,6 +337,8 @@ void LoopTable::copy(const LoopTable& orig) {
  *@return   changes are made internally(void)
  */
 void LoopTable::setToSingleAminoAcid() {
+    pMakeResident();
+    pClearIndex();
     nAminoAcid = 1;
     LoopTableEntry tmpEntry;
     tmpEntry.setToSingleAminoAcid();
@@ -246,6 +355,7 @@ void LoopTable::setToSingleAminoAcid() {
  */
 void LoopTable::concatenate(LoopTable& src1, LoopTable& src2,
         unsigned long nSrc1, unsigned long nSrc2) {
+    pMakeResident();
     src1.initOccurrence(nSrc1);
 
     // nSrc1 statistical cases of src1:
@@ -274,6 +384,8 @@ void LoopTable::concatenate(LoopTable& src1, LoopTable& src2,
  *@return   changes are made internally(void)
  */
 void LoopTable::adjustTable() { // adjusts the internal hash table 
+    pMakeResident();
+    pClearIndex();
 
     vector<vector<LoopTableEntry> > tmpEntry;
     tmpEntry.resize(MAX_BINS);
@@ -302,6 +414,9 @@ void LoopTable::read(const string& filename) {
         ERROR("Table data file " + filename + " not found.", exception);
     }
 
+    pUnmap();
+    rotated = false;
+
     // first read the global table parameters
     is.read((char*) &nAminoAcid, sizeof (unsigned int));
 
@@ -366,6 +481,8 @@ void LoopTable::read(const string& filename) {
  *@return   changes are made internally(void)
  */
 void LoopTable::cluster(double cutoff) {
+    pMakeResident();
+    pClearIndex();
 
     if (entry.size() == 0)
         return;
@@ -413,11 +530,11 @@ void LoopTable::write(const string& filename) {
     // first write the global table parameters:
     os.write((char*) &nAminoAcid, sizeof (unsigned int));
 
-    unsigned int nBin = entry.size();
+    unsigned int nBin = pGetBinCount();
 
     os.write((char*) &nBin, sizeof (unsigned int));
-    for (unsigned int i = 0; i < entry.size(); i++) {
-        nBin = entry[i].size();
+    for (unsigned int i = 0; i < pGetBinCount(); i++) {
+        nBin = pGetBinSize(i);
         os.write((char*) &nBin, sizeof (unsigned int));
     }
 
@@ -435,11 +552,11 @@ void LoopTable::write(const string& filename) {
     // next write the table itself, compressing it on the fly:
 
     INVARIANT(os, exception);
-    for (unsigned int index = 0; index < entry.size(); index++)
-        for (unsigned int i = 0; i < entry[index].size(); i++)
+    for (unsigned int index = 0; index < pGetBinCount(); index++)
+        for (unsigned int i = 0; i < pGetBinSize(index); i++)
             for (unsigned int j = 0; j < 6; j++)
                 for (unsigned int k = 0; k < 3; k++) {
-                    unsigned short tmp = code((entry[index][i])[j][k],
+                    unsigned short tmp = code(pGetEntry(index, i)[j][k],
                             min[j][k], max[j][k]);
                     os.write((char*) &tmp, sizeof (unsigned short));
                 }
@@ -489,6 +606,297 @@ void LoopTable::writeASCII(const string& filename, unsigned long num,
 
 
 
+/**
+ *@Description Maps a table written by writeMapped() into memory. The
+ *    entries are used in place: nothing is decoded and processes reading
+ *    the same file share its pages. Entries modified later (eg. by
+ *    getNClosest()) are copied on write and never written back.
+ *@param  reference to the file name(const string&)
+ *@return   changes are made internally(void)
+ */
+void LoopTable::readMapped(const string& filename) {
+    if ((sizeof (LoopTableEntry) != 18 * sizeof (float))
+            || (sizeof (LoopTableIndexNode) != 5 * sizeof (unsigned int)))
+        ERROR("LoopTable::readMapped() : unsupported entry layout.", exception);
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cout << "Table data file " << filename
+                << " not found. Please construct it first.\n";
+        ERROR("Table data file " + filename + " not found.", exception);
+    }
+    struct stat status;
+    size_t length = 0;
+    if (fstat(fd, &status) == 0)
+        length = status.st_size;
+    void* address = MAP_FAILED;
+    if (length > 0)
+        address = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+        ERROR("LoopTable::readMapped() : could not map " + filename, exception);
+
+    // check the header before using anything:
+    const char* data = static_cast<const char*> (address);
+    // version, byte order, entry size, nAminoAcid, nBins, rotated, index nodes:
+    unsigned int header[7];
+    size_t offset = sizeof (MAPPED_MAGIC) + sizeof (header);
+    bool valid = (length >= offset)
+            && (memcmp(data, MAPPED_MAGIC, sizeof (MAPPED_MAGIC)) == 0);
+    if (valid) {
+        memcpy(header, data + sizeof (MAPPED_MAGIC), sizeof (header));
+        valid = (header[0] == MAPPED_VERSION) && (header[1] == MAPPED_BYTE_ORDER)
+                && (header[2] == sizeof (LoopTableEntry)) && (header[4] == MAX_BINS);
+    }
+    size_t limitOffset = offset;
+    offset += 2 * sizeof (double) + 2 * 18 * sizeof (float);
+    size_t binOffset = offset;
+    if (valid) {
+        offset += (header[4] + 1) * sizeof (unsigned int);
+        offset += (MAPPED_ALIGNMENT - offset % MAPPED_ALIGNMENT) % MAPPED_ALIGNMENT;
+        valid = (length >= offset);
+    }
+    vector<unsigned int> binStart;
+    if (valid) {
+        binStart.resize(header[4] + 1);
+        memcpy(&binStart[0], data + binOffset, binStart.size() * sizeof (unsigned int));
+        for (unsigned int i = 0; i < header[4]; i++)
+            valid = valid && (binStart[i] <= binStart[i + 1]);
+        valid = valid && (binStart[0] == 0) && ((length - offset) / sizeof (LoopTableEntry)
+                >= binStart.back());
+    }
+    size_t nodeOffset = 0, pointOffset = 0, orderOffset = 0;
+    if (valid) {
+        nodeOffset = offset + binStart.back() * sizeof (LoopTableEntry);
+        pointOffset = nodeOffset + header[6] * sizeof (LoopTableIndexNode);
+        valid = (length >= pointOffset);
+    }
+    if (valid && (header[6] > 0)) {
+        LoopTableIndexNode root;
+        memcpy(&root, data + nodeOffset, sizeof (root));
+        orderOffset = pointOffset + 9 * root.end * sizeof (float);
+        valid = (root.begin == 0) && (root.end <= binStart.back())
+                && (length >= orderOffset + root.end * sizeof (unsigned int));
+    }
+    if (!valid) {
+        munmap(address, length);
+        ERROR("LoopTable::readMapped() : " + filename
+                + " is not a mapped table of this version, please convert it again.",
+                exception);
+    }
+
+    pUnmap();
+    vector<vector<LoopTableEntry> >().swap(entry);
+
+    nAminoAcid = header[3];
+    rotated = (header[5] != 0);
+    memcpy(&lowerLimit, data + limitOffset, sizeof (double));
+    memcpy(&upperLimit, data + limitOffset + sizeof (double), sizeof (double));
+    stepLimit = (upperLimit - lowerLimit) / (header[4] - 1);
+    float limit[2][18];
+    memcpy(limit, data + limitOffset + 2 * sizeof (double), sizeof (limit));
+    for (unsigned int i = 0; i < 6; i++)
+        for (unsigned int j = 0; j < 3; j++) {
+            max[i][j] = limit[0][3 * i + j];
+            min[i][j] = limit[1][3 * i + j];
+        }
+
+    mapped = reinterpret_cast<LoopTableEntry*> (static_cast<char*> (address) + offset);
+    mappedBin.swap(binStart);
+    mapAddress = address;
+    mapLength = length;
+
+    if (header[6] > 0) {
+        indexNode = reinterpret_cast<const LoopTableIndexNode*> (data + nodeOffset);
+        indexPoint = reinterpret_cast<const float*> (data + pointOffset);
+        indexOrder = reinterpret_cast<const unsigned int*> (data + orderOffset);
+        indexSize = header[6];
+    }
+}
+
+/**
+ *@Description Writes the table in the format read by readMapped(): a
+ *    versioned header, the start of each bin and the decoded entries,
+ *    bin after bin, beginning at an aligned offset, followed by the k-d 
+ *    tree: its nodes, the coordinates and the numbers of the entries in 
+ *    tree order. Unlike write()
+ *    the coordinates are stored as they are, without compression, so the
+ *    file is about twice as large.
+ *@param  reference to the file name(const string&)
+ *@return   changes are made internally(void)
+ */
+void LoopTable::writeMapped(const string& filename) {
+    ofstream os(filename.c_str(), ios::out | ios::binary);
+    if (!os)
+        ERROR("LoopTable::writeMapped() : could not write " + filename, exception);
+
+    if (!isIndexed())
+        buildIndex();
+
+    unsigned int nBins = pGetBinCount();
+    unsigned int header[7] = {MAPPED_VERSION, MAPPED_BYTE_ORDER,
+        sizeof (LoopTableEntry), nAminoAcid, nBins, rotated ? 1 : 0, indexSize};
+    os.write(MAPPED_MAGIC, sizeof (MAPPED_MAGIC));
+    os.write((char*) header, sizeof (header));
+    os.write((char*) &lowerLimit, sizeof (double));
+    os.write((char*) &upperLimit, sizeof (double));
+    for (unsigned int i = 0; i < 6; i++)
+        for (unsigned int j = 0; j < 3; j++)
+            os.write((char*) &max[i][j], sizeof (float));
+    for (unsigned int i = 0; i < 6; i++)
+        for (unsigned int j = 0; j < 3; j++)
+            os.write((char*) &min[i][j], sizeof (float));
+
+    unsigned int start = 0;
+    for (unsigned int i = 0; i < nBins; i++) {
+        os.write((char*) &start, sizeof (unsigned int));
+        start += pGetBinSize(i);
+    }
+    os.write((char*) &start, sizeof (unsigned int));
+
+    size_t offset = sizeof (MAPPED_MAGIC) + sizeof (header) + 2 * sizeof (double)
+            + 2 * 18 * sizeof (float) + (nBins + 1) * sizeof (unsigned int);
+    for (; offset % MAPPED_ALIGNMENT != 0; offset++)
+        os.put(0);
+
+    for (unsigned int index = 0; index < nBins; index++)
+        for (unsigned int i = 0; i < pGetBinSize(index); i++)
+            for (unsigned int j = 0; j < 6; j++)
+                for (unsigned int k = 0; k < 3; k++)
+                    os.write((char*) &pGetEntry(index, i)[j][k], sizeof (float));
+
+    unsigned int nIndexed = (indexSize > 0) ? indexNode[0].end : 0;
+    os.write((char*) indexNode, indexSize * sizeof (LoopTableIndexNode));
+    os.write((char*) indexPoint, 9 * nIndexed * sizeof (float));
+    os.write((char*) indexOrder, nIndexed * sizeof (unsigned int));
+
+    if (!os)
+        ERROR("LoopTable::writeMapped() : could not write " + filename, exception);
+    os.close();
+}
+
+/**
+ *@Description Rotates the end point of all entries into the XY plane,
+ *    as required by LoopModel.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::rotateIntoXYPlane() {
+    pClearIndex();
+    VectorTransformation vt;
+    for (unsigned int index = 0; index < pGetBinCount(); index++)
+        for (unsigned int i = 0; i < pGetBinSize(index); i++)
+            pGetEntry(index, i).rotateIntoXYPlane(vt);
+    rotated = true;
+}
+
+/**
+ *@Description Builds the k-d tree used by getClosest() and getNClosest().
+ *    Called by the first search if needed; has to be called again after
+ *    changing entries through operator[]. Each node splits its entries at
+ *    the median of the coordinate with the largest weighted spread, until
+ *    at most INDEX_LEAF_SIZE entries are left. The coordinates are copied
+ *    in tree order, so that the entries of a leaf are compared without
+ *    touching the table. Entries with non-finite coordinates are left out.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::buildIndex() {
+    pClearIndex();
+    unsigned int n = size();
+    if (n == 0)
+        return;
+
+    // copy the coordinates, numbering the entries as operator[] does:
+    vector<IndexPoint> point;
+    point.reserve(n);
+    indexBin.resize(pGetBinCount());
+    unsigned int count = 0;
+    for (unsigned int index = 0; index < pGetBinCount(); index++) {
+        indexBin[index] = count;
+        for (unsigned int i = 0; i < pGetBinSize(index); i++, count++) {
+            IndexPoint p;
+            bool finite = true;
+            for (unsigned int d = 0; d < 9; d++) {
+                p.x[d] = sDescriptor(pGetEntry(index, i), d);
+                finite = finite && sIsFinite(p.x[d]);
+            }
+            p.entry = count;
+            if (finite)
+                point.push_back(p);
+        }
+    }
+    n = point.size();
+    if (n == 0)
+        return;
+
+    LoopTableIndexNode root;
+    root.split = 0;
+    root.dim = 0;
+    root.begin = 0;
+    root.end = n;
+    root.child = 0;
+    indexNodeData.push_back(root);
+
+    // split the nodes breadth first, appending the children in pairs:
+    for (unsigned int k = 0; k < indexNodeData.size(); k++) {
+        LoopTableIndexNode node = indexNodeData[k];
+        if (node.end - node.begin <= INDEX_LEAF_SIZE)
+            continue;
+
+        float lo[9], hi[9];
+        for (unsigned int d = 0; d < 9; d++)
+            lo[d] = hi[d] = point[node.begin].x[d];
+        for (unsigned int i = node.begin + 1; i < node.end; i++)
+            for (unsigned int d = 0; d < 9; d++) {
+                if (point[i].x[d] < lo[d])
+                    lo[d] = point[i].x[d];
+                if (point[i].x[d] > hi[d])
+                    hi[d] = point[i].x[d];
+            }
+
+        double maxSpread = 0.0;
+        for (unsigned int d = 0; d < 9; d++) {
+            double spread = sDescriptorWeight(d) * sqr(hi[d] - lo[d]);
+            if (spread > maxSpread) {
+                maxSpread = spread;
+                node.dim = d;
+            }
+        }
+        if (maxSpread <= 0.0) // identical entries
+            continue;
+
+        unsigned int mid = (node.begin + node.end) / 2;
+        nth_element(point.begin() + node.begin, point.begin() + mid,
+                point.begin() + node.end, IndexPointLess(node.dim));
+        node.split = point[mid].x[node.dim];
+        node.child = indexNodeData.size();
+        indexNodeData[k] = node;
+
+        LoopTableIndexNode child = root;
+        child.begin = node.begin;
+        child.end = mid;
+        indexNodeData.push_back(child);
+        child.begin = mid;
+        child.end = node.end;
+        indexNodeData.push_back(child);
+    }
+
+    indexOrderData.resize(n);
+    indexPointData.resize(9 * n);
+    for (unsigned int i = 0; i < n; i++) {
+        indexOrderData[i] = point[i].entry;
+        for (unsigned int d = 0; d < 9; d++)
+            indexPointData[9 * i + d] = point[i].x[d];
+    }
+
+    indexNode = &indexNodeData[0];
+    indexPoint = &indexPointData[0];
+    indexOrder = &indexOrderData[0];
+    indexSize = indexNodeData.size();
+}
+
+
 // OPERATORS:
 
 /**
@@ -533,6 +941,8 @@ double LoopTable::pEstimateSimilarityCutoff(const LoopTableEntry& le,
  *@return   changes are made internally(void)
  */
 void LoopTable::store(const LoopTableEntry& src) {
+    pMakeResident();
+    pClearIndex();
     entry[0].push_back(src);
 
     double tmp = sqrt(sqr(src.endPoint.x)
@@ -650,6 +1060,131 @@ double LoopTable::decode(const unsigned short value, const double min,
 }
 
 
+/**
+ *@Description Copies the entries of a mapped table into memory, so that
+ *    the table can be changed.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pMakeResident() {
+    if (mapped == NULL)
+        return;
+    entry.clear();
+    entry.resize(pGetBinCount());
+    for (unsigned int i = 0; i < pGetBinCount(); i++)
+        entry[i].assign(mapped + mappedBin[i], mapped + mappedBin[i + 1]);
+    pUnmap();
+}
+
+/**
+ *@Description Releases the mapped file, if any.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pUnmap() {
+    if (mapAddress != NULL)
+        munmap(mapAddress, mapLength);
+    mapped = NULL;
+    mappedBin.clear();
+    mapAddress = NULL;
+    mapLength = 0;
+    pClearIndex();
+}
+
+/**
+ *@Description Finds the entries closest to destination, as measured by
+ *    LoopTableEntry::calculateDeviation(), on the k-d tree. Ties are
+ *    broken by entry number.
+ *@param  reference to the destination(const LoopTableEntry&), number of 
+ *    entries wanted(unsigned int), result: deviation and number of the 
+ *    entries found, closest first(vector<pair<double, unsigned int> >&)
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pSearchIndex(const LoopTableEntry& dest, unsigned int num,
+        vector<pair<double, unsigned int> >& best) {
+    PROFILE_REGION("LoopTable::pSearchIndex");
+    if (!isIndexed())
+        buildIndex();
+    best.clear();
+    if ((num == 0) || (indexSize == 0))
+        return;
+
+    float query[9], offset[9];
+    for (unsigned int d = 0; d < 9; d++) {
+        query[d] = sDescriptor(dest, d);
+        offset[d] = 0;
+    }
+    unsigned long scanned = pSearchNode(0, query, offset, 0.0, num, best);
+    PROFILE_COUNT("entries scanned", scanned);
+    sort_heap(best.begin(), best.end());
+}
+
+/**
+ *@Description Searches a subtree, keeping the closest num entries found
+ *    in the heap best (largest deviation on top). offset holds the 
+ *    distance of the query from the node along each split coordinate, 
+ *    bound the resulting lower bound of the deviation of its entries.
+ *@param  node(unsigned int), coordinates of the destination(const float*),
+ *    offsets(float*), bound(double), number of entries wanted(unsigned int),
+ *    heap(vector<pair<double, unsigned int> >&)
+ *@return   number of entries compared(unsigned long)
+ */
+unsigned long LoopTable::pSearchNode(unsigned int node, const float* query, float* offset, double bound, unsigned int num,
+        vector<pair<double, unsigned int> >& best) const {
+    const LoopTableIndexNode& current = indexNode[node];
+
+    if (current.child == 0) {
+        for (unsigned int i = current.begin; i < current.end; i++) {
+            pair<double, unsigned int> candidate(sDeviation(indexPoint + 9 * i,
+                    query), indexOrder[i]);
+            if (best.size() < num) {
+                best.push_back(candidate);
+                push_heap(best.begin(), best.end());
+            } else if (candidate < best.front()) {
+                pop_heap(best.begin(), best.end());
+                best.back() = candidate;
+                push_heap(best.begin(), best.end());
+            }
+        }
+        return current.end - current.begin;
+    }
+
+    unsigned int d = current.dim;
+    float diff = query[d] - current.split;
+    unsigned int nearChild = (diff < 0) ? current.child : current.child + 1;
+    unsigned long scanned = pSearchNode(nearChild, query, offset, bound, num, best);
+
+    double farBound = bound + sDescriptorWeight(d)
+            * (static_cast<double> (diff) * diff
+            - static_cast<double> (offset[d]) * offset[d]);
+    if ((best.size() < num)
+            || (farBound <= best.front().first * (1 + INDEX_TOLERANCE))) {
+        float old = offset[d];
+        offset[d] = diff;
+        scanned += pSearchNode(2 * current.child + 1 - nearChild, query, offset,
+                farBound, num, best);
+        offset[d] = old;
+    }
+    return scanned;
+}
+
+/**
+ *@Description Drops the k-d tree.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pClearIndex() {
+    indexNodeData.clear();
+    indexPointData.clear();
+    indexOrderData.clear();
+    indexBin.clear();
+    indexNode = NULL;
+    indexPoint = NULL;
+    indexOrder = NULL;
+    indexSize = 0;
+}
+
+
 // TESTERS:
 
 /**
@@ -26,6 +26,8 @@
 #include <RamachandranData.h>
 #include <LoopTableEntry.h>
 #include <queue>
+#include <utility>
+#include <algorithm>
 using namespace Victor;
 using namespace Victor::Lobo;
 using namespace Victor::Biopool; 
@@ -45,6 +47,22 @@ namespace Victor { namespace Lobo {
         }
     };
 
+    /**@brief  Node of the k-d tree indexing the entries of a table.
+     * 
+     *@Description  The tree splits on the nine coordinates of endPoint,
+     *      endDirection and endNormal, ie. the ones compared by
+     *      LoopTableEntry::calculateDeviation(). Inner nodes have two
+     *      children, stored next to each other; leaves cover a range of
+     *      the index order. All fields are 32 bits wide, so that the nodes
+     *      can be mapped from a file (see LoopTable::writeMapped()).
+     * */
+    struct LoopTableIndexNode {
+        float split; // split value (inner nodes)
+        unsigned int dim; // split coordinate, 0..8 (inner nodes)
+        unsigned int begin, end; // range of entries below the node
+        unsigned int child; // index of the first child, 0 for leaves
+    };
+
     /**
      * @brief  Defines a table of possible amino chain end points and end directions 
      *  after k amino acids have been concatenated. 
@@ -65,6 +83,9 @@ namespace Victor { namespace Lobo {
         virtual unsigned int size();
         unsigned int getLength();
         unsigned int getMaxBins();
+        bool isRotated();
+        bool isMapped();
+        bool isIndexed();
         void showDistribution();
         virtual LoopTableEntry getClosest(const LoopTableEntry& le,
                 unsigned int currentSelection = 1);
@@ -88,6 +109,10 @@ namespace Victor { namespace Lobo {
         virtual void read(const string&);
         virtual void cluster(double cutoff);
         virtual void write(const string&);
+        virtual void readMapped(const string&);
+        virtual void writeMapped(const string&);
+        void rotateIntoXYPlane();
+        void buildIndex();
         void writeASCII(const string&, unsigned long num = 0,
                 unsigned int wEntry = 0, unsigned int wDim = 0);
 
@@ -102,6 +127,8 @@ namespace Victor { namespace Lobo {
 
         static unsigned int MAX_FACTOR;
 
+        static string getMappedFileName(const string& fileName);
+
     protected:
 
         // HELPERS: 
@@ -112,9 +139,6 @@ namespace Victor { namespace Lobo {
         void pInsertElem(LoopTableEntry& elem,
                 vector<vector<LoopTableEntry> >& table);
         unsigned int pGetBin(const vgVector3<float>& e);
-        void pAddToSolutionQueue(unsigned int offset,
-                priority_queue<solutionQueueElem>& solutionQueue,
-                const LoopTableEntry& dest);
 
         //methods used to concatenate two tables:
         void initOccurrence(const unsigned long);
@@ -124,6 +148,23 @@ namespace Victor { namespace Lobo {
         unsigned short code(const double, const double, const double);
         double decode(const unsigned short, const double, const double);
 
+        // access to the entries, either in memory or mapped:
+        unsigned int pGetBinCount() const;
+        unsigned int pGetBinSize(unsigned int bin) const;
+        LoopTableEntry& pGetEntry(unsigned int bin, unsigned int i);
+        const LoopTableEntry& pGetEntry(unsigned int bin, unsigned int i) const;
+        void pMakeResident();
+        void pUnmap();
+
+        // nearest neighbour search on the k-d tree:
+        const LoopTableEntry& pGetIndexedEntry(unsigned int n) const;
+        void pSearchIndex(const LoopTableEntry& dest, unsigned int num,
+                vector<pair<double, unsigned int> >& best);
+        unsigned long pSearchNode(unsigned int node, const float* query, float* offset,
+                double bound, unsigned int num,
+                vector<pair<double, unsigned int> >& best) const;
+        void pClearIndex();
+
 
     private:
 
@@ -136,6 +177,30 @@ namespace Victor { namespace Lobo {
 
         // table of (sorted) bins containing the chain information
         vector<vector<LoopTableEntry> > entry;
+
+        // alternatively, entries of a table read by readMapped(), stored
+        // bin after bin; entries of bin i are mapped[mappedBin[i]] ..
+        // mapped[mappedBin[i + 1] - 1]
+        LoopTableEntry* mapped;
+        vector<unsigned int> mappedBin;
+        void* mapAddress;
+        size_t mapLength;
+
+        bool rotated; // entries rotated into the XY plane
+
+        // k-d tree over the entries, built by buildIndex() or mapped along
+        // with them; indexPoint holds the coordinates compared by the
+        // search (9 per entry) and indexOrder the entry numbers (as used by
+        // operator[]), both in tree order. Entries changed through
+        // operator[] are not reindexed.
+        vector<LoopTableIndexNode> indexNodeData;
+        vector<float> indexPointData;
+        vector<unsigned int> indexOrderData;
+        vector<unsigned int> indexBin; // first entry number of each bin
+        const LoopTableIndexNode* indexNode;
+        const float* indexPoint;
+        const unsigned int* indexOrder;
+        unsigned int indexSize; // number of nodes
         
 
         double lowerLimit; // information about the lower and 
@@ -155,6 +220,9 @@ namespace Victor { namespace Lobo {
         static double BOND_LENGTH_N_TO_CALPHA;
         static double BOND_ANGLE_AT_N_TO_CALPHA;
 
+        static unsigned int MAPPED_VERSION;
+        static unsigned int INDEX_LEAF_SIZE;
+
     };
 
     void printTable(LoopTable&, int num = -1);
@@ -199,6 +267,8 @@ namespace Victor { namespace Lobo {
      *@return  corresponding value ( unsigned int)
      */
     inline unsigned int LoopTable::size() {
+        if (mapped != NULL)
+            return mappedBin.back();
         unsigned int count = 0;
         for (unsigned int i = 0; i < entry.size(); i++)
             count += entry[i].size();
@@ -223,6 +293,33 @@ namespace Victor { namespace Lobo {
         return MAX_BINS;
     }
 
+    /**
+     *@Description tells whether the entries were rotated into the XY plane
+     *@param  none
+     *@return  corresponding value ( bool)
+     */
+    inline bool LoopTable::isRotated() {
+        return rotated;
+    }
+
+    /**
+     *@Description tells whether the entries are mapped from a file
+     *@param  none
+     *@return  corresponding value ( bool)
+     */
+    inline bool LoopTable::isMapped() {
+        return (mapped != NULL);
+    }
+
+    /**
+     *@Description tells whether the k-d tree of the entries is available
+     *@param  none
+     *@return  corresponding value ( bool)
+     */
+    inline bool LoopTable::isIndexed() {
+        return (indexNode != NULL);
+    }
+
     // MODIFIERS:
 
     /**
@@ -251,6 +348,11 @@ namespace Victor { namespace Lobo {
      *@return  reference to the loop entry table( LoopTableEntry&)
      */
     inline LoopTableEntry& LoopTable::operator[](unsigned int n) {
+        if (mapped != NULL) {
+            if (n >= mappedBin.back())
+                ERROR("LoopTable::operator[] : Argument out of scope.", exception);
+            return mapped[n];
+        }
 
         unsigned int count = MAX_BINS + 1;
         for (unsigned int i = 0; i < entry.size(); i++) {
@@ -273,6 +375,12 @@ namespace Victor { namespace Lobo {
      *@return  reference to the loop entry table( LoopTableEntry&)
      */
     inline const LoopTableEntry& LoopTable::operator[](unsigned int n) const {
+        if (mapped != NULL) {
+            if (n >= mappedBin.back())
+                ERROR("LoopTable::operator[] : Argument out of scope.", exception);
+            return mapped[n];
+        }
+
         unsigned int count = MAX_BINS + 1;
         for (unsigned int i = 0; i < entry.size(); i++) {
             if (n >= entry[i].size())
@@ -319,20 +427,58 @@ namespace Victor { namespace Lobo {
     }
 
     /**
-     *@Description Adds the data into the solution queue
-     *@param  offset(unsigned int),reference to the solutions 
-     * queue(priority_queue<solutionQueueElem>&), reference to the loop entry table(const LoopTableEntry&)
-     *@return   changes are made internally(void)
+     *@Description returns the number of bins
+     *@param  none
+     *@return  corresponding value ( unsigned int)
      */
-    inline void LoopTable::pAddToSolutionQueue(unsigned int offset,
-            priority_queue<solutionQueueElem>& solutionQueue, const LoopTableEntry& dest) {
-        solutionQueueElem sqe;
-        for (unsigned int i = 0; i < entry[offset].size(); i++) {
-            sqe.dev = entry[offset][i].calculateDeviation(dest, nAminoAcid);
-            sqe.index1 = offset;
-            sqe.index2 = i;
-            solutionQueue.push(sqe);
-        }
+    inline unsigned int LoopTable::pGetBinCount() const {
+        return (mapped != NULL) ? mappedBin.size() - 1 : entry.size();
+    }
+
+    /**
+     *@Description returns the number of entries in a bin
+     *@param  bin index(unsigned int)
+     *@return  corresponding value ( unsigned int)
+     */
+    inline unsigned int LoopTable::pGetBinSize(unsigned int bin) const {
+        if (mapped != NULL)
+            return mappedBin[bin + 1] - mappedBin[bin];
+        return entry[bin].size();
+    }
+
+    /**
+     *@Description returns an entry of a bin
+     *@param  bin index(unsigned int), index in the bin(unsigned int)
+     *@return  reference to the loop entry table( LoopTableEntry&)
+     */
+    inline LoopTableEntry& LoopTable::pGetEntry(unsigned int bin, unsigned int i) {
+        if (mapped != NULL)
+            return mapped[mappedBin[bin] + i];
+        return entry[bin][i];
+    }
+
+    /**
+     *@Description returns an entry of a bin
+     *@param  bin index(unsigned int), index in the bin(unsigned int)
+     *@return  reference to the loop entry table( const LoopTableEntry&)
+     */
+    inline const LoopTableEntry& LoopTable::pGetEntry(unsigned int bin, unsigned int i) const {
+        if (mapped != NULL)
+            return mapped[mappedBin[bin] + i];
+        return entry[bin][i];
+    }
+
+    /**
+     *@Description returns an entry by its number, for the k-d tree search
+     *@param  entry number(unsigned int)
+     *@return  reference to the loop entry table( const LoopTableEntry&)
+     */
+    inline const LoopTableEntry& LoopTable::pGetIndexedEntry(unsigned int n) const {
+        if (mapped != NULL)
+            return mapped[n];
+        unsigned int bin = upper_bound(indexBin.begin(), indexBin.end(), n)
+                - indexBin.begin() - 1;
+        return entry[bin][n - indexBin[bin]];
     }
 
 }} // namespace
@@ -265,11 +265,13 @@ namespace Victor { namespace Lobo {
      *@Description setToOrigin is the dual method to concatenate. It reverses the 
      *    concatenation held there, ie. the source is 'subtracted' from 
      *    destination.
-     *@param  reference to the loop table entry(const LoopTableEntry&),number of chains(unsigned int)
+     *@param  reference to the loop table entry(const LoopTableEntry&),number of chains(unsigned int),
+     *    transformation(VectorTransformation&), seed for the random bond angle
+     *    deviation, NULL to use rand()(unsigned int*)
      *@return   the resulting loop table entry(LoopTableEntry)
      */
     LoopTableEntry LoopTableEntry::setToOrigin(LoopTableEntry& dest, unsigned int nChain,
-            VectorTransformation& vt) {
+            VectorTransformation& vt, unsigned int* seed) {
 
         PRECOND(nChain >= 1, exception);
 
@@ -319,8 +321,8 @@ namespace Victor { namespace Lobo {
 
         rotationMatrix = vgMatrix3<float>::createRotationMatrix(source.endNormal,
                 DEG2RAD * ((nChain % 2 != 0)
-                ? - getBOND_ANGLE_AT_N_TO_CALPHA()
-                : getBOND_ANGLE_AT_N_TO_CALPHA()));
+                ? - getBOND_ANGLE_AT_N_TO_CALPHA(seed)
+                : getBOND_ANGLE_AT_N_TO_CALPHA(seed)));
 
         vgVector3<float> tempEndDir = -source.endDirection;
         tempEndDir = rotationMatrix * tempEndDir;
@@ -46,7 +46,9 @@ namespace Victor { namespace Lobo {
         // CONSTRUCTORS/DESTRUCTOR:
         LoopTableEntry();
         LoopTableEntry(const LoopTableEntry& orig);
-        virtual ~LoopTableEntry();
+        // not virtual: entries are laid out as six float vectors only, so
+        // that mapped tables can be used in place, see LoopTable::readMapped()
+        ~LoopTableEntry();
 
         // PREDICATES:
         // 
@@ -57,7 +59,7 @@ namespace Victor { namespace Lobo {
         float getBOND_ANGLE_AT_CALPHA_TO_CPRIME();
         float getBOND_ANGLE_AT_CPRIME_TO_N();
         float getBOND_LENGTH_N_TO_CALPHA();
-        float getBOND_ANGLE_AT_N_TO_CALPHA();
+        float getBOND_ANGLE_AT_N_TO_CALPHA(unsigned int* seed = NULL);
 
         static double getBondLengthTol() {
             return BOND_LENGTH_TOL;
@@ -78,7 +80,7 @@ namespace Victor { namespace Lobo {
         LoopTableEntry concatenate(const LoopTableEntry&, unsigned int);
         // 
         LoopTableEntry setToOrigin(LoopTableEntry&, unsigned int,
-                VectorTransformation& vt);
+                VectorTransformation& vt, unsigned int* seed = NULL);
         // 
         float rotateIntoXYPlane(VectorTransformation& vt);
         // 
@@ -132,7 +134,7 @@ namespace Victor { namespace Lobo {
 
     private:
 
-        double pGetRand();
+        double pGetRand(unsigned int* seed = NULL);
 
     };
 
@@ -174,14 +176,16 @@ namespace Victor { namespace Lobo {
     // -----------------x-------------------x-------------------x-----------------
 
     /**
-     *@Description returns a random number
-     *@param  none
+     *@Description returns a random number, drawn with rand_r() from seed 
+     *    if given, else with rand()
+     *@param  pointer to the seed(unsigned int*)
      *@return  corresponding value ( double)
      */
-    inline double LoopTableEntry::pGetRand() {
+    inline double LoopTableEntry::pGetRand(unsigned int* seed) {
         double tmp = 0.0;
         for (unsigned int i = 0; i < 12; i++)
-            tmp += static_cast<double> (rand()) / RAND_MAX;
+            tmp += static_cast<double> ((seed != NULL) ? rand_r(seed) : rand())
+                / RAND_MAX;
 
         return tmp - 6;
     }
@@ -239,12 +243,12 @@ namespace Victor { namespace Lobo {
 
     /**
      *@Description returns the value of  BOND_ANGLE_AT_N_TO_CALPHA
-     *@param  none
+     *@param  pointer to the seed of the random deviation, see pGetRand()(unsigned int*)
      *@return  corresponding value ( float)
      */
-    inline float LoopTableEntry::getBOND_ANGLE_AT_N_TO_CALPHA() {
+    inline float LoopTableEntry::getBOND_ANGLE_AT_N_TO_CALPHA(unsigned int* seed) {
         return BOND_ANGLE_AT_N_TO_CALPHA
-                + BOND_ANGLE_TOL * BOND_ANGLE_AT_N_TO_CALPHA_SD * pGetRand();
+                + BOND_ANGLE_TOL * BOND_ANGLE_AT_N_TO_CALPHA_SD * pGetRand(seed);
     }
 
 
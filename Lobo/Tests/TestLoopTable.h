@@ -0,0 +1,170 @@
+/*
+ * TestLoopTable.h
+ *
+ *  Checks that mapped tables give the same entries as the .lt files and
+ *  that the indexed searches find the closest entries.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <LoopTable.h>
+#include <RamachandranData.h>
+
+using namespace std;
+using namespace Victor::Lobo;
+
+/// Gives the tests access to LoopTable::store().
+
+class StoringLoopTable : public LoopTable {
+public:
+
+    void store(const LoopTableEntry& src) {
+        LoopTable::store(src);
+    }
+};
+
+class TestLoopTable : public CppUnit::TestFixture {
+public:
+
+    TestLoopTable() {
+    }
+
+    virtual ~TestLoopTable() {
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestLoopTable");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopTable>("Test1 - mapped table equals the decoded one.",
+                &TestLoopTable::testTestLoopTable_A));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopTable>("Test2 - indexed search equals brute force.",
+                &TestLoopTable::testTestLoopTable_B));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+    }
+
+protected:
+
+    void testTestLoopTable_A() {
+        string path = getenv("VICTOR_ROOT");
+        string tableFile = path + "Lobo/Tests/data/TestLoopTable.lt";
+        string mappedFile = LoopTable::getMappedFileName(tableFile);
+
+        // a small table for two amino acids
+        istringstream ramaIn("4\n-60 -45\n-120 130\n-70 140\n60 40\n");
+        RamachandranData rama;
+        rama.load(ramaIn);
+        LoopTable single1, single2, table;
+        single1.setRama(&rama);
+        single2.setRama(&rama);
+        single1.setToSingleAminoAcid();
+        single2.setToSingleAminoAcid();
+        table.concatenate(single1, single2, 500, 1);
+        table.write(tableFile);
+
+        LoopTable decoded;
+        decoded.read(tableFile);
+        CPPUNIT_ASSERT(!decoded.isRotated());
+        decoded.rotateIntoXYPlane();
+        decoded.writeMapped(mappedFile);
+
+        LoopTable mapped;
+        mapped.readMapped(mappedFile);
+        CPPUNIT_ASSERT(mapped.isMapped() && mapped.isRotated() && mapped.isIndexed());
+        CPPUNIT_ASSERT(mapped.getLength() == decoded.getLength());
+        CPPUNIT_ASSERT(mapped.size() == decoded.size());
+        for (unsigned int i = 0; i < decoded.size(); i++)
+            CPPUNIT_ASSERT(memcmp(&mapped[i], &decoded[i], sizeof (LoopTableEntry)) == 0);
+
+        LoopTableEntry dest = decoded[decoded.size() / 2];
+        vector<LoopTableEntry> res1 = decoded.getNClosest(dest, 5, 2);
+        vector<LoopTableEntry> res2 = mapped.getNClosest(dest, 5, 2);
+        CPPUNIT_ASSERT(res1.size() == res2.size());
+        for (unsigned int i = 0; i < res1.size(); i++)
+            CPPUNIT_ASSERT(memcmp(&res1[i], &res2[i], sizeof (LoopTableEntry)) == 0);
+
+        // copies are held in memory
+        LoopTable copy(mapped);
+        CPPUNIT_ASSERT(!copy.isMapped() && (copy.size() == mapped.size()));
+
+        // storing into a mapped table loads it first
+        StoringLoopTable stored;
+        stored.readMapped(mappedFile);
+        CPPUNIT_ASSERT(stored.isMapped());
+        stored.store(dest);
+        CPPUNIT_ASSERT(!stored.isMapped() && (stored.size() == mapped.size() + 1));
+
+        remove(tableFile.c_str());
+        remove(mappedFile.c_str());
+    }
+
+    void testTestLoopTable_B() {
+        istringstream ramaIn("4\n-60 -45\n-120 130\n-70 140\n60 40\n");
+        RamachandranData rama;
+        rama.load(ramaIn);
+        LoopTable single1, single2, table;
+        single1.setRama(&rama);
+        single2.setRama(&rama);
+        single1.setToSingleAminoAcid();
+        single2.setToSingleAminoAcid();
+        table.concatenate(single1, single2, 2000, 1);
+        table.rotateIntoXYPlane();
+        CPPUNIT_ASSERT(!table.isIndexed());
+
+        srand(11);
+        for (unsigned int q = 0; q < 20; q++) {
+            LoopTableEntry dest = table[rand() % table.size()];
+            dest.endPoint += vgVector3<float>(0.05 * (q % 5), -0.1, 0);
+            dest.endDirection += vgVector3<float>(0, 0.02 * (q % 3), -0.05);
+
+            vector<pair<double, unsigned int> > brute;
+            for (unsigned int i = 0; i < table.size(); i++)
+                brute.push_back(pair<double, unsigned int>(
+                    table[i].calculateDeviation(dest), i));
+            sort(brute.begin(), brute.end());
+
+            // nAmino > 5: the entries are returned unchanged
+            vector<LoopTableEntry> res = table.getNClosest(dest, 1 + 3 * q, 8);
+            CPPUNIT_ASSERT(table.isIndexed());
+            CPPUNIT_ASSERT(!res.empty() && (res.size() <= 1 + 3 * q));
+            for (unsigned int i = 0; i < res.size(); i++)
+                CPPUNIT_ASSERT(memcmp(&res[i], &table[brute[i].second],
+                    sizeof (LoopTableEntry)) == 0);
+            if (res.size() < 1 + 3 * q)
+                CPPUNIT_ASSERT(brute[res.size()].first > 20 * brute[0].first);
+
+            LoopTableEntry closest = table.getClosest(dest, q % 4);
+            CPPUNIT_ASSERT(memcmp(&closest, &table[brute[q % 4].second],
+                    sizeof (LoopTableEntry)) == 0);
+        }
+
+        // copies keep the index
+        LoopTable copy(table);
+        CPPUNIT_ASSERT(copy.isIndexed());
+        LoopTableEntry dest = table[0];
+        LoopTableEntry closest1 = copy.getClosest(dest, 2);
+        LoopTableEntry closest2 = table.getClosest(dest, 2);
+        CPPUNIT_ASSERT(memcmp(&closest1, &closest2, sizeof (LoopTableEntry)) == 0);
+    }
+
+};
@@ -0,0 +1,96 @@
+/*
+ * BenchAlign2.h
+ *
+ *  Pairwise alignment of two random related sequences, per length.
+ */
+
+#include <Benchmark.h>
+#include <BenchBiopool.h>
+#include <NWAlign.h>
+#include <SWAlign.h>
+#include <FSAlign.h>
+#include <ScoringS2S.h>
+#include <SequenceData.h>
+#include <SubMatrix.h>
+#include <AGPFunction.h>
+#include <cstdlib>
+
+using namespace std;
+using namespace Victor::Align2;
+
+class BenchAlign2 {
+public:
+
+    static void add(BenchRunner& runner) {
+        vector<long> lengths;
+        lengths.push_back(100);
+        lengths.push_back(200);
+        lengths.push_back(400);
+        lengths.push_back(800);
+        runner.addRange("NWAlign", benchNW, lengths);
+        runner.addRange("SWAlign", benchSW, lengths);
+        runner.addRange("FSAlign", benchFS, lengths);
+    }
+
+protected:
+
+    /// Random sequence and a copy with about 30% substitutions and 5% indels.
+
+    static void makeSequences(unsigned int length, string& seq1, string& seq2) {
+        static const string residues = "ACDEFGHIKLMNPQRSTVWY";
+        srand(length);
+        seq1 = "";
+        seq2 = "";
+        for (unsigned int i = 0; i < length; i++)
+            seq1 += residues[rand() % residues.size()];
+        for (unsigned int i = 0; (i < length) && (seq2.size() < length); i++) {
+            int r = rand() % 100;
+            if (r < 3)
+                continue; // deletion
+            if (r < 5)
+                seq2 += residues[rand() % residues.size()]; // insertion
+            if (r < 35)
+                seq2 += residues[rand() % residues.size()];
+            else
+                seq2 += seq1[i];
+        }
+    }
+
+    static void benchAlign(BenchState& state, const string& type) {
+        ifstream matrixFile(BenchBiopool::path("data/blosum62.dat").c_str());
+        if (!matrixFile)
+            ERROR("Error opening substitution matrix file.", exception);
+        SubMatrix sub(matrixFile);
+        string seq1, seq2;
+        makeSequences(state.getArg(), seq1, seq2);
+        SequenceData ad(2, seq1, seq2, "target", "template");
+        ScoringS2S ss(&sub, &ad, NULL, 1.00);
+        AGPFunction gf(12.0, 3.0);
+
+        state.setItems(static_cast<double> (seq1.size()) * seq2.size());
+        while (state.keepRunning()) {
+            Align* a;
+            if (type == "SW")
+                a = new SWAlign(&ad, &gf, &ss);
+            else if (type == "FS")
+                a = new FSAlign(&ad, &gf, &ss);
+            else
+                a = new NWAlign(&ad, &gf, &ss);
+            benchKeep(a->getScore());
+            delete a;
+        }
+    }
+
+    static void benchNW(BenchState& state) {
+        benchAlign(state, "NW");
+    }
+
+    static void benchSW(BenchState& state) {
+        benchAlign(state, "SW");
+    }
+
+    static void benchFS(BenchState& state) {
+        benchAlign(state, "FS");
+    }
+
+};
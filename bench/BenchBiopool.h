@@ -0,0 +1,151 @@
+/*
+ * BenchBiopool.h
+ *
+ *  Loading and walking the structure of samples/3DFR.pdb.
+ */
+
+#ifndef __BENCH_BIOPOOL_H__
+#define __BENCH_BIOPOOL_H__
+
+#include <Benchmark.h>
+#include <PdbLoader.h>
+#include <Protein.h>
+#include <BackboneBuilder.h>
+#include <sstream>
+#include <cstdlib>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class BenchBiopool {
+public:
+
+    static void add(BenchRunner& runner) {
+        runner.add("PdbLoader/load/3DFR", benchLoad, 0);
+        runner.add("PdbLoader/loadWithH/3DFR", benchLoad, 1);
+        runner.add("Spacer/getAmino", benchGetAmino);
+        runner.add("Atom/distance", benchDistance);
+        runner.add("Spacer/sync", benchSync);
+        runner.add("BackboneBuilder/build/3DFR", benchBuild, 1);
+        runner.add("BackboneBuilder/build/3DFRx64", benchBuild, 64);
+    }
+
+    /// Path of a file of the Victor tree.
+
+    static string path(const string& file) {
+        const char* root = getenv("VICTOR_ROOT");
+        if (root == NULL)
+            ERROR("Environment variable VICTOR_ROOT was not found.", exception);
+        return string(root) + file;
+    }
+
+    /// Contents of samples/3DFR.pdb, read once.
+
+    static const string& sampleText() {
+        static string text;
+        if (text.empty()) {
+            ifstream in(path("samples/3DFR.pdb").c_str());
+            if (!in)
+                ERROR("File not found: samples/3DFR.pdb", exception);
+            ostringstream os;
+            os << in.rdbuf();
+            text = os.str();
+        }
+        return text;
+    }
+
+    /// First chain of 3DFR without hydrogens, loaded once.
+
+    static Spacer& sample() {
+        static Protein prot;
+        if (prot.sizeProtein() == 0)
+            load(prot, false);
+        return *prot.getSpacer(0u);
+    }
+
+    static void load(Protein& prot, bool withH) {
+        istringstream in(sampleText());
+        PdbLoader pl(in);
+        pl.setNoVerbose();
+        if (!withH)
+            pl.setNoHAtoms();
+        prot.load(pl);
+    }
+
+protected:
+
+    static void benchLoad(BenchState& state) {
+        state.setItems(sampleText().size()); // bytes
+        while (state.keepRunning()) {
+            Protein prot;
+            load(prot, state.getArg() != 0);
+            benchKeep(prot.sizeProtein());
+        }
+    }
+
+    static void benchGetAmino(BenchState& state) {
+        Spacer& sp = sample();
+        state.setItems(sp.sizeAmino());
+        while (state.keepRunning()) {
+            unsigned int atoms = 0;
+            for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+                atoms += sp.getAmino(i).size();
+            benchKeep(atoms);
+        }
+    }
+
+    static void benchDistance(BenchState& state) {
+        Spacer& sp = sample();
+        vector<Atom*> ca;
+        for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+            ca.push_back(&sp.getAmino(i)[CA]);
+        state.setItems(ca.size() * (ca.size() - 1) / 2);
+        while (state.keepRunning()) {
+            double sum = 0.0;
+            for (unsigned int i = 0; i < ca.size(); i++)
+                for (unsigned int j = i + 1; j < ca.size(); j++)
+                    sum += ca[i]->distance(*ca[j]);
+            benchKeep(sum);
+        }
+    }
+
+    /// Turns a residue in the middle of the chain and updates the coordinates,
+    /// including the flat coordinate view.
+
+    static void benchSync(BenchState& state) {
+        Protein prot;
+        load(prot, false);
+        Spacer& sp = *prot.getSpacer(0u);
+        sp.getCoordinates();
+        AminoAcid& aa = sp.getAmino(sp.sizeAmino() / 2);
+        double phi = aa.getPhi();
+        state.setItems(sp.sizeAmino());
+        unsigned long n = 0;
+        while (state.keepRunning()) {
+            aa.setPhi(phi + (((n++) % 2 == 0) ? 10.0 : 0.0));
+            sp.sync();
+        }
+        benchKeep(sp.getAmino(sp.sizeAmino() - 1)[CA].getCoords().x);
+    }
+
+    /// Rebuilds the backbone of 3DFR from its torsions, as arg variants
+    /// which differ in one phi; items are atoms placed.
+
+    static void benchBuild(BenchState& state) {
+        Spacer& sp = sample();
+        BackboneBuilder bb;
+        bb.setFromSpacer(sp, 0, sp.sizeAmino() - 1);
+        unsigned int nv = state.getArg();
+        bb.setVariants(nv);
+        unsigned int n = bb.sizeAmino() / 2;
+        for (unsigned int v = 0; v < nv; v++)
+            bb.setPhi(n, bb.getPhi(n) + v, v);
+        state.setItems(bb.size() * nv);
+        while (state.keepRunning())
+            bb.build();
+        benchKeep(bb.getX(bb.size() - 1, nv - 1));
+    }
+
+};
+
+#endif /* __BENCH_BIOPOOL_H__ */
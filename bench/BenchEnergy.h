@@ -0,0 +1,79 @@
+/*
+ * BenchEnergy.h
+ *
+ *  Knowledge-based potentials on the first chain of samples/3DFR.pdb.
+ */
+
+#include <Benchmark.h>
+#include <BenchBiopool.h>
+#include <RapdfPotential.h>
+#include <SolvationPotential.h>
+#include <PhiPsi.h>
+#include <EnergyCache.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+using namespace Victor::Energy;
+
+class BenchEnergy {
+public:
+
+    static void add(BenchRunner& runner) {
+        runner.add("RapdfPotential/calculateEnergy", benchRapdf);
+        runner.add("SolvationPotential/calculateEnergy", benchSolvation);
+        runner.add("PhiPsi/calculateEnergy", benchPhiPsi);
+        runner.add("EnergyCache/update", benchCacheUpdate);
+    }
+
+protected:
+
+    /// Energy of the sample chain, per residue.
+
+    static void benchPotential(BenchState& state, Potential& pot) {
+        Spacer& sp = BenchBiopool::sample();
+        state.setItems(sp.sizeAmino());
+        while (state.keepRunning())
+            benchKeep(pot.calculateEnergy(sp));
+    }
+
+    static void benchRapdf(BenchState& state) {
+        static RapdfPotential rapdf;
+        benchPotential(state, rapdf);
+    }
+
+    static void benchSolvation(BenchState& state) {
+        static SolvationPotential solv;
+        benchPotential(state, solv);
+    }
+
+    static void benchPhiPsi(BenchState& state) {
+        static PhiPsi tor;
+        benchPotential(state, tor);
+    }
+
+    /// Moves a residue in the middle of the chain back and forth and
+    /// updates all three potentials; items are updates.
+
+    static void benchCacheUpdate(BenchState& state) {
+        static RapdfPotential rapdf;
+        static SolvationPotential solv;
+        static PhiPsi tor;
+        Protein prot;
+        BenchBiopool::load(prot, false);
+        Spacer& sp = *prot.getSpacer(0u);
+        EnergyCache cache(&rapdf, &solv, &tor);
+        cache.attach(sp);
+        unsigned int i = sp.sizeAmino() / 2;
+        AminoAcid& aa = sp.getAmino(i);
+        state.setItems(1);
+        unsigned long n = 0;
+        while (state.keepRunning()) {
+            vgVector3<double> shift(0.0, 0.0, ((n++) % 2 == 0) ? 0.5 : -0.5);
+            for (unsigned int j = 0; j < aa.size(); j++)
+                aa[j].setCoords(aa[j].getCoords() + shift);
+            cache.update(i);
+        }
+        benchKeep(cache.getEnergy());
+    }
+
+};
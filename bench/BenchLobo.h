@@ -0,0 +1,144 @@
+/*
+ * BenchLobo.h
+ *
+ *  Loop tables built from the torsion angles of samples/3DFR.pdb, and a
+ *  loop of 3DFR modelled from them.
+ */
+
+#include <Benchmark.h>
+#include <BenchBiopool.h>
+#include <LoopTable.h>
+#include <LoopModel.h>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+using namespace Victor::Biopool;
+using namespace Victor::Lobo;
+
+class BenchLobo {
+public:
+
+    static void add(BenchRunner& runner) {
+        runner.add("LoopTable/read/aa4", benchRead);
+        runner.add("LoopTable/getNClosest/aa4", benchGetNClosest);
+        runner.add("LoopModel/createLoopModel/3DFR", benchCreateLoopModel);
+    }
+
+protected:
+
+    static const unsigned long TABLE_ENTRIES = 131072;
+
+    /// First and last residue of the loop modelled in 3DFR.
+
+    static const unsigned int LOOP_START = 18;
+    static const unsigned int LOOP_END = 22;
+
+    static string& tableBase() {
+        static string base;
+        return base;
+    }
+
+    static void removeTables() {
+        remove((tableBase() + "2.lt").c_str());
+        remove((tableBase() + "4.lt").c_str());
+        remove(tableBase().substr(0, tableBase().rfind('/')).c_str());
+    }
+
+    /// Writes aa2.lt and aa4.lt to a temporary directory, once.
+
+    static const string& tables() {
+        if (!tableBase().empty())
+            return tableBase();
+
+        // the phi/psi pairs of the sample are the Ramachandran data
+        Spacer& sp = BenchBiopool::sample();
+        ostringstream ramaOut;
+        unsigned int pairs = 0;
+        for (unsigned int i = 1; i + 1 < sp.sizeAmino(); i++) {
+            ramaOut << sp.getAmino(i).getPhi() << " "
+                    << sp.getAmino(i).getPsi() << "\n";
+            pairs++;
+        }
+        ostringstream rama;
+        rama << pairs << "\n" << ramaOut.str();
+        istringstream ramaIn(rama.str());
+        static RamachandranData ramaData;
+        srand(1);
+        ramaData.load(ramaIn);
+
+        char dir[] = "/tmp/victorBenchXXXXXX";
+        if (mkdtemp(dir) == NULL)
+            ERROR("Could not create a temporary directory.", exception);
+        tableBase() = string(dir) + "/aa";
+        atexit(removeTables);
+
+        LoopTable single1, single2, table2, table4;
+        single1.setRama(&ramaData);
+        single2.setRama(&ramaData);
+        single1.setToSingleAminoAcid();
+        single2.setToSingleAminoAcid();
+        table2.concatenate(single1, single2, TABLE_ENTRIES, 1);
+        table2.write(tableBase() + "2.lt");
+        table4.concatenate(table2, table2, TABLE_ENTRIES, 1);
+        table4.write(tableBase() + "4.lt");
+        return tableBase();
+    }
+
+    static void benchRead(BenchState& state) {
+        string file = tables() + "4.lt";
+        state.setItems(TABLE_ENTRIES);
+        while (state.keepRunning()) {
+            LoopTable table;
+            table.read(file);
+            benchKeep(table.size());
+        }
+    }
+
+    static void benchGetNClosest(BenchState& state) {
+        LoopTable table;
+        table.read(tables() + "4.lt");
+        table.rotateIntoXYPlane();
+        table.buildIndex();
+
+        // entries of the table, moved a little
+        srand(2);
+        vector<LoopTableEntry> queries;
+        for (unsigned int i = 0; i < 64; i++) {
+            LoopTableEntry dest = table[rand() % table.size()];
+            dest.endPoint += vgVector3<float>(0.1, -0.1, 0.05);
+            queries.push_back(dest);
+        }
+
+        state.setItems(queries.size());
+        while (state.keepRunning())
+            for (unsigned int i = 0; i < queries.size(); i++)
+                benchKeep(table.getNClosest(queries[i], 20, 4).size());
+    }
+
+    static unsigned int modelLoop(LoopModel& lm, Spacer& sp,
+            vector<string>& typeVec) {
+        srand(3);
+        return lm.createLoopModel(sp.getAmino(LOOP_START),
+                sp.getAmino(LOOP_START + 1)[N].getCoords(),
+                sp.getAmino(LOOP_END), sp.getAmino(LOOP_END + 1)[N].getCoords(),
+                LOOP_START, LOOP_END, LoopModel::MAX_ITER_SOL, 1,
+                typeVec).size();
+    }
+
+    static void benchCreateLoopModel(BenchState& state) {
+        Spacer& sp = BenchBiopool::sample();
+        LoopModel lm;
+        lm.setTableFileName(tables());
+        vector<string> typeVec;
+        for (unsigned int i = LOOP_START + 1; i < LOOP_END + 1; i++)
+            typeVec.push_back(sp.getAmino(i).getType());
+
+        // loads the tables, before the timed loop
+        unsigned int loops = modelLoop(lm, sp, typeVec);
+        while (state.keepRunning())
+            loops += modelLoop(lm, sp, typeVec);
+        benchKeep(loops);
+    }
+
+};
@@ -0,0 +1,205 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//  Microbenchmark runner.
+//
+//  @version 0.1
+
+#include "Benchmark.h"
+#include <timer.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+extern "C" {
+#include <time.h>
+#include <unistd.h>
+}
+
+volatile char benchSink = 0;
+
+static double
+sCpuNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// BenchState:
+
+BenchState::BenchState(unsigned long iterations, long arg)
+: iterations(iterations), left(iterations), arg(arg), items(0.0),
+running(false), realStart(0.0), cpuStart(0.0), realNanos(0.0),
+cpuNanos(0.0) {
+}
+
+void
+BenchState::pStart() {
+    realNanos = cpuNanos = 0.0;
+    resume();
+}
+
+void
+BenchState::pause() {
+    if (!running)
+        return;
+    realNanos += Timer::now() - realStart;
+    cpuNanos += sCpuNow() - cpuStart;
+    running = false;
+}
+
+void
+BenchState::resume() {
+    if (running)
+        return;
+    running = true;
+    cpuStart = sCpuNow();
+    realStart = Timer::now();
+}
+
+// BenchRunner:
+
+BenchRunner::BenchRunner() : filter(""), minTime(0.5), repetitions(3) {
+}
+
+/**
+ *@param name benchmark name, "Class/method" by convention
+ *@param function body
+ *@param arg argument passed to the body (e.g. a sequence length)
+ */
+void
+BenchRunner::add(const string& name, BenchFunction function, long arg) {
+    Entry e = {name, function, arg};
+    entries.push_back(e);
+}
+
+/**
+ *   Adds one benchmark per argument, named "name/arg".
+ */
+void
+BenchRunner::addRange(const string& name, BenchFunction function,
+        const vector<long>& args) {
+    for (unsigned int i = 0; i < args.size(); i++) {
+        ostringstream os;
+        os << name << "/" << args[i];
+        add(os.str(), function, args[i]);
+    }
+}
+
+void
+BenchRunner::list(ostream& os) const {
+    for (unsigned int i = 0; i < entries.size(); i++)
+        os << entries[i].name << "\n";
+}
+
+/**
+ *   Runs the benchmarks whose names contain the filter.
+ *@param os table of the results
+ *@param json results as JSON, if not NULL
+ */
+void
+BenchRunner::run(ostream& os, ostream* json) {
+    vector<Result> results;
+    os << left << setw(40) << "benchmark" << right << setw(14) << "time ns"
+            << setw(14) << "cpu ns" << setw(12) << "iterations"
+            << setw(16) << "items/s" << "\n" << fixed;
+    for (unsigned int i = 0; i < entries.size(); i++) {
+        if (entries[i].name.find(filter) == string::npos)
+            continue;
+        Result r = pRun(entries[i]);
+        results.push_back(r);
+        os << left << setw(40) << r.name << right << setprecision(0)
+                << setw(14) << r.realNanos << setw(14) << r.cpuNanos
+                << setw(12) << r.iterations;
+        if (r.items > 0)
+            os << setw(16) << setprecision(4) << scientific
+            << r.items * 1e9 / r.realNanos << fixed;
+        os << endl;
+    }
+    if (json != NULL)
+        pWriteJson(*json, results);
+}
+
+/**
+ *   Grows the iterations until a run takes the minimum time, then
+ *   repeats the run and keeps the median.
+ */
+BenchRunner::Result
+BenchRunner::pRun(const Entry& e) {
+    unsigned long iterations = 1;
+    while (true) {
+        BenchState state(iterations, e.arg);
+        e.function(state);
+        double nanos = state.getRealNanos();
+        if ((nanos >= minTime * 1e9) || (iterations >= 1000000000))
+            break;
+        // aim 20% above the minimum, growing at most 10 times per step
+        double grow = (nanos > 0) ? 1.2 * minTime * 1e9 / nanos : 10;
+        if (grow > 10)
+            grow = 10;
+        unsigned long next = static_cast<unsigned long> (iterations * grow);
+        iterations = (next > iterations) ? next : iterations + 1;
+    }
+
+    vector<pair<double, double> > runs; // real, cpu per iteration
+    double items = 0.0;
+    for (unsigned int r = 0; r < repetitions; r++) {
+        BenchState state(iterations, e.arg);
+        e.function(state);
+        runs.push_back(pair<double, double>(state.getRealNanos() / iterations,
+                state.getCpuNanos() / iterations));
+        items = state.getItems();
+    }
+    sort(runs.begin(), runs.end());
+
+    Result res;
+    res.name = e.name;
+    res.iterations = iterations;
+    res.realNanos = runs[runs.size() / 2].first;
+    res.cpuNanos = runs[runs.size() / 2].second;
+    res.minNanos = runs[0].first;
+    res.items = items;
+    return res;
+}
+
+void
+BenchRunner::pWriteJson(ostream& json, const vector<Result>& results) const {
+    char host[256] = "";
+    gethostname(host, sizeof (host) - 1);
+    time_t now = time(NULL);
+    char date[64];
+    strftime(date, sizeof (date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    json << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"host_name\": \"" << host << "\",\n"
+            << "    \"num_cpus\": " << sysconf(_SC_NPROCESSORS_ONLN) << ",\n"
+            << "    \"min_time\": " << minTime << ",\n"
+            << "    \"repetitions\": " << repetitions << "\n"
+            << "  },\n  \"benchmarks\": [\n"
+            << setprecision(1) << fixed;
+    for (unsigned int i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        json << "    {\"name\": \"" << r.name << "\", \"iterations\": "
+                << r.iterations << ", \"real_time\": " << r.realNanos
+                << ", \"cpu_time\": " << r.cpuNanos
+                << ", \"min_real_time\": " << r.minNanos
+                << ", \"time_unit\": \"ns\"";
+        if (r.items > 0)
+            json << ", \"items_per_second\": " << r.items * 1e9 / r.realNanos;
+        json << "}" << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+    json << "  ]\n}" << endl;
+}
@@ -0,0 +1,171 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+@Description Microbenchmark runner.
+
+    @version 0.1*/
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <string>
+#include <vector>
+#include <iostream>
+using namespace std;
+
+/** State of one run of a benchmark. The benchmark prepares its data, then
+ *  times its body in a loop:
+ *
+ *      while (state.keepRunning())
+ *          benchKeep(work(state.getArg()));
+ *
+ *  Only the loop is timed; pause() and resume() exclude work done in it.
+
+ *@version 0.1 */
+class BenchState {
+public:
+
+    BenchState(unsigned long iterations, long arg);
+
+    // Selectors.
+
+    long getArg() const {
+        return arg;
+    }
+
+    unsigned long getIterations() const {
+        return iterations;
+    }
+
+    double getRealNanos() const {
+        return realNanos;
+    }
+
+    double getCpuNanos() const {
+        return cpuNanos;
+    }
+
+    double getItems() const {
+        return items;
+    }
+
+    // Modifiers.
+
+    /// True until the body has run the given number of iterations.
+
+    bool keepRunning() {
+        if (left == iterations)
+            pStart();
+        if (left > 0) {
+            left--;
+            return true;
+        }
+        pause();
+        return false;
+    }
+
+    void pause();
+    void resume();
+
+    /// Items (atoms, cells, ...) processed by each iteration, for rates.
+
+    void setItems(double perIteration) {
+        items = perIteration;
+    }
+
+private:
+    void pStart();
+
+    unsigned long iterations;
+    unsigned long left;
+    long arg;
+    double items;
+    bool running;
+    double realStart, cpuStart;
+    double realNanos, cpuNanos;
+};
+
+/// Benchmark body.
+typedef void (*BenchFunction)(BenchState&);
+
+/** BenchRunner runs the registered benchmarks and reports the time per
+ *  iteration of each, as a table and optionally as JSON in the format of
+ *  Google Benchmark.
+ *
+ *  The number of iterations is grown until a run takes the minimum time,
+ *  then the run is repeated; the median run is reported. Benchmarks must
+ *  be deterministic (fixed seeds), so that results can be compared
+ *  across builds.
+
+ *@version 0.1 */
+class BenchRunner {
+public:
+
+    BenchRunner();
+
+    // Modifiers.
+
+    void add(const string& name, BenchFunction function, long arg = 0);
+    void addRange(const string& name, BenchFunction function,
+            const vector<long>& args);
+
+    void setFilter(const string& _filter) {
+        filter = _filter;
+    }
+
+    void setMinTime(double seconds) {
+        minTime = seconds;
+    }
+
+    void setRepetitions(unsigned int n) {
+        repetitions = (n > 0) ? n : 1;
+    }
+
+    void list(ostream& os) const;
+    void run(ostream& os, ostream* json = NULL);
+
+private:
+
+    struct Entry {
+        string name;
+        BenchFunction function;
+        long arg;
+    };
+
+    struct Result {
+        string name;
+        unsigned long iterations;
+        double realNanos, cpuNanos, minNanos, items;
+    };
+
+    Result pRun(const Entry& e);
+    void pWriteJson(ostream& json, const vector<Result>& results) const;
+
+    vector<Entry> entries;
+    string filter;
+    double minTime;
+    unsigned int repetitions;
+};
+
+/// Keeps the compiler from dropping a computation whose result is unused.
+extern volatile char benchSink;
+
+template <class T> inline void
+benchKeep(const T& value) {
+    benchSink = *reinterpret_cast<const volatile char*> (&value);
+}
+
+#endif /* __BENCHMARK_H__ */
@@ -0,0 +1,77 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ */
+#include <Benchmark.h>
+#include <BenchBiopool.h>
+#include <BenchEnergy.h>
+#include <BenchAlign2.h>
+#include <BenchLobo.h>
+#include <GetArg.h>
+#include <fstream>
+
+using namespace std;
+
+void sShowHelp() {
+    cout << "Victor Bench -- microbenchmarks of the libraries, on the files of\n"
+            << "samples/ and data/ below VICTOR_ROOT\n"
+            << " Options: \n"
+            << "\t[--filter <text>] \t Only benchmarks whose name contains text\n"
+            << "\t[--json <filename>] \t Also write the results as JSON\n"
+            << "\t[--minTime <double>] \t Minimum seconds per run (def = 0.5)\n"
+            << "\t[--repetitions <n>] \t Runs per benchmark, the median is reported (def = 3)\n"
+            << "\t[--list] \t\t List the benchmarks\n\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (getArg("h", argc, argv)) {
+        sShowHelp();
+        return 1;
+    }
+
+    string filter, jsonFile;
+    double minTime;
+    unsigned int repetitions;
+    getArg("-filter", filter, argc, argv, "");
+    getArg("-json", jsonFile, argc, argv, "!");
+    getArg("-minTime", minTime, argc, argv, 0.5);
+    getArg("-repetitions", repetitions, argc, argv, 3);
+
+    BenchRunner runner;
+    BenchBiopool::add(runner);
+    BenchEnergy::add(runner);
+    BenchAlign2::add(runner);
+    BenchLobo::add(runner);
+
+    if (getArg("-list", argc, argv)) {
+        runner.list(cout);
+        return 0;
+    }
+
+    runner.setFilter(filter);
+    runner.setMinTime(minTime);
+    runner.setRepetitions(repetitions);
+
+    if (jsonFile != "!") {
+        ofstream json(jsonFile.c_str());
+        if (!json)
+            ERROR("Could not open file for writing.", exception);
+        runner.run(cout, &json);
+    } else
+        runner.run(cout);
+
+    return 0;
+}
@@ -32,22 +32,36 @@ using namespace std;
 #define OSTREAM cerr
 #endif
 
+#include <Trace.h>
+
+// Streams one trace line of the module's category, if selected at run time.
+#define TRACE_OUT(category)                                         \
+   for (TraceLine _trace_line_(category); _trace_line_.isOpen();    \
+        _trace_line_.close())                                       \
+      _trace_line_.stream()
+
+// Below the VERBOSE level of the build, the statement is dead code and
+// compiles to nothing: no stream is created and no argument evaluated.
+#define TRACE_NONE while (false) OSTREAM
+
 #if VERBOSE >= 3
-#define V3OUT OSTREAM
+#define V3OUT TRACE_OUT(TRACE_CATEGORY)
 #else
-#define V3OUT ofstream("/dev/null")
+#define V3OUT TRACE_NONE
 #endif
 
 #if VERBOSE >= 2
-#define V2OUT OSTREAM
+#define V2OUT TRACE_OUT(TRACE_CATEGORY)
+#define TRACE_SPAN(name) TraceSpan _trace_span_(TRACE_CATEGORY, name)
 #else
-#define V2OUT ofstream("/dev/null")
+#define V2OUT TRACE_NONE
+#define TRACE_SPAN(name)
 #endif
 
 #if VERBOSE >= 1
-#define V1OUT OSTREAM
+#define V1OUT TRACE_OUT(TRACE_CATEGORY)
 #else
-#define V1OUT ofstream("/dev/null")
+#define V1OUT TRACE_NONE
 #endif
 
 // If internalization is used, please include <libintl.h> *before* <debug.h>
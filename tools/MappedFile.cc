@@ -0,0 +1,76 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//  Read-only view of a whole file, memory-mapped.
+//
+//  @version 0.1
+
+#include "MappedFile.h"
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+}
+
+MappedFile::MappedFile(const string& fileName) : open(false), mapped(false),
+data(NULL), length(0) {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    open = true;
+
+    struct stat st;
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+        void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+            madvise(p, st.st_size, MADV_WILLNEED);
+            mapped = true;
+            data = static_cast<const char*> (p);
+            length = st.st_size;
+        }
+    }
+    if (!mapped)
+        readAll(fd);
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (mapped)
+        munmap(const_cast<char*> (data), length);
+    else
+        delete[] data;
+}
+
+/// Reads fd to its end into an allocated buffer.
+void MappedFile::readAll(int fd) {
+    unsigned long capacity = 65536;
+    char* buffer = new char[capacity];
+    ssize_t n;
+    while ((n = read(fd, buffer + length, capacity - length)) > 0) {
+        length += n;
+        if (length == capacity) {
+            char* larger = new char[2 * capacity];
+            for (unsigned long i = 0; i < length; i++)
+                larger[i] = buffer[i];
+            delete[] buffer;
+            buffer = larger;
+            capacity *= 2;
+        }
+    }
+    data = buffer;
+}
@@ -0,0 +1,69 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+@Description Read-only view of a whole file, memory-mapped.
+
+    @version 0.1*/
+
+#ifndef __MAPPED_FILE
+#define __MAPPED_FILE
+
+#include <string>
+using namespace std;
+
+/** MappedFile maps a file read-only into memory for as long as the object
+ *  lives, so that its contents can be scanned in place without going
+ *  through a stream. The kernel is told that the file will be read
+ *  sequentially, to read ahead at disk speed. Files that cannot be mapped
+ *  (e.g. pipes) are read into memory instead.
+
+ *@version 0.1 */
+class MappedFile {
+public:
+
+    MappedFile(const string& fileName);
+    virtual ~MappedFile();
+
+    // Selectors.
+
+    /// The file could be opened.
+    bool isOpen() const {
+        return open;
+    }
+
+    /// Contents of the file, not NUL-terminated.
+    const char* getData() const {
+        return data;
+    }
+
+    unsigned long size() const {
+        return length;
+    }
+
+private:
+    // The mapping cannot be shared.
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    void readAll(int fd);
+
+    bool open;
+    bool mapped; // data is a mapping, else allocated
+    const char* data;
+    unsigned long length;
+};
+
+#endif
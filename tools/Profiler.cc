@@ -0,0 +1,327 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//  Hierarchical profiler of named regions and counters.
+//
+//  @version 0.1
+
+#include "Profiler.h"
+#include "timer.h"
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+
+extern "C" {
+#include <stdlib.h>
+#include <pthread.h>
+}
+
+/** A region, with the regions entered inside it. */
+struct ProfileNode {
+
+    ProfileNode(const char* name = "", ProfileNode* parent = NULL)
+    : name(name), calls(0), nanos(0.0), start(0.0), parent(parent) {
+    }
+
+    ~ProfileNode() {
+        clear();
+    }
+
+    void clear() {
+        for (unsigned int i = 0; i < children.size(); i++)
+            delete children[i];
+        children.clear();
+        counters.clear();
+    }
+
+    ProfileNode* child(const char* childName) {
+        for (unsigned int i = 0; i < children.size(); i++)
+            if ((children[i]->name == childName)
+                    || (strcmp(children[i]->name, childName) == 0))
+                return children[i];
+        children.push_back(new ProfileNode(childName, this));
+        return children.back();
+    }
+
+    unsigned long& counter(const char* counterName) {
+        for (unsigned int i = 0; i < counters.size(); i++)
+            if ((counters[i].first == counterName)
+                    || (strcmp(counters[i].first, counterName) == 0))
+                return counters[i].second;
+        counters.push_back(pair<const char*, unsigned long>(counterName, 0));
+        return counters.back().second;
+    }
+
+    const char* name;
+    unsigned long calls;
+    double nanos; // total time, subregions included
+    double start; // of the current call
+    ProfileNode* parent;
+    vector<ProfileNode*> children;
+    vector<pair<const char*, unsigned long> > counters;
+
+private:
+    ProfileNode(const ProfileNode&);
+    ProfileNode& operator=(const ProfileNode&);
+};
+
+/** Regions of one thread; current is the innermost open one. */
+struct ProfileThread {
+
+    ProfileThread() : root(), current(&root) {
+    }
+
+    ProfileNode root;
+    ProfileNode* current;
+};
+
+bool Profiler::enabled = false;
+
+static pthread_mutex_t sMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t sKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t sKey;
+static vector<ProfileThread*> sThreads; // never freed, for the report
+static string sJsonFile;
+static bool sAtExit = false;
+
+static void
+sMakeKey() {
+    pthread_key_create(&sKey, NULL);
+}
+
+/**
+ *   Regions of the calling thread, registered on first use.
+ */
+static ProfileThread*
+sThread() {
+    pthread_once(&sKeyOnce, sMakeKey);
+    ProfileThread* t = static_cast<ProfileThread*> (pthread_getspecific(sKey));
+    if (t == NULL) {
+        t = new ProfileThread;
+        pthread_setspecific(sKey, t);
+        pthread_mutex_lock(&sMutex);
+        sThreads.push_back(t);
+        pthread_mutex_unlock(&sMutex);
+    }
+    return t;
+}
+
+/**
+ *   Adds the calls, times and counters of a tree to the regions of the
+ *   same names.
+ */
+static void
+sMerge(ProfileNode& into, const ProfileNode& from) {
+    into.calls += from.calls;
+    into.nanos += from.nanos;
+    for (unsigned int i = 0; i < from.counters.size(); i++)
+        into.counter(from.counters[i].first) += from.counters[i].second;
+    for (unsigned int i = 0; i < from.children.size(); i++)
+        sMerge(*into.child(from.children[i]->name), *from.children[i]);
+}
+
+static unsigned int
+sMergeThreads(ProfileNode& merged) {
+    pthread_mutex_lock(&sMutex);
+    for (unsigned int i = 0; i < sThreads.size(); i++)
+        sMerge(merged, sThreads[i]->root);
+    unsigned int threads = sThreads.size();
+    pthread_mutex_unlock(&sMutex);
+    return threads;
+}
+
+static double
+sSelfNanos(const ProfileNode& node) {
+    double self = node.nanos;
+    for (unsigned int i = 0; i < node.children.size(); i++)
+        self -= node.children[i]->nanos;
+    return self;
+}
+
+static void
+sReportNode(ostream& os, const ProfileNode& node, unsigned int depth) {
+    string indent(2 * depth, ' ');
+    os << left << setw(44) << indent + node.name << right
+            << setw(10) << node.calls
+            << setw(14) << node.nanos * 1e-6
+            << setw(14) << sSelfNanos(node) * 1e-6 << "\n";
+    for (unsigned int i = 0; i < node.counters.size(); i++)
+        os << left << setw(44) << indent + "  # " + node.counters[i].first
+        << right << setw(10) << node.counters[i].second << "\n";
+    for (unsigned int i = 0; i < node.children.size(); i++)
+        sReportNode(os, *node.children[i], depth + 1);
+}
+
+static void
+sJsonString(ostream& os, const char* s) {
+    os << '"';
+    for (; *s != '\0'; s++) {
+        if ((*s == '"') || (*s == '\\'))
+            os << '\\';
+        os << *s;
+    }
+    os << '"';
+}
+
+static void
+sJsonNode(ostream& os, const ProfileNode& node) {
+    os << "{\"name\": ";
+    sJsonString(os, node.name);
+    os << ", \"calls\": " << node.calls
+            << ", \"ms\": " << node.nanos * 1e-6
+            << ", \"self_ms\": " << sSelfNanos(node) * 1e-6
+            << ", \"counters\": {";
+    for (unsigned int i = 0; i < node.counters.size(); i++) {
+        if (i > 0)
+            os << ", ";
+        sJsonString(os, node.counters[i].first);
+        os << ": " << node.counters[i].second;
+    }
+    os << "}, \"children\": [";
+    for (unsigned int i = 0; i < node.children.size(); i++) {
+        if (i > 0)
+            os << ", ";
+        sJsonNode(os, *node.children[i]);
+    }
+    os << "]}";
+}
+
+static void
+sReportAtExit() {
+    if (!Profiler::isEnabled())
+        return;
+    Profiler::report(cerr);
+    if (!sJsonFile.empty()) {
+        ofstream json(sJsonFile.c_str());
+        if (json)
+            Profiler::writeJson(json);
+        else
+            cerr << "PROFILE: could not write " << sJsonFile << endl;
+    }
+}
+
+/**
+ *   Turns the profiler on when the environment asks for it.
+ */
+static bool
+sEnableFromEnvironment() {
+    const char* value = getenv("VICTOR_PROFILE");
+    if ((value == NULL) || (*value == '\0') || (strcmp(value, "0") == 0))
+        return false;
+    Profiler::enable(strcmp(value, "1") == 0 ? "" : value);
+    return true;
+}
+
+static bool sFromEnvironment = sEnableFromEnvironment();
+
+// MODIFIERS:
+
+/**
+ *   Turns the profiler on. The report is written to cerr at exit.
+ *@param jsonFile file to write the report to as JSON at exit, if given
+ */
+void
+Profiler::enable(const string& jsonFile) {
+    enabled = true;
+    sJsonFile = jsonFile;
+    if (!sAtExit) {
+        sAtExit = true;
+        atexit(sReportAtExit);
+    }
+}
+
+void
+Profiler::disable() {
+    enabled = false;
+}
+
+void
+Profiler::enter(const char* name) {
+    ProfileThread* t = sThread();
+    t->current = t->current->child(name);
+    t->current->start = Timer::now();
+}
+
+void
+Profiler::leave() {
+    ProfileThread* t = sThread();
+    ProfileNode* node = t->current;
+    if (node->parent == NULL)
+        return; // the regions were reset meanwhile
+    node->nanos += Timer::now() - node->start;
+    node->calls++;
+    t->current = node->parent;
+}
+
+/**
+ *@param name counter
+ *@param n amount to add
+ */
+void
+Profiler::count(const char* name, unsigned long n) {
+    sThread()->current->counter(name) += n;
+}
+
+/**
+ *   Drops the regions and counters of all threads. No region may be open.
+ */
+void
+Profiler::reset() {
+    pthread_mutex_lock(&sMutex);
+    for (unsigned int i = 0; i < sThreads.size(); i++) {
+        sThreads[i]->root.clear();
+        sThreads[i]->current = &sThreads[i]->root;
+    }
+    pthread_mutex_unlock(&sMutex);
+}
+
+// OUTPUT:
+
+/**
+ *   Writes the regions of all threads, merged by name, as a table: calls,
+ *   total and self time in ms, and counters below their region.
+ */
+void
+Profiler::report(ostream& os) {
+    ProfileNode merged;
+    unsigned int threads = sMergeThreads(merged);
+    ios::fmtflags flags = os.flags();
+    os << "PROFILE: " << threads << " thread(s)\n"
+            << left << setw(44) << "region" << right << setw(10) << "calls"
+            << setw(14) << "total ms" << setw(14) << "self ms" << "\n"
+            << fixed << setprecision(3);
+    for (unsigned int i = 0; i < merged.counters.size(); i++)
+        os << left << setw(44) << string("# ") + merged.counters[i].first
+        << right << setw(10) << merged.counters[i].second << "\n";
+    for (unsigned int i = 0; i < merged.children.size(); i++)
+        sReportNode(os, *merged.children[i], 0);
+    os << flush;
+    os.flags(flags);
+}
+
+/**
+ *   Writes the regions of all threads, merged by name, as a JSON object.
+ */
+void
+Profiler::writeJson(ostream& os) {
+    ProfileNode merged("all");
+    unsigned int threads = sMergeThreads(merged);
+    for (unsigned int i = 0; i < merged.children.size(); i++)
+        merged.nanos += merged.children[i]->nanos;
+    os << "{\"threads\": " << threads << ", \"regions\": ";
+    sJsonNode(os, merged);
+    os << "}" << endl;
+}
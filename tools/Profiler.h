@@ -0,0 +1,98 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+@Description Hierarchical profiler of named regions and counters.
+
+    @version 0.1*/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <string>
+#include <iostream>
+using namespace std;
+
+/** Profiler accumulates the time spent in named regions of the code, and
+ *  counters of the work done in them (e.g. pairs of atoms evaluated).
+ *
+ *  Regions nest: a region entered inside another one is reported below
+ *  it, with its own total and the time spent in it but not in its
+ *  subregions. Each thread accumulates into its own tree, without locks;
+ *  the trees are merged by name for the report.
+ *
+ *  The profiler is off by default, when a region costs one test. Setting
+ *  the environment variable VICTOR_PROFILE turns it on for any program:
+ *  "1" writes the report to cerr at exit, a file name also writes it
+ *  there as JSON. Region and counter names must be string literals.
+
+ *@version 0.1 */
+class Profiler {
+public:
+
+    // Selectors.
+
+    static bool isEnabled() {
+        return enabled;
+    }
+
+    // Modifiers.
+
+    static void enable(const string& jsonFile = "");
+    static void disable();
+    static void enter(const char* name);
+    static void leave();
+    static void count(const char* name, unsigned long n);
+    static void reset();
+
+    // Output.
+
+    static void report(ostream& os = cerr);
+    static void writeJson(ostream& os);
+
+private:
+    static bool enabled;
+};
+
+/** Times the scope it lives in as a region of Profiler. Only used through
+ *  PROFILE_REGION. */
+class ProfileRegion {
+public:
+
+    explicit ProfileRegion(const char* name) : active(Profiler::isEnabled()) {
+        if (active)
+            Profiler::enter(name);
+    }
+
+    ~ProfileRegion() {
+        if (active)
+            Profiler::leave();
+    }
+
+private:
+    ProfileRegion(const ProfileRegion&);
+    ProfileRegion& operator=(const ProfileRegion&);
+
+    bool active;
+};
+
+#define PROFILE_REGION(name) ProfileRegion _profile_region_(name)
+
+// Adds n to a counter of the current region; count in a local variable
+// inside loops and add it once.
+#define PROFILE_COUNT(name, n)                                      \
+   do { if (Profiler::isEnabled()) Profiler::count(name, n); } while (false)
+
+#endif /* __PROFILER_H__ */
@@ -0,0 +1,193 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//  Runtime side of the trace macros of Debug.h.
+//
+//  @version 0.1
+
+#include "Trace.h"
+#include <cctype>
+
+extern "C" {
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/time.h>
+}
+
+bool Trace::initialized = false;
+unsigned int Trace::categories = TRACE_ALL;
+vector<string> Trace::ring;
+unsigned int Trace::next = 0;
+unsigned long Trace::written = 0;
+
+// Lines may come from the threads of PdbPipeline.
+static pthread_mutex_t sRingMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t sInitOnce = PTHREAD_ONCE_INIT;
+
+static void
+sDumpAtExit() {
+    Trace::dump(cerr);
+}
+
+static double
+sNow() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+unsigned int
+Trace::getCategories() {
+    if (!initialized)
+        init();
+    return categories;
+}
+
+unsigned int
+Trace::getRingSize() {
+    return ring.size();
+}
+
+void
+Trace::setCategories(unsigned int mask) {
+    categories = mask;
+    __sync_synchronize();
+    initialized = true;
+}
+
+/**
+ *   Keeps the last lines in memory instead of writing them. Lines already
+ *   in the ring are dropped.
+ *@param lines size of the ring, 0 to write lines directly
+ */
+void
+Trace::setRingSize(unsigned int lines) {
+    pthread_mutex_lock(&sRingMutex);
+    ring.assign(lines, string());
+    next = 0;
+    written = 0;
+    pthread_mutex_unlock(&sRingMutex);
+}
+
+/**
+ *   Stores a line in the ring, overwriting the oldest one when full.
+ */
+void
+Trace::write(const string& line) {
+    pthread_mutex_lock(&sRingMutex);
+    if (ring.empty())
+        cerr << line;
+    else {
+        ring[next] = line;
+        next = (next + 1) % ring.size();
+        written++;
+    }
+    pthread_mutex_unlock(&sRingMutex);
+}
+
+/**
+ *   Writes the lines of the ring, oldest first, and empties it.
+ */
+void
+Trace::dump(ostream& os) {
+    pthread_mutex_lock(&sRingMutex);
+    if (written > ring.size())
+        os << "TRACE: " << written - ring.size() << " older lines dropped."
+            << endl;
+    unsigned int n = (written < ring.size()) ? written : ring.size();
+    unsigned int first = (written < ring.size()) ? 0 : next;
+    for (unsigned int i = 0; i < n; i++) {
+        string& line = ring[(first + i) % ring.size()];
+        os << line;
+        line.clear();
+    }
+    os << flush;
+    next = 0;
+    written = 0;
+    pthread_mutex_unlock(&sRingMutex);
+}
+
+/**
+ *@param names comma separated module names, or "all"
+ *@return mask of TraceCategory values
+ */
+unsigned int
+Trace::parseCategories(const string& names) {
+    unsigned int mask = 0;
+    string::size_type pos = 0;
+    while (pos <= names.size()) {
+        string::size_type end = names.find(',', pos);
+        if (end == string::npos)
+            end = names.size();
+        string name = names.substr(pos, end - pos);
+        for (unsigned int i = 0; i < name.size(); i++)
+            name[i] = tolower(name[i]);
+
+        if (name == "all")
+            mask |= TRACE_ALL;
+        else if (name == "tools")
+            mask |= TRACE_TOOLS;
+        else if (name == "biopool")
+            mask |= TRACE_BIOPOOL;
+        else if (name == "energy")
+            mask |= TRACE_ENERGY;
+        else if (name == "align2")
+            mask |= TRACE_ALIGN2;
+        else if (name == "lobo")
+            mask |= TRACE_LOBO;
+        else if (!name.empty())
+            cerr << "TRACE: unknown category " << name << " ignored." << endl;
+        pos = end + 1;
+    }
+    return mask;
+}
+
+/**
+ *   Reads the environment once, whichever thread traces first.
+ */
+void
+Trace::init() {
+    pthread_once(&sInitOnce, pInit);
+}
+
+void
+Trace::pInit() {
+    const char* names = getenv("VICTOR_TRACE");
+    if (names != NULL)
+        categories = parseCategories(names);
+    const char* lines = getenv("VICTOR_TRACE_RING");
+    if ((lines != NULL) && (atoi(lines) > 0)) {
+        setRingSize(atoi(lines));
+        atexit(sDumpAtExit);
+    }
+    // threads that find it set skip init(), so it comes last
+    __sync_synchronize();
+    initialized = true;
+}
+
+TraceSpan::TraceSpan(unsigned int category, const char* name)
+: category(category), name(name), start(0.0) {
+    if (Trace::isEnabled(category))
+        start = sNow();
+}
+
+TraceSpan::~TraceSpan() {
+    if (!Trace::isEnabled(category))
+        return;
+    ostringstream os;
+    os << "TRACE_SPAN: " << name << " " << (sNow() - start) * 1000.0
+            << " ms" << endl;
+    Trace::write(os.str());
+}
@@ -0,0 +1,148 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+@Description Runtime side of the trace macros of Debug.h.
+
+    @version 0.1*/
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+/// Modules whose trace output can be selected at run time.
+enum TraceCategory {
+    TRACE_TOOLS = 1,
+    TRACE_BIOPOOL = 2,
+    TRACE_ENERGY = 4,
+    TRACE_ALIGN2 = 8,
+    TRACE_LOBO = 16,
+    TRACE_ALL = 31
+};
+
+// Makefile.global defines the category of the module being compiled.
+#ifndef TRACE_CATEGORY
+#define TRACE_CATEGORY TRACE_TOOLS
+#endif
+
+/** Trace decides which trace lines are written and where to.
+ *
+ *  The categories are read from the environment variable VICTOR_TRACE,
+ *  a comma separated list of module names (e.g. "biopool,energy") or
+ *  "all", the default. With VICTOR_TRACE_RING=n the last n lines are kept
+ *  in memory instead of being written, and dumped to cerr at exit; the
+ *  ring can also be set up and dumped by the program.
+ *
+ *  Lines are only produced by the trace macros of Debug.h, which compile
+ *  to nothing below the VERBOSE level of the build.
+
+ *@version 0.1 */
+class Trace {
+public:
+
+    // Selectors.
+
+    static bool isEnabled(unsigned int category) {
+        if (!initialized)
+            init();
+        return (categories & category) != 0;
+    }
+
+    static unsigned int getCategories();
+    static unsigned int getRingSize();
+
+    // Modifiers.
+
+    static void setCategories(unsigned int mask);
+    static void setRingSize(unsigned int lines);
+    static void write(const string& line);
+    static void dump(ostream& os = cerr);
+
+    // Helpers.
+
+    static unsigned int parseCategories(const string& names);
+
+private:
+    static void init();
+    static void pInit();
+
+    static bool initialized;
+    static unsigned int categories;
+    static vector<string> ring; // empty: lines are written directly
+    static unsigned int next; // oldest line of a full ring
+    static unsigned long written;
+};
+
+/** One trace line, collected while the macro streams into it and handed
+ *  to Trace when complete. Only used through the macros of Debug.h. */
+class TraceLine {
+public:
+
+    explicit TraceLine(unsigned int category) : open(Trace::isEnabled(category)),
+    buffer(NULL) {
+    }
+
+    ~TraceLine() {
+        delete buffer;
+    }
+
+    bool isOpen() const {
+        return open;
+    }
+
+    ostream& stream() {
+        if (Trace::getRingSize() == 0)
+            return cerr;
+        buffer = new ostringstream;
+        return *buffer;
+    }
+
+    void close() {
+        if (buffer != NULL)
+            Trace::write(buffer->str());
+        open = false;
+    }
+
+private:
+    TraceLine(const TraceLine&);
+    TraceLine& operator=(const TraceLine&);
+
+    bool open;
+    ostringstream* buffer;
+};
+
+/** Traces the wall clock time between its construction and destruction.
+ *  Only used through TRACE_SPAN. */
+class TraceSpan {
+public:
+
+    TraceSpan(unsigned int category, const char* name);
+    ~TraceSpan();
+
+private:
+    TraceSpan(const TraceSpan&);
+    TraceSpan& operator=(const TraceSpan&);
+
+    unsigned int category;
+    const char* name;
+    double start;
+};
+
+#endif /* __TRACE_H__ */
@@ -20,36 +20,27 @@
 
 #include "timer.h"
 
-int Timer::seconds() const {
-    if (endTime != 0) {
+double Timer::nanoseconds() const {
+    if (endTime != 0.0) {
         return endTime - startTime;
     }
     else {
-        time_t now = time(0);
-        return now - startTime;
+        return now() - startTime;
     }
 }
 
-int Timer::minutes() const {
-    if (endTime != 0) {
-        return (endTime - startTime) / 60;
-    }
-    else {
-        time_t now = time(0);
-        return (now - startTime) / 60;
-    }
+double Timer::milliseconds() const {
+    return nanoseconds() * 1e-6;
 }
 
-int Timer::hours() const {
-    if (endTime != 0) {
-        return (endTime - startTime) / 3600;
-    }
-    else {
-        time_t now = time(0);
-        return (now - startTime) / 3600;
-    }
+int Timer::seconds() const {
+    return static_cast<int> (nanoseconds() * 1e-9);
 }
 
+int Timer::minutes() const {
+    return seconds() / 60;
+}
 
-
-
+int Timer::hours() const {
+    return seconds() / 3600;
+}
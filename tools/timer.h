@@ -16,7 +16,7 @@
 /**  
 @Description Timer class for benchmarking and more.
 
-    @version 0.1*/
+    @version 0.2*/
 
 #ifndef __TIMER
 #define __TIMER
@@ -28,13 +28,15 @@ extern "C" {
 #include <iostream>
 using namespace std;
 
-/** Timer provides an interface for timing.
+/** Timer provides an interface for timing, with the monotonic clock of
+ *  the system (nanosecond resolution). The time is taken between start()
+ *  and stop(), or until now while the timer runs.
 
- *@version 0.1 */
+ *@version 0.2 */
 class Timer {
 public:
 
-    Timer() : startTime(0), endTime(0) {
+    Timer() : startTime(0.0), endTime(0.0) {
     }
 
     // We use default destructor and copy-constructor.
@@ -42,31 +44,41 @@ public:
     // Modifiers.
 
     inline void start() {
-        time(&startTime);
+        startTime = now();
+        endTime = 0.0;
     }
 
     inline void stop() {
-        time(&endTime);
+        endTime = now();
     }
 
     inline void reset() {
-        startTime = endTime = 0;
+        startTime = endTime = 0.0;
     }
 
     // Selectors.
+    double nanoseconds() const;
+    double milliseconds() const;
     int seconds() const;
     int minutes() const;
     int hours() const;
 
+    /// Nanoseconds since an arbitrary point, not affected by clock changes.
+    static inline double now() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e9 + ts.tv_nsec;
+    }
+
 protected:
-    time_t startTime, endTime;
+    double startTime, endTime; // nanoseconds, see now()
 };
 
 // output operator
 
 inline ostream& operator<<(ostream& os, const Timer& time) {
     os << time.hours() << " hours " << (time.minutes() % 60) << " minutes "
-            << (time.seconds() % 60) << " seconds.";
+            << (time.nanoseconds() * 1e-9 - time.minutes() * 60) << " seconds.";
     return os;
 }
 